@@ -1,56 +1,55 @@
 #version 330 core
 
 // Input from vertex shader
-in vec3 fragColor;
-in vec3 fragNormal;
-in vec2 fragTexCoord;
+in vec3 vPosition;
+in vec3 vNormal;
+in vec2 vTexCoord;
+in float vLighting;
 in float fragLightLevel;
+flat in float fragTextureLayer;
+
+// Per-frame camera data, shared by all shaders (see CameraUniforms)
+layout(std140) uniform Camera {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uCameraPosition;
+};
 
 // Uniforms
-uniform sampler2D texture_sampler;
+// Block textures, one layer per texture (see BlockTextureArray)
+uniform sampler2DArray uBlockTextures;
 uniform vec3 lightDir;
-uniform vec3 viewPos;
 
 // Output
 out vec4 FragColor;
 
 void main()
 {
-    // Sample texture color
-    vec4 texColor = texture(texture_sampler, fragTexCoord);
-    
+    // Sample texture color; GL_REPEAT wraps merged quads within their layer
+    vec4 texColor = texture(uBlockTextures, vec3(vTexCoord, fragTextureLayer));
+
     // Discard transparent pixels
     if (texColor.a < 0.1)
         discard;
-    
+
     // Normalize the normal vector
-    vec3 norm = normalize(fragNormal);
-    
-    // Calculate ambient lighting
-    float ambientStrength = 0.3;
-    vec3 ambient = ambientStrength * fragColor;
-    
-    // Calculate diffuse lighting
-    vec3 lightDirection = normalize(lightDir);
-    float diff = max(dot(norm, lightDirection), 0.0);
-    vec3 diffuse = diff * fragColor;
-    
+    vec3 norm = normalize(vNormal);
+
     // Calculate specular lighting
     float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - fragColor);
+    vec3 lightDirection = normalize(lightDir);
+    vec3 viewDir = normalize(uCameraPosition.xyz - vPosition);
     vec3 reflectDir = reflect(-lightDirection, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
-    vec3 specular = specularStrength * spec * vec3(1.0);
-    
+    float specular = specularStrength * spec;
+
     // Apply light level (day/night cycle)
     float lightIntensity = mix(0.2, 1.0, fragLightLevel);
-    
-    // Combine all lighting components
-    vec3 result = (ambient + diffuse + specular) * lightIntensity;
-    
-    // Apply texture color
-    result *= texColor.rgb;
-    
+
+    // Ambient and diffuse come from the vertex shader as vLighting
+    vec3 result = (vLighting + specular) * lightIntensity * texColor.rgb;
+
     // Output final color
     FragColor = vec4(result, texColor.a);
 }
@@ -1,43 +1,90 @@
 #version 330 core
 
 // Input vertex attributes
-layout(location = 0) in vec3 aPosition;
-layout(location = 1) in vec3 aNormal;
-layout(location = 2) in vec2 aTexCoord;
-layout(location = 3) in uint aBlockType;
+// Packed 8-byte chunk vertex built by ChunkMesher (see PackedVertex):
+//   x: bits 0-4 x, 5-13 y, 14-18 z, 19-21 face
+//   y: bits 0-15 block texture array layer, 16-19 block light, 20-23 sky light
+layout(location = 0) in uvec2 aPacked;
 
-// Uniforms
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+// Chunk origin of the draw, fed per draw from the shared chunk buffer (see
+// ChunkBuffer); left disabled, and so zero, for per-section VAOs, which
+// place the chunk with uChunkOffset instead
+layout(location = 1) in vec3 aChunkOrigin;
+
+// Face index -> normal (+Z, -Z, -X, +X, -Y, +Y)
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+    vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0),
+    vec3(0.0, -1.0, 0.0), vec3(0.0, 1.0, 0.0)
+);
+
+// Face index -> axes projected onto the block-space u and v coordinates
+const vec3 FACE_TEX_U[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+    vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0)
+);
+const vec3 FACE_TEX_V[6] = vec3[6](
+    vec3(0.0, 1.0, 0.0), vec3(0.0, 1.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, 1.0, 0.0),
+    vec3(1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)
+);
+
+// Per-frame camera data, shared by all shaders (see CameraUniforms)
+layout(std140) uniform Camera {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uCameraPosition;
+};
+
+// Chunk meshes are only ever translated: world position = local position
+// + chunk offset, and normals come straight from FACE_NORMALS
+uniform vec3 uChunkOffset;
 
 // Output to fragment shader
 out vec3 vPosition;
 out vec3 vNormal;
 out vec2 vTexCoord;
-out flat uint vBlockType;
 out float vLighting;
+out float fragLightLevel;
+flat out float fragTextureLayer;
 
 void main()
 {
+    // Decode the packed vertex
+    vec3 localPosition = vec3(float(aPacked.x & 31u),
+                              float((aPacked.x >> 5u) & 511u),
+                              float((aPacked.x >> 14u) & 31u));
+    int face = int((aPacked.x >> 19u) & 7u);
+    float layer = float(aPacked.y & 65535u);
+    float blockLight = float((aPacked.y >> 16u) & 15u) / 15.0;
+    float skyLight = float((aPacked.y >> 20u) & 15u) / 15.0;
+
     // Calculate world position
-    vPosition = vec3(uModel * vec4(aPosition, 1.0));
-    
-    // Transform normal to world space
-    vNormal = normalize(mat3(transpose(inverse(uModel))) * aNormal);
-    
-    // Pass texture coordinates
-    vTexCoord = aTexCoord;
-    
-    // Pass block type as flat (uninterpolated)
-    vBlockType = aBlockType;
-    
+    vPosition = localPosition + aChunkOrigin + uChunkOffset;
+
+    // A translation leaves normals unchanged
+    vNormal = FACE_NORMALS[face];
+
+    // Texture coordinates in block units; the array repeats them across
+    // merged quads
+    vTexCoord = vec2(dot(localPosition, FACE_TEX_U[face]),
+                     dot(localPosition, FACE_TEX_V[face]));
+
+    // Pass the texture layer as flat (uninterpolated)
+    fragTextureLayer = layer;
+
     // Calculate basic lighting based on normal direction
     // Simple ambient + directional light
     vec3 lightDir = normalize(vec3(0.5, 1.0, 0.5));
     float diffuse = max(dot(vNormal, lightDir), 0.0);
     vLighting = 0.3 + 0.7 * diffuse;  // 30% ambient + 70% diffuse
-    
+
+    // Flood-filled light of the block in front of the face, baked by the
+    // mesher; the brighter of sky and block light wins
+    fragLightLevel = max(skyLight, blockLight);
+
     // Calculate final position
-    gl_Position = uProjection * uView * vec4(vPosition, 1.0);
+    gl_Position = uViewProjection * vec4(vPosition, 1.0);
 }
@@ -0,0 +1,599 @@
+// Headless benchmarks for terrain generation, meshing, block access,
+// region storage and chunk replication. Results go to stdout (or --output) as JSON; equal seeds
+// and sizes measure the same work on every run.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../net/chunk_packets.h"
+#include "../net/replication_server.h"
+#include "../world/chunk_mesher.h"
+#include "../world/chunk_section.h"
+#include "../world/region_file.h"
+#include "../world/terrain_generator.h"
+#include "../world/world.h"
+
+namespace cppcraft {
+namespace bench {
+
+namespace {
+
+using world::CHUNK_SIZE_X;
+using world::CHUNK_SIZE_Y;
+using world::CHUNK_SIZE_Z;
+using world::ChunkStorage;
+using world::World;
+
+// Runs of each measurement; the fastest one is reported, which filters out
+// most scheduler and cache noise
+constexpr int REPEATS = 3;
+
+constexpr uint32_t DEFAULT_SEED = 12345;
+
+// Chunks per side of the benchmarked area
+constexpr int DEFAULT_CHUNKS_PER_SIDE = 16;
+
+// Block reads and writes per access benchmark
+constexpr size_t DEFAULT_ACCESS_COUNT = size_t{1} << 22;
+constexpr size_t DEFAULT_WRITE_COUNT = size_t{1} << 16;
+
+// Replication: client counts compared, and the steady-state ticks and
+// block changes per tick measured for each
+constexpr int REPLICATION_CLIENT_COUNTS[] = {1, 16, 64};
+constexpr int REPLICATION_TICKS = 100;
+constexpr int REPLICATION_CHANGES_PER_TICK = 64;
+
+struct Options {
+  uint32_t seed = DEFAULT_SEED;
+  int chunks_per_side = DEFAULT_CHUNKS_PER_SIDE;
+  size_t access_count = DEFAULT_ACCESS_COUNT;
+  size_t write_count = DEFAULT_WRITE_COUNT;
+  std::string output_path;
+};
+
+// Deterministic generator for access patterns (xorshift64*)
+class Random {
+ public:
+  explicit Random(uint64_t seed) : state_(seed ? seed : 1) {}
+
+  uint32_t Next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return static_cast<uint32_t>((state_ * 0x2545F4914F6CDD1DULL) >> 32);
+  }
+
+  int Below(int bound) {
+    return static_cast<int>(Next() % static_cast<uint32_t>(bound));
+  }
+
+ private:
+  uint64_t state_;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Time a function REPEATS times and return the fastest run in seconds
+template <typename Function>
+double TimeBest(Function&& function) {
+  double best = 0.0;
+  for (int run = 0; run < REPEATS; ++run) {
+    const Clock::time_point start = Clock::now();
+    function();
+    const double seconds = SecondsSince(start);
+    if (run == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best;
+}
+
+double PerSecond(double count, double seconds) {
+  return seconds > 0.0 ? count / seconds : 0.0;
+}
+
+// Accumulates one JSON object per result
+class Report {
+ public:
+  void Begin(const std::string& name) {
+    out_ << (results_++ ? ",\n" : "\n") << "    {\"name\": \"" << name << "\"";
+  }
+
+  Report() { out_.precision(9); }
+
+  void Add(const char* key, double value) {
+    out_ << ", \"" << key << "\": " << value;
+  }
+
+  void End() { out_ << "}"; }
+
+  std::string Finish(const Options& options) const {
+    std::ostringstream json;
+    json << "{\n  \"benchmark\": \"cppcraft-bench\",\n"
+         << "  \"seed\": " << options.seed << ",\n"
+         << "  \"chunks_per_side\": " << options.chunks_per_side << ",\n"
+         << "  \"repeats\": " << REPEATS << ",\n"
+         << "  \"results\": [" << out_.str() << "\n  ]\n}\n";
+    return json.str();
+  }
+
+ private:
+  std::ostringstream out_;
+  int results_ = 0;
+};
+
+// Generated chunks of the benchmarked area, row by row from (0, 0)
+struct Area {
+  int side = 0;
+  std::vector<ChunkStorage> chunks;
+
+  const ChunkStorage* Find(int chunk_x, int chunk_z) const {
+    if (chunk_x < 0 || chunk_z < 0 || chunk_x >= side || chunk_z >= side) {
+      return nullptr;
+    }
+    return &chunks[static_cast<size_t>(chunk_z) * side + chunk_x];
+  }
+
+  ChunkStorage* Find(int chunk_x, int chunk_z) {
+    return const_cast<ChunkStorage*>(
+        static_cast<const Area*>(this)->Find(chunk_x, chunk_z));
+  }
+};
+
+// Generate a side x side area of chunks from (0, 0)
+void GenerateArea(const world::TerrainGenerator& generator, int side,
+                  Area* area) {
+  area->side = side;
+  area->chunks.clear();
+  area->chunks.resize(static_cast<size_t>(side) * side);
+  for (int z = 0; z < side; ++z) {
+    for (int x = 0; x < side; ++x) {
+      generator.Generate(x, z, &area->chunks[static_cast<size_t>(z) * side + x]);
+    }
+  }
+}
+
+void BenchGenerate(const Options& options, Area* area, Report* report) {
+  world::TerrainSettings settings;
+  settings.seed = options.seed;
+  const world::TerrainGenerator generator(settings);
+
+  const double seconds = TimeBest(
+      [&] { GenerateArea(generator, options.chunks_per_side, area); });
+
+  size_t memory = 0;
+  for (const ChunkStorage& storage : area->chunks) {
+    memory += storage.GetMemoryUsage();
+  }
+
+  const double chunk_count = static_cast<double>(area->chunks.size());
+  report->Begin("generate");
+  report->Add("chunks", chunk_count);
+  report->Add("seconds", seconds);
+  report->Add("chunks_per_second", PerSecond(chunk_count, seconds));
+  report->Add("blocks_per_second",
+              PerSecond(chunk_count * world::CHUNK_VOLUME, seconds));
+  report->Add("storage_bytes", static_cast<double>(memory));
+  report->End();
+}
+
+// Copy a section and its one-block border into a mesh snapshot, the way
+// the world does before queueing a mesh job; unloaded neighbors read as air
+void FillMeshInput(const Area& area, int chunk_x, int chunk_z, int section_y,
+                   world::MeshInput* input) {
+  input->blocks.assign(world::MESH_INPUT_VOLUME, world::AIR_BLOCK_ID);
+  input->section_y = section_y;
+  const int base_y = section_y * world::SECTION_SIZE;
+  for (int y = -1; y <= world::SECTION_SIZE; ++y) {
+    const int world_y = base_y + y;
+    if (world_y < 0 || world_y >= CHUNK_SIZE_Y) {
+      continue;
+    }
+    for (int z = -1; z <= world::SECTION_SIZE; ++z) {
+      for (int x = -1; x <= world::SECTION_SIZE; ++x) {
+        const int world_x = chunk_x * CHUNK_SIZE_X + x;
+        const int world_z = chunk_z * CHUNK_SIZE_Z + z;
+        const ChunkStorage* storage =
+            area.Find(World::worldToChunkCoord(world_x),
+                      World::worldToChunkCoord(world_z));
+        if (storage) {
+          input->blocks[world::MeshInput::GetIndex(x, y, z)] =
+              storage->Get(World::worldToLocalCoord(world_x), world_y,
+                           World::worldToLocalCoord(world_z));
+        }
+      }
+    }
+  }
+}
+
+void BenchMesh(const Area& area, world::MeshMode mode, const char* name,
+               Report* report) {
+  // Snapshots are taken up front so only the mesher is timed
+  std::vector<world::MeshInput> inputs;
+  for (int z = 0; z < area.side; ++z) {
+    for (int x = 0; x < area.side; ++x) {
+      for (int section = 0; section < world::SECTIONS_PER_CHUNK; ++section) {
+        if (!area.Find(x, z)->GetSection(section)) {
+          continue;
+        }
+        inputs.emplace_back();
+        FillMeshInput(area, x, z, section, &inputs.back());
+        inputs.back().mode = mode;
+      }
+    }
+  }
+
+  world::MeshScratch scratch;
+  world::ChunkMeshData mesh;
+  size_t quads = 0;
+  size_t naive_quads = 0;
+  size_t bytes = 0;
+  const double seconds = TimeBest([&] {
+    quads = 0;
+    naive_quads = 0;
+    bytes = 0;
+    for (const world::MeshInput& input : inputs) {
+      world::ChunkMesher(input, &mesh, &scratch).Build();
+      quads += mesh.stats.quad_count;
+      naive_quads += mesh.stats.naive_quad_count;
+      bytes += mesh.vertices.size() * sizeof(world::PackedVertex);
+    }
+  });
+
+  report->Begin(name);
+  report->Add("sections", static_cast<double>(inputs.size()));
+  report->Add("seconds", seconds);
+  report->Add("sections_per_second",
+              PerSecond(static_cast<double>(inputs.size()), seconds));
+  report->Add("quads", static_cast<double>(quads));
+  report->Add("faces_per_second", PerSecond(static_cast<double>(naive_quads), seconds));
+  report->Add("vertex_bytes", static_cast<double>(bytes));
+  report->End();
+}
+
+// Reads also report a checksum of the blocks read, which keeps them from
+// being optimized away and changes if generation does
+void AddAccessResult(const char* name, size_t count, double seconds,
+                     Report* report, const uint64_t* checksum = nullptr) {
+  report->Begin(name);
+  report->Add("operations", static_cast<double>(count));
+  report->Add("seconds", seconds);
+  report->Add("operations_per_second",
+              PerSecond(static_cast<double>(count), seconds));
+  if (checksum) {
+    report->Add("checksum", static_cast<double>(*checksum % 1000000007ULL));
+  }
+  report->End();
+}
+
+// Reads and writes blocks through World::getBlock() and setBlock(), so the
+// chunk map lookup and its last-chunk cache are part of every access. The
+// world has no mesh uploader and is never updated: writes queue light and
+// mesh work without running it, and later benchmarks still see unmodified
+// terrain in their own area.
+void BenchBlockAccess(const Options& options, Report* report) {
+  world::TerrainSettings settings;
+  settings.seed = options.seed;
+
+  const int side = options.chunks_per_side;
+  World game_world(settings);
+  for (int z = 0; z < side; ++z) {
+    for (int x = 0; x < side; ++x) {
+      game_world.loadChunk(x, z);
+    }
+  }
+  const int width = side * CHUNK_SIZE_X;
+  const int depth = side * CHUNK_SIZE_Z;
+
+  // Sequential reads walk X fastest, like most block loops
+  uint64_t checksum = 0;
+  const double sequential_read = TimeBest([&] {
+    checksum = 0;
+    size_t done = 0;
+    for (int y = 0; y < CHUNK_SIZE_Y && done < options.access_count; ++y) {
+      for (int z = 0; z < depth && done < options.access_count; ++z) {
+        for (int x = 0; x < width && done < options.access_count; ++x, ++done) {
+          checksum += game_world.getBlock(x, y, z);
+        }
+      }
+    }
+  });
+  AddAccessResult("get_block_sequential", options.access_count, sequential_read,
+                  report, &checksum);
+
+  const double random_read = TimeBest([&] {
+    checksum = 0;
+    Random random(options.seed);
+    for (size_t i = 0; i < options.access_count; ++i) {
+      checksum += game_world.getBlock(random.Below(width), random.Below(CHUNK_SIZE_Y),
+                                      random.Below(depth));
+    }
+  });
+  AddAccessResult("get_block_random", options.access_count, random_read, report,
+                  &checksum);
+
+  // Writes alternate between two block types so every one changes a block
+  const uint16_t stone = static_cast<uint16_t>(world::BlockType::STONE);
+  const uint16_t cobblestone = static_cast<uint16_t>(world::BlockType::COBBLESTONE);
+  int pass = 0;
+  const double sequential_write = TimeBest([&] {
+    const uint16_t block = (pass++ & 1) ? stone : cobblestone;
+    size_t done = 0;
+    for (int y = 0; y < CHUNK_SIZE_Y && done < options.write_count; ++y) {
+      for (int z = 0; z < depth && done < options.write_count; ++z) {
+        for (int x = 0; x < width && done < options.write_count; ++x, ++done) {
+          game_world.setBlock(x, y, z, block);
+        }
+      }
+    }
+  });
+  AddAccessResult("set_block_sequential", options.write_count, sequential_write,
+                  report);
+
+  const double random_write = TimeBest([&] {
+    Random random(options.seed + pass);
+    const uint16_t block = (pass++ & 1) ? stone : cobblestone;
+    for (size_t i = 0; i < options.write_count; ++i) {
+      game_world.setBlock(random.Below(width), random.Below(CHUNK_SIZE_Y),
+                          random.Below(depth), block);
+    }
+  });
+  AddAccessResult("set_block_random", options.write_count, random_write, report);
+}
+
+uint64_t DirectorySize(const std::filesystem::path& directory) {
+  uint64_t total = 0;
+  std::error_code error;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(directory, error)) {
+    if (entry.is_regular_file(error)) {
+      total += entry.file_size(error);
+    }
+  }
+  return total;
+}
+
+bool BenchStorage(const Area& area, Report* report) {
+  std::error_code error;
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path(error) / "cppcraft-bench-regions";
+  std::filesystem::remove_all(directory, error);
+  if (!std::filesystem::create_directories(directory, error)) {
+    std::cerr << "Failed to create " << directory << ": " << error.message()
+              << std::endl;
+    return false;
+  }
+
+  bool ok = true;
+  uint64_t file_bytes = 0;
+  const double save_seconds = TimeBest([&] {
+    {
+      world::RegionStore store(directory.string());
+      for (int z = 0; z < area.side; ++z) {
+        for (int x = 0; x < area.side; ++x) {
+          ok &= store.SaveChunk(x, z, *area.Find(x, z));
+        }
+      }
+    }
+    file_bytes = DirectorySize(directory);
+  });
+
+  ChunkStorage loaded;
+  const double load_seconds = TimeBest([&] {
+    world::RegionStore store(directory.string());
+    for (int z = 0; z < area.side; ++z) {
+      for (int x = 0; x < area.side; ++x) {
+        ok &= store.LoadChunk(x, z, &loaded);
+      }
+    }
+  });
+  std::filesystem::remove_all(directory, error);
+
+  if (!ok) {
+    std::cerr << "Region storage benchmark failed to save or load chunks"
+              << std::endl;
+    return false;
+  }
+
+  const double chunk_count = static_cast<double>(area.chunks.size());
+  const double megabytes = static_cast<double>(file_bytes) / (1024.0 * 1024.0);
+  report->Begin("region_save");
+  report->Add("chunks", chunk_count);
+  report->Add("seconds", save_seconds);
+  report->Add("chunks_per_second", PerSecond(chunk_count, save_seconds));
+  report->Add("megabytes_per_second", PerSecond(megabytes, save_seconds));
+  report->Add("file_bytes", static_cast<double>(file_bytes));
+  report->End();
+
+  report->Begin("region_load");
+  report->Add("chunks", chunk_count);
+  report->Add("seconds", load_seconds);
+  report->Add("chunks_per_second", PerSecond(chunk_count, load_seconds));
+  report->Add("megabytes_per_second", PerSecond(megabytes, load_seconds));
+  report->End();
+  return true;
+}
+
+bool SameBlocks(const ChunkStorage& a, const ChunkStorage& b) {
+  for (int y = 0; y < CHUNK_SIZE_Y; ++y) {
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z) {
+      for (int x = 0; x < CHUNK_SIZE_X; ++x) {
+        if (a.Get(x, y, z) != b.Get(x, y, z)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Stream the area to growing numbers of clients, then time ticks of random
+// block changes; the encoded bytes per tick should not grow with clients
+bool BenchReplication(Area* area, Report* report) {
+  const int view_distance = std::min(net::DEFAULT_VIEW_DISTANCE, area->side / 2);
+  const int center = area->side / 2;
+  bool replica_matches = true;
+
+  for (int client_count : REPLICATION_CLIENT_COUNTS) {
+    net::ReplicationServer server(
+        [area](int chunk_x, int chunk_z) { return area->Find(chunk_x, chunk_z); });
+    server.SetSnapshotBudget(SIZE_MAX);
+    std::vector<net::ClientId> clients;
+    for (int i = 0; i < client_count; ++i) {
+      clients.push_back(server.AddClient(center, center, view_distance));
+    }
+
+    // The first client's packets rebuild its replica; the rest are dropped
+    net::ChunkReplica replica;
+    std::vector<net::Packet> packets;
+    auto deliver = [&]() {
+      for (size_t i = 0; i < clients.size(); ++i) {
+        packets.clear();
+        server.TakePackets(clients[i], &packets);
+        if (i == 0) {
+          for (const net::Packet& packet : packets) {
+            replica_matches &= replica.Apply(packet->data(), packet->size());
+          }
+        }
+      }
+    };
+
+    const Clock::time_point stream_start = Clock::now();
+    server.Tick();
+    const double stream_seconds = SecondsSince(stream_start);
+    const size_t stream_bytes = server.GetStats().bytes_encoded;
+    deliver();
+
+    Random random(static_cast<uint64_t>(client_count));
+    world::BlockChangeLog* log = server.GetChangeLog();
+    size_t bytes_encoded = 0;
+    size_t bytes_queued = 0;
+    double tick_seconds = 0.0;
+    for (int tick = 0; tick < REPLICATION_TICKS; ++tick) {
+      for (int i = 0; i < REPLICATION_CHANGES_PER_TICK; ++i) {
+        const int chunk_x = center + random.Below(view_distance + 1) - view_distance / 2;
+        const int chunk_z = center + random.Below(view_distance + 1) - view_distance / 2;
+        const int x = random.Below(CHUNK_SIZE_X);
+        const int y = random.Below(CHUNK_SIZE_Y);
+        const int z = random.Below(CHUNK_SIZE_Z);
+        if (!area->Find(chunk_x, chunk_z)) {
+          continue;
+        }
+        ChunkStorage& storage = area->chunks[static_cast<size_t>(chunk_z) * area->side + chunk_x];
+        if (storage.Set(x, y, z, static_cast<uint16_t>(1 + random.Below(8)))) {
+          log->Record(chunk_x, chunk_z, x, y, z);
+        }
+      }
+
+      const Clock::time_point start = Clock::now();
+      server.Tick();
+      tick_seconds += SecondsSince(start);
+      bytes_encoded += server.GetStats().bytes_encoded;
+      bytes_queued += server.GetStats().bytes_queued;
+      deliver();
+    }
+
+    for (int chunk_z = 0; chunk_z < area->side; ++chunk_z) {
+      for (int chunk_x = 0; chunk_x < area->side; ++chunk_x) {
+        const ChunkStorage* copy = replica.Find(chunk_x, chunk_z);
+        if (copy && !SameBlocks(*copy, *area->Find(chunk_x, chunk_z))) {
+          replica_matches = false;
+        }
+      }
+    }
+
+    report->Begin("replication_" + std::to_string(client_count) + "_clients");
+    report->Add("clients", client_count);
+    report->Add("chunks_per_client", static_cast<double>(replica.GetChunkCount()));
+    report->Add("stream_seconds", stream_seconds);
+    report->Add("stream_bytes_encoded", static_cast<double>(stream_bytes));
+    report->Add("tick_seconds", tick_seconds / REPLICATION_TICKS);
+    report->Add("bytes_encoded_per_tick",
+                static_cast<double>(bytes_encoded) / REPLICATION_TICKS);
+    report->Add("bytes_per_client_per_tick",
+                static_cast<double>(bytes_queued) / REPLICATION_TICKS / client_count);
+    report->End();
+  }
+
+  if (!replica_matches) {
+    std::cerr << "Replication benchmark replica differs from the server" << std::endl;
+  }
+  return replica_matches;
+}
+
+bool ParseOptions(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+      options->seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--chunks") == 0 && has_value) {
+      options->chunks_per_side = std::max(std::atoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--accesses") == 0 && has_value) {
+      options->access_count = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--writes") == 0 && has_value) {
+      options->write_count = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+      options->output_path = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed N] [--chunks N] [--accesses N] [--writes N]"
+                   " [--output FILE]"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int Run(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    return 2;
+  }
+
+  Report report;
+  Area area;
+  BenchGenerate(options, &area, &report);
+  BenchMesh(area, world::MeshMode::Naive, "mesh_naive", &report);
+  BenchMesh(area, world::MeshMode::Greedy, "mesh_greedy", &report);
+  BenchBlockAccess(options, &report);
+  if (!BenchStorage(area, &report) || !BenchReplication(&area, &report)) {
+    return 1;
+  }
+
+  const std::string json = report.Finish(options);
+  if (options.output_path.empty()) {
+    std::cout << json;
+    return 0;
+  }
+
+  std::ofstream out(options.output_path);
+  out << json;
+  if (!out) {
+    std::cerr << "Failed to write " << options.output_path << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace bench
+}  // namespace cppcraft
+
+int main(int argc, char* argv[]) { return cppcraft::bench::Run(argc, argv); }
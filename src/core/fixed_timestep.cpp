@@ -0,0 +1,78 @@
+#include "fixed_timestep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace cppcraft {
+namespace core {
+
+FixedTimestep::FixedTimestep(const TimestepSettings& settings)
+    : tick_seconds_(1.0 / std::max(settings.tick_rate, 1)),
+      max_ticks_per_frame_(std::max(settings.max_ticks_per_frame, 1)) {}
+
+int FixedTimestep::BeginFrame() {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  double elapsed = 0.0;
+  if (started_) {
+    elapsed = std::chrono::duration<double>(now - last_frame_).count();
+  }
+  started_ = true;
+  last_frame_ = now;
+  return Advance(elapsed);
+}
+
+int FixedTimestep::Advance(double elapsed_seconds) {
+  accumulator_ += std::clamp(elapsed_seconds, 0.0, MAX_FRAME_SECONDS);
+
+  int ticks = static_cast<int>(accumulator_ / tick_seconds_);
+  if (ticks > max_ticks_per_frame_) {
+    dropped_ticks_ += static_cast<uint64_t>(ticks - max_ticks_per_frame_);
+    ticks = max_ticks_per_frame_;
+  }
+  accumulator_ -= ticks * tick_seconds_;
+
+  // Whatever the guard dropped is forgotten, keeping only the fraction of a
+  // tick the interpolation needs
+  if (accumulator_ >= tick_seconds_) {
+    accumulator_ = std::fmod(accumulator_, tick_seconds_);
+  }
+
+  tick_count_ += static_cast<uint64_t>(ticks);
+  return ticks;
+}
+
+FramePacer::FramePacer(int target_fps)
+    : period_(target_fps > 0
+                  ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / target_fps))
+                  : std::chrono::steady_clock::duration::zero()) {}
+
+void FramePacer::Wait() {
+  if (period_ == std::chrono::steady_clock::duration::zero()) {
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (!started_ || now - deadline_ > period_) {
+    started_ = true;
+    deadline_ = now + period_;
+  } else {
+    deadline_ += period_;
+  }
+
+  const std::chrono::steady_clock::time_point sleep_until =
+      deadline_ - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(DEFAULT_SPIN_SECONDS));
+  if (sleep_until > now) {
+    std::this_thread::sleep_until(sleep_until);
+  }
+  while (std::chrono::steady_clock::now() < deadline_) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace core
+}  // namespace cppcraft
@@ -0,0 +1,193 @@
+#ifndef SRC_CORE_FIXED_TIMESTEP_H_
+#define SRC_CORE_FIXED_TIMESTEP_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace cppcraft {
+namespace core {
+
+// Simulation ticks per second, as in Minecraft
+constexpr int DEFAULT_TICK_RATE = 20;
+
+// Most ticks one frame may run; any further backlog is dropped
+constexpr int DEFAULT_MAX_TICKS_PER_FRAME = 5;
+
+// Longest frame the accumulator counts, in seconds; longer stalls (window
+// drags, breakpoints) are treated as this long
+constexpr double MAX_FRAME_SECONDS = 0.25;
+
+// Time before a frame deadline the pacer stops sleeping and spins, to
+// absorb the operating system's sleep granularity
+constexpr double DEFAULT_SPIN_SECONDS = 0.002;
+
+/**
+ * @brief How frames are spaced out
+ */
+enum class FramePacing {
+  // The swap interval blocks until the display's next refresh
+  VSYNC,
+
+  // Sleep until shortly before the next frame is due, then spin
+  SLEEP_SPIN,
+
+  // Render as fast as possible
+  UNLIMITED,
+};
+
+/**
+ * @struct TimestepSettings
+ * @brief Simulation rate and frame pacing of the game loop
+ */
+struct TimestepSettings {
+  int tick_rate = DEFAULT_TICK_RATE;
+
+  /**
+   * @brief Ticks one frame may run before the backlog is dropped
+   */
+  int max_ticks_per_frame = DEFAULT_MAX_TICKS_PER_FRAME;
+
+  FramePacing pacing = FramePacing::SLEEP_SPIN;
+
+  /**
+   * @brief Frame rate the SLEEP_SPIN pacer holds
+   */
+  int target_fps = 60;
+};
+
+/**
+ * @brief Fixed-timestep accumulator
+ *
+ * Each frame adds the real time that passed to an accumulator and runs one
+ * simulation tick for every whole tick in it, so the simulation advances at
+ * the same rate whatever the frame rate. The remainder becomes the
+ * interpolation factor between the last two ticks' states for rendering.
+ *
+ * To keep a slow frame from scheduling more ticks than the next frame can
+ * run (the spiral of death), frame times are capped at MAX_FRAME_SECONDS
+ * and at most max_ticks_per_frame ticks run per frame; the excess is
+ * dropped, so the simulation slows down instead of falling further behind.
+ */
+class FixedTimestep {
+ public:
+  explicit FixedTimestep(const TimestepSettings& settings = TimestepSettings());
+
+  /**
+   * @brief Start a frame, measuring the time since the previous one
+   * @return Ticks to run this frame
+   */
+  int BeginFrame();
+
+  /**
+   * @brief Start a frame with an explicit elapsed time
+   * @param elapsed_seconds Real time since the previous frame
+   * @return Ticks to run this frame
+   */
+  int Advance(double elapsed_seconds);
+
+  /**
+   * @brief Get the simulated time per tick, in seconds
+   */
+  float GetTickSeconds() const { return static_cast<float>(tick_seconds_); }
+
+  /**
+   * @brief Get how far the frame is between the last tick and the next one
+   * @return 0 to 1; render previous + (current - previous) * alpha
+   */
+  float GetAlpha() const {
+    return static_cast<float>(accumulator_ / tick_seconds_);
+  }
+
+  /**
+   * @brief Get the number of ticks run since construction
+   */
+  uint64_t GetTickCount() const { return tick_count_; }
+
+  /**
+   * @brief Get the number of ticks dropped by the spiral-of-death guard
+   */
+  uint64_t GetDroppedTickCount() const { return dropped_ticks_; }
+
+ private:
+  double tick_seconds_;
+  int max_ticks_per_frame_;
+  double accumulator_ = 0.0;
+  uint64_t tick_count_ = 0;
+  uint64_t dropped_ticks_ = 0;
+  bool started_ = false;
+  std::chrono::steady_clock::time_point last_frame_;
+};
+
+/**
+ * @brief Holds frames to a target rate by sleeping, then spinning
+ *
+ * Sleeping alone overshoots by up to the scheduler's granularity, and
+ * spinning alone burns a core; the pacer sleeps until DEFAULT_SPIN_SECONDS
+ * before the deadline and yields in a loop for the rest. Deadlines advance
+ * by exactly one frame period, so an early or late frame does not shift the
+ * ones after it; after a stall longer than a frame the schedule restarts.
+ */
+class FramePacer {
+ public:
+  /**
+   * @param target_fps Frames per second; 0 or less disables pacing
+   */
+  explicit FramePacer(int target_fps);
+
+  /**
+   * @brief Block until the next frame is due
+   */
+  void Wait();
+
+ private:
+  std::chrono::steady_clock::duration period_;
+  std::chrono::steady_clock::time_point deadline_;
+  bool started_ = false;
+};
+
+/**
+ * @brief A value kept at its previous and current tick, for rendering
+ *        between ticks
+ *
+ * @tparam T Type with subtraction, addition and scaling by a float, such as
+ *         float or glm::vec3
+ */
+template <typename T>
+class InterpolatedValue {
+ public:
+  explicit InterpolatedValue(const T& value = T()) : previous_(value), current_(value) {}
+
+  /**
+   * @brief Set the value of the tick just run
+   */
+  void Set(const T& value) {
+    previous_ = current_;
+    current_ = value;
+  }
+
+  /**
+   * @brief Set the value without interpolating from the old one, e.g. after
+   *        a teleport
+   */
+  void Reset(const T& value) {
+    previous_ = value;
+    current_ = value;
+  }
+
+  const T& Get() const { return current_; }
+
+  /**
+   * @brief Get the value between the last two ticks
+   * @param alpha FixedTimestep::GetAlpha()
+   */
+  T Get(float alpha) const { return previous_ + (current_ - previous_) * alpha; }
+
+ private:
+  T previous_;
+  T current_;
+};
+
+}  // namespace core
+}  // namespace cppcraft
+
+#endif  // SRC_CORE_FIXED_TIMESTEP_H_
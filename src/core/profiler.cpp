@@ -0,0 +1,297 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace cppcraft {
+namespace core {
+
+namespace {
+
+uint64_t SteadyNowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// Write a string as a JSON string literal
+void WriteJsonString(std::ostream& out, const char* text) {
+  out << '"';
+  for (const char* c = text; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      out << *c;
+    }
+  }
+  out << '"';
+}
+
+// Trace thread ID of an event: the GPU gets its own track at 0
+uint32_t GetTraceThread(uint32_t thread) {
+  return thread == PROFILE_GPU_THREAD ? 0 : thread + 1;
+}
+
+}  // namespace
+
+bool ProfileEventRing::Push(const ProfileEvent& event) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == PROFILE_RING_CAPACITY) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  events_[head & (PROFILE_RING_CAPACITY - 1)] = event;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void ProfileEventRing::Drain(std::vector<ProfileEvent>* out) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t head = head_.load(std::memory_order_acquire);
+  for (size_t i = tail; i != head; ++i) {
+    out->push_back(events_[i & (PROFILE_RING_CAPACITY - 1)]);
+  }
+  tail_.store(head, std::memory_order_release);
+}
+
+Profiler& Profiler::Get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() : epoch_ns_(SteadyNowNs()), enabled_(true) {}
+
+uint64_t Profiler::Now() const { return SteadyNowNs() - epoch_ns_; }
+
+void Profiler::Record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+  ProfileEvent event;
+  event.name = name;
+  event.start_ns = start_ns;
+  event.duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+  Push(event);
+}
+
+void Profiler::RecordGpu(const char* name, uint64_t start_ns,
+                         uint64_t duration_ns) {
+  ProfileEvent event;
+  event.name = name;
+  event.start_ns = start_ns;
+  event.duration_ns = duration_ns;
+  event.thread = PROFILE_GPU_THREAD;
+  Push(event);
+}
+
+void Profiler::Push(const ProfileEvent& event) {
+  ThreadRing* ring = GetThreadRing();
+  ProfileEvent stamped = event;
+  if (stamped.thread != PROFILE_GPU_THREAD) {
+    stamped.thread = ring->index;
+  }
+  ring->ring.Push(stamped);
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+  ThreadRing* ring = GetThreadRing();
+  std::lock_guard<std::mutex> lock(threads_mutex_);
+  ring->name = name;
+}
+
+Profiler::ThreadRing* Profiler::GetThreadRing() {
+  thread_local ThreadRing* ring = nullptr;
+  if (!ring) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    threads_.push_back(std::make_unique<ThreadRing>());
+    ring = threads_.back().get();
+    ring->index = static_cast<uint32_t>(threads_.size() - 1);
+    ring->name = "thread " + std::to_string(ring->index);
+  }
+  return ring;
+}
+
+size_t Profiler::GetScopeIndex(const ProfileEvent& event) {
+  const bool gpu = event.thread == PROFILE_GPU_THREAD;
+  std::unordered_map<const char*, size_t>& scopes = gpu ? gpu_scopes_ : cpu_scopes_;
+
+  auto found = scopes.find(event.name);
+  if (found != scopes.end()) {
+    return found->second;
+  }
+
+  // The same literal may live at different addresses in different
+  // translation units; those still share a row
+  size_t index = 0;
+  while (index < stats_.size() &&
+         (stats_[index].gpu != gpu ||
+          std::strcmp(stats_[index].name, event.name) != 0)) {
+    ++index;
+  }
+  if (index == stats_.size()) {
+    ProfileScopeStats stats;
+    stats.name = event.name;
+    stats.gpu = gpu;
+    stats_.push_back(stats);
+    history_.emplace_back();
+  }
+  scopes.emplace(event.name, index);
+  return index;
+}
+
+void Profiler::SetCounter(const char* name, double value) {
+  size_t index = 0;
+  while (index < counters_.size() && counters_[index].name != name &&
+         std::strcmp(counters_[index].name, name) != 0) {
+    ++index;
+  }
+  if (index == counters_.size()) {
+    ProfileCounter counter;
+    counter.name = name;
+    counters_.push_back(counter);
+  }
+  counters_[index].value = value;
+}
+
+void Profiler::EndFrame() {
+  const uint64_t now = Now();
+  const int slot = frame_count_ % PROFILE_HISTORY_FRAMES;
+  frame_ms_[slot] = static_cast<double>(now - frame_start_ns_) * 1e-6;
+  frame_start_ns_ = now;
+
+  drained_.clear();
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (const std::unique_ptr<ThreadRing>& thread : threads_) {
+      thread->ring.Drain(&drained_);
+      dropped_events_ += thread->ring.TakeDropped();
+    }
+  }
+
+  for (const ProfileEvent& event : drained_) {
+    ScopeHistory& history = history_[GetScopeIndex(event)];
+    history.current_ms += static_cast<double>(event.duration_ns) * 1e-6;
+    ++history.current_calls;
+  }
+
+  if (capturing_) {
+    const size_t room = MAX_CAPTURE_EVENTS - capture_.size();
+    capture_.insert(capture_.end(), drained_.begin(),
+                    drained_.begin() + std::min(room, drained_.size()));
+    for (size_t i = 0; i < counters_.size() && counter_capture_.size() < MAX_CAPTURE_EVENTS; ++i) {
+      CounterSample sample;
+      sample.counter = i;
+      sample.time_ns = now;
+      sample.value = counters_[i].value;
+      counter_capture_.push_back(sample);
+    }
+  }
+
+  ++frame_count_;
+  const int frames = std::min(frame_count_, PROFILE_HISTORY_FRAMES);
+  for (size_t i = 0; i < stats_.size(); ++i) {
+    ScopeHistory& history = history_[i];
+    history.frame_ms[slot] = history.current_ms;
+
+    ProfileScopeStats& stats = stats_[i];
+    stats.last_ms = history.current_ms;
+    stats.calls = history.current_calls;
+    stats.average_ms = 0.0;
+    stats.max_ms = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+      stats.average_ms += history.frame_ms[frame];
+      stats.max_ms = std::max(stats.max_ms, history.frame_ms[frame]);
+    }
+    stats.average_ms /= frames;
+
+    history.current_ms = 0.0;
+    history.current_calls = 0;
+  }
+}
+
+double Profiler::GetAverageFrameMs() const {
+  const int frames = std::min(frame_count_, PROFILE_HISTORY_FRAMES);
+  if (frames == 0) {
+    return 0.0;
+  }
+
+  double total = 0.0;
+  for (int frame = 0; frame < frames; ++frame) {
+    total += frame_ms_[frame];
+  }
+  return total / frames;
+}
+
+double Profiler::GetMaxFrameMs() const {
+  const int frames = std::min(frame_count_, PROFILE_HISTORY_FRAMES);
+  return frames == 0 ? 0.0
+                     : *std::max_element(frame_ms_.begin(), frame_ms_.begin() + frames);
+}
+
+void Profiler::StartCapture() {
+  capture_.clear();
+  counter_capture_.clear();
+  capturing_ = true;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) {
+  capturing_ = false;
+
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Failed to write profiler trace " << path << std::endl;
+    return false;
+  }
+
+  // Complete ("X") events with microsecond times, plus one metadata event
+  // naming each thread
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+         "\"args\":{\"name\":\"GPU\"}}";
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (const std::unique_ptr<ThreadRing>& thread : threads_) {
+      out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+          << GetTraceThread(thread->index) << ",\"args\":{\"name\":";
+      WriteJsonString(out, thread->name.c_str());
+      out << "}}";
+    }
+  }
+
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  for (const ProfileEvent& event : capture_) {
+    out << ",\n{\"name\":";
+    WriteJsonString(out, event.name);
+    out << ",\"cat\":\"" << (event.thread == PROFILE_GPU_THREAD ? "gpu" : "cpu")
+        << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << GetTraceThread(event.thread)
+        << ",\"ts\":" << static_cast<double>(event.start_ns) * 1e-3
+        << ",\"dur\":" << static_cast<double>(event.duration_ns) * 1e-3 << "}";
+  }
+
+  // Counter ("C") events draw as a graph per counter
+  for (const CounterSample& sample : counter_capture_) {
+    out << ",\n{\"name\":";
+    WriteJsonString(out, counters_[sample.counter].name);
+    out << ",\"ph\":\"C\",\"pid\":1,\"ts\":"
+        << static_cast<double>(sample.time_ns) * 1e-3
+        << ",\"args\":{\"value\":" << sample.value << "}}";
+  }
+  out << "\n]}\n";
+
+  capture_.clear();
+  capture_.shrink_to_fit();
+  counter_capture_.clear();
+  counter_capture_.shrink_to_fit();
+
+  if (!out) {
+    std::cerr << "Failed to write profiler trace " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace cppcraft
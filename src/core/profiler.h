@@ -0,0 +1,327 @@
+#ifndef SRC_CORE_PROFILER_H_
+#define SRC_CORE_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppcraft {
+namespace core {
+
+// Events one thread can buffer between two EndFrame() calls; a power of two.
+// Events past that are dropped and counted.
+constexpr size_t PROFILE_RING_CAPACITY = 4096;
+
+// Frames the overlay's averages and maxima cover (two seconds at 60 FPS)
+constexpr int PROFILE_HISTORY_FRAMES = 120;
+
+// Events one capture keeps before it stops recording new ones
+constexpr size_t MAX_CAPTURE_EVENTS = size_t{1} << 20;
+
+// Thread index of events measured by GPU timer queries
+constexpr uint32_t PROFILE_GPU_THREAD = 0xFFFFFFFFu;
+
+/**
+ * @struct ProfileEvent
+ * @brief One timed scope, in nanoseconds since the profiler was created
+ */
+struct ProfileEvent {
+  /**
+   * @brief Scope name; must be a string literal or otherwise outlive the
+   *        profiler, since only the pointer is stored
+   */
+  const char* name = nullptr;
+
+  uint64_t start_ns = 0;
+  uint64_t duration_ns = 0;
+
+  /**
+   * @brief Index of the recording thread, or PROFILE_GPU_THREAD
+   */
+  uint32_t thread = 0;
+};
+
+/**
+ * @brief Fixed-size single-producer, single-consumer event queue
+ *
+ * The owning thread pushes and the main thread drains once per frame, with
+ * no lock on either side. A full ring drops new events instead of blocking
+ * the thread being measured.
+ */
+class ProfileEventRing {
+ public:
+  ProfileEventRing() : events_(PROFILE_RING_CAPACITY) {}
+
+  /**
+   * @brief Append an event; only called by the owning thread
+   * @return False if the ring was full and the event was dropped
+   */
+  bool Push(const ProfileEvent& event);
+
+  /**
+   * @brief Move every queued event out; only called by the main thread
+   * @param out Receives the events in push order
+   */
+  void Drain(std::vector<ProfileEvent>* out);
+
+  /**
+   * @brief Get and reset the number of events dropped since the last call
+   */
+  size_t TakeDropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+ private:
+  std::vector<ProfileEvent> events_;
+
+  // Producer and consumer positions on separate cache lines; both only grow
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  std::atomic<size_t> dropped_{0};
+};
+
+/**
+ * @struct ProfileScopeStats
+ * @brief Per-frame timing of one scope name, summed over all threads
+ */
+struct ProfileScopeStats {
+  const char* name = nullptr;
+
+  /**
+   * @brief Whether the time was measured on the GPU
+   */
+  bool gpu = false;
+
+  /**
+   * @brief Time in the last frame, in milliseconds
+   */
+  double last_ms = 0.0;
+
+  /**
+   * @brief Mean and worst time per frame over the history, in milliseconds
+   */
+  double average_ms = 0.0;
+  double max_ms = 0.0;
+
+  /**
+   * @brief Times the scope ran in the last frame
+   */
+  uint32_t calls = 0;
+};
+
+/**
+ * @struct ProfileCounter
+ * @brief Latest value of a named per-frame quantity, such as memory in use
+ */
+struct ProfileCounter {
+  const char* name = nullptr;
+  double value = 0.0;
+};
+
+/**
+ * @brief Process-wide frame profiler
+ *
+ * Scoped timers on any thread push events into a ring owned by that
+ * thread. Once per frame the main thread calls EndFrame(), which drains
+ * every ring and updates the per-scope statistics shown by the overlay; the
+ * events can also be captured and written as a Chrome trace
+ * (chrome://tracing or ui.perfetto.dev). Counters sit next to the scopes
+ * for values that are sampled rather than timed.
+ *
+ * Profiling starts enabled. Disabled, a scoped timer costs one relaxed
+ * atomic load. Everything but Record(), RecordGpu(), SetThreadName() and
+ * IsEnabled() is main-thread only, counters included.
+ */
+class Profiler {
+ public:
+  /**
+   * @brief Get the profiler
+   */
+  static Profiler& Get();
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Get the current time in nanoseconds since the profiler was created
+   */
+  uint64_t Now() const;
+
+  /**
+   * @brief Record a CPU scope on the calling thread
+   * @param name Scope name (see ProfileEvent::name)
+   * @param start_ns Start time from Now()
+   * @param end_ns End time from Now()
+   */
+  void Record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+  /**
+   * @brief Record a GPU timer query result
+   * @param name Scope name (see ProfileEvent::name)
+   * @param start_ns CPU time the commands were submitted at, from Now()
+   * @param duration_ns GPU time the commands took
+   */
+  void RecordGpu(const char* name, uint64_t start_ns, uint64_t duration_ns);
+
+  /**
+   * @brief Name the calling thread in exported traces
+   */
+  void SetThreadName(const std::string& name);
+
+  /**
+   * @brief Set a counter's value; captures sample it once per frame
+   * @param name Counter name (see ProfileEvent::name)
+   * @param value New value
+   */
+  void SetCounter(const char* name, double value);
+
+  /**
+   * @brief Close the current frame and collect every thread's events
+   */
+  void EndFrame();
+
+  /**
+   * @brief Get the statistics of every scope seen so far, in first-seen order
+   */
+  const std::vector<ProfileScopeStats>& GetStats() const { return stats_; }
+
+  /**
+   * @brief Get every counter set so far, in first-set order
+   */
+  const std::vector<ProfileCounter>& GetCounters() const { return counters_; }
+
+  /**
+   * @brief Get the mean and worst frame time over the history, in milliseconds
+   */
+  double GetAverageFrameMs() const;
+  double GetMaxFrameMs() const;
+
+  /**
+   * @brief Get the number of events dropped by full rings so far
+   */
+  size_t GetDroppedEventCount() const { return dropped_events_; }
+
+  /**
+   * @brief Start keeping every collected event for WriteChromeTrace()
+   *
+   * Any previous capture is discarded.
+   */
+  void StartCapture();
+
+  bool IsCapturing() const { return capturing_; }
+
+  /**
+   * @brief Stop capturing and write the captured events as Chrome-trace JSON
+   * @param path Output file
+   * @return False if the file cannot be written
+   */
+  bool WriteChromeTrace(const std::string& path);
+
+ private:
+  struct ThreadRing {
+    ProfileEventRing ring;
+    uint32_t index = 0;
+    std::string name;
+  };
+
+  struct CounterSample {
+    size_t counter = 0;
+    uint64_t time_ns = 0;
+    double value = 0.0;
+  };
+
+  struct ScopeHistory {
+    std::array<double, PROFILE_HISTORY_FRAMES> frame_ms{};
+    double current_ms = 0.0;
+    uint32_t current_calls = 0;
+  };
+
+  Profiler();
+
+  void Push(const ProfileEvent& event);
+
+  // Ring of the calling thread, registered on first use
+  ThreadRing* GetThreadRing();
+
+  // Statistics slot of an event's scope, added on first sight
+  size_t GetScopeIndex(const ProfileEvent& event);
+
+  const uint64_t epoch_ns_;
+  std::atomic<bool> enabled_;
+
+  // Guards the list of rings, not the rings themselves; rings are never
+  // removed, since a thread may still be pushing to its ring while exiting
+  mutable std::mutex threads_mutex_;
+  std::vector<std::unique_ptr<ThreadRing>> threads_;
+
+  // Main thread only
+  std::vector<ProfileEvent> drained_;
+  std::vector<ProfileScopeStats> stats_;
+  std::vector<ScopeHistory> history_;
+  std::unordered_map<const char*, size_t> cpu_scopes_;
+  std::unordered_map<const char*, size_t> gpu_scopes_;
+  std::array<double, PROFILE_HISTORY_FRAMES> frame_ms_{};
+  int frame_count_ = 0;
+  uint64_t frame_start_ns_ = 0;
+  size_t dropped_events_ = 0;
+  bool capturing_ = false;
+  std::vector<ProfileEvent> capture_;
+  std::vector<ProfileCounter> counters_;
+  std::vector<CounterSample> counter_capture_;
+};
+
+/**
+ * @brief Records the time between its construction and destruction
+ */
+class ScopedTimer {
+ public:
+  /**
+   * @param name Scope name (see ProfileEvent::name)
+   */
+  explicit ScopedTimer(const char* name)
+      : name_(name),
+        active_(Profiler::Get().IsEnabled()),
+        start_ns_(active_ ? Profiler::Get().Now() : 0) {}
+
+  ~ScopedTimer() {
+    if (active_) {
+      Profiler& profiler = Profiler::Get();
+      profiler.Record(name_, start_ns_, profiler.Now());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const char* name_;
+  bool active_;
+  uint64_t start_ns_;
+};
+
+}  // namespace core
+}  // namespace cppcraft
+
+#define CPPCRAFT_PROFILE_CONCAT_INNER(a, b) a##b
+#define CPPCRAFT_PROFILE_CONCAT(a, b) CPPCRAFT_PROFILE_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing block; compiled out with CPPCRAFT_NO_PROFILER
+#ifdef CPPCRAFT_NO_PROFILER
+#define PROFILE_SCOPE(name) ((void)0)
+#else
+#define PROFILE_SCOPE(name)                                                    \
+  ::cppcraft::core::ScopedTimer CPPCRAFT_PROFILE_CONCAT(profile_scope_,        \
+                                                        __LINE__)(name)
+#endif
+
+#endif  // SRC_CORE_PROFILER_H_
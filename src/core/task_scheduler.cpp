@@ -0,0 +1,129 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "profiler.h"
+
+namespace cppcraft {
+namespace core {
+
+namespace {
+
+// Pool and worker index of the calling thread, if it is a pool worker
+thread_local const TaskScheduler* tls_scheduler = nullptr;
+thread_local unsigned int tls_worker = 0;
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(unsigned int thread_count) : stopping_(false) {
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  workers_.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  threads_.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&TaskScheduler::WorkerLoop, this, i);
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stopping_ = true;
+  }
+  wake_cv_.notify_all();
+
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TaskScheduler::Submit(Task task) {
+  const unsigned int index =
+      tls_scheduler == this
+          ? tls_worker
+          : next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                GetThreadCount();
+
+  unfinished_.fetch_add(1, std::memory_order_relaxed);
+  {
+    // Counted under the wake lock so a worker about to sleep cannot miss
+    // it, and before the push so a taker never counts below zero
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+  }
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->tasks.push_back(std::move(task));
+  }
+  wake_cv_.notify_one();
+}
+
+void TaskScheduler::Wait() {
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  idle_cv_.wait(lock, [this] {
+    return unfinished_.load(std::memory_order_acquire) == 0;
+  });
+}
+
+void TaskScheduler::WorkerLoop(unsigned int index) {
+  tls_scheduler = this;
+  tls_worker = index;
+  Profiler::Get().SetThreadName("task worker " + std::to_string(index));
+
+  for (;;) {
+    Task task;
+    if (!TryTake(index, &task)) {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_cv_.wait(lock, [this] {
+        return stopping_ || queued_.load(std::memory_order_relaxed) != 0;
+      });
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+
+    task();
+    task = nullptr;
+
+    if (unfinished_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      idle_cv_.notify_all();
+    }
+  }
+}
+
+bool TaskScheduler::TryTake(unsigned int index, Task* out) {
+  const unsigned int count = GetThreadCount();
+  for (unsigned int i = 0; i < count; ++i) {
+    const unsigned int victim = (index + i) % count;
+    Worker& worker = *workers_[victim];
+
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+      continue;
+    }
+    if (victim == index) {
+      *out = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    } else {
+      *out = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace core
+}  // namespace cppcraft
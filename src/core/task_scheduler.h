@@ -0,0 +1,102 @@
+#ifndef SRC_CORE_TASK_SCHEDULER_H_
+#define SRC_CORE_TASK_SCHEDULER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cppcraft {
+namespace core {
+
+/**
+ * @brief Thread pool with one task deque per worker and work stealing
+ *
+ * Tasks submitted from outside the pool are dealt round-robin onto the
+ * workers' deques; tasks submitted by a running task go onto its own
+ * worker's deque. A worker runs its own tasks oldest first and, once its
+ * deque is empty, steals the newest task of another worker, so uneven tasks
+ * even out without a shared queue every worker contends on.
+ */
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Start the workers
+   * @param thread_count Number of workers; 0 uses one per hardware thread
+   */
+  explicit TaskScheduler(unsigned int thread_count = 0);
+
+  /**
+   * @brief Finish every submitted task, then stop the workers
+   */
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  /**
+   * @brief Queue a task; any thread, including the pool's own
+   */
+  void Submit(Task task);
+
+  /**
+   * @brief Block until every task submitted so far has finished
+   *
+   * Must not be called from a task.
+   */
+  void Wait();
+
+  unsigned int GetThreadCount() const {
+    return static_cast<unsigned int>(workers_.size());
+  }
+
+  /**
+   * @brief Get the number of tasks taken from another worker's deque
+   */
+  uint64_t GetStealCount() const {
+    return steals_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(unsigned int index);
+
+  /**
+   * @brief Take the oldest own task, or else the newest of another worker
+   */
+  bool TryTake(unsigned int index, Task* out);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  // Sleeping workers wait for queued_ to become non-zero; Wait() waits for
+  // unfinished_ to reach zero
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+  std::condition_variable idle_cv_;
+  bool stopping_;
+
+  // Tasks sitting in a deque, and tasks submitted but not yet finished
+  std::atomic<size_t> queued_{0};
+  std::atomic<size_t> unfinished_{0};
+
+  std::atomic<unsigned int> next_worker_{0};
+  std::atomic<uint64_t> steals_{0};
+};
+
+}  // namespace core
+}  // namespace cppcraft
+
+#endif  // SRC_CORE_TASK_SCHEDULER_H_
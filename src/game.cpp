@@ -1,4 +1,6 @@
 #include "game.h"
+#include "core/fixed_timestep.h"
+#include "core/profiler.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -98,35 +100,57 @@ bool Game::run() {
     isRunning = true;
     std::cout << "Game loop started" << std::endl;
 
+    cppcraft::core::Profiler& profiler = cppcraft::core::Profiler::Get();
+    profiler.SetThreadName("main");
+
+    // Fixed simulation ticks, rendered in between by interpolation; a slow
+    // frame runs at most a few ticks and drops the rest of its backlog
+    cppcraft::core::TimestepSettings settings;
+    cppcraft::core::FixedTimestep timestep(settings);
+    cppcraft::core::FramePacer pacer(settings.target_fps);
+
     while (isRunning) {
-        if (!update()) {
-            break;
+        handleInput();
+
+        const int ticks = timestep.BeginFrame();
+        for (int i = 0; i < ticks && isRunning; ++i) {
+            PROFILE_SCOPE("game.tick");
+            update(timestep.GetTickSeconds());
         }
-        if (!render()) {
+        if (!isRunning) {
             break;
         }
+
+        {
+            PROFILE_SCOPE("game.render");
+            if (!render(timestep.GetAlpha())) {
+                break;
+            }
+        }
+
+        // Collect every thread's timings for the overlay and trace capture
+        profiler.EndFrame();
+
+        pacer.Wait();
     }
 
     std::cout << "Game loop ended" << std::endl;
     return true;
 }
 
-bool Game::update() {
-    // Handle input
-    handleInput();
-
-    // Update game logic
-    updateGameLogic();
+bool Game::update(float deltaTime) {
+    // Update game logic by one tick
+    updateGameLogic(deltaTime);
 
     return isRunning;
 }
 
-bool Game::render() {
+bool Game::render(float alpha) {
     // Clear screen
     clearScreen();
 
-    // Render game objects
-    renderGame();
+    // Render game objects between the last two ticks
+    renderGame(alpha);
 
     // Present frame
     presentFrame();
@@ -138,7 +162,7 @@ void Game::handleInput() {
     // Input handling code here
 }
 
-void Game::updateGameLogic() {
+void Game::updateGameLogic(float deltaTime) {
     // Game logic update code here
 }
 
@@ -146,7 +170,7 @@ void Game::clearScreen() {
     // Clear screen/backbuffer code here
 }
 
-void Game::renderGame() {
+void Game::renderGame(float alpha) {
     // Render all game objects here
 }
 
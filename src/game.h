@@ -51,15 +51,16 @@ public:
     bool isRunning() const;
 
     /**
-     * @brief Update game logic
-     * @param deltaTime Time since last update in seconds
+     * @brief Run one simulation tick
+     * @param deltaTime Fixed tick length in seconds
      */
     void update(float deltaTime);
 
     /**
      * @brief Render the game
+     * @param alpha How far the frame is between the last two ticks (0 to 1)
      */
-    void render();
+    void render(float alpha);
 
 private:
     bool m_running;
@@ -0,0 +1,97 @@
+#include "block_texture_array.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Constructor
+BlockTextureArray::BlockTextureArray() : m_texture(0), m_tileSize(0), m_layerCount(0) {}
+
+// Destructor
+BlockTextureArray::~BlockTextureArray() {
+    if (m_texture != 0) {
+        glDeleteTextures(1, &m_texture);
+    }
+}
+
+// Allocate level 0 of every layer and set up sampling
+bool BlockTextureArray::create(int tileSize, int layerCount) {
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (tileSize <= 0 || layerCount <= 0 || layerCount > maxLayers) {
+        std::cerr << "Unsupported block texture array: " << layerCount << " layers of "
+                  << tileSize << "x" << tileSize << std::endl;
+        return false;
+    }
+
+    if (m_texture == 0) {
+        glGenTextures(1, &m_texture);
+    }
+    m_tileSize = tileSize;
+    m_layerCount = layerCount;
+
+    std::vector<unsigned char> clear(static_cast<size_t>(tileSize) * tileSize * layerCount * 4, 0);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, tileSize, tileSize, layerCount, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+
+    // Pixel-art magnification, smooth minification between mip levels
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    generateMipmaps();
+    return true;
+}
+
+// Replace one layer's level 0
+void BlockTextureArray::setLayer(int layer, const unsigned char* pixels) {
+    if (layer < 0 || layer >= m_layerCount) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_tileSize, m_tileSize, 1,
+                    GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+// Upload atlas tiles straight from the atlas image using unpack offsets
+int BlockTextureArray::loadAtlas(const unsigned char* pixels, int width, int height) {
+    if (m_texture == 0 || width % m_tileSize != 0 || height % m_tileSize != 0) {
+        return 0;
+    }
+
+    int tilesPerRow = width / m_tileSize;
+    int tileCount = std::min(tilesPerRow * (height / m_tileSize), m_layerCount);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    for (int tile = 0; tile < tileCount; ++tile) {
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, (tile % tilesPerRow) * m_tileSize);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, (tile / tilesPerRow) * m_tileSize);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, tile, m_tileSize, m_tileSize, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    return tileCount;
+}
+
+// Mipmaps are generated per layer, so neighboring textures never blend
+void BlockTextureArray::generateMipmaps() {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+// Bind for sampling
+void BlockTextureArray::bind(GLuint unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+}
@@ -0,0 +1,97 @@
+#ifndef BLOCK_TEXTURE_ARRAY_H
+#define BLOCK_TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+
+// Texture unit the block textures are bound to for every chunk draw
+constexpr GLuint BLOCK_TEXTURE_UNIT = 0;
+
+/**
+ * @class BlockTextureArray
+ * @brief GL_TEXTURE_2D_ARRAY holding one square block texture per layer
+ *
+ * Chunk vertices carry their layer index (see GetBlockTextureLayer), so a
+ * single bound texture serves every block type: no per-type samplers, no
+ * branches in the fragment shader and no rebinds between draws. Layers wrap
+ * with GL_REPEAT, so greedy-merged quads tile their texture without atlas
+ * bleeding, and each layer gets its own full mip chain.
+ */
+class BlockTextureArray {
+public:
+    /**
+     * @brief Constructor - no GL objects until create()
+     */
+    BlockTextureArray();
+
+    /**
+     * @brief Destructor - deletes the texture
+     */
+    ~BlockTextureArray();
+
+    BlockTextureArray(const BlockTextureArray&) = delete;
+    BlockTextureArray& operator=(const BlockTextureArray&) = delete;
+
+    /**
+     * @brief Allocate the array; layers start out transparent black
+     * @param tileSize Width and height of one texture in pixels (power of two)
+     * @param layerCount Number of layers
+     * @return true on success
+     */
+    bool create(int tileSize, int layerCount);
+
+    /**
+     * @brief Upload one layer
+     * @param layer The layer index
+     * @param pixels tileSize * tileSize RGBA8 pixels
+     */
+    void setLayer(int layer, const unsigned char* pixels);
+
+    /**
+     * @brief Upload layers from a grid atlas image
+     *
+     * Tile i of the atlas, counted row-major from the top-left, becomes
+     * layer i; tiles beyond the layer count are ignored.
+     *
+     * @param pixels RGBA8 atlas pixels, top row first
+     * @param width Atlas width in pixels, a multiple of the tile size
+     * @param height Atlas height in pixels, a multiple of the tile size
+     * @return Number of layers filled
+     */
+    int loadAtlas(const unsigned char* pixels, int width, int height);
+
+    /**
+     * @brief Rebuild the mip chain of every layer; call after uploading
+     */
+    void generateMipmaps();
+
+    /**
+     * @brief Bind the array to a texture unit
+     * @param unit The texture unit (default: BLOCK_TEXTURE_UNIT)
+     */
+    void bind(GLuint unit = BLOCK_TEXTURE_UNIT) const;
+
+    /**
+     * @brief Get the OpenGL texture ID
+     * @return The texture ID, or 0 before create()
+     */
+    GLuint getId() const { return m_texture; }
+
+    /**
+     * @brief Get the width and height of one layer
+     * @return The tile size in pixels
+     */
+    int getTileSize() const { return m_tileSize; }
+
+    /**
+     * @brief Get the number of layers
+     * @return The layer count
+     */
+    int getLayerCount() const { return m_layerCount; }
+
+private:
+    GLuint m_texture;
+    int m_tileSize;
+    int m_layerCount;
+};
+
+#endif // BLOCK_TEXTURE_ARRAY_H
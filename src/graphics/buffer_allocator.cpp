@@ -0,0 +1,76 @@
+#include "buffer_allocator.h"
+#include <algorithm>
+
+// Constructor
+BufferAllocator::BufferAllocator(size_t capacity) : m_capacity(0), m_used(0) {
+    grow(capacity);
+}
+
+// Take the start of the first free range that is large enough
+bool BufferAllocator::allocate(size_t size, size_t& offset) {
+    if (size == 0) {
+        offset = 0;
+        return true;
+    }
+
+    for (size_t i = 0; i < m_free.size(); ++i) {
+        Range& range = m_free[i];
+        if (range.size < size) {
+            continue;
+        }
+
+        offset = range.offset;
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0) {
+            m_free.erase(m_free.begin() + i);
+        }
+        m_used += size;
+        return true;
+    }
+    return false;
+}
+
+// Insert a range in offset order, merging it with the ranges on either side
+void BufferAllocator::free(size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    m_used -= size;
+
+    auto next = std::lower_bound(m_free.begin(), m_free.end(), offset,
+                                 [](const Range& range, size_t value) {
+                                     return range.offset < value;
+                                 });
+
+    bool mergePrevious = next != m_free.begin() &&
+                         (next - 1)->offset + (next - 1)->size == offset;
+    bool mergeNext = next != m_free.end() && offset + size == next->offset;
+
+    if (mergePrevious && mergeNext) {
+        (next - 1)->size += size + next->size;
+        m_free.erase(next);
+    } else if (mergePrevious) {
+        (next - 1)->size += size;
+    } else if (mergeNext) {
+        next->offset = offset;
+        next->size += size;
+    } else {
+        m_free.insert(next, Range{ offset, size });
+    }
+}
+
+// Free the new tail of the buffer
+void BufferAllocator::grow(size_t capacity) {
+    if (capacity <= m_capacity) {
+        return;
+    }
+
+    size_t tail = m_capacity;
+    size_t added = capacity - m_capacity;
+    m_capacity = capacity;
+
+    // free() subtracts from m_used; the tail was never allocated
+    m_used += added;
+    free(tail, added);
+}
@@ -0,0 +1,75 @@
+#ifndef BUFFER_ALLOCATOR_H
+#define BUFFER_ALLOCATOR_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class BufferAllocator
+ * @brief Free-list suballocator for ranges of one large GPU buffer
+ *
+ * Only book-keeping; no GL calls. Offsets and sizes are in elements of the
+ * buffer (vertices, indices, ...). Free ranges are kept sorted by offset,
+ * allocated first fit, and merged with their neighbors when released, so
+ * memory freed by remeshed sections is reused instead of growing the buffer.
+ */
+class BufferAllocator {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Number of elements available for allocation
+     */
+    explicit BufferAllocator(size_t capacity = 0);
+
+    /**
+     * @brief Allocate a range
+     * @param size Number of elements; zero always succeeds at offset 0
+     * @param offset Receives the first element of the range
+     * @return false if no free range is large enough
+     */
+    bool allocate(size_t size, size_t& offset);
+
+    /**
+     * @brief Return a range to the free list
+     * @param offset First element of a range returned by allocate()
+     * @param size Size the range was allocated with
+     */
+    void free(size_t offset, size_t size);
+
+    /**
+     * @brief Add the elements between the old and new capacity to the free list
+     * @param capacity The new capacity; must not be smaller than the current one
+     */
+    void grow(size_t capacity);
+
+    /**
+     * @brief Get the number of elements managed
+     * @return The capacity
+     */
+    size_t getCapacity() const { return m_capacity; }
+
+    /**
+     * @brief Get the number of elements in allocated ranges
+     * @return The used element count
+     */
+    size_t getUsed() const { return m_used; }
+
+    /**
+     * @brief Get the number of separate free ranges, a measure of fragmentation
+     * @return The free range count
+     */
+    size_t getFreeRangeCount() const { return m_free.size(); }
+
+private:
+    struct Range {
+        size_t offset;
+        size_t size;
+    };
+
+    // Sorted by offset, never adjacent (adjacent ranges are merged)
+    std::vector<Range> m_free;
+    size_t m_capacity;
+    size_t m_used;
+};
+
+#endif // BUFFER_ALLOCATOR_H
@@ -0,0 +1,34 @@
+#include "camera_uniforms.h"
+
+// Constructor
+CameraUniformBuffer::CameraUniformBuffer() : m_buffer(0), m_uniforms() {}
+
+// Destructor
+CameraUniformBuffer::~CameraUniformBuffer() {
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+// Allocate the buffer once; updates only overwrite it
+void CameraUniformBuffer::create() {
+    if (m_buffer == 0) {
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniforms), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BINDING, m_buffer);
+}
+
+// Upload the frame's camera matrices in one call
+void CameraUniformBuffer::update(const glm::mat4& view, const glm::mat4& projection) {
+    m_uniforms.view = view;
+    m_uniforms.projection = projection;
+    m_uniforms.viewProjection = projection * view;
+    m_uniforms.cameraPosition = glm::vec4(glm::vec3(glm::inverse(view)[3]), 1.0f);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniforms), &m_uniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
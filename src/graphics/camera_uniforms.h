@@ -0,0 +1,77 @@
+#ifndef CAMERA_UNIFORMS_H
+#define CAMERA_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform buffer binding point of the Camera block in every shader
+constexpr GLuint CAMERA_UNIFORM_BINDING = 0;
+
+/**
+ * @struct CameraUniforms
+ * @brief Per-frame camera data, laid out like the std140 Camera block
+ *
+ * GLSL declaration (shaders/vertex.glsl, Renderer's built-in shader):
+ *
+ *     layout(std140) uniform Camera {
+ *         mat4 uView;
+ *         mat4 uProjection;
+ *         mat4 uViewProjection;
+ *         vec4 uCameraPosition;
+ *     };
+ */
+struct CameraUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition;  // w unused
+};
+
+static_assert(sizeof(CameraUniforms) == 208, "CameraUniforms must match the std140 Camera block");
+
+/**
+ * @class CameraUniformBuffer
+ * @brief Uniform buffer holding the Camera block, shared by all shaders
+ *
+ * Updated once per frame and bound to CAMERA_UNIFORM_BINDING, so draws never
+ * upload view or projection matrices themselves.
+ */
+class CameraUniformBuffer {
+public:
+    /**
+     * @brief Constructor - no GL objects until create()
+     */
+    CameraUniformBuffer();
+
+    /**
+     * @brief Destructor - deletes the buffer
+     */
+    ~CameraUniformBuffer();
+
+    CameraUniformBuffer(const CameraUniformBuffer&) = delete;
+    CameraUniformBuffer& operator=(const CameraUniformBuffer&) = delete;
+
+    /**
+     * @brief Create the buffer and bind it to CAMERA_UNIFORM_BINDING
+     */
+    void create();
+
+    /**
+     * @brief Upload the camera data for a frame
+     * @param view The view matrix
+     * @param projection The projection matrix
+     */
+    void update(const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Get the data of the last update
+     * @return The camera uniforms
+     */
+    const CameraUniforms& getUniforms() const { return m_uniforms; }
+
+private:
+    GLuint m_buffer;
+    CameraUniforms m_uniforms;
+};
+
+#endif // CAMERA_UNIFORMS_H
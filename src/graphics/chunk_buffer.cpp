@@ -0,0 +1,152 @@
+#include "chunk_buffer.h"
+#include "quad_index_buffer.h"
+#include <algorithm>
+
+using cppcraft::world::PackedVertex;
+
+// Constructor
+ChunkBuffer::ChunkBuffer(size_t vertexCapacity)
+    : m_vao(0), m_vertexBuffer(0), m_commandBuffer(0), m_originBuffer(0),
+      m_vertices(vertexCapacity), m_drawCapacity(0), m_lastDrawCount(0) {
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vertexBuffer);
+    glGenBuffers(1, &m_commandBuffer);
+    glGenBuffers(1, &m_originBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertexCapacity * sizeof(PackedVertex), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    bindAttributes();
+}
+
+// Destructor
+ChunkBuffer::~ChunkBuffer() {
+    glDeleteBuffers(1, &m_originBuffer);
+    glDeleteBuffers(1, &m_commandBuffer);
+    glDeleteBuffers(1, &m_vertexBuffer);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+// Suballocate and fill a mesh, doubling the buffer until the mesh fits
+void ChunkBuffer::upload(const std::vector<PackedVertex>& vertices, size_t& vertexOffset) {
+    while (!m_vertices.allocate(vertices.size(), vertexOffset)) {
+        size_t capacity = m_vertices.getCapacity();
+        size_t grown = std::max(capacity * 2, capacity + vertices.size());
+        growBuffer(m_vertexBuffer, GL_ARRAY_BUFFER, capacity * sizeof(PackedVertex),
+                   grown * sizeof(PackedVertex));
+        m_vertices.grow(grown);
+        bindAttributes();
+    }
+
+    if (!vertices.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * sizeof(PackedVertex),
+                        vertices.size() * sizeof(PackedVertex), vertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+// Free a mesh's range
+void ChunkBuffer::release(size_t vertexOffset, size_t vertexCount) {
+    m_vertices.free(vertexOffset, vertexCount);
+}
+
+// Drop queued draws
+void ChunkBuffer::clearDraws() {
+    m_commands.clear();
+    m_origins.clear();
+}
+
+// Queue one indirect draw; its instance index selects its origin
+void ChunkBuffer::addDraw(size_t vertexOffset, size_t indexOffset, size_t indexCount,
+                          const glm::vec3& origin) {
+    if (indexCount == 0) {
+        return;
+    }
+
+    DrawCommand command;
+    command.count = static_cast<GLuint>(indexCount);
+    command.instanceCount = 1;
+    command.firstIndex = static_cast<GLuint>(indexOffset);
+    command.baseVertex = static_cast<GLint>(vertexOffset);
+    command.baseInstance = static_cast<GLuint>(m_commands.size());
+    m_commands.push_back(command);
+    m_origins.push_back(glm::vec4(origin, 0.0f));
+}
+
+// Upload this frame's commands and origins, then draw them all at once
+void ChunkBuffer::draw() {
+    m_lastDrawCount = m_commands.size();
+    if (m_commands.empty()) {
+        return;
+    }
+
+    // Reallocate only when the visible set outgrows the buffers; otherwise
+    // orphan them so the driver does not wait on the previous frame
+    if (m_commands.size() > m_drawCapacity) {
+        m_drawCapacity = std::max(m_commands.size(), m_drawCapacity * 2);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, m_drawCapacity * sizeof(DrawCommand), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(DrawCommand), m_commands.data());
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_originBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_drawCapacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_origins.size() * sizeof(glm::vec4), m_origins.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(m_vao);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                static_cast<GLsizei>(m_commands.size()), 0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+// Get buffer occupancy
+ChunkBufferStats ChunkBuffer::getStats() const {
+    ChunkBufferStats stats;
+    stats.vertexCapacity = m_vertices.getCapacity();
+    stats.verticesUsed = m_vertices.getUsed();
+    stats.freeRanges = m_vertices.getFreeRangeCount();
+    stats.drawCount = m_lastDrawCount;
+    return stats;
+}
+
+// Copy a buffer into a new, larger one
+void ChunkBuffer::growBuffer(GLuint& buffer, GLenum target, size_t oldBytes, size_t newBytes) {
+    GLuint grown = 0;
+    glGenBuffers(1, &grown);
+    glBindBuffer(target, grown);
+    glBufferData(target, newBytes, nullptr, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, 0, oldBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(target, 0);
+
+    glDeleteBuffers(1, &buffer);
+    buffer = grown;
+}
+
+// Attach the vertex, origin and quad index buffers to the shared VAO
+void ChunkBuffer::bindAttributes() {
+    glBindVertexArray(m_vao);
+
+    // Packed position/face and tile words, decoded in the vertex shader
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(PackedVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // One chunk origin per draw, selected by the command's baseInstance
+    glBindBuffer(GL_ARRAY_BUFFER, m_originBuffer);
+    glVertexAttribPointer(CHUNK_ORIGIN_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    glVertexAttribDivisor(CHUNK_ORIGIN_ATTRIBUTE, 1);
+    glEnableVertexAttribArray(CHUNK_ORIGIN_ATTRIBUTE);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getQuadIndexBuffer());
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,139 @@
+#ifndef CHUNK_BUFFER_H
+#define CHUNK_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "buffer_allocator.h"
+#include "../world/chunk_mesh.h"
+
+// Initial size of the shared chunk vertex buffer; doubles when full
+constexpr size_t DEFAULT_CHUNK_BUFFER_VERTICES = 4 * 1024 * 1024;
+
+// Vertex attribute fed one chunk origin per draw (see shaders/vertex.glsl)
+constexpr GLuint CHUNK_ORIGIN_ATTRIBUTE = 1;
+
+/**
+ * @struct ChunkBufferStats
+ * @brief Occupancy of the shared chunk buffers and size of the last draw
+ */
+struct ChunkBufferStats {
+    size_t vertexCapacity = 0;
+    size_t verticesUsed = 0;
+    size_t freeRanges = 0;
+    size_t drawCount = 0;
+};
+
+/**
+ * @class ChunkBuffer
+ * @brief Shared vertex storage for every chunk section mesh
+ *
+ * Section meshes are suballocated from one vertex buffer with a free-list
+ * allocator, so all of them share a single VAO. Indices come from the
+ * static quad index buffer (see getQuadIndexBuffer()), whose pattern is
+ * relative to a mesh's first vertex; each draw's command supplies that as
+ * the base vertex.
+ *
+ * A frame queues the visible sections with addDraw() and submits them all
+ * with one glMultiDrawElementsIndirect call. Each command's baseInstance is
+ * its draw index, which selects the chunk origin from a per-draw attribute
+ * buffer (divisor 1), so no uniforms change between draws.
+ *
+ * Requires OpenGL 4.3; main thread only.
+ */
+class ChunkBuffer {
+public:
+    /**
+     * @brief Constructor - creates the buffers and the shared VAO
+     * @param vertexCapacity Initial vertex capacity
+     */
+    explicit ChunkBuffer(size_t vertexCapacity = DEFAULT_CHUNK_BUFFER_VERTICES);
+
+    /**
+     * @brief Destructor - deletes the GL objects
+     */
+    ~ChunkBuffer();
+
+    ChunkBuffer(const ChunkBuffer&) = delete;
+    ChunkBuffer& operator=(const ChunkBuffer&) = delete;
+
+    /**
+     * @brief Copy a section mesh into the shared vertex buffer
+     *
+     * Grows the buffer when no free range is large enough.
+     *
+     * @param vertices The mesh vertices
+     * @param vertexOffset Receives the first vertex of the allocation
+     */
+    void upload(const std::vector<cppcraft::world::PackedVertex>& vertices,
+                size_t& vertexOffset);
+
+    /**
+     * @brief Free a mesh uploaded with upload()
+     */
+    void release(size_t vertexOffset, size_t vertexCount);
+
+    /**
+     * @brief Drop the draws queued for the previous frame
+     */
+    void clearDraws();
+
+    /**
+     * @brief Queue a mesh for the next draw()
+     * @param vertexOffset First vertex of the mesh
+     * @param indexOffset First index to draw in the quad index pattern
+     * @param indexCount Number of indices to draw
+     * @param origin World position of the mesh's chunk
+     */
+    void addDraw(size_t vertexOffset, size_t indexOffset, size_t indexCount,
+                 const glm::vec3& origin);
+
+    /**
+     * @brief Submit every queued draw with one indirect multi-draw
+     *
+     * The caller binds the shader; the VAO is unbound afterwards.
+     */
+    void draw();
+
+    /**
+     * @brief Get buffer occupancy and the size of the last draw
+     * @return The buffer statistics
+     */
+    ChunkBufferStats getStats() const;
+
+private:
+    // Layout fixed by glMultiDrawElementsIndirect
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    /**
+     * @brief Reallocate a buffer at a larger size, keeping its contents
+     */
+    static void growBuffer(GLuint& buffer, GLenum target, size_t oldBytes, size_t newBytes);
+
+    /**
+     * @brief Point the VAO at the current buffers
+     */
+    void bindAttributes();
+
+    GLuint m_vao;
+    GLuint m_vertexBuffer;
+    GLuint m_commandBuffer;
+    GLuint m_originBuffer;
+
+    BufferAllocator m_vertices;
+
+    // Draws of the current frame and the GPU capacity reserved for them
+    std::vector<DrawCommand> m_commands;
+    std::vector<glm::vec4> m_origins;
+    size_t m_drawCapacity;
+    size_t m_lastDrawCount;
+};
+
+#endif // CHUNK_BUFFER_H
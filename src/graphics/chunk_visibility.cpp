@@ -0,0 +1,207 @@
+#include "chunk_visibility.h"
+#include "../world/chunk_mesh.h"
+#include "../world/world.h"
+#include <algorithm>
+#include <cmath>
+
+using cppcraft::world::Chunk;
+using cppcraft::world::World;
+using cppcraft::world::SECTION_SIZE;
+using cppcraft::world::SECTIONS_PER_CHUNK;
+
+namespace {
+
+// Neighbor offsets per face index (0 = +Z, 1 = -Z, 2 = -X, 3 = +X, 4 = -Y, 5 = +Y)
+const int FACE_STEP_X[6] = { 0, 0, -1, 1, 0, 0 };
+const int FACE_STEP_Y[6] = { 0, 0, 0, 0, -1, 1 };
+const int FACE_STEP_Z[6] = { 1, -1, 0, 0, 0, 0 };
+
+// Faces come in opposite pairs
+int oppositeFace(int face) {
+    return face ^ 1;
+}
+
+} // namespace
+
+// Constructor
+ChunkVisibility::ChunkVisibility()
+    : m_occlusionCulling(true), m_sortedCamera{ 0, 0, 0 }, m_hasSortedOrder(false) {}
+
+// Rebuild the visible section list
+void ChunkVisibility::update(const World& world, const glm::mat4& view,
+                             const glm::mat4& projection) {
+    m_frustum.update(view, projection);
+    m_visible.clear();
+    m_chunksInView.clear();
+    m_stats = VisibilityStats();
+
+    glm::vec3 cameraPosition = glm::vec3(glm::inverse(view)[3]);
+    bool occlusion = m_occlusionCulling && findReachableSections(world, cameraPosition);
+
+    world.forEachChunk([&](const Chunk& chunk) {
+        glm::vec3 origin = chunk.GetWorldPosition();
+        int chunkX = chunk.GetChunkX();
+        int chunkZ = chunk.GetChunkZ();
+
+        glm::vec3 columnMax = origin + glm::vec3(SECTION_SIZE, SECTION_SIZE * SECTIONS_PER_CHUNK,
+                                                 SECTION_SIZE);
+
+        // Evicted chunks have nothing to draw yet, but must be rebuilt once
+        // they could be seen
+        if (chunk.IsMeshEvicted()) {
+            if (m_frustum.intersectsBox(origin, columnMax) &&
+                (!occlusion || isAnySectionReachable(chunkX, chunkZ))) {
+                m_chunksInView.push_back(&chunk);
+            }
+            return;
+        }
+
+        int meshed = 0;
+        for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+            meshed += chunk.HasSectionMesh(section);
+        }
+        if (meshed == 0) {
+            return;
+        }
+
+        // Whole-column test first; most culled chunks stop here
+        if (!m_frustum.intersectsBox(origin, columnMax)) {
+            m_stats.frustumCulled += meshed;
+            return;
+        }
+
+        size_t visibleBefore = m_visible.size();
+        for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+            if (!chunk.HasSectionMesh(section)) {
+                continue;
+            }
+            if (!isSectionInFrustum(chunkX, section, chunkZ)) {
+                ++m_stats.frustumCulled;
+            } else if (occlusion &&
+                       m_reachable.find(sectionKey(chunkX, section, chunkZ)) == m_reachable.end()) {
+                ++m_stats.occlusionCulled;
+            } else {
+                m_visible.push_back({ &chunk, section });
+            }
+        }
+
+        if (m_visible.size() > visibleBefore) {
+            ++m_stats.visibleChunks;
+            m_chunksInView.push_back(&chunk);
+        }
+    });
+
+    m_stats.visibleSections = m_visible.size();
+    sortFrontToBack(cameraPosition);
+}
+
+// Sort visible sections by squared section distance from the camera's section
+void ChunkVisibility::sortFrontToBack(const glm::vec3& cameraPosition) {
+    int camera[3] = {
+        World::worldToChunkCoord(static_cast<int>(std::floor(cameraPosition.x))),
+        static_cast<int>(std::floor(cameraPosition.y / SECTION_SIZE)),
+        World::worldToChunkCoord(static_cast<int>(std::floor(cameraPosition.z)))
+    };
+
+    auto sameSection = [](const VisibleSection& a, const VisibleSection& b) {
+        return a.chunk == b.chunk && a.section == b.section;
+    };
+    bool unchanged = m_hasSortedOrder && std::equal(camera, camera + 3, m_sortedCamera) &&
+                     m_visible.size() == m_unsorted.size() &&
+                     std::equal(m_visible.begin(), m_visible.end(), m_unsorted.begin(), sameSection);
+    if (unchanged) {
+        m_visible = m_sorted;
+        return;
+    }
+
+    m_unsorted = m_visible;
+    std::copy(camera, camera + 3, m_sortedCamera);
+    m_hasSortedOrder = true;
+
+    auto distance = [&camera](const VisibleSection& visible) {
+        int dx = visible.chunk->GetChunkX() - camera[0];
+        int dy = visible.section - camera[1];
+        int dz = visible.chunk->GetChunkZ() - camera[2];
+        return dx * dx + dy * dy + dz * dz;
+    };
+    // Stable, so equally distant sections keep their chunk grouping
+    std::stable_sort(m_visible.begin(), m_visible.end(),
+                     [&distance](const VisibleSection& a, const VisibleSection& b) {
+                         return distance(a) < distance(b);
+                     });
+    m_sorted = m_visible;
+}
+
+// Breadth-first walk through connected sections, away from the camera
+bool ChunkVisibility::findReachableSections(const World& world,
+                                            const glm::vec3& cameraPosition) {
+    m_reachable.clear();
+    m_queue.clear();
+
+    int cameraX = World::worldToChunkCoord(static_cast<int>(std::floor(cameraPosition.x)));
+    int cameraZ = World::worldToChunkCoord(static_cast<int>(std::floor(cameraPosition.z)));
+    int cameraY = static_cast<int>(std::floor(cameraPosition.y));
+    if (cameraY < 0 || cameraY >= SECTION_SIZE * SECTIONS_PER_CHUNK ||
+        !world.findChunk(cameraX, cameraZ)) {
+        return false;
+    }
+
+    SectionNode start = { cameraX, cameraY / SECTION_SIZE, cameraZ, -1, 0 };
+    m_queue.push_back(start);
+    m_reachable.insert(sectionKey(start.chunkX, start.section, start.chunkZ));
+
+    for (size_t head = 0; head < m_queue.size(); ++head) {
+        SectionNode node = m_queue[head];
+        const Chunk* chunk = world.findChunk(node.chunkX, node.chunkZ);
+        uint64_t connections = chunk->GetSectionConnectivity(node.section);
+
+        for (int face = 0; face < 6; ++face) {
+            // Never step back toward the camera
+            if (node.directions & (1 << oppositeFace(face))) {
+                continue;
+            }
+            if (node.entryFace >= 0 &&
+                !cppcraft::world::AreFacesConnected(connections, node.entryFace, face)) {
+                continue;
+            }
+
+            SectionNode next = { node.chunkX + FACE_STEP_X[face], node.section + FACE_STEP_Y[face],
+                                 node.chunkZ + FACE_STEP_Z[face], oppositeFace(face),
+                                 static_cast<uint8_t>(node.directions | (1 << face)) };
+            if (next.section < 0 || next.section >= SECTIONS_PER_CHUNK ||
+                !world.findChunk(next.chunkX, next.chunkZ) ||
+                !isSectionInFrustum(next.chunkX, next.section, next.chunkZ)) {
+                continue;
+            }
+
+            if (m_reachable.insert(sectionKey(next.chunkX, next.section, next.chunkZ)).second) {
+                m_queue.push_back(next);
+            }
+        }
+    }
+
+    return true;
+}
+
+// Test a section's box against the frustum
+bool ChunkVisibility::isSectionInFrustum(int chunkX, int section, int chunkZ) const {
+    glm::vec3 min(chunkX * SECTION_SIZE, section * SECTION_SIZE, chunkZ * SECTION_SIZE);
+    return m_frustum.intersectsBox(min, min + glm::vec3(SECTION_SIZE));
+}
+
+// Check the reachable set for any section of the chunk
+bool ChunkVisibility::isAnySectionReachable(int chunkX, int chunkZ) const {
+    for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+        if (m_reachable.find(sectionKey(chunkX, section, chunkZ)) != m_reachable.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pack section coordinates; chunk coordinates keep 30 bits each
+uint64_t ChunkVisibility::sectionKey(int chunkX, int section, int chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX) & 0x3FFFFFFFu) << 34) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(chunkZ) & 0x3FFFFFFFu) << 4) |
+           static_cast<uint64_t>(section & 0xF);
+}
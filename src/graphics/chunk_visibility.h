@@ -0,0 +1,169 @@
+#ifndef CHUNK_VISIBILITY_H
+#define CHUNK_VISIBILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+#include "frustum.h"
+
+namespace cppcraft {
+namespace world {
+class Chunk;
+class World;
+} // namespace world
+} // namespace cppcraft
+
+/**
+ * @struct VisibleSection
+ * @brief One chunk section mesh that passed the visibility tests
+ */
+struct VisibleSection {
+    const cppcraft::world::Chunk* chunk;
+    int section;
+};
+
+/**
+ * @struct VisibilityStats
+ * @brief Visible and culled section meshes of the last visibility update
+ */
+struct VisibilityStats {
+    size_t visibleSections = 0;
+    size_t visibleChunks = 0;
+    size_t frustumCulled = 0;
+    size_t occlusionCulled = 0;
+};
+
+/**
+ * @class ChunkVisibility
+ * @brief Per-frame visibility pass over the loaded chunk sections
+ *
+ * Every section with a mesh is first tested against the view frustum, using
+ * the chunk's box and then the 16x16x16 section box from
+ * Chunk::getWorldPosition(). With occlusion culling enabled, sections must
+ * also be reachable from the camera's section by a breadth-first walk that
+ * only moves away from the camera, only leaves a section through a face
+ * connected by air to the face it entered through, and only enters sections
+ * inside the frustum. Caves and mountains hidden behind solid ground are
+ * skipped that way without any GPU queries.
+ *
+ * The visible list is ordered front to back by section distance from the
+ * camera's section, so the opaque pass gets early depth rejection and the
+ * translucent pass can walk it in reverse. The order is only recomputed when
+ * the camera moves into another section or the set of visible sections
+ * changes.
+ *
+ * Chunks whose meshes were evicted to save video memory have no sections to
+ * test; they are listed among the chunks in view when their column is in
+ * the frustum (and, with occlusion culling, reachable), so the world can
+ * rebuild them.
+ */
+class ChunkVisibility {
+public:
+    /**
+     * @brief Constructor - occlusion culling starts enabled
+     */
+    ChunkVisibility();
+
+    /**
+     * @brief Rebuild the visible section list for a camera
+     * @param world The world whose loaded chunks are tested
+     * @param view The view matrix
+     * @param projection The projection matrix
+     */
+    void update(const cppcraft::world::World& world, const glm::mat4& view,
+                const glm::mat4& projection);
+
+    /**
+     * @brief Enable/disable cave-style occlusion culling
+     * @param enabled true to walk section connectivity, false for frustum only
+     */
+    void setOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+
+    /**
+     * @brief Check if occlusion culling is enabled
+     * @return true if enabled
+     */
+    bool isOcclusionCullingEnabled() const { return m_occlusionCulling; }
+
+    /**
+     * @brief Get the sections to draw, nearest first
+     * @return The visible sections of the last update
+     */
+    const std::vector<VisibleSection>& getVisibleSections() const { return m_visible; }
+
+    /**
+     * @brief Get the chunks with at least one visible section, plus evicted
+     *        chunks in view
+     * @return The chunks of the last update, in no particular order
+     */
+    const std::vector<const cppcraft::world::Chunk*>& getChunksInView() const {
+        return m_chunksInView;
+    }
+
+    /**
+     * @brief Get the visible and culled counts of the last update
+     * @return The visibility statistics
+     */
+    const VisibilityStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Get the frustum of the last update
+     * @return The view frustum
+     */
+    const Frustum& getFrustum() const { return m_frustum; }
+
+private:
+    /**
+     * @brief Walk section connectivity outward from the camera
+     * @return false if the camera is outside the loaded world; nothing is
+     *         occlusion culled then
+     */
+    bool findReachableSections(const cppcraft::world::World& world,
+                               const glm::vec3& cameraPosition);
+
+    /**
+     * @brief Test a section's box against the frustum
+     */
+    bool isSectionInFrustum(int chunkX, int section, int chunkZ) const;
+
+    /**
+     * @brief Check whether the last flood fill reached any section of a chunk
+     */
+    bool isAnySectionReachable(int chunkX, int chunkZ) const;
+
+    /**
+     * @brief Order the visible list front to back, reusing the last order
+     *        while neither the camera section nor the visible set changed
+     */
+    void sortFrontToBack(const glm::vec3& cameraPosition);
+
+    static uint64_t sectionKey(int chunkX, int section, int chunkZ);
+
+    struct SectionNode {
+        int chunkX;
+        int section;
+        int chunkZ;
+        int entryFace;       // Face the walk came in through, -1 at the camera
+        uint8_t directions;  // Faces stepped through so far, one bit each
+    };
+
+    Frustum m_frustum;
+    bool m_occlusionCulling;
+
+    std::vector<VisibleSection> m_visible;
+    std::vector<const cppcraft::world::Chunk*> m_chunksInView;
+
+    // Unsorted visible list and camera section the current order was built for
+    std::vector<VisibleSection> m_unsorted;
+    std::vector<VisibleSection> m_sorted;
+    int m_sortedCamera[3];
+    bool m_hasSortedOrder;
+    std::unordered_set<uint64_t> m_reachable;
+    std::vector<SectionNode> m_queue;
+
+    VisibilityStats m_stats;
+};
+
+#endif // CHUNK_VISIBILITY_H
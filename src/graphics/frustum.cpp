@@ -0,0 +1,43 @@
+#include "frustum.h"
+
+// Constructor
+Frustum::Frustum() {
+    for (glm::vec4& plane : m_planes) {
+        plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+// Extract the planes from the rows of projection * view
+void Frustum::update(const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 m = projection * view;
+
+    // glm is column-major: m[column][row]
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    m_planes[0] = row3 + row0;
+    m_planes[1] = row3 - row0;
+    m_planes[2] = row3 + row1;
+    m_planes[3] = row3 - row1;
+    m_planes[4] = row3 + row2;
+    m_planes[5] = row3 - row2;
+
+    for (glm::vec4& plane : m_planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+// Test a box by its corner farthest along each plane normal
+bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+    for (const glm::vec4& plane : m_planes) {
+        glm::vec3 positive(plane.x >= 0.0f ? max.x : min.x,
+                           plane.y >= 0.0f ? max.y : min.y,
+                           plane.z >= 0.0f ? max.z : min.z);
+        if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
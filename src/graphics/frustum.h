@@ -0,0 +1,44 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+/**
+ * @class Frustum
+ * @brief View frustum as six inward-facing planes, for visibility tests
+ *
+ * Planes are extracted directly from a combined projection * view matrix
+ * (Gribb/Hartmann), so they are in world space.
+ */
+class Frustum {
+public:
+    /**
+     * @brief Constructor - an infinite frustum that contains everything
+     */
+    Frustum();
+
+    /**
+     * @brief Rebuild the planes from camera matrices
+     * @param view The view matrix
+     * @param projection The projection matrix
+     */
+    void update(const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Test an axis-aligned box against the frustum
+     *
+     * Conservative: boxes near a frustum corner may pass although they are
+     * outside, but a box that is partly inside never fails.
+     *
+     * @param min The minimum corner of the box
+     * @param max The maximum corner of the box
+     * @return True if the box may be visible
+     */
+    bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+
+private:
+    // Left, right, bottom, top, near, far; xyz = normal, w = distance
+    glm::vec4 m_planes[6];
+};
+
+#endif // FRUSTUM_H
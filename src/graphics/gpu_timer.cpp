@@ -0,0 +1,84 @@
+#include "gpu_timer.h"
+#include "../core/profiler.h"
+
+using cppcraft::core::Profiler;
+
+// Constructor
+GpuTimer::GpuTimer() : m_frame(0), m_created(false), m_running(false) {}
+
+// Destructor
+GpuTimer::~GpuTimer() {
+    if (!m_created) {
+        return;
+    }
+    for (Frame& frame : m_frames) {
+        for (Query& query : frame.queries) {
+            glDeleteQueries(1, &query.id);
+        }
+    }
+}
+
+// Allocate every query up front; frames reuse them in turn
+void GpuTimer::create() {
+    if (m_created) {
+        return;
+    }
+    for (Frame& frame : m_frames) {
+        for (Query& query : frame.queries) {
+            glGenQueries(1, &query.id);
+        }
+    }
+    m_created = true;
+}
+
+// Move to the next frame slot, reading back what it measured last time
+void GpuTimer::beginFrame() {
+    if (!m_created) {
+        return;
+    }
+    if (m_running) {
+        end();
+    }
+
+    m_frame = (m_frame + 1) % GPU_TIMER_FRAMES;
+    Frame& frame = m_frames[m_frame];
+
+    Profiler& profiler = Profiler::Get();
+    for (int i = 0; i < frame.used; ++i) {
+        Query& query = frame.queries[i];
+        GLint available = 0;
+        glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsed);
+        profiler.RecordGpu(query.name, query.submittedAt, elapsed);
+    }
+    frame.used = 0;
+}
+
+// Start a query unless profiling is off or the frame ran out of them
+void GpuTimer::begin(const char* name) {
+    Frame& frame = m_frames[m_frame];
+    Profiler& profiler = Profiler::Get();
+    if (!m_created || m_running || frame.used == GPU_TIMERS_PER_FRAME ||
+        !profiler.IsEnabled()) {
+        return;
+    }
+
+    Query& query = frame.queries[frame.used++];
+    query.name = name;
+    query.submittedAt = profiler.Now();
+    glBeginQuery(GL_TIME_ELAPSED, query.id);
+    m_running = true;
+}
+
+// End the query begin() started, if any
+void GpuTimer::end() {
+    if (m_running) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_running = false;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+
+// Frames a timer query stays in flight before its result is read; results
+// still missing by then are dropped rather than stalling on the GPU
+constexpr int GPU_TIMER_FRAMES = 4;
+
+// Timed ranges per frame; further begin() calls are ignored
+constexpr int GPU_TIMERS_PER_FRAME = 16;
+
+/**
+ * @class GpuTimer
+ * @brief GL_TIME_ELAPSED queries feeding the frame profiler
+ *
+ * Each frame's queries are read back GPU_TIMER_FRAMES frames later, so the
+ * CPU never waits on them, and recorded with Profiler::RecordGpu() at the
+ * CPU time the range was submitted. GL_TIME_ELAPSED queries cannot nest:
+ * end() must be called before the next begin().
+ */
+class GpuTimer {
+public:
+    /**
+     * @brief Constructor - no GL objects until create()
+     */
+    GpuTimer();
+
+    /**
+     * @brief Destructor - deletes the queries
+     */
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /**
+     * @brief Create the query objects
+     */
+    void create();
+
+    /**
+     * @brief Start a frame, collecting the results of the oldest one
+     */
+    void beginFrame();
+
+    /**
+     * @brief Start timing a range of GL commands
+     * @param name Profiler scope name; must outlive the profiler
+     */
+    void begin(const char* name);
+
+    /**
+     * @brief Stop timing the current range
+     */
+    void end();
+
+private:
+    struct Query {
+        GLuint id = 0;
+        const char* name = nullptr;
+        uint64_t submittedAt = 0;
+    };
+
+    struct Frame {
+        std::array<Query, GPU_TIMERS_PER_FRAME> queries;
+        int used = 0;
+    };
+
+    std::array<Frame, GPU_TIMER_FRAMES> m_frames;
+    int m_frame;
+    bool m_created;
+
+    // Whether begin() started a query that end() has to close
+    bool m_running;
+};
+
+#endif // GPU_TIMER_H
@@ -0,0 +1,264 @@
+#include "profiler_overlay.h"
+#include "shader_cache.h"
+#include "../core/profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstddef>
+
+using cppcraft::core::Profiler;
+using cppcraft::core::ProfileCounter;
+using cppcraft::core::ProfileScopeStats;
+
+namespace {
+
+// Screen pixels per font pixel, and the resulting text metrics
+const float FONT_SCALE = 2.0f;
+const float GLYPH_ADVANCE = 4.0f * FONT_SCALE;
+const float LINE_HEIGHT = 7.0f * FONT_SCALE;
+
+// Layout of a row: name, mean and worst milliseconds, then the bar
+const float OVERLAY_MARGIN = 8.0f;
+const int NAME_COLUMNS = 18;
+const int NUMBER_COLUMNS = 7;
+const float BAR_WIDTH = 200.0f;
+
+const glm::vec4 BACKGROUND_COLOR(0.0f, 0.0f, 0.0f, 0.6f);
+const glm::vec4 TEXT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+const glm::vec4 CPU_BAR_COLOR(0.3f, 0.85f, 0.3f, 1.0f);
+const glm::vec4 GPU_BAR_COLOR(1.0f, 0.6f, 0.2f, 1.0f);
+const glm::vec4 MAX_BAR_COLOR(1.0f, 1.0f, 1.0f, 0.25f);
+const glm::vec4 BUDGET_COLOR(1.0f, 0.2f, 0.2f, 1.0f);
+
+// 3x5 pixel glyphs, one row per entry, bit 2 leftmost
+struct Glyph {
+    char character;
+    unsigned char rows[5];
+};
+
+const Glyph FONT[] = {
+    { '0', { 7, 5, 5, 5, 7 } }, { '1', { 2, 6, 2, 2, 7 } }, { '2', { 7, 1, 7, 4, 7 } },
+    { '3', { 7, 1, 7, 1, 7 } }, { '4', { 5, 5, 7, 1, 1 } }, { '5', { 7, 4, 7, 1, 7 } },
+    { '6', { 7, 4, 7, 5, 7 } }, { '7', { 7, 1, 1, 1, 1 } }, { '8', { 7, 5, 7, 5, 7 } },
+    { '9', { 7, 5, 7, 1, 7 } }, { 'A', { 2, 5, 7, 5, 5 } }, { 'B', { 6, 5, 6, 5, 6 } },
+    { 'C', { 3, 4, 4, 4, 3 } }, { 'D', { 6, 5, 5, 5, 6 } }, { 'E', { 7, 4, 6, 4, 7 } },
+    { 'F', { 7, 4, 6, 4, 4 } }, { 'G', { 3, 4, 5, 5, 3 } }, { 'H', { 5, 5, 7, 5, 5 } },
+    { 'I', { 7, 2, 2, 2, 7 } }, { 'J', { 1, 1, 1, 5, 2 } }, { 'K', { 5, 5, 6, 5, 5 } },
+    { 'L', { 4, 4, 4, 4, 7 } }, { 'M', { 5, 7, 7, 5, 5 } }, { 'N', { 6, 5, 5, 5, 5 } },
+    { 'O', { 2, 5, 5, 5, 2 } }, { 'P', { 6, 5, 6, 4, 4 } }, { 'Q', { 2, 5, 5, 6, 3 } },
+    { 'R', { 6, 5, 6, 5, 5 } }, { 'S', { 3, 4, 2, 1, 6 } }, { 'T', { 7, 2, 2, 2, 2 } },
+    { 'U', { 5, 5, 5, 5, 7 } }, { 'V', { 5, 5, 5, 5, 2 } }, { 'W', { 5, 5, 7, 7, 5 } },
+    { 'X', { 5, 5, 2, 5, 5 } }, { 'Y', { 5, 5, 2, 2, 2 } }, { 'Z', { 7, 1, 2, 4, 7 } },
+    { '.', { 0, 0, 0, 0, 2 } }, { ':', { 0, 2, 0, 2, 0 } }, { '-', { 0, 0, 7, 0, 0 } },
+    { '_', { 0, 0, 0, 0, 7 } }, { '/', { 1, 1, 2, 4, 4 } },
+};
+
+const Glyph* findGlyph(char character) {
+    character = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+    for (const Glyph& glyph : FONT) {
+        if (glyph.character == character) {
+            return &glyph;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// Constructor
+ProfilerOverlay::ProfilerOverlay()
+    : m_program(0), m_vao(0), m_vbo(0), m_screenSizeLocation(-1), m_bufferCapacity(0) {}
+
+// Destructor
+ProfilerOverlay::~ProfilerOverlay() {
+    if (m_program != 0) {
+        glDeleteProgram(m_program);
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_vbo);
+    }
+}
+
+// Build the flat-color screen-space shader and its vertex layout
+void ProfilerOverlay::create() {
+    if (m_program != 0) {
+        return;
+    }
+
+    const char* vertexShaderSource = R"(
+        #version 330 core
+        layout (location = 0) in vec2 position;
+        layout (location = 1) in vec4 color;
+
+        out vec4 Color;
+
+        // Viewport size in pixels; positions start at the top-left corner
+        uniform vec2 screenSize;
+
+        void main() {
+            Color = color;
+            vec2 ndc = position / screenSize * 2.0 - 1.0;
+            gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+        }
+    )";
+
+    const char* fragmentShaderSource = R"(
+        #version 330 core
+        in vec4 Color;
+        out vec4 FragColor;
+
+        void main() {
+            FragColor = Color;
+        }
+    )";
+
+    // Loaded from the shader cache when this driver has linked it before
+    const ShaderStageSource stages[] = {
+        { GL_VERTEX_SHADER, vertexShaderSource },
+        { GL_FRAGMENT_SHADER, fragmentShaderSource },
+    };
+    m_program = buildShaderProgram(stages, 2, "profiler overlay");
+    if (m_program == 0) {
+        return;
+    }
+    m_screenSizeLocation = glGetUniformLocation(m_program, "screenSize");
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex),
+                          (void*)offsetof(OverlayVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex),
+                          (void*)offsetof(OverlayVertex, color));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+// Lay out the table, then draw it in one call without depth testing
+void ProfilerOverlay::draw(const Profiler& profiler, int viewportWidth, int viewportHeight) {
+    if (m_program == 0 || viewportWidth <= 0 || viewportHeight <= 0) {
+        return;
+    }
+
+    const std::vector<ProfileScopeStats>& stats = profiler.GetStats();
+    const std::vector<ProfileCounter>& counters = profiler.GetCounters();
+    const int rows = static_cast<int>(stats.size() + counters.size()) + 2;
+    const float barX = OVERLAY_MARGIN * 2.0f + GLYPH_ADVANCE * (NAME_COLUMNS + NUMBER_COLUMNS * 2);
+    const float msToPixels = BAR_WIDTH / PROFILER_OVERLAY_BUDGET_MS;
+
+    m_vertices.clear();
+    addRect(OVERLAY_MARGIN, OVERLAY_MARGIN, barX + BAR_WIDTH,
+            LINE_HEIGHT * rows + OVERLAY_MARGIN, BACKGROUND_COLOR);
+
+    char line[128];
+    float y = OVERLAY_MARGIN * 1.5f;
+    std::snprintf(line, sizeof(line), "%-*s%*.2f%*.2f", NAME_COLUMNS, "frame ms avg/max",
+                  NUMBER_COLUMNS, profiler.GetAverageFrameMs(),
+                  NUMBER_COLUMNS, profiler.GetMaxFrameMs());
+    addText(OVERLAY_MARGIN * 1.5f, y, line, TEXT_COLOR);
+    addRect(barX + BAR_WIDTH - 1.0f, y, 2.0f, LINE_HEIGHT * (rows - 1), BUDGET_COLOR);
+    y += LINE_HEIGHT;
+
+    for (const ProfileScopeStats& scope : stats) {
+        std::snprintf(line, sizeof(line), "%-*.*s%*.2f%*.2f", NAME_COLUMNS, NAME_COLUMNS - 1,
+                      scope.name, NUMBER_COLUMNS, scope.average_ms, NUMBER_COLUMNS, scope.max_ms);
+        addText(OVERLAY_MARGIN * 1.5f, y, line, TEXT_COLOR);
+
+        float barHeight = LINE_HEIGHT - FONT_SCALE * 2.0f;
+        addRect(barX, y, std::min(static_cast<float>(scope.max_ms) * msToPixels, BAR_WIDTH),
+                barHeight, MAX_BAR_COLOR);
+        addRect(barX, y, std::min(static_cast<float>(scope.average_ms) * msToPixels, BAR_WIDTH),
+                barHeight, scope.gpu ? GPU_BAR_COLOR : CPU_BAR_COLOR);
+        y += LINE_HEIGHT;
+    }
+
+    // Counters show their latest value, without a bar
+    for (const ProfileCounter& counter : counters) {
+        std::snprintf(line, sizeof(line), "%-*.*s%*.2f", NAME_COLUMNS, NAME_COLUMNS - 1,
+                      counter.name, NUMBER_COLUMNS * 2, counter.value);
+        addText(OVERLAY_MARGIN * 1.5f, y, line, TEXT_COLOR);
+        y += LINE_HEIGHT;
+    }
+
+    std::snprintf(line, sizeof(line), "dropped events %zu", profiler.GetDroppedEventCount());
+    addText(OVERLAY_MARGIN * 1.5f, y, line, TEXT_COLOR);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    size_t bytes = m_vertices.size() * sizeof(OverlayVertex);
+    if (bytes > m_bufferCapacity) {
+        m_bufferCapacity = bytes * 2;
+        glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(m_program);
+    glUniform2f(m_screenSizeLocation, static_cast<float>(viewportWidth),
+                static_cast<float>(viewportHeight));
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
+    glBindVertexArray(0);
+
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (!blend) {
+        glDisable(GL_BLEND);
+    }
+    if (cullFace) {
+        glEnable(GL_CULL_FACE);
+    }
+}
+
+// Two triangles per rectangle
+void ProfilerOverlay::addRect(float x, float y, float width, float height,
+                              const glm::vec4& color) {
+    if (width <= 0.0f || height <= 0.0f) {
+        return;
+    }
+    glm::vec2 topLeft(x, y);
+    glm::vec2 topRight(x + width, y);
+    glm::vec2 bottomLeft(x, y + height);
+    glm::vec2 bottomRight(x + width, y + height);
+    m_vertices.push_back({ topLeft, color });
+    m_vertices.push_back({ bottomLeft, color });
+    m_vertices.push_back({ bottomRight, color });
+    m_vertices.push_back({ topLeft, color });
+    m_vertices.push_back({ bottomRight, color });
+    m_vertices.push_back({ topRight, color });
+}
+
+// One rectangle per horizontal run of lit glyph pixels
+void ProfilerOverlay::addText(float x, float y, const std::string& text, const glm::vec4& color) {
+    for (char character : text) {
+        const Glyph* glyph = findGlyph(character);
+        if (glyph) {
+            for (int row = 0; row < 5; ++row) {
+                int column = 0;
+                while (column < 3) {
+                    if (!(glyph->rows[row] & (4 >> column))) {
+                        ++column;
+                        continue;
+                    }
+                    int start = column;
+                    while (column < 3 && (glyph->rows[row] & (4 >> column))) {
+                        ++column;
+                    }
+                    addRect(x + start * FONT_SCALE, y + row * FONT_SCALE,
+                            (column - start) * FONT_SCALE, FONT_SCALE, color);
+                }
+            }
+        }
+        x += GLYPH_ADVANCE;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef PROFILER_OVERLAY_H
+#define PROFILER_OVERLAY_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+namespace cppcraft {
+namespace core {
+class Profiler;
+} // namespace core
+} // namespace cppcraft
+
+// Frame time the overlay's bars are scaled to (60 FPS)
+constexpr float PROFILER_OVERLAY_BUDGET_MS = 1000.0f / 60.0f;
+
+/**
+ * @class ProfilerOverlay
+ * @brief On-screen table of the frame profiler's per-scope timings
+ *
+ * Draws one row per scope in the top-left corner: its name, mean and worst
+ * milliseconds per frame, and a bar against the 60 FPS frame budget (green
+ * for CPU scopes, orange for GPU ones), followed by one row per counter with
+ * its latest value. Text uses a built-in 3x5 pixel font, so the overlay
+ * needs no textures; every row is one batch of rectangles.
+ */
+class ProfilerOverlay {
+public:
+    /**
+     * @brief Constructor - no GL objects until create()
+     */
+    ProfilerOverlay();
+
+    /**
+     * @brief Destructor - deletes the shader and buffers
+     */
+    ~ProfilerOverlay();
+
+    ProfilerOverlay(const ProfilerOverlay&) = delete;
+    ProfilerOverlay& operator=(const ProfilerOverlay&) = delete;
+
+    /**
+     * @brief Compile the shader and create the vertex buffer
+     */
+    void create();
+
+    /**
+     * @brief Draw the profiler's statistics over the current frame
+     * @param profiler The profiler to show
+     * @param viewportWidth Viewport width in pixels
+     * @param viewportHeight Viewport height in pixels
+     */
+    void draw(const cppcraft::core::Profiler& profiler, int viewportWidth, int viewportHeight);
+
+private:
+    struct OverlayVertex {
+        glm::vec2 position;  // pixels from the top-left corner
+        glm::vec4 color;
+    };
+
+    GLuint m_program;
+    GLuint m_vao;
+    GLuint m_vbo;
+    GLint m_screenSizeLocation;
+
+    // Rebuilt every frame; the buffer only grows
+    std::vector<OverlayVertex> m_vertices;
+    size_t m_bufferCapacity;
+
+    /**
+     * @brief Queue a filled rectangle
+     */
+    void addRect(float x, float y, float width, float height, const glm::vec4& color);
+
+    /**
+     * @brief Queue a line of text; letters are drawn in upper case
+     */
+    void addText(float x, float y, const std::string& text, const glm::vec4& color);
+};
+
+#endif // PROFILER_OVERLAY_H
@@ -0,0 +1,24 @@
+#include "quad_index_buffer.h"
+#include "../world/chunk_mesh.h"
+#include <vector>
+
+using cppcraft::world::FillQuadIndices;
+using cppcraft::world::INDICES_PER_QUAD;
+using cppcraft::world::MAX_SECTION_QUADS;
+
+// Create and fill the pattern on first use
+// Not GL_ELEMENT_ARRAY_BUFFER: that binding belongs to whichever VAO is bound
+GLuint getQuadIndexBuffer() {
+    static GLuint buffer = 0;
+    if (buffer == 0) {
+        std::vector<unsigned int> indices(MAX_SECTION_QUADS * INDICES_PER_QUAD);
+        FillQuadIndices(indices.data(), MAX_SECTION_QUADS);
+
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int),
+                     indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    return buffer;
+}
@@ -0,0 +1,21 @@
+#ifndef QUAD_INDEX_BUFFER_H
+#define QUAD_INDEX_BUFFER_H
+
+#include <glad/glad.h>
+
+/**
+ * @brief Get the static index buffer every chunk mesh is drawn with
+ *
+ * Holds FillQuadIndices() for MAX_SECTION_QUADS quads (about 576 KB),
+ * filled once on first use. Meshes only upload vertices: a layer's
+ * LayerRange is its range of this pattern. Per-section VAOs and the shared
+ * chunk buffer's VAO all bind it as their element buffer.
+ *
+ * Main thread only. The buffer is created in the current GL context and
+ * lives as long as that context.
+ *
+ * @return The index buffer name
+ */
+GLuint getQuadIndexBuffer();
+
+#endif // QUAD_INDEX_BUFFER_H
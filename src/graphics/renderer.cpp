@@ -1,59 +1,139 @@
 #include "renderer.h"
+#include "block_texture_array.h"
+#include "chunk_buffer.h"
+#include "shader.h"
+#include "shader_cache.h"
+#include "../core/profiler.h"
+#include "../world/world.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
+using cppcraft::core::Profiler;
+using cppcraft::world::Chunk;
+using cppcraft::world::MeshResidency;
+using cppcraft::world::RenderLayer;
+using cppcraft::world::World;
+using cppcraft::world::SECTIONS_PER_CHUNK;
+
 Renderer::Renderer() 
-    : vao(0), vbo(0), ebo(0), shaderProgram(0), 
-      vertexCount(0), indexCount(0) {
-    initializeRenderer();
+    : m_projectionMatrix(1.0f), m_viewMatrix(1.0f), m_modelMatrix(1.0f),
+      m_shaderProgram(0), m_depthTestingEnabled(false), m_blendingEnabled(false),
+      m_faceCullingEnabled(false), m_wireframeMode(false), m_viewportWidth(0),
+      m_viewportHeight(0), m_profilerOverlayVisible(false),
+      m_chunkOffsetLocation(-1), m_alphaCutoffLocation(-1) {
 }
 
 Renderer::~Renderer() {
-    cleanup();
+    shutdown();
 }
 
-void Renderer::initializeRenderer() {
+bool Renderer::initialize() {
+    // Every program built from here on, the overlay's and hot-reloaded ones
+    // included, loads its binary from the cache when the driver allows
+    if (!ShaderCache::getDefault()) {
+        m_shaderCache = std::make_unique<ShaderCache>(DEFAULT_SHADER_CACHE_DIRECTORY);
+        ShaderCache::setDefault(m_shaderCache.get());
+    }
+    
     // Initialize shader program
-    shaderProgram = createShaderProgram();
+    m_shaderProgram = createShaderProgram();
+    if (m_shaderProgram == 0) {
+        std::cerr << "Failed to build the renderer chunk shader" << std::endl;
+        return false;
+    }
     
-    // Generate VAO, VBO, and EBO
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
+    // Resolve uniforms once; draws only use the cached locations
+    m_chunkOffsetLocation = glGetUniformLocation(m_shaderProgram, "chunkOffset");
+    m_alphaCutoffLocation = glGetUniformLocation(m_shaderProgram, "alphaCutoff");
+    GLuint cameraBlock = glGetUniformBlockIndex(m_shaderProgram, "Camera");
+    if (cameraBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_shaderProgram, cameraBlock, CAMERA_UNIFORM_BINDING);
+    }
+    m_cameraUniforms.create();
+    m_gpuTimer.create();
+    m_profilerOverlay.create();
+    
+    // Block textures always come from the same unit
+    glUseProgram(m_shaderProgram);
+    glUniform1i(glGetUniformLocation(m_shaderProgram, "blockTextures"), BLOCK_TEXTURE_UNIT);
+    glUseProgram(0);
     
-    // Setup vertex attributes
-    setupVertexAttributes();
+    setDepthTesting(true);
+    setFaceCulling(true);
     
     std::cout << "Renderer initialized successfully" << std::endl;
+    return true;
 }
 
 GLuint Renderer::createShaderProgram() {
+    // Same decoding as shaders/vertex.glsl; chunk VAOs and the shared chunk
+    // buffer both feed the 8-byte PackedVertex at location 0 as integers
     const char* vertexShaderSource = R"(
         #version 330 core
-        layout (location = 0) in vec3 position;
-        layout (location = 1) in vec3 normal;
-        layout (location = 2) in vec2 texCoord;
-        layout (location = 3) in float blockType;
+        // x: bits 0-4 x, 5-13 y, 14-18 z, 19-21 face
+        // y: bits 0-15 texture layer, 16-19 block light, 20-23 sky light
+        layout (location = 0) in uvec2 packedVertex;
+        
+        // Per-draw chunk origin from the shared chunk buffer; zero for
+        // per-section VAOs, which set chunkOffset instead
+        layout (location = 1) in vec3 chunkOrigin;
         
         out vec3 FragPos;
         out vec3 Normal;
         out vec2 TexCoord;
-        out float BlockType;
+        out float LightLevel;
+        flat out float TextureLayer;
+        
+        // Face index -> normal (+Z, -Z, -X, +X, -Y, +Y)
+        const vec3 FACE_NORMALS[6] = vec3[6](
+            vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+            vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0),
+            vec3(0.0, -1.0, 0.0), vec3(0.0, 1.0, 0.0)
+        );
         
-        uniform mat4 model;
-        uniform mat4 view;
-        uniform mat4 projection;
+        // Face index -> axes projected onto the texture u and v coordinates
+        const vec3 FACE_TEX_U[6] = vec3[6](
+            vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+            vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+            vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0)
+        );
+        const vec3 FACE_TEX_V[6] = vec3[6](
+            vec3(0.0, 1.0, 0.0), vec3(0.0, 1.0, 0.0),
+            vec3(0.0, 1.0, 0.0), vec3(0.0, 1.0, 0.0),
+            vec3(1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)
+        );
+        
+        // Per-frame camera data (see CameraUniforms)
+        layout (std140) uniform Camera {
+            mat4 uView;
+            mat4 uProjection;
+            mat4 uViewProjection;
+            vec4 uCameraPosition;
+        };
+        
+        // Chunks are only ever translated, so normals need no matrix
+        uniform vec3 chunkOffset;
         
         void main() {
-            FragPos = vec3(model * vec4(position, 1.0));
-            Normal = mat3(transpose(inverse(model))) * normal;
-            TexCoord = texCoord;
-            BlockType = blockType;
+            vec3 position = vec3(float(packedVertex.x & 31u),
+                                 float((packedVertex.x >> 5u) & 511u),
+                                 float((packedVertex.x >> 14u) & 31u));
+            int face = int((packedVertex.x >> 19u) & 7u);
             
-            gl_Position = projection * view * vec4(FragPos, 1.0);
+            FragPos = position + chunkOrigin + chunkOffset;
+            Normal = FACE_NORMALS[face];
+            // Block units; GL_REPEAT tiles them across merged quads
+            TexCoord = vec2(dot(position, FACE_TEX_U[face]),
+                            dot(position, FACE_TEX_V[face]));
+            TextureLayer = float(packedVertex.y & 65535u);
+            LightLevel = max(float((packedVertex.y >> 16u) & 15u),
+                             float((packedVertex.y >> 20u) & 15u)) / 15.0;
+            
+            gl_Position = uViewProjection * vec4(FragPos, 1.0);
         }
     )";
     
@@ -62,27 +142,21 @@ GLuint Renderer::createShaderProgram() {
         in vec3 FragPos;
         in vec3 Normal;
         in vec2 TexCoord;
-        in float BlockType;
+        in float LightLevel;
+        flat in float TextureLayer;
         
         out vec4 FragColor;
         
-        uniform sampler2D texture0;
-        uniform sampler2D texture1;
-        uniform sampler2D texture2;
-        uniform sampler2D texture3;
+        // One layer per block texture (see BlockTextureArray)
+        uniform sampler2DArray blockTextures;
+        
+        // Texels below this alpha are discarded; zero keeps them all
+        uniform float alphaCutoff;
         
         void main() {
-            vec4 texColor;
-            
-            // Select texture based on block type
-            if (BlockType < 0.5) {
-                texColor = texture(texture0, TexCoord);
-            } else if (BlockType < 1.5) {
-                texColor = texture(texture1, TexCoord);
-            } else if (BlockType < 2.5) {
-                texColor = texture(texture2, TexCoord);
-            } else {
-                texColor = texture(texture3, TexCoord);
+            vec4 texColor = texture(blockTextures, vec3(TexCoord, TextureLayer));
+            if (texColor.a < alphaCutoff) {
+                discard;
             }
             
             // Lighting calculation
@@ -95,162 +169,224 @@ GLuint Renderer::createShaderProgram() {
             float diff = max(dot(norm, lightDir), 0.0);
             vec3 diffuse = diff * texColor.rgb;
             
-            vec3 result = (ambient + diffuse);
+            // Baked sky and block light of the face
+            vec3 result = (ambient + diffuse) * mix(0.2, 1.0, LightLevel);
             FragColor = vec4(result, texColor.a);
         }
     )";
     
-    // Compile vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    checkShaderCompilation(vertexShader, "VERTEX");
-    
-    // Compile fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    checkShaderCompilation(fragmentShader, "FRAGMENT");
-    
-    // Link shader program
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    checkProgramLinking(program);
-    
-    // Cleanup
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return program;
+    // Loaded from the shader cache when this driver has linked it before
+    const ShaderStageSource stages[] = {
+        { GL_VERTEX_SHADER, vertexShaderSource },
+        { GL_FRAGMENT_SHADER, fragmentShaderSource },
+    };
+    return buildShaderProgram(stages, 2, "renderer");
 }
 
-void Renderer::setupVertexAttributes() {
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 
-                         sizeof(Vertex), (void*)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
-    
-    // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 
-                         sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(1);
-    
-    // Texture coordinate attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 
-                         sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-    glEnableVertexAttribArray(2);
-    
-    // Block type attribute
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 
-                         sizeof(Vertex), (void*)offsetof(Vertex, blockType));
-    glEnableVertexAttribArray(3);
+void Renderer::shutdown() {
+    if (m_shaderCache) {
+        ShaderCache::setDefault(nullptr);
+        m_shaderCache.reset();
+    }
+    if (m_shaderProgram == 0) {
+        return;
+    }
+    glDeleteProgram(m_shaderProgram);
+    m_shaderProgram = 0;
+    m_currentShader.reset();
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    std::cout << "Renderer cleanup completed" << std::endl;
 }
 
-void Renderer::renderChunk(const Chunk& chunk, const glm::mat4& view, 
-                          const glm::mat4& projection) {
-    if (chunk.getVertexCount() == 0) {
-        return;
+void Renderer::renderWorld(const World& world, const glm::mat4& view,
+                           const glm::mat4& projection) {
+    PROFILE_SCOPE("render.world");
+    {
+        PROFILE_SCOPE("render.visibility");
+        m_visibility.update(world, view, projection);
     }
+
+    // Keep what is in view resident and bring evicted chunks back
+    if (MeshResidency* residency = world.getMeshResidency()) {
+        for (const Chunk* chunk : m_visibility.getChunksInView()) {
+            residency->MarkVisible(chunk->GetChunkX(), chunk->GetChunkZ());
+        }
+    }
+    m_cameraUniforms.update(view, projection);
+    beginChunkPass();
     
-    glUseProgram(shaderProgram);
-    
-    // Set up transformations
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, chunk.getPosition());
-    
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
-    
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    // Opaque front to back for early depth rejection, then alpha-tested cutout
+    m_gpuTimer.begin("gpu.opaque");
+    drawLayer(world, RenderLayer::Opaque, false);
+    m_gpuTimer.end();
+    glUniform1f(m_alphaCutoffLocation, CUTOUT_ALPHA_CUTOFF);
+    m_gpuTimer.begin("gpu.cutout");
+    drawLayer(world, RenderLayer::Cutout, false);
+    m_gpuTimer.end();
+    glUniform1f(m_alphaCutoffLocation, 0.0f);
     
-    // Bind chunk's VAO and draw
-    glBindVertexArray(chunk.getVAO());
-    glDrawElements(GL_TRIANGLES, chunk.getIndexCount(), GL_UNSIGNED_INT, 0);
+    // Translucent back to front, blended over the opaque scene; depth is
+    // tested but not written so water behind ice still shows through
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    m_gpuTimer.begin("gpu.translucent");
+    drawLayer(world, RenderLayer::Translucent, true);
+    m_gpuTimer.end();
+    glDepthMask(GL_TRUE);
+    if (!m_blendingEnabled) {
+        glDisable(GL_BLEND);
+    }
     glBindVertexArray(0);
 }
 
-void Renderer::renderChunks(const std::vector<Chunk>& chunks, 
-                           const glm::mat4& view, const glm::mat4& projection) {
-    for (const auto& chunk : chunks) {
-        renderChunk(chunk, view, projection);
+void Renderer::beginFrame() {
+    m_gpuTimer.beginFrame();
+}
+
+void Renderer::endFrame() {
+    if (m_profilerOverlayVisible) {
+        // Sized to whatever viewport the frame was drawn into
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        m_profilerOverlay.draw(Profiler::Get(), viewport[2], viewport[3]);
     }
 }
 
-void Renderer::renderBlock(const Block& block, const glm::mat4& view, 
-                          const glm::mat4& projection) {
-    glUseProgram(shaderProgram);
-    
-    // Set up transformations
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, block.getPosition());
-    model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
-    
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
-    
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    
-    // Bind and draw
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+void Renderer::setProfilerOverlay(bool visible) {
+    m_profilerOverlayVisible = visible;
 }
 
-void Renderer::uploadVertexData(const std::vector<Vertex>& vertices, 
-                               const std::vector<GLuint>& indices) {
-    vertexCount = vertices.size();
-    indexCount = indices.size();
-    
-    glBindVertexArray(vao);
-    
-    // Upload vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), 
-                 vertices.data(), GL_DYNAMIC_DRAW);
+void Renderer::drawLayer(const World& world, RenderLayer layer, bool backToFront) {
+    const std::vector<VisibleSection>& visible = m_visibility.getVisibleSections();
+    ChunkBuffer* chunkBuffer = world.getChunkBuffer();
+    if (chunkBuffer) {
+        chunkBuffer->clearDraws();
+    }
     
-    // Upload index data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), 
-                 indices.data(), GL_DYNAMIC_DRAW);
+    // Shared buffer: queue the layer of every visible section, then one
+    // indirect multi-draw with the chunk origins taken from the buffer.
+    // Otherwise set the chunk offset whenever the chunk changes.
+    const Chunk* currentChunk = nullptr;
+    for (size_t i = 0; i < visible.size(); ++i) {
+        const VisibleSection& section = visible[backToFront ? visible.size() - 1 - i : i];
+        if (!section.chunk->HasSectionLayer(section.section, layer)) {
+            continue;
+        }
+        if (!chunkBuffer && section.chunk != currentChunk) {
+            currentChunk = section.chunk;
+            glUniform3fv(m_chunkOffsetLocation, 1, glm::value_ptr(currentChunk->GetWorldPosition()));
+        }
+        section.chunk->RenderSectionLayer(section.section, layer);
+    }
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    if (chunkBuffer) {
+        chunkBuffer->draw();
+    }
 }
 
-void Renderer::setTexture(GLuint textureUnit, GLuint textureID) {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+void Renderer::beginChunkPass() {
+    glUseProgram(m_shaderProgram);
+    glUniform3f(m_chunkOffsetLocation, 0.0f, 0.0f, 0.0f);
+    glUniform1f(m_alphaCutoffLocation, 0.0f);
+}
+
+void Renderer::drawChunk(const Chunk& chunk) {
+    glUniform3fv(m_chunkOffsetLocation, 1, glm::value_ptr(chunk.GetWorldPosition()));
     
-    GLint texLoc = glGetUniformLocation(shaderProgram, 
-                                       ("texture" + std::to_string(textureUnit)).c_str());
-    glUniform1i(texLoc, textureUnit);
+    // Each section has its own VAO
+    for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+        chunk.RenderSection(section);
+    }
 }
 
-void Renderer::enableFaceCulling(bool enable) {
-    if (enable) {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+void Renderer::setOcclusionCulling(bool enabled) {
+    m_visibility.setOcclusionCulling(enabled);
+}
+
+const VisibilityStats& Renderer::getVisibilityStats() const {
+    return m_visibility.getStats();
+}
+
+void Renderer::clearScreen(float r, float g, float b, float a) {
+    glClearColor(r, g, b, a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void Renderer::setViewport(int width, int height) {
+    m_viewportWidth = width;
+    m_viewportHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void Renderer::setProjectionMatrix(const glm::mat4& projection) {
+    m_projectionMatrix = projection;
+    applyMatrices();
+}
+
+void Renderer::setViewMatrix(const glm::mat4& view) {
+    m_viewMatrix = view;
+    applyMatrices();
+}
+
+void Renderer::setModelMatrix(const glm::mat4& model) {
+    m_modelMatrix = model;
+    applyMatrices();
+}
+
+const glm::mat4& Renderer::getProjectionMatrix() const {
+    return m_projectionMatrix;
+}
+
+const glm::mat4& Renderer::getViewMatrix() const {
+    return m_viewMatrix;
+}
+
+const glm::mat4& Renderer::getModelMatrix() const {
+    return m_modelMatrix;
+}
+
+void Renderer::useShader(std::shared_ptr<Shader> shader) {
+    m_currentShader = std::move(shader);
+    if (m_currentShader) {
+        m_currentShader->use();
+        applyMatrices();
+    }
+}
+
+std::shared_ptr<Shader> Renderer::getCurrentShader() const {
+    return m_currentShader;
+}
+
+void Renderer::setBlockTextures(const BlockTextureArray& textures) {
+    textures.bind(BLOCK_TEXTURE_UNIT);
+}
+
+void Renderer::drawVertexArray(unsigned int vao, unsigned int vertexCount,
+                               unsigned int indexCount, unsigned int offset) {
+    if (indexCount > 0) {
+        drawIndexed(vao, indexCount, offset);
     } else {
-        glDisable(GL_CULL_FACE);
+        drawArrays(vao, vertexCount, offset);
     }
 }
 
-void Renderer::enableDepthTesting(bool enable) {
-    if (enable) {
+void Renderer::drawArrays(unsigned int vao, unsigned int vertexCount, unsigned int offset) {
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, offset, vertexCount);
+    glBindVertexArray(0);
+}
+
+void Renderer::drawIndexed(unsigned int vao, unsigned int indexCount, unsigned int offset) {
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT,
+                   reinterpret_cast<const void*>(offset * sizeof(GLuint)));
+    glBindVertexArray(0);
+}
+
+void Renderer::setDepthTesting(bool enabled) {
+    m_depthTestingEnabled = enabled;
+    if (enabled) {
         glEnable(GL_DEPTH_TEST);
         glDepthFunc(GL_LEQUAL);
     } else {
@@ -258,71 +394,78 @@ void Renderer::enableDepthTesting(bool enable) {
     }
 }
 
-void Renderer::setWireframeMode(bool wireframe) {
-    if (wireframe) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+void Renderer::setBlending(bool enabled) {
+    m_blendingEnabled = enabled;
+    if (enabled) {
+        glEnable(GL_BLEND);
     } else {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glDisable(GL_BLEND);
     }
 }
 
-void Renderer::clear(const glm::vec4& clearColor) {
-    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Renderer::setBlendFunction(unsigned int srcFactor, unsigned int dstFactor) {
+    glBlendFunc(srcFactor, dstFactor);
 }
 
-void Renderer::checkShaderCompilation(GLuint shader, const std::string& type) {
-    GLint success;
-    GLchar infoLog[1024];
-    
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-        std::cerr << "Shader compilation error [" << type << "]: " 
-                  << infoLog << std::endl;
-    }
-}
-
-void Renderer::checkProgramLinking(GLuint program) {
-    GLint success;
-    GLchar infoLog[1024];
-    
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 1024, nullptr, infoLog);
-        std::cerr << "Program linking error: " << infoLog << std::endl;
+void Renderer::setFaceCulling(bool enabled) {
+    m_faceCullingEnabled = enabled;
+    if (enabled) {
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_BACK);
+    } else {
+        glDisable(GL_CULL_FACE);
     }
 }
 
-void Renderer::cleanup() {
-    if (vao != 0) glDeleteVertexArrays(1, &vao);
-    if (vbo != 0) glDeleteBuffers(1, &vbo);
-    if (ebo != 0) glDeleteBuffers(1, &ebo);
-    if (shaderProgram != 0) glDeleteProgram(shaderProgram);
-    
-    std::cout << "Renderer cleanup completed" << std::endl;
+void Renderer::setFrontFace(bool clockwise) {
+    glFrontFace(clockwise ? GL_CW : GL_CCW);
 }
 
-GLuint Renderer::getVAO() const {
-    return vao;
-}
-
-GLuint Renderer::getVBO() const {
-    return vbo;
+void Renderer::setWireframeMode(bool enabled) {
+    m_wireframeMode = enabled;
+    if (enabled) {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    } else {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
 }
 
-GLuint Renderer::getEBO() const {
-    return ebo;
+const char* Renderer::getVersionString() const {
+    return reinterpret_cast<const char*>(glGetString(GL_VERSION));
 }
 
-GLuint Renderer::getShaderProgram() const {
-    return shaderProgram;
+std::string Renderer::getCapabilitiesInfo() const {
+    GLint maxTextureSize = 0;
+    GLint maxArrayLayers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxArrayLayers);
+    
+    std::ostringstream info;
+    info << "Vendor: " << glGetString(GL_VENDOR) << "\n"
+         << "Renderer: " << glGetString(GL_RENDERER) << "\n"
+         << "Version: " << glGetString(GL_VERSION) << "\n"
+         << "GLSL: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << "\n"
+         << "Max texture size: " << maxTextureSize << "\n"
+         << "Max array texture layers: " << maxArrayLayers << "\n";
+    return info.str();
 }
 
-size_t Renderer::getVertexCount() const {
-    return vertexCount;
+void Renderer::applyMatrices() {
+    // No camera buffer exists before initialize()
+    if (m_shaderProgram == 0) {
+        return;
+    }
+    m_cameraUniforms.update(m_viewMatrix, m_projectionMatrix);
+    if (m_currentShader) {
+        m_currentShader->setMat4("model", m_modelMatrix);
+    }
 }
 
-size_t Renderer::getIndexCount() const {
-    return indexCount;
+bool Renderer::validateRenderState() const {
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "OpenGL error 0x" << std::hex << error << std::dec << std::endl;
+        return false;
+    }
+    return m_shaderProgram != 0;
 }
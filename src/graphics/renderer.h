@@ -5,9 +5,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <memory>
-
+#include <string>
+#include "camera_uniforms.h"
+#include "chunk_visibility.h"
+#include "gpu_timer.h"
+#include "profiler_overlay.h"
+
+namespace cppcraft {
+namespace world {
+enum class RenderLayer;
+} // namespace world
+} // namespace cppcraft
+
+class BlockTextureArray;
 class Shader;
-class Texture;
+class ShaderCache;
+
+// Alpha below which cutout texels (leaves, plants) are discarded
+constexpr float CUTOUT_ALPHA_CUTOFF = 0.5f;
 
 /**
  * @class Renderer
@@ -31,6 +46,11 @@ public:
 
     /**
      * @brief Initialize the renderer and OpenGL context.
+     *
+     * Unless a default ShaderCache is already set, installs one in
+     * DEFAULT_SHADER_CACHE_DIRECTORY for all programs built afterwards;
+     * shutdown() removes it again.
+     *
      * @return true if initialization was successful, false otherwise.
      */
     bool initialize();
@@ -42,11 +62,15 @@ public:
 
     /**
      * @brief Begin a new frame for rendering.
+     *
+     * Collects the GPU timings of earlier frames for the profiler.
      */
     void beginFrame();
 
     /**
      * @brief End the current frame and present to screen.
+     *
+     * Draws the profiler overlay on top when it is shown.
      */
     void endFrame();
 
@@ -115,11 +139,10 @@ public:
     std::shared_ptr<Shader> getCurrentShader() const;
 
     /**
-     * @brief Bind a texture for rendering.
-     * @param texture The texture to bind
-     * @param unit The texture unit to bind to (default: 0)
+     * @brief Bind the block texture array used by every chunk draw.
+     * @param textures The block textures, one layer per texture
      */
-    void bindTexture(std::shared_ptr<Texture> texture, unsigned int unit = 0);
+    void setBlockTextures(const BlockTextureArray& textures);
 
     /**
      * @brief Draw a vertex array.
@@ -146,6 +169,45 @@ public:
      */
     void drawIndexed(unsigned int vao, unsigned int indexCount, unsigned int offset = 0);
 
+    /**
+     * @brief Draw every visible chunk section of a world.
+     *
+     * Runs the frustum and occlusion visibility pass, then draws the
+     * surviving section meshes in three passes: opaque front to back, cutout
+     * with an alpha test, and translucent back to front with blending and
+     * depth writes off. With the world's shared chunk buffer each pass is one
+     * glMultiDrawElementsIndirect call, otherwise one draw per section.
+     * @param world The world to draw
+     * @param view The view matrix
+     * @param projection The projection matrix
+     */
+    void renderWorld(const cppcraft::world::World& world, const glm::mat4& view,
+                     const glm::mat4& projection);
+
+    /**
+     * @brief Enable/disable cave-style occlusion culling of chunk sections.
+     * @param enabled true to cull by section connectivity, false for frustum only
+     */
+    void setOcclusionCulling(bool enabled);
+
+    /**
+     * @brief Show/hide the frame profiler overlay drawn by endFrame().
+     * @param visible true to draw per-subsystem CPU and GPU timings
+     */
+    void setProfilerOverlay(bool visible);
+
+    /**
+     * @brief Check if the frame profiler overlay is shown.
+     * @return true if endFrame() draws the overlay
+     */
+    bool isProfilerOverlayVisible() const { return m_profilerOverlayVisible; }
+
+    /**
+     * @brief Get the visible and culled section counts of the last renderWorld().
+     * @return The visibility statistics
+     */
+    const VisibilityStats& getVisibilityStats() const;
+
     /**
      * @brief Enable/disable depth testing.
      * @param enabled true to enable, false to disable
@@ -201,9 +263,13 @@ private:
     glm::mat4 m_viewMatrix;
     glm::mat4 m_modelMatrix;
 
-    // Shader and texture management
+    // Shader management; chunks always draw with the built-in program
     std::shared_ptr<Shader> m_currentShader;
-    std::shared_ptr<Texture> m_currentTexture;
+    unsigned int m_shaderProgram;
+
+    // Program binaries, installed as the default cache unless the
+    // application set one before initialize()
+    std::unique_ptr<ShaderCache> m_shaderCache;
 
     // Render state
     bool m_depthTestingEnabled;
@@ -215,8 +281,52 @@ private:
     int m_viewportWidth;
     int m_viewportHeight;
 
+    // Per-frame chunk section visibility
+    ChunkVisibility m_visibility;
+
+    // Camera block shared by all shaders, uploaded once per frame
+    CameraUniformBuffer m_cameraUniforms;
+
+    // GPU timing of the world passes and the overlay showing all timings
+    GpuTimer m_gpuTimer;
+    ProfilerOverlay m_profilerOverlay;
+    bool m_profilerOverlayVisible;
+
+    // Uniform locations of the built-in shader, resolved after linking
+    int m_chunkOffsetLocation;
+    int m_alphaCutoffLocation;
+
+    /**
+     * @brief Build the built-in chunk shader, which decodes PackedVertex
+     * @return The linked program, or 0 on failure
+     */
+    unsigned int createShaderProgram();
+
+    /**
+     * @brief Bind the built-in shader for chunk draws (zero offset, no alpha cutoff)
+     */
+    void beginChunkPass();
+
+    /**
+     * @brief Draw every section of a chunk with the chunk offset uniform
+     * @param chunk The chunk to draw
+     */
+    void drawChunk(const cppcraft::world::Chunk& chunk);
+
+    /**
+     * @brief Draw one render layer of every visible section
+     * @param world The world being drawn
+     * @param layer The render layer to draw
+     * @param backToFront true to walk the visible list farthest first
+     */
+    void drawLayer(const cppcraft::world::World& world, cppcraft::world::RenderLayer layer,
+                   bool backToFront);
+
     /**
      * @brief Internal method to apply the current matrix stack to the shader.
+     *
+     * View and projection go to the camera block, the model matrix to the
+     * current shader.
      */
     void applyMatrices();
 
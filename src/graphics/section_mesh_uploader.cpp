@@ -0,0 +1,66 @@
+#include "section_mesh_uploader.h"
+#include "quad_index_buffer.h"
+
+using cppcraft::world::PackedVertex;
+using cppcraft::world::SectionMesh;
+
+SectionMeshUploader::SectionMeshUploader(bool sharedBuffer)
+    : m_chunkBuffer(sharedBuffer ? std::make_unique<ChunkBuffer>() : nullptr) {
+}
+
+// Shared ranges have a fixed size, so a rebuilt mesh gets a new one; a
+// section's own buffer is refilled in place
+void SectionMeshUploader::Upload(SectionMesh* mesh, const std::vector<PackedVertex>& vertices) {
+    if (m_chunkBuffer) {
+        if (mesh->built) {
+            Release(mesh);
+        }
+        m_chunkBuffer->upload(vertices, mesh->vertex_offset);
+        mesh->shared_buffer = m_chunkBuffer.get();
+        return;
+    }
+
+    if (!mesh->built) {
+        glGenVertexArrays(1, &mesh->vao);
+        glGenBuffers(1, &mesh->vbo);
+    }
+    glBindVertexArray(mesh->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PackedVertex),
+                 vertices.data(), GL_STATIC_DRAW);
+
+    // Triangles come from the shared quad pattern
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getQuadIndexBuffer());
+
+    // Packed position/face and texture/light words, decoded in the vertex
+    // shader; the chunk origin comes from the chunkOffset uniform
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(PackedVertex), nullptr);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void SectionMeshUploader::Release(SectionMesh* mesh) {
+    if (mesh->shared_buffer) {
+        mesh->shared_buffer->release(mesh->vertex_offset, mesh->vertex_count);
+        mesh->shared_buffer = nullptr;
+        return;
+    }
+    glDeleteBuffers(1, &mesh->vbo);
+    glDeleteVertexArrays(1, &mesh->vao);
+    mesh->vbo = 0;
+    mesh->vao = 0;
+}
+
+void SectionMeshUploader::Draw(const SectionMesh& mesh, size_t firstIndex,
+                               size_t indexCount, const glm::vec3& origin) {
+    if (mesh.shared_buffer) {
+        mesh.shared_buffer->addDraw(mesh.vertex_offset, firstIndex, indexCount, origin);
+        return;
+    }
+
+    glBindVertexArray(mesh.vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                   reinterpret_cast<const void*>(firstIndex * sizeof(GLuint)));
+}
@@ -0,0 +1,53 @@
+#ifndef SECTION_MESH_UPLOADER_H
+#define SECTION_MESH_UPLOADER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "chunk_buffer.h"
+#include "../world/mesh_uploader.h"
+
+/**
+ * @class SectionMeshUploader
+ * @brief Keeps chunk section meshes in OpenGL buffers
+ *
+ * Either every section owns a VAO and vertex buffer, drawn one at a time
+ * with the chunk placed by the chunkOffset uniform, or all sections are
+ * suballocated from one ChunkBuffer and submitted with a single indirect
+ * multi-draw. Both draw their indices from the static quad index buffer.
+ *
+ * To switch storage, create a new uploader and pass it to
+ * World::setMeshUploader(), which releases and rebuilds every mesh.
+ *
+ * Main thread only; the shared buffer needs OpenGL 4.3.
+ */
+class SectionMeshUploader : public cppcraft::world::MeshUploader {
+public:
+    /**
+     * @brief Constructor
+     * @param sharedBuffer true to suballocate meshes from one ChunkBuffer
+     */
+    explicit SectionMeshUploader(bool sharedBuffer = false);
+
+    void Upload(cppcraft::world::SectionMesh* mesh,
+                const std::vector<cppcraft::world::PackedVertex>& vertices) override;
+
+    void Release(cppcraft::world::SectionMesh* mesh) override;
+
+    /**
+     * @brief Draw a range of a section's indices; leaves its VAO bound
+     *
+     * With the shared buffer the range is queued for its next draw() instead.
+     */
+    void Draw(const cppcraft::world::SectionMesh& mesh, size_t firstIndex,
+              size_t indexCount, const glm::vec3& origin) override;
+
+    ChunkBuffer* GetSharedBuffer() const override { return m_chunkBuffer.get(); }
+
+private:
+    // Shared mesh storage, or null if sections own their buffers
+    std::unique_ptr<ChunkBuffer> m_chunkBuffer;
+};
+
+#endif // SECTION_MESH_UPLOADER_H
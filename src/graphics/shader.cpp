@@ -1,4 +1,5 @@
 #include "shader.h"
+#include "shader_cache.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <fstream>
@@ -6,204 +7,71 @@
 #include <iostream>
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
+    : ID(0),
+      stageFiles{ { GL_VERTEX_SHADER, vertexPath }, { GL_FRAGMENT_SHADER, fragmentPath } }
 {
-    // 1. Retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    
-    // Ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    
-    try
-    {
-        // Open files
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        
-        // Read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        
-        // Close file handlers
-        vShaderFile.close();
-        fShaderFile.close();
-        
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch(std::ifstream::failure& e)
-    {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-    }
-    
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    // 2. Compile shaders
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-    
-    // Vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    
-    // Print compile errors if any
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    
-    // Print compile errors if any
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // Shader Program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    
-    // Print linking errors if any
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if(!success)
-    {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    ID = buildProgramFromFiles(stageFiles);
+    cacheUniformLocations();
 }
 
 Shader::Shader(const char* vertexPath, const char* geometryPath, const char* fragmentPath)
+    : ID(0),
+      stageFiles{ { GL_VERTEX_SHADER, vertexPath },
+                  { GL_GEOMETRY_SHADER, geometryPath },
+                  { GL_FRAGMENT_SHADER, fragmentPath } }
 {
-    // 1. Retrieve the vertex/geometry/fragment source code from filePath
-    std::string vertexCode;
-    std::string geometryCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream gShaderFile;
-    std::ifstream fShaderFile;
-    
-    // Ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    
-    try
-    {
-        // Open files
-        vShaderFile.open(vertexPath);
-        gShaderFile.open(geometryPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, gShaderStream, fShaderStream;
-        
-        // Read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        gShaderStream << gShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        
-        // Close file handlers
-        vShaderFile.close();
-        gShaderFile.close();
-        fShaderFile.close();
-        
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        geometryCode = gShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch(std::ifstream::failure& e)
-    {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-    }
-    
-    const char* vShaderCode = vertexCode.c_str();
-    const char* gShaderCode = geometryCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    // 2. Compile shaders
-    unsigned int vertex, geometry, fragment;
-    int success;
-    char infoLog[512];
-    
-    // Vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    
-    // Print compile errors if any
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // Geometry Shader
-    geometry = glCreateShader(GL_GEOMETRY_SHADER);
-    glShaderSource(geometry, 1, &gShaderCode, NULL);
-    glCompileShader(geometry);
-    
-    // Print compile errors if any
-    glGetShaderiv(geometry, GL_COMPILE_STATUS, &success);
-    if(!success)
+    ID = buildProgramFromFiles(stageFiles);
+    cacheUniformLocations();
+}
+
+// Read every stage file and build through the shader cache
+GLuint Shader::buildProgramFromFiles(const std::vector<ShaderStageFile>& files)
+{
+    std::vector<std::string> sources(files.size());
+    std::vector<ShaderStageSource> stages(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
     {
-        glGetShaderInfoLog(geometry, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::GEOMETRY::COMPILATION_FAILED\n" << infoLog << std::endl;
+        if (!readShaderFile(files[i].path, &sources[i]))
+        {
+            return 0;
+        }
+        stages[i] = { files[i].type, sources[i].c_str() };
     }
     
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
+    std::string label = files.empty() ? std::string() : files.front().path;
+    return buildShaderProgram(stages.data(), stages.size(), label.c_str());
+}
+
+// Swap in a rebuilt program and restore what belongs to the shader, not the program
+void Shader::replaceProgram(GLuint program)
+{
+    glDeleteProgram(ID);
+    ID = program;
+    cacheUniformLocations();
     
-    // Print compile errors if any
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if(!success)
+    for (const auto& block : uniformBlockBindings)
     {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        GLuint index = glGetUniformBlockIndex(ID, block.first.c_str());
+        if (index != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(ID, index, block.second);
+        }
     }
-    
-    // Shader Program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, geometry);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    
-    // Print linking errors if any
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if(!success)
+}
+
+bool Shader::readShaderFile(const std::string& filePath, std::string* source)
+{
+    std::ifstream file(filePath);
+    if (!file)
     {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filePath << std::endl;
+        return false;
     }
     
-    // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(geometry);
-    glDeleteShader(fragment);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    *source = stream.str();
+    return true;
 }
 
 Shader::~Shader()
@@ -219,60 +87,148 @@ void Shader::use() const
 // Utility uniform functions
 void Shader::setBool(const std::string &name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(getUniformLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string &name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
 
 void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform2fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setVec2(const std::string &name, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(getUniformLocation(name), x, y);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform3fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setVec3(const std::string &name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(getUniformLocation(name), x, y, z);
 }
 
 void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
 {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform4fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
 {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 
 void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+// Cached uniform lookups
+GLint Shader::getUniformLocation(const std::string &name) const
+{
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+void Shader::setInt(GLint location, int value) const
+{
+    glUniform1i(location, value);
+}
+
+void Shader::setFloat(GLint location, float value) const
+{
+    glUniform1f(location, value);
+}
+
+void Shader::setVec3(GLint location, const glm::vec3 &value) const
+{
+    glUniform3fv(location, 1, &value[0]);
+}
+
+void Shader::setVec4(GLint location, const glm::vec4 &value) const
+{
+    glUniform4fv(location, 1, &value[0]);
+}
+
+void Shader::setMat3(GLint location, const glm::mat3 &mat) const
+{
+    glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat4(GLint location, const glm::mat4 &mat) const
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+bool Shader::bindUniformBlock(const char* blockName, GLuint binding)
+{
+    uniformBlockBindings[blockName] = binding;
+    GLuint index = glGetUniformBlockIndex(ID, blockName);
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    glUniformBlockBinding(ID, index, binding);
+    return true;
+}
+
+// Query every active uniform once; arrays are reachable as "name" and "name[0]"
+void Shader::cacheUniformLocations()
+{
+    uniformLocations.clear();
+    if (ID == 0)
+    {
+        return;
+    }
+    
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    
+    std::string name(maxLength > 0 ? maxLength : 1, '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, &name[0]);
+        
+        std::string uniformName(name.data(), length);
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        
+        // Members of uniform blocks have no location
+        if (location < 0)
+        {
+            continue;
+        }
+        
+        uniformLocations[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+        {
+            uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+        }
+    }
 }
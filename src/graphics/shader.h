@@ -2,15 +2,36 @@
 #define SHADER_H
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+/**
+ * @struct ShaderStageFile
+ * @brief Source file of one program stage
+ */
+struct ShaderStageFile {
+    GLenum type;
+    std::string path;
+};
+
 /**
  * @class Shader
  * @brief Manages OpenGL shader programs for rendering
  * 
  * Provides functionality to compile, link, and manage vertex and fragment shaders.
  * Supports setting uniforms and managing the active shader program.
+ *
+ * Uniform locations are queried once after linking and cached, so no setter
+ * calls glGetUniformLocation. Draw loops should look up a location once with
+ * getUniformLocation() and use the location overloads of the setters, which
+ * skip the name lookup entirely.
+ *
+ * Programs are built through the default ShaderCache, so a later launch on
+ * the same driver loads the linked binary instead of compiling. The stage
+ * files are remembered, and a ShaderReloader can rebuild them in the
+ * background and swap the new program in with replaceProgram().
  */
 class Shader
 {
@@ -22,6 +43,14 @@ public:
      */
     Shader(const char* vertexPath, const char* fragmentPath);
 
+    /**
+     * @brief Constructor - creates and links a shader program with a geometry stage
+     * @param vertexPath Path to the vertex shader source file
+     * @param geometryPath Path to the geometry shader source file
+     * @param fragmentPath Path to the fragment shader source file
+     */
+    Shader(const char* vertexPath, const char* geometryPath, const char* fragmentPath);
+
     /**
      * @brief Destructor - deletes the shader program
      */
@@ -122,6 +151,90 @@ public:
      */
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    /**
+     * @brief Gets the cached location of a uniform
+     * @param name The name of the uniform variable
+     * @return The location, or -1 if the program has no such active uniform
+     */
+    GLint getUniformLocation(const std::string& name) const;
+
+    /**
+     * @brief Sets an integer uniform by location
+     * @param location A location from getUniformLocation()
+     * @param value The integer value to set
+     */
+    void setInt(GLint location, int value) const;
+
+    /**
+     * @brief Sets a float uniform by location
+     * @param location A location from getUniformLocation()
+     * @param value The float value to set
+     */
+    void setFloat(GLint location, float value) const;
+
+    /**
+     * @brief Sets a vec3 uniform by location
+     * @param location A location from getUniformLocation()
+     * @param value The glm::vec3 value to set
+     */
+    void setVec3(GLint location, const glm::vec3& value) const;
+
+    /**
+     * @brief Sets a vec4 uniform by location
+     * @param location A location from getUniformLocation()
+     * @param value The glm::vec4 value to set
+     */
+    void setVec4(GLint location, const glm::vec4& value) const;
+
+    /**
+     * @brief Sets a mat3 uniform by location
+     * @param location A location from getUniformLocation()
+     * @param mat The glm::mat3 matrix to set
+     */
+    void setMat3(GLint location, const glm::mat3& mat) const;
+
+    /**
+     * @brief Sets a mat4 uniform by location
+     * @param location A location from getUniformLocation()
+     * @param mat The glm::mat4 matrix to set
+     */
+    void setMat4(GLint location, const glm::mat4& mat) const;
+
+    /**
+     * @brief Connects a uniform block to a uniform buffer binding point
+     * @param blockName The name of the uniform block in the shader
+     * @param binding The binding point the buffer is bound to
+     * @return false if the program has no such uniform block
+     */
+    bool bindUniformBlock(const char* blockName, GLuint binding);
+
+    /**
+     * @brief Reads stage files and builds a new program from them
+     *
+     * Any thread with a current GL context sharing objects with the render
+     * context may call it.
+     *
+     * @param files Stage source files in attach order
+     * @return The linked program, or 0 if a file is unreadable or the build failed
+     */
+    static GLuint buildProgramFromFiles(const std::vector<ShaderStageFile>& files);
+
+    /**
+     * @brief Replaces the program with a newly built one
+     *
+     * The old program is deleted, uniform locations are queried again and
+     * uniform blocks are bound to the same binding points as before. Other
+     * uniform values start over at their defaults and must be set again.
+     *
+     * @param program A linked program built from getStageFiles()
+     */
+    void replaceProgram(GLuint program);
+
+    /**
+     * @brief Gets the source files the program is built from
+     */
+    const std::vector<ShaderStageFile>& getStageFiles() const { return stageFiles; }
+
     /**
      * @brief Gets the shader program ID
      * @return The OpenGL shader program ID
@@ -131,28 +244,27 @@ public:
 private:
     GLuint ID;
 
+    // Active uniform name -> location, filled once after linking
+    std::unordered_map<std::string, GLint> uniformLocations;
+
+    // Stage source files in attach order
+    std::vector<ShaderStageFile> stageFiles;
+
+    // Uniform block name -> binding point, reapplied when the program is replaced
+    std::unordered_map<std::string, GLuint> uniformBlockBindings;
+
     /**
-     * @brief Compiles a shader from source code
-     * @param source The shader source code
-     * @param shaderType The type of shader (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)
-     * @return The compiled shader ID
+     * @brief Queries and caches the locations of all active uniforms
      */
-    GLuint compileShader(const std::string& source, GLenum shaderType) const;
+    void cacheUniformLocations();
 
     /**
      * @brief Reads shader source code from a file
      * @param filePath Path to the shader file
-     * @return The shader source code as a string
-     */
-    std::string readShaderFile(const char* filePath) const;
-
-    /**
-     * @brief Links vertex and fragment shaders into a program
-     * @param vertexShader The compiled vertex shader ID
-     * @param fragmentShader The compiled fragment shader ID
-     * @return The linked shader program ID
+     * @param source Receives the shader source code
+     * @return false if the file could not be read
      */
-    GLuint linkProgram(GLuint vertexShader, GLuint fragmentShader) const;
+    static bool readShaderFile(const std::string& filePath, std::string* source);
 };
 
 #endif // SHADER_H
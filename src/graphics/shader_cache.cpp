@@ -0,0 +1,269 @@
+#include "shader_cache.h"
+#include "../core/profiler.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+// "CCPB" and the layout of BinaryHeader; bump the version when it changes
+const uint32_t BINARY_MAGIC = 0x42504343u;
+const uint32_t BINARY_VERSION = 1;
+
+// Written in native byte order; the cache never leaves the machine
+struct BinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+std::atomic<ShaderCache*> g_defaultCache{ nullptr };
+
+// FNV-1a over a byte range
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+uint64_t hashString(uint64_t hash, const char* text) {
+    if (text == nullptr) {
+        text = "";
+    }
+    // Include the terminator so adjacent strings cannot run together
+    return hashBytes(hash, text, std::char_traits<char>::length(text) + 1);
+}
+
+// Key of a program: the driver that compiles it and every stage's source
+uint64_t programKey(const ShaderStageSource* stages, size_t count) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t type = stages[i].type;
+        hash = hashBytes(hash, &type, sizeof(type));
+        hash = hashString(hash, stages[i].source);
+    }
+    return hash;
+}
+
+// Check whether the current context can save and load program binaries
+bool isProgramBinarySupported() {
+#ifdef GL_NUM_PROGRAM_BINARY_FORMATS
+    if (glGetProgramBinary == nullptr || glProgramBinary == nullptr) {
+        return false;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+#else
+    return false;
+#endif
+}
+
+bool isProgramLinked(GLuint program) {
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success != 0;
+}
+
+} // namespace
+
+// Constructor
+ShaderCache::ShaderCache(const std::string& directory)
+    : m_directory(directory), m_hits(0), m_misses(0) {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "Shader cache directory " << m_directory << " unavailable: "
+                  << error.message() << std::endl;
+    }
+}
+
+// Load a cached program or build it from source
+GLuint ShaderCache::buildProgram(const ShaderStageSource* stages, size_t count,
+                                 const char* label) {
+    PROFILE_SCOPE("shader.build");
+
+    if (!isProgramBinarySupported()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return compileShaderProgram(stages, count, label, false);
+    }
+
+    uint64_t key = programKey(stages, count);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    std::string path = m_directory + "/" + name;
+
+    if (GLuint program = loadBinary(path, key)) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return program;
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    GLuint program = compileShaderProgram(stages, count, label, true);
+    if (program != 0) {
+        saveBinary(path, key, program);
+    }
+    return program;
+}
+
+// Set the cache used by buildShaderProgram()
+void ShaderCache::setDefault(ShaderCache* cache) {
+    g_defaultCache.store(cache, std::memory_order_release);
+}
+
+// Get the cache used by buildShaderProgram()
+ShaderCache* ShaderCache::getDefault() {
+    return g_defaultCache.load(std::memory_order_acquire);
+}
+
+// Load a saved binary into a new program
+GLuint ShaderCache::loadBinary(const std::string& path, uint64_t key) const {
+#ifdef GL_NUM_PROGRAM_BINARY_FORMATS
+    std::ifstream file(path, std::ios::binary);
+    BinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != BINARY_MAGIC || header.version != BINARY_VERSION ||
+        header.key != key || header.length == 0) {
+        return 0;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) {
+        return 0;
+    }
+
+    // A driver update may reject old binaries; the caller recompiles then
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    if (!isProgramLinked(program)) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+#else
+    (void)path;
+    (void)key;
+    return 0;
+#endif
+}
+
+// Save a linked program's binary through a temporary file, so a crash
+// mid-write never leaves a truncated binary under the real name
+void ShaderCache::saveBinary(const std::string& path, uint64_t key, GLuint program) const {
+#ifdef GL_NUM_PROGRAM_BINARY_FORMATS
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    BinaryHeader header;
+    header.magic = BINARY_MAGIC;
+    header.version = BINARY_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::remove(temporaryPath.c_str());
+    }
+#else
+    (void)path;
+    (void)key;
+    (void)program;
+#endif
+}
+
+// Build a program through the default cache, or from source
+GLuint buildShaderProgram(const ShaderStageSource* stages, size_t count, const char* label) {
+    if (ShaderCache* cache = ShaderCache::getDefault()) {
+        return cache->buildProgram(stages, count, label);
+    }
+    return compileShaderProgram(stages, count, label, false);
+}
+
+// Compile every stage, then link; nothing is left behind on failure
+GLuint compileShaderProgram(const ShaderStageSource* stages, size_t count, const char* label,
+                            bool retrievable) {
+    GLchar infoLog[1024];
+    std::vector<GLuint> shaders;
+    shaders.reserve(count);
+
+    bool compiled = true;
+    for (size_t i = 0; i < count && compiled; ++i) {
+        GLuint shader = glCreateShader(stages[i].type);
+        glShaderSource(shader, 1, &stages[i].source, nullptr);
+        glCompileShader(shader);
+        shaders.push_back(shader);
+
+        GLint success = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << "Shader compilation error [" << label << ", stage " << i << "]: "
+                      << infoLog << std::endl;
+            compiled = false;
+        }
+    }
+
+    GLuint program = 0;
+    if (compiled) {
+        program = glCreateProgram();
+#ifdef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+        if (retrievable) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+#else
+        (void)retrievable;
+#endif
+        for (GLuint shader : shaders) {
+            glAttachShader(program, shader);
+        }
+        glLinkProgram(program);
+        for (GLuint shader : shaders) {
+            glDetachShader(program, shader);
+        }
+
+        if (!isProgramLinked(program)) {
+            glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << "Program linking error [" << label << "]: " << infoLog << std::endl;
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    for (GLuint shader : shaders) {
+        glDeleteShader(shader);
+    }
+    return program;
+}
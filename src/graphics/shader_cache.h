@@ -0,0 +1,116 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <glad/glad.h>
+
+// Directory the renderer keeps program binaries in, relative to the
+// working directory
+constexpr const char* DEFAULT_SHADER_CACHE_DIRECTORY = "shader_cache";
+
+/**
+ * @struct ShaderStageSource
+ * @brief GLSL source of one program stage
+ */
+struct ShaderStageSource {
+    GLenum type;
+    const char* source;
+};
+
+/**
+ * @class ShaderCache
+ * @brief Directory of linked program binaries for faster startup
+ *
+ * buildProgram() hashes the stage sources together with the GL vendor,
+ * renderer and version strings and loads the binary saved under that key
+ * with glProgramBinary. On a miss, or when the driver rejects the binary
+ * (drivers may after an update), the program is compiled and linked from
+ * source and its binary saved for the next launch. Without program binary
+ * support (GL 4.1 or ARB_get_program_binary, and at least one binary
+ * format) every build compiles from source.
+ *
+ * Any thread with a current GL context may build programs; hot reload
+ * builds on a background context.
+ */
+class ShaderCache {
+public:
+    /**
+     * @brief Use a directory for program binaries, creating it if missing
+     * @param directory Cache directory
+     */
+    explicit ShaderCache(const std::string& directory);
+
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    /**
+     * @brief Load a cached program or build it from source
+     * @param stages Stage sources in attach order
+     * @param count Number of stages
+     * @param label Name used in error messages
+     * @return The linked program, or 0 if compiling or linking failed
+     */
+    GLuint buildProgram(const ShaderStageSource* stages, size_t count, const char* label);
+
+    /**
+     * @brief Get the cache directory
+     */
+    const std::string& getDirectory() const { return m_directory; }
+
+    /**
+     * @brief Get the number of programs loaded from a binary and built from source
+     */
+    size_t getHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    size_t getMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the cache used by buildShaderProgram(); null disables caching
+     */
+    static void setDefault(ShaderCache* cache);
+
+    /**
+     * @brief Get the cache used by buildShaderProgram(), or null
+     */
+    static ShaderCache* getDefault();
+
+private:
+    /**
+     * @brief Load a saved binary into a new program
+     * @return The linked program, or 0 if there is no usable binary
+     */
+    GLuint loadBinary(const std::string& path, uint64_t key) const;
+
+    /**
+     * @brief Save a linked program's binary, replacing any previous file
+     */
+    void saveBinary(const std::string& path, uint64_t key, GLuint program) const;
+
+    std::string m_directory;
+    std::atomic<size_t> m_hits;
+    std::atomic<size_t> m_misses;
+};
+
+/**
+ * @brief Build a program through the default cache, or from source if none is set
+ * @param stages Stage sources in attach order
+ * @param count Number of stages
+ * @param label Name used in error messages
+ * @return The linked program, or 0 if compiling or linking failed
+ */
+GLuint buildShaderProgram(const ShaderStageSource* stages, size_t count, const char* label);
+
+/**
+ * @brief Compile and link a program from source, logging any errors
+ * @param stages Stage sources in attach order
+ * @param count Number of stages
+ * @param label Name used in error messages
+ * @param retrievable Ask the driver to keep the binary for glGetProgramBinary
+ * @return The linked program, or 0 if compiling or linking failed
+ */
+GLuint compileShaderProgram(const ShaderStageSource* stages, size_t count, const char* label,
+                            bool retrievable);
+
+#endif // SHADER_CACHE_H
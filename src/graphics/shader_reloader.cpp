@@ -0,0 +1,163 @@
+#include "shader_reloader.h"
+#include "../core/profiler.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+// Constructor
+ShaderReloader::ShaderReloader(GLFWwindow* context)
+    : m_context(context),
+      m_nextId(1),
+      m_nextPoll(std::chrono::steady_clock::now()),
+      m_stopping(false),
+      m_worker(&ShaderReloader::workerLoop, this) {}
+
+// Destructor
+ShaderReloader::~ShaderReloader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_requests.clear();
+    }
+    m_requestReady.notify_all();
+    m_worker.join();
+
+    // Programs are shared with the render context, which is current here
+    for (const Built& built : m_built) {
+        glDeleteSync(built.fence);
+        glDeleteProgram(built.program);
+    }
+}
+
+// Start watching a shader's stage files
+void ShaderReloader::watch(Shader* shader) {
+    unwatch(shader);
+    m_watched.push_back({ shader, m_nextId++, getWriteTimes(*shader) });
+}
+
+// Stop watching a shader
+void ShaderReloader::unwatch(Shader* shader) {
+    m_watched.erase(std::remove_if(m_watched.begin(), m_watched.end(),
+                                   [shader](const Watched& watched) {
+                                       return watched.shader == shader;
+                                   }),
+                    m_watched.end());
+}
+
+// Rebuild a watched shader now
+void ShaderReloader::reload(Shader* shader) {
+    for (const Watched& watched : m_watched) {
+        if (watched.shader == shader) {
+            queueRebuild(watched);
+        }
+    }
+}
+
+// Queue rebuilds of changed shaders and swap in finished ones
+void ShaderReloader::update() {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= m_nextPoll) {
+        m_nextPoll = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(SHADER_RELOAD_POLL_SECONDS));
+        for (Watched& watched : m_watched) {
+            std::vector<std::filesystem::file_time_type> writeTimes = getWriteTimes(*watched.shader);
+            if (writeTimes != watched.writeTimes) {
+                watched.writeTimes = std::move(writeTimes);
+                queueRebuild(watched);
+            }
+        }
+    }
+
+    std::vector<Built> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_built.empty()) {
+            return;
+        }
+
+        // Keep programs the driver is still building for a later frame
+        auto pending = std::partition(m_built.begin(), m_built.end(), [](const Built& built) {
+            GLenum status = glClientWaitSync(built.fence, 0, 0);
+            return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+        });
+        finished.assign(m_built.begin(), pending);
+        m_built.erase(m_built.begin(), pending);
+    }
+
+    for (const Built& built : finished) {
+        glDeleteSync(built.fence);
+        if (Watched* watched = findWatched(built.id)) {
+            watched->shader->replaceProgram(built.program);
+            std::cout << "Reloaded shader " << watched->shader->getStageFiles().front().path
+                      << std::endl;
+        } else {
+            glDeleteProgram(built.program);
+        }
+    }
+}
+
+// Read and build requested shaders on the background context
+void ShaderReloader::workerLoop() {
+    cppcraft::core::Profiler::Get().SetThreadName("shader reloader");
+    glfwMakeContextCurrent(m_context);
+
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestReady.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) {
+                break;
+            }
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        GLuint program = Shader::buildProgramFromFiles(request.files);
+        if (program == 0) {
+            std::cerr << "Shader reload failed, keeping the previous program: "
+                      << request.files.front().path << std::endl;
+            continue;
+        }
+
+        // Flushed so the fence, and the build before it, reach the driver
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_built.push_back({ request.id, program, fence });
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+// Hand a shader's files to the worker
+void ShaderReloader::queueRebuild(const Watched& watched) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back({ watched.id, watched.shader->getStageFiles() });
+    }
+    m_requestReady.notify_one();
+}
+
+ShaderReloader::Watched* ShaderReloader::findWatched(uint64_t id) {
+    for (Watched& watched : m_watched) {
+        if (watched.id == id) {
+            return &watched;
+        }
+    }
+    return nullptr;
+}
+
+// Last write time of every stage file; unreadable files read as the epoch
+std::vector<std::filesystem::file_time_type> ShaderReloader::getWriteTimes(const Shader& shader) {
+    std::vector<std::filesystem::file_time_type> writeTimes;
+    for (const ShaderStageFile& file : shader.getStageFiles()) {
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(file.path, error);
+        writeTimes.push_back(error ? std::filesystem::file_time_type() : time);
+    }
+    return writeTimes;
+}
@@ -0,0 +1,115 @@
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+#include <glad/glad.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "shader.h"
+
+struct GLFWwindow;
+
+// Seconds between checks of the watched shaders' file times
+constexpr double SHADER_RELOAD_POLL_SECONDS = 0.5;
+
+/**
+ * @class ShaderReloader
+ * @brief Rebuilds edited shaders on a background GL context
+ *
+ * update() compares the watched shaders' stage file times every
+ * SHADER_RELOAD_POLL_SECONDS. When one changed, a worker thread with its
+ * own context reads and builds the program through the shader cache, so the
+ * new binary is saved as well. The frame never waits on the compiler: a
+ * later update() swaps the program in once its fence shows the driver has
+ * finished with it. A shader that fails to build keeps its old program.
+ */
+class ShaderReloader {
+public:
+    /**
+     * @brief Constructor - starts the worker thread
+     * @param context Hidden window created with the render window as its share
+     *        parameter; current on the worker thread from now on
+     */
+    explicit ShaderReloader(GLFWwindow* context);
+
+    /**
+     * @brief Destructor - stops the worker and drops unapplied programs
+     */
+    ~ShaderReloader();
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    /**
+     * @brief Start watching a shader's stage files
+     * @param shader Must stay alive until unwatch() or destruction
+     */
+    void watch(Shader* shader);
+
+    /**
+     * @brief Stop watching a shader; rebuilds still in flight are discarded
+     */
+    void unwatch(Shader* shader);
+
+    /**
+     * @brief Rebuild a watched shader now, changed or not
+     */
+    void reload(Shader* shader);
+
+    /**
+     * @brief Queue rebuilds of changed shaders and swap in finished ones
+     *
+     * Call once per frame on the render thread.
+     */
+    void update();
+
+private:
+    struct Watched {
+        Shader* shader;
+        uint64_t id;
+        std::vector<std::filesystem::file_time_type> writeTimes;
+    };
+
+    struct Request {
+        uint64_t id;
+        std::vector<ShaderStageFile> files;
+    };
+
+    struct Built {
+        uint64_t id;
+        GLuint program;
+        GLsync fence;
+    };
+
+    void workerLoop();
+
+    void queueRebuild(const Watched& watched);
+
+    Watched* findWatched(uint64_t id);
+
+    static std::vector<std::filesystem::file_time_type> getWriteTimes(const Shader& shader);
+
+    GLFWwindow* m_context;
+
+    // Render thread only; ids keep a rebuild from reaching a shader watched
+    // again at the address of an unwatched one
+    std::vector<Watched> m_watched;
+    uint64_t m_nextId;
+    std::chrono::steady_clock::time_point m_nextPoll;
+
+    // Shared with the worker
+    std::mutex m_mutex;
+    std::condition_variable m_requestReady;
+    std::deque<Request> m_requests;
+    std::vector<Built> m_built;
+    bool m_stopping;
+
+    std::thread m_worker;
+};
+
+#endif // SHADER_RELOADER_H
@@ -1,16 +1,13 @@
 #include "input_handler.h"
 #include <iostream>
-#include <algorithm>
+
+using cppcraft::input::InputEvent;
+using cppcraft::input::InputEventType;
 
 InputHandler::InputHandler()
     : m_isRunning(true),
-      m_mouseX(0),
-      m_mouseY(0),
-      m_mousePressed(false),
       m_scrollDelta(0)
 {
-    // Initialize key states
-    std::fill(m_keyStates.begin(), m_keyStates.end(), false);
 }
 
 InputHandler::~InputHandler()
@@ -34,81 +31,99 @@ bool InputHandler::initialize()
 void InputHandler::cleanup()
 {
     m_isRunning = false;
-    m_keyStates.fill(false);
+    m_tracker.Reset();
 }
 
+// Drain the events queued since the last tick into a new snapshot; called
+// once per simulation tick on the simulation thread
 void InputHandler::processInput()
 {
-    // Process all pending input events
-    // This will be called each frame to handle keyboard, mouse, and other input
+    const cppcraft::input::InputSnapshot& snapshot = m_tracker.Update(&m_events);
+    m_scrollDelta = static_cast<int>(snapshot.GetScrollDelta());
 }
 
+// The handlers below run on the thread polling the window and only queue
+// the event; state changes once the simulation thread drains the queue
+
 void InputHandler::handleKeyDown(int keyCode)
 {
-    if (keyCode >= 0 && keyCode < static_cast<int>(m_keyStates.size())) {
-        m_keyStates[keyCode] = true;
-    }
+    InputEvent event;
+    event.type = InputEventType::KEY_DOWN;
+    event.code = keyCode;
+    m_events.Push(event);
 }
 
 void InputHandler::handleKeyUp(int keyCode)
 {
-    if (keyCode >= 0 && keyCode < static_cast<int>(m_keyStates.size())) {
-        m_keyStates[keyCode] = false;
-    }
+    InputEvent event;
+    event.type = InputEventType::KEY_UP;
+    event.code = keyCode;
+    m_events.Push(event);
 }
 
 void InputHandler::handleMouseMove(int x, int y)
 {
-    m_mouseX = x;
-    m_mouseY = y;
+    InputEvent event;
+    event.type = InputEventType::MOUSE_MOVE;
+    event.x = static_cast<float>(x);
+    event.y = static_cast<float>(y);
+    m_events.Push(event);
 }
 
 void InputHandler::handleMouseDown(int button)
 {
-    if (button == 0) { // Left mouse button
-        m_mousePressed = true;
-    }
+    InputEvent event;
+    event.type = InputEventType::MOUSE_DOWN;
+    event.code = button;
+    m_events.Push(event);
 }
 
 void InputHandler::handleMouseUp(int button)
 {
-    if (button == 0) { // Left mouse button
-        m_mousePressed = false;
-    }
+    InputEvent event;
+    event.type = InputEventType::MOUSE_UP;
+    event.code = button;
+    m_events.Push(event);
 }
 
 void InputHandler::handleMouseScroll(int delta)
 {
-    m_scrollDelta = delta;
+    InputEvent event;
+    event.type = InputEventType::MOUSE_SCROLL;
+    event.y = static_cast<float>(delta);
+    m_events.Push(event);
+}
+
+// Input as of the current tick, unchanged until the next processInput()
+const cppcraft::input::InputSnapshot& InputHandler::getSnapshot() const
+{
+    return m_tracker.GetSnapshot();
 }
 
 bool InputHandler::isKeyPressed(int keyCode) const
 {
-    if (keyCode >= 0 && keyCode < static_cast<int>(m_keyStates.size())) {
-        return m_keyStates[keyCode];
-    }
-    return false;
+    return getSnapshot().IsKeyHeld(keyCode);
 }
 
 bool InputHandler::isMousePressed() const
 {
-    return m_mousePressed;
+    return getSnapshot().IsButtonHeld(0); // Left mouse button
 }
 
 void InputHandler::getMousePosition(int& x, int& y) const
 {
-    x = m_mouseX;
-    y = m_mouseY;
+    x = getMouseX();
+    y = getMouseY();
 }
 
 int InputHandler::getMouseX() const
 {
-    return m_mouseX;
+    return static_cast<int>(getSnapshot().GetMouseX());
 }
 
 int InputHandler::getMouseY() const
 {
-    return m_mouseY;
+    return static_cast<int>(getSnapshot().GetMouseY());
 }
 
 int InputHandler::getScrollDelta() const
@@ -123,8 +138,7 @@ void InputHandler::clearScrollDelta()
 
 void InputHandler::resetInputState()
 {
-    std::fill(m_keyStates.begin(), m_keyStates.end(), false);
-    m_mousePressed = false;
+    m_tracker.Reset();
     m_scrollDelta = 0;
 }
 
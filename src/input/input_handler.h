@@ -1,83 +1,17 @@
 #ifndef INPUT_HANDLER_H
 #define INPUT_HANDLER_H
 
-#include <unordered_map>
-#include <vector>
-#include <functional>
-#include <glm/glm.hpp>
-
-/**
- * @brief Enumeration for keyboard keys
- */
-enum class Key {
-    // Letter keys
-    A, B, C, D, E, F, G, H, I, J, K, L, M,
-    N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
-    
-    // Number keys
-    NUM_0, NUM_1, NUM_2, NUM_3, NUM_4,
-    NUM_5, NUM_6, NUM_7, NUM_8, NUM_9,
-    
-    // Function keys
-    F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
-    
-    // Special keys
-    ESCAPE, ENTER, TAB, BACKSPACE, SPACE,
-    SHIFT, CTRL, ALT,
-    ARROW_UP, ARROW_DOWN, ARROW_LEFT, ARROW_RIGHT,
-    HOME, END, PAGE_UP, PAGE_DOWN,
-    DELETE, INSERT,
-    
-    // Unknown key
-    UNKNOWN
-};
-
-/**
- * @brief Enumeration for mouse buttons
- */
-enum class MouseButton {
-    LEFT,
-    RIGHT,
-    MIDDLE,
-    UNKNOWN
-};
-
-/**
- * @brief Enumeration for input action types
- */
-enum class InputAction {
-    PRESSED,
-    RELEASED,
-    HELD
-};
-
-/**
- * @brief Callback function type for keyboard events
- */
-using KeyCallback = std::function<void(Key, InputAction)>;
-
-/**
- * @brief Callback function type for mouse movement events
- */
-using MouseMovementCallback = std::function<void(const glm::vec2&)>;
-
-/**
- * @brief Callback function type for mouse button events
- */
-using MouseButtonCallback = std::function<void(MouseButton, InputAction)>;
-
-/**
- * @brief Callback function type for mouse scroll events
- */
-using MouseScrollCallback = std::function<void(float)>;
+#include "input_queue.h"
 
 /**
  * @class InputHandler
  * @brief Handles keyboard and mouse input for the Cppcraft-2 application
- * 
- * This class manages all input events from the keyboard and mouse,
- * maintains the state of keys and buttons, and provides mechanisms
- * for registering and triggering callbacks.
+ *
+ * The window's event callbacks push raw events through the handle*()
+ * methods, which only queue them; processInput() drains the queue once per
+ * simulation tick into a snapshot that stays fixed for the whole tick, so
+ * the game reads one consistent view of input however many events arrive
+ * while it runs.
  */
 class InputHandler {
 public:
@@ -85,215 +19,140 @@ public:
      * @brief Constructor
      */
     InputHandler();
-    
+
     /**
      * @brief Destructor
      */
     ~InputHandler();
-    
+
     /**
      * @brief Initialize the input handler
      * @return true if initialization was successful, false otherwise
      */
     bool initialize();
-    
-    /**
-     * @brief Shutdown the input handler
-     */
-    void shutdown();
-    
-    /**
-     * @brief Update input states (called once per frame)
-     */
-    void update();
-    
-    // ==================== Keyboard Methods ====================
-    
-    /**
-     * @brief Register a keyboard callback
-     * @param key The key to listen for
-     * @param callback The callback function to invoke
-     * @return The ID of the registered callback for later removal
-     */
-    int registerKeyCallback(Key key, const KeyCallback& callback);
-    
+
     /**
-     * @brief Unregister a keyboard callback
-     * @param key The key to stop listening for
-     * @param callbackId The ID of the callback to remove
+     * @brief Stop handling input and release every held key and button
      */
-    void unregisterKeyCallback(Key key, int callbackId);
-    
+    void cleanup();
+
     /**
-     * @brief Check if a key is currently pressed
-     * @param key The key to check
-     * @return true if the key is pressed, false otherwise
+     * @brief Drain the queued events into a new snapshot
+     *
+     * Call once per simulation tick, on the simulation thread.
      */
-    bool isKeyPressed(Key key) const;
-    
+    void processInput();
+
+    // ==================== Event Methods ====================
+    // Called from the thread polling the window; each only queues the event
+
     /**
-     * @brief Check if a key is currently held down
-     * @param key The key to check
-     * @return true if the key is held, false otherwise
+     * @brief Queue a key press
+     * @param keyCode Key code, below cppcraft::input::KEY_CODE_COUNT
      */
-    bool isKeyHeld(Key key) const;
-    
+    void handleKeyDown(int keyCode);
+
     /**
-     * @brief Check if a key was released
-     * @param key The key to check
-     * @return true if the key was released, false otherwise
+     * @brief Queue a key release
+     * @param keyCode Key code, below cppcraft::input::KEY_CODE_COUNT
      */
-    bool isKeyReleased(Key key) const;
-    
+    void handleKeyUp(int keyCode);
+
     /**
-     * @brief Get all currently pressed keys
-     * @return Vector of currently pressed keys
+     * @brief Queue a mouse movement
+     * @param x Cursor x in screen coordinates
+     * @param y Cursor y in screen coordinates
      */
-    std::vector<Key> getPressedKeys() const;
-    
-    // ==================== Mouse Methods ====================
-    
+    void handleMouseMove(int x, int y);
+
     /**
-     * @brief Register a mouse movement callback
-     * @param callback The callback function to invoke
-     * @return The ID of the registered callback for later removal
+     * @brief Queue a mouse button press
+     * @param button Button index, 0 for the left button
      */
-    int registerMouseMovementCallback(const MouseMovementCallback& callback);
-    
+    void handleMouseDown(int button);
+
     /**
-     * @brief Unregister a mouse movement callback
-     * @param callbackId The ID of the callback to remove
+     * @brief Queue a mouse button release
+     * @param button Button index, 0 for the left button
      */
-    void unregisterMouseMovementCallback(int callbackId);
-    
+    void handleMouseUp(int button);
+
     /**
-     * @brief Register a mouse button callback
-     * @param button The mouse button to listen for
-     * @param callback The callback function to invoke
-     * @return The ID of the registered callback for later removal
+     * @brief Queue a scroll wheel movement
+     * @param delta Scroll steps, positive away from the user
      */
-    int registerMouseButtonCallback(MouseButton button, const MouseButtonCallback& callback);
-    
+    void handleMouseScroll(int delta);
+
+    // ==================== State Methods ====================
+    // Read the snapshot of the last processInput()
+
     /**
-     * @brief Unregister a mouse button callback
-     * @param button The mouse button to stop listening for
-     * @param callbackId The ID of the callback to remove
+     * @brief Get the input as of the current tick
+     * @return Snapshot, unchanged until the next processInput()
      */
-    void unregisterMouseButtonCallback(MouseButton button, int callbackId);
-    
+    const cppcraft::input::InputSnapshot& getSnapshot() const;
+
     /**
-     * @brief Register a mouse scroll callback
-     * @param callback The callback function to invoke
-     * @return The ID of the registered callback for later removal
+     * @brief Check if a key is held
+     * @param keyCode Key code to check
+     * @return true if the key is held, false otherwise
      */
-    int registerMouseScrollCallback(const MouseScrollCallback& callback);
-    
+    bool isKeyPressed(int keyCode) const;
+
     /**
-     * @brief Unregister a mouse scroll callback
-     * @param callbackId The ID of the callback to remove
+     * @brief Check if the left mouse button is held
+     * @return true if the button is held, false otherwise
      */
-    void unregisterMouseScrollCallback(int callbackId);
-    
+    bool isMousePressed() const;
+
     /**
      * @brief Get the current mouse position
-     * @return The mouse position in screen coordinates
+     * @param x Receives the cursor x in screen coordinates
+     * @param y Receives the cursor y in screen coordinates
      */
-    glm::vec2 getMousePosition() const;
-    
-    /**
-     * @brief Get the mouse position change since the last frame
-     * @return The delta movement of the mouse
-     */
-    glm::vec2 getMouseDelta() const;
-    
+    void getMousePosition(int& x, int& y) const;
+
     /**
-     * @brief Check if a mouse button is pressed
-     * @param button The mouse button to check
-     * @return true if the button is pressed, false otherwise
+     * @brief Get the cursor x in screen coordinates
      */
-    bool isMouseButtonPressed(MouseButton button) const;
-    
+    int getMouseX() const;
+
     /**
-     * @brief Check if a mouse button is held
-     * @param button The mouse button to check
-     * @return true if the button is held, false otherwise
+     * @brief Get the cursor y in screen coordinates
      */
-    bool isMouseButtonHeld(MouseButton button) const;
-    
+    int getMouseY() const;
+
     /**
-     * @brief Set mouse position (if supported by platform)
-     * @param position The new mouse position
+     * @brief Get the scroll steps of the current tick
      */
-    void setMousePosition(const glm::vec2& position);
-    
+    int getScrollDelta() const;
+
     /**
-     * @brief Show or hide the mouse cursor
-     * @param visible true to show, false to hide
+     * @brief Consume the scroll steps of the current tick
      */
-    void setMouseVisible(bool visible);
-    
+    void clearScrollDelta();
+
     /**
-     * @brief Check if the mouse is visible
-     * @return true if visible, false otherwise
+     * @brief Release every held key and button, e.g. on focus loss
      */
-    bool isMouseVisible() const;
-    
-    // ==================== General Methods ====================
-    
+    void resetInputState();
+
     /**
-     * @brief Clear all input states and callbacks
+     * @brief Check if the game should keep running
      */
-    void clear();
-    
+    bool isRunning() const;
+
     /**
-     * @brief Check if any input is being received
-     * @return true if any key or mouse button is active
+     * @brief Set whether the game should keep running
+     * @param running false to request the game loop to stop
      */
-    bool hasActiveInput() const;
+    void setRunning(bool running);
 
 private:
-    // Keyboard state tracking
-    std::unordered_map<int, bool> keyStates_;           ///< Current state of keys
-    std::unordered_map<int, bool> previousKeyStates_;   ///< Previous frame key states
-    
-    // Keyboard callbacks
-    std::unordered_map<int, std::vector<std::pair<int, KeyCallback>>> keyCallbacks_;
-    
-    // Mouse state tracking
-    glm::vec2 mousePosition_;                            ///< Current mouse position
-    glm::vec2 previousMousePosition_;                    ///< Previous frame mouse position
-    std::unordered_map<int, bool> mouseButtonStates_;   ///< Current mouse button states
-    std::unordered_map<int, bool> previousMouseButtonStates_;  ///< Previous frame button states
-    float mouseScrollDelta_;                             ///< Accumulated scroll delta
-    bool mouseVisible_;                                  ///< Whether mouse cursor is visible
-    
-    // Mouse callbacks
-    std::vector<std::pair<int, MouseMovementCallback>> mouseMovementCallbacks_;
-    std::unordered_map<int, std::vector<std::pair<int, MouseButtonCallback>>> mouseButtonCallbacks_;
-    std::vector<std::pair<int, MouseScrollCallback>> mouseScrollCallbacks_;
-    
-    // Callback ID generation
-    int nextCallbackId_;                                 ///< Counter for unique callback IDs
-    
-    /**
-     * @brief Generate a unique callback ID
-     * @return A new unique callback ID
-     */
-    int generateCallbackId();
-    
-    /**
-     * @brief Convert native key code to Key enumeration
-     * @param nativeKeyCode The native platform-specific key code
-     * @return The corresponding Key enumeration value
-     */
-    Key convertNativeKeyCode(int nativeKeyCode) const;
-    
-    /**
-     * @brief Convert native mouse button code to MouseButton enumeration
-     * @param nativeButtonCode The native platform-specific button code
-     * @return The corresponding MouseButton enumeration value
-     */
-    MouseButton convertNativeMouseButton(int nativeButtonCode) const;
+    cppcraft::input::InputEventQueue m_events;   ///< Events queued since the last tick
+    cppcraft::input::InputTracker m_tracker;     ///< Builds the per-tick snapshot
+    bool m_isRunning;                             ///< Whether the game loop should continue
+    int m_scrollDelta;                            ///< Unconsumed scroll of the current tick
 };
 
 #endif // INPUT_HANDLER_H
@@ -0,0 +1,89 @@
+#include "input_queue.h"
+
+namespace cppcraft {
+namespace input {
+
+namespace {
+
+// Set a bit if the code is in range
+template <size_t N>
+void SetBit(std::bitset<N>* bits, int code, bool value) {
+  if (code >= 0 && code < static_cast<int>(N)) {
+    bits->set(static_cast<size_t>(code), value);
+  }
+}
+
+}  // namespace
+
+bool InputEventQueue::Push(const InputEvent& event) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == INPUT_QUEUE_CAPACITY) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  events_[head & (INPUT_QUEUE_CAPACITY - 1)] = event;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+const InputSnapshot& InputTracker::Update(InputEventQueue* queue) {
+  snapshot_.keys_pressed_.reset();
+  snapshot_.buttons_pressed_.reset();
+  snapshot_.mouse_delta_x_ = 0.0f;
+  snapshot_.mouse_delta_y_ = 0.0f;
+  snapshot_.scroll_delta_ = 0.0f;
+
+  // Releases from Reset() belong to this tick, ahead of the queued events
+  snapshot_.keys_released_ = pending_key_releases_;
+  snapshot_.buttons_released_ = pending_button_releases_;
+  snapshot_.keys_held_ &= ~pending_key_releases_;
+  snapshot_.buttons_held_ &= ~pending_button_releases_;
+  pending_key_releases_.reset();
+  pending_button_releases_.reset();
+
+  queue->Drain([this](const InputEvent& event) { Apply(event); });
+  return snapshot_;
+}
+
+void InputTracker::Reset() {
+  pending_key_releases_ |= snapshot_.keys_held_;
+  pending_button_releases_ |= snapshot_.buttons_held_;
+}
+
+void InputTracker::Apply(const InputEvent& event) {
+  InputSnapshot& s = snapshot_;
+  switch (event.type) {
+    case InputEventType::KEY_DOWN:
+      SetBit(&s.keys_held_, event.code, true);
+      SetBit(&s.keys_pressed_, event.code, true);
+      break;
+    case InputEventType::KEY_UP:
+      SetBit(&s.keys_held_, event.code, false);
+      SetBit(&s.keys_released_, event.code, true);
+      break;
+    case InputEventType::MOUSE_DOWN:
+      SetBit(&s.buttons_held_, event.code, true);
+      SetBit(&s.buttons_pressed_, event.code, true);
+      break;
+    case InputEventType::MOUSE_UP:
+      SetBit(&s.buttons_held_, event.code, false);
+      SetBit(&s.buttons_released_, event.code, true);
+      break;
+    case InputEventType::MOUSE_MOVE:
+      if (has_mouse_position_) {
+        s.mouse_delta_x_ += event.x - s.mouse_x_;
+        s.mouse_delta_y_ += event.y - s.mouse_y_;
+      }
+      s.mouse_x_ = event.x;
+      s.mouse_y_ = event.y;
+      has_mouse_position_ = true;
+      break;
+    case InputEventType::MOUSE_SCROLL:
+      s.scroll_delta_ += event.y;
+      break;
+  }
+}
+
+}  // namespace input
+}  // namespace cppcraft
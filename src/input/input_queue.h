@@ -0,0 +1,211 @@
+#ifndef SRC_INPUT_INPUT_QUEUE_H_
+#define SRC_INPUT_INPUT_QUEUE_H_
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppcraft {
+namespace input {
+
+// Raw events the queue holds between two drains; a power of two. At 20
+// ticks per second this still leaves room for an 8 kHz mouse.
+constexpr size_t INPUT_QUEUE_CAPACITY = 4096;
+
+// Native key codes tracked by snapshots (GLFW's run up to 348); other codes
+// are ignored
+constexpr int KEY_CODE_COUNT = 512;
+
+// Native mouse button codes tracked by snapshots
+constexpr int MOUSE_BUTTON_COUNT = 8;
+
+enum class InputEventType : uint8_t {
+  KEY_DOWN,
+  KEY_UP,
+  MOUSE_MOVE,
+  MOUSE_DOWN,
+  MOUSE_UP,
+  MOUSE_SCROLL,
+};
+
+/**
+ * @struct InputEvent
+ * @brief One raw event as reported by the window system
+ */
+struct InputEvent {
+  InputEventType type = InputEventType::KEY_DOWN;
+
+  /**
+   * @brief Native key or mouse button code
+   */
+  int32_t code = 0;
+
+  /**
+   * @brief Cursor position for MOUSE_MOVE, scroll offset in y for
+   *        MOUSE_SCROLL
+   */
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+/**
+ * @brief Fixed-size single-producer, single-consumer queue of raw events
+ *
+ * The thread polling the window pushes, the simulation thread drains once
+ * per tick; neither side takes a lock or allocates. A full queue drops new
+ * events and counts them rather than blocking the window thread.
+ */
+class InputEventQueue {
+ public:
+  InputEventQueue() : events_(INPUT_QUEUE_CAPACITY) {}
+
+  InputEventQueue(const InputEventQueue&) = delete;
+  InputEventQueue& operator=(const InputEventQueue&) = delete;
+
+  /**
+   * @brief Append an event; producer thread only
+   * @return False if the queue was full and the event was dropped
+   */
+  bool Push(const InputEvent& event);
+
+  /**
+   * @brief Visit and remove every queued event; consumer thread only
+   * @param visit Called with each event in push order
+   * @return Number of events visited
+   */
+  template <typename Visitor>
+  size_t Drain(Visitor&& visit) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    for (size_t i = tail; i != head; ++i) {
+      visit(events_[i & (INPUT_QUEUE_CAPACITY - 1)]);
+    }
+    tail_.store(head, std::memory_order_release);
+    return head - tail;
+  }
+
+  /**
+   * @brief Get the number of events dropped by a full queue so far
+   */
+  size_t GetDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::vector<InputEvent> events_;
+
+  // Producer and consumer positions on separate cache lines; both only grow
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  std::atomic<size_t> dropped_{0};
+};
+
+/**
+ * @brief Input state as of one simulation tick
+ *
+ * Held keys and buttons are bitsets indexed by native code. A key pressed
+ * and released within the same tick reads as pressed and released but not
+ * held, so short taps are never lost. All cursor motion during the tick is
+ * coalesced into a single delta.
+ */
+class InputSnapshot {
+ public:
+  bool IsKeyHeld(int code) const { return Test(keys_held_, code); }
+  bool WasKeyPressed(int code) const { return Test(keys_pressed_, code); }
+  bool WasKeyReleased(int code) const { return Test(keys_released_, code); }
+
+  bool IsButtonHeld(int button) const { return Test(buttons_held_, button); }
+  bool WasButtonPressed(int button) const {
+    return Test(buttons_pressed_, button);
+  }
+  bool WasButtonReleased(int button) const {
+    return Test(buttons_released_, button);
+  }
+
+  /**
+   * @brief Get the cursor position at the end of the tick
+   */
+  float GetMouseX() const { return mouse_x_; }
+  float GetMouseY() const { return mouse_y_; }
+
+  /**
+   * @brief Get the cursor movement during the tick
+   */
+  float GetMouseDeltaX() const { return mouse_delta_x_; }
+  float GetMouseDeltaY() const { return mouse_delta_y_; }
+
+  /**
+   * @brief Get the scroll offset accumulated during the tick
+   */
+  float GetScrollDelta() const { return scroll_delta_; }
+
+  /**
+   * @brief Check whether any key or button is held
+   */
+  bool HasHeldInput() const { return keys_held_.any() || buttons_held_.any(); }
+
+ private:
+  friend class InputTracker;
+
+  template <size_t N>
+  static bool Test(const std::bitset<N>& bits, int code) {
+    return code >= 0 && code < static_cast<int>(N) &&
+           bits.test(static_cast<size_t>(code));
+  }
+
+  std::bitset<KEY_CODE_COUNT> keys_held_;
+  std::bitset<KEY_CODE_COUNT> keys_pressed_;
+  std::bitset<KEY_CODE_COUNT> keys_released_;
+  std::bitset<MOUSE_BUTTON_COUNT> buttons_held_;
+  std::bitset<MOUSE_BUTTON_COUNT> buttons_pressed_;
+  std::bitset<MOUSE_BUTTON_COUNT> buttons_released_;
+  float mouse_x_ = 0.0f;
+  float mouse_y_ = 0.0f;
+  float mouse_delta_x_ = 0.0f;
+  float mouse_delta_y_ = 0.0f;
+  float scroll_delta_ = 0.0f;
+};
+
+/**
+ * @brief Turns the raw event stream into one snapshot per tick
+ *
+ * Consumer thread only. The snapshot returned by Update() stays unchanged
+ * until the next call, so every system in a tick sees the same input.
+ */
+class InputTracker {
+ public:
+  /**
+   * @brief Drain the queue and build the snapshot for a new tick
+   */
+  const InputSnapshot& Update(InputEventQueue* queue);
+
+  const InputSnapshot& GetSnapshot() const { return snapshot_; }
+
+  /**
+   * @brief Release every key and button, e.g. when the window loses focus
+   *
+   * The releases show up in the snapshot of the next Update(), before the
+   * events still queued are applied; the current snapshot is unchanged.
+   */
+  void Reset();
+
+ private:
+  void Apply(const InputEvent& event);
+
+  InputSnapshot snapshot_;
+
+  // Keys and buttons released by Reset(), reported by the next Update()
+  std::bitset<KEY_CODE_COUNT> pending_key_releases_;
+  std::bitset<MOUSE_BUTTON_COUNT> pending_button_releases_;
+
+  // Whether a cursor position has been seen; the first move sets the
+  // position without producing a delta
+  bool has_mouse_position_ = false;
+};
+
+}  // namespace input
+}  // namespace cppcraft
+
+#endif  // SRC_INPUT_INPUT_QUEUE_H_
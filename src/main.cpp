@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <memory>
-
-// Forward declarations for core game systems
-class Window;
-class Renderer;
-class InputHandler;
-class GameWorld;
+#include <string>
+#include <system_error>
+#include "core/fixed_timestep.h"
+#include "core/profiler.h"
+#include "graphics/renderer.h"
+#include "input/input_handler.h"
+#include "world/region_file.h"
+#include "world/terrain_generator.h"
+#include "world/world_pregen.h"
 
 /**
  * @brief Main entry point for Cppcraft 2 - A Minecraft clone
@@ -15,16 +23,20 @@ class GameWorld;
  */
 class Game {
 private:
-    std::unique_ptr<Window> window;
     std::unique_ptr<Renderer> renderer;
     std::unique_ptr<InputHandler> inputHandler;
-    std::unique_ptr<GameWorld> gameWorld;
     
     bool isRunning;
     const int TARGET_FPS = 60;
+    cppcraft::core::TimestepSettings timestepSettings;
 
 public:
-    Game() : isRunning(true) {}
+    explicit Game(const cppcraft::core::TimestepSettings& settings = cppcraft::core::TimestepSettings())
+        : isRunning(true), timestepSettings(settings) {
+        if (timestepSettings.target_fps <= 0) {
+            timestepSettings.target_fps = TARGET_FPS;
+        }
+    }
     
     /**
      * @brief Initialize game systems and resources
@@ -33,14 +45,19 @@ public:
         std::cout << "Initializing Cppcraft 2..." << std::endl;
         
         try {
-            // Initialize window (TODO: implement)
+            // Initialize window (TODO: implement). Once the render context
+            // exists, create a ShaderReloader on a hidden window sharing it,
+            // so edited shaders rebuild in the background
             std::cout << "  - Initializing window..." << std::endl;
             
             // Initialize renderer (TODO: implement)
             std::cout << "  - Initializing renderer..." << std::endl;
             
-            // Initialize input handler (TODO: implement)
             std::cout << "  - Initializing input handler..." << std::endl;
+            inputHandler = std::make_unique<InputHandler>();
+            if (!inputHandler->initialize()) {
+                return false;
+            }
             
             // Initialize game world (TODO: implement)
             std::cout << "  - Initializing game world..." << std::endl;
@@ -55,21 +72,67 @@ public:
     
     /**
      * @brief Main game loop
+     *
+     * The simulation runs in fixed ticks of 1 / tick_rate seconds, however
+     * long frames take; rendering interpolates between the last two ticks.
+     * With VSYNC pacing the swap interval spaces frames out, with SLEEP_SPIN
+     * the loop holds target_fps itself.
      */
     void run() {
-        std::cout << "Starting game loop..." << std::endl;
+        std::cout << "Starting game loop at " << timestepSettings.tick_rate
+                  << " ticks per second..." << std::endl;
+        
+        cppcraft::core::FixedTimestep timestep(timestepSettings);
+        cppcraft::core::FramePacer pacer(
+            timestepSettings.pacing == cppcraft::core::FramePacing::SLEEP_SPIN
+                ? timestepSettings.target_fps
+                : 0);
         
         while (isRunning) {
-            // TODO: Implement game loop
-            // - Handle input
-            // - Update game state
-            // - Render frame
-            // - Maintain frame rate
+            // TODO: Poll window events into the input handler once per frame
+            
+            const int ticks = timestep.BeginFrame();
+            for (int i = 0; i < ticks; ++i) {
+                PROFILE_SCOPE("game.tick");
+                // Each tick sees one snapshot; events arriving during the
+                // tick wait in the queue for the next one
+                inputHandler->processInput();
+                update(timestep.GetTickSeconds(), inputHandler->getSnapshot());
+            }
+            
+            {
+                PROFILE_SCOPE("game.render");
+                // TODO: Render frame, interpolating by timestep.GetAlpha()
+            }
             
             isRunning = false; // Placeholder: exit after one iteration
+            
+            // Collect every thread's timings for the overlay and trace capture
+            cppcraft::core::Profiler::Get().EndFrame();
+            
+            pacer.Wait();
+        }
+        
+        if (timestep.GetDroppedTickCount() > 0) {
+            std::cout << "Dropped " << timestep.GetDroppedTickCount()
+                      << " ticks on slow frames" << std::endl;
         }
     }
     
+    /**
+     * @brief Run one simulation tick
+     * @param tickSeconds Fixed tick length in seconds
+     * @param input Input as of this tick
+     */
+    void update(float tickSeconds, const cppcraft::input::InputSnapshot& input) {
+        if (!inputHandler->isRunning()) {
+            isRunning = false;
+        }
+        // TODO: Move the player and world by input over tickSeconds
+        static_cast<void>(tickSeconds);
+        static_cast<void>(input);
+    }
+    
     /**
      * @brief Shutdown game systems and cleanup resources
      */
@@ -77,15 +140,60 @@ public:
         std::cout << "Shutting down Cppcraft 2..." << std::endl;
         
         // Cleanup in reverse order of initialization
-        gameWorld.reset();
         inputHandler.reset();
         renderer.reset();
-        window.reset();
         
         std::cout << "Shutdown complete!" << std::endl;
     }
 };
 
+/**
+ * @brief Generate and save the chunks around the origin without a window
+ * @param saveDirectory Save directory, created if missing
+ * @param terrainSettings Terrain of the world being saved
+ * @param pregenSettings Square of chunks and generation threads
+ * @return Process exit code
+ */
+int runPregen(const std::string& saveDirectory,
+              const cppcraft::world::TerrainSettings& terrainSettings,
+              const cppcraft::world::PregenSettings& pregenSettings) {
+    std::error_code error;
+    std::filesystem::create_directories(saveDirectory, error);
+    if (error) {
+        std::cerr << "Cannot create save directory " << saveDirectory << ": "
+                  << error.message() << std::endl;
+        return 1;
+    }
+
+    const int side = pregenSettings.radius * 2 + 1;
+    std::cout << "Pre-generating " << side << "x" << side << " chunks into "
+              << saveDirectory << "..." << std::endl;
+
+    cppcraft::world::TerrainGenerator terrain(terrainSettings);
+    cppcraft::world::RegionStore regions(saveDirectory);
+    cppcraft::world::PregenProgress result = cppcraft::world::PregenerateChunks(
+        terrain, &regions, pregenSettings,
+        [](const cppcraft::world::PregenProgress& progress) {
+            const size_t done = progress.skipped + progress.written + progress.failed;
+            std::printf("\r  %zu / %zu chunks (%.1f%%), %.0f chunks/s", done, progress.total,
+                        progress.total > 0 ? 100.0 * done / progress.total : 100.0,
+                        progress.chunks_per_second);
+            std::fflush(stdout);
+
+            // Keep the profiler rings drained; there are no frames here
+            cppcraft::core::Profiler::Get().EndFrame();
+        });
+    std::printf("\n");
+
+    std::cout << "Wrote " << result.written << " chunks in " << result.elapsed_seconds
+              << " s, skipped " << result.skipped << " already saved";
+    if (result.failed > 0) {
+        std::cout << ", " << result.failed << " failed to write";
+    }
+    std::cout << std::endl;
+    return result.failed > 0 ? 1 : 0;
+}
+
 /**
  * @brief Main application entry point
  */
@@ -95,7 +203,57 @@ int main(int argc, char* argv[]) {
     std::cout << "==================================" << std::endl;
     std::cout << std::endl;
     
-    Game game;
+    // --trace <file> writes a Chrome trace of the whole session on exit
+    // --tick-rate <n> sets the simulation ticks per second
+    // --fps <n> sets the frame rate held without vsync
+    // --vsync paces frames by the display; --unlimited does not pace them
+    // --pregen <radius> saves the chunks within radius of the origin and
+    //   exits; --save <dir>, --seed <n> and --threads <n> configure it
+    std::string tracePath;
+    std::string saveDirectory = "world";
+    bool pregen = false;
+    cppcraft::world::TerrainSettings terrainSettings;
+    cppcraft::world::PregenSettings pregenSettings;
+    cppcraft::core::TimestepSettings timestepSettings;
+    timestepSettings.target_fps = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            timestepSettings.tick_rate = std::max(std::atoi(argv[++i]), 1);
+        } else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            timestepSettings.target_fps = std::max(std::atoi(argv[++i]), 0);
+        } else if (std::strcmp(argv[i], "--vsync") == 0) {
+            timestepSettings.pacing = cppcraft::core::FramePacing::VSYNC;
+        } else if (std::strcmp(argv[i], "--unlimited") == 0) {
+            timestepSettings.pacing = cppcraft::core::FramePacing::UNLIMITED;
+        } else if (std::strcmp(argv[i], "--pregen") == 0 && i + 1 < argc) {
+            pregen = true;
+            pregenSettings.radius = std::max(std::atoi(argv[++i]), 0);
+        } else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            saveDirectory = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            terrainSettings.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            pregenSettings.thread_count = static_cast<unsigned int>(std::max(std::atoi(argv[++i]), 0));
+        }
+    }
+    
+    cppcraft::core::Profiler& profiler = cppcraft::core::Profiler::Get();
+    profiler.SetThreadName("main");
+    if (!tracePath.empty()) {
+        profiler.StartCapture();
+    }
+    
+    if (pregen) {
+        int exitCode = runPregen(saveDirectory, terrainSettings, pregenSettings);
+        if (!tracePath.empty() && profiler.WriteChromeTrace(tracePath)) {
+            std::cout << "Profiler trace written to " << tracePath << std::endl;
+        }
+        return exitCode;
+    }
+    
+    Game game(timestepSettings);
     
     // Initialize the game
     if (!game.initialize()) {
@@ -109,6 +267,10 @@ int main(int argc, char* argv[]) {
     // Cleanup and shutdown
     game.shutdown();
     
+    if (!tracePath.empty() && profiler.WriteChromeTrace(tracePath)) {
+        std::cout << "Profiler trace written to " << tracePath << std::endl;
+    }
+    
     std::cout << "Thank you for playing Cppcraft 2!" << std::endl;
     return 0;
 }
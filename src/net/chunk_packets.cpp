@@ -0,0 +1,210 @@
+#include "chunk_packets.h"
+
+#include <memory>
+#include <utility>
+
+#include "../world/region_file.h"
+
+namespace cppcraft {
+namespace net {
+
+namespace {
+
+void AppendVarint(std::vector<uint8_t>* out, uint32_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+// Zigzag keeps small negative coordinates to one or two bytes
+void AppendSignedVarint(std::vector<uint8_t>* out, int32_t value) {
+  AppendVarint(out, (static_cast<uint32_t>(value) << 1) ^
+                        static_cast<uint32_t>(value >> 31));
+}
+
+void AppendHeader(std::vector<uint8_t>* out, PacketType type, int chunk_x,
+                  int chunk_z) {
+  out->push_back(static_cast<uint8_t>(type));
+  AppendSignedVarint(out, chunk_x);
+  AppendSignedVarint(out, chunk_z);
+}
+
+// Bounds-checked cursor over one packet
+class PacketReader {
+ public:
+  PacketReader(const uint8_t* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  bool ReadU8(uint8_t* value) {
+    if (data_ == end_) return false;
+    *value = *data_++;
+    return true;
+  }
+
+  bool ReadVarint(uint32_t* value) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t byte;
+      if (!ReadU8(&byte)) return false;
+      result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadSignedVarint(int32_t* value) {
+    uint32_t raw;
+    if (!ReadVarint(&raw)) return false;
+    *value = static_cast<int32_t>((raw >> 1) ^ (~(raw & 1) + 1));
+    return true;
+  }
+
+  const uint8_t* GetData() const { return data_; }
+  size_t GetRemaining() const { return static_cast<size_t>(end_ - data_); }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* end_;
+};
+
+}  // namespace
+
+void EncodeChunkSnapshot(int chunk_x, int chunk_z,
+                         const world::ChunkStorage& storage,
+                         std::vector<uint8_t>* out) {
+  AppendHeader(out, PacketType::CHUNK_SNAPSHOT, chunk_x, chunk_z);
+  world::EncodeChunkPayload(storage, out);
+}
+
+void EncodeSectionUpdate(const world::SectionChanges& changes,
+                         const world::ChunkStorage& storage,
+                         std::vector<uint8_t>* out) {
+  if (changes.indices.size() > SECTION_DELTA_LIMIT) {
+    AppendHeader(out, PacketType::SECTION_SNAPSHOT, changes.chunk_x,
+                 changes.chunk_z);
+    out->push_back(static_cast<uint8_t>(changes.section));
+    const world::ChunkSection* section = storage.GetSection(changes.section);
+    out->push_back(section != nullptr);
+    if (section) {
+      world::EncodeSectionPayload(*section, out);
+    }
+    return;
+  }
+
+  AppendHeader(out, PacketType::SECTION_DELTA, changes.chunk_x, changes.chunk_z);
+  out->push_back(static_cast<uint8_t>(changes.section));
+  AppendVarint(out, static_cast<uint32_t>(changes.indices.size()));
+
+  const int base_y = changes.section * world::SECTION_SIZE;
+  int previous = -1;
+  for (uint16_t index : changes.indices) {
+    const int x = index % world::SECTION_SIZE;
+    const int z = (index / world::SECTION_SIZE) % world::SECTION_SIZE;
+    const int y = index / world::SECTION_AREA;
+    AppendVarint(out, static_cast<uint32_t>(index - previous));
+    AppendVarint(out, storage.Get(x, base_y + y, z));
+    previous = index;
+  }
+}
+
+void EncodeChunkUnload(int chunk_x, int chunk_z, std::vector<uint8_t>* out) {
+  AppendHeader(out, PacketType::CHUNK_UNLOAD, chunk_x, chunk_z);
+}
+
+bool ChunkReplica::Apply(const uint8_t* data, size_t size) {
+  PacketReader reader(data, size);
+  uint8_t type;
+  int32_t chunk_x;
+  int32_t chunk_z;
+  if (!reader.ReadU8(&type) || !reader.ReadSignedVarint(&chunk_x) ||
+      !reader.ReadSignedVarint(&chunk_z)) {
+    return false;
+  }
+  const uint64_t key = Key(chunk_x, chunk_z);
+
+  switch (static_cast<PacketType>(type)) {
+    case PacketType::CHUNK_SNAPSHOT: {
+      world::ChunkStorage storage;
+      if (!world::DecodeChunkPayload(reader.GetData(), reader.GetRemaining(),
+                                     &storage)) {
+        return false;
+      }
+      chunks_[key] = std::move(storage);
+      return true;
+    }
+
+    case PacketType::SECTION_DELTA: {
+      auto it = chunks_.find(key);
+      uint8_t section;
+      uint32_t count;
+      if (it == chunks_.end() || !reader.ReadU8(&section) ||
+          section >= world::SECTIONS_PER_CHUNK || !reader.ReadVarint(&count) ||
+          count > static_cast<uint32_t>(world::SECTION_VOLUME)) {
+        return false;
+      }
+
+      // Decode everything first so a truncated packet changes nothing
+      std::vector<std::pair<int, uint16_t>> blocks(count);
+      int index = -1;
+      for (auto& block : blocks) {
+        uint32_t gap;
+        uint32_t block_id;
+        if (!reader.ReadVarint(&gap) || !reader.ReadVarint(&block_id) ||
+            gap == 0 || gap > static_cast<uint32_t>(world::SECTION_VOLUME - 1 - index) ||
+            block_id > 0xFFFF) {
+          return false;
+        }
+        index += static_cast<int>(gap);
+        block = {index, static_cast<uint16_t>(block_id)};
+      }
+
+      const int base_y = section * world::SECTION_SIZE;
+      for (const auto& block : blocks) {
+        it->second.Set(block.first % world::SECTION_SIZE,
+                       base_y + block.first / world::SECTION_AREA,
+                       (block.first / world::SECTION_SIZE) % world::SECTION_SIZE,
+                       block.second);
+      }
+      return true;
+    }
+
+    case PacketType::SECTION_SNAPSHOT: {
+      auto it = chunks_.find(key);
+      uint8_t section;
+      uint8_t present;
+      if (it == chunks_.end() || !reader.ReadU8(&section) ||
+          section >= world::SECTIONS_PER_CHUNK || !reader.ReadU8(&present)) {
+        return false;
+      }
+
+      std::unique_ptr<world::ChunkSection> blocks;
+      if (present) {
+        blocks = std::make_unique<world::ChunkSection>();
+        if (!world::DecodeSectionPayload(reader.GetData(), reader.GetRemaining(),
+                                         blocks.get())) {
+          return false;
+        }
+      }
+      it->second.SetSection(section, std::move(blocks));
+      return true;
+    }
+
+    case PacketType::CHUNK_UNLOAD:
+      chunks_.erase(key);
+      return true;
+  }
+  return false;
+}
+
+const world::ChunkStorage* ChunkReplica::Find(int chunk_x, int chunk_z) const {
+  auto it = chunks_.find(Key(chunk_x, chunk_z));
+  return it != chunks_.end() ? &it->second : nullptr;
+}
+
+}  // namespace net
+}  // namespace cppcraft
@@ -0,0 +1,99 @@
+#ifndef SRC_NET_CHUNK_PACKETS_H_
+#define SRC_NET_CHUNK_PACKETS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../world/block_change_log.h"
+#include "../world/chunk_section.h"
+
+namespace cppcraft {
+namespace net {
+
+/**
+ * @brief First byte of every chunk packet
+ *
+ * Layouts, after the type; coordinates are zigzag varints, counts and block
+ * IDs varints:
+ * - CHUNK_SNAPSHOT: chunk x, chunk z, region payload (EncodeChunkPayload)
+ * - SECTION_DELTA: chunk x, chunk z, uint8 section, change count, then per
+ *   change the gap to the previous block index (the first counted from -1)
+ *   and the new block ID
+ * - SECTION_SNAPSHOT: chunk x, chunk z, uint8 section, uint8 1 and the
+ *   section payload (EncodeSectionPayload), or uint8 0 for an all-air
+ *   section
+ * - CHUNK_UNLOAD: chunk x, chunk z
+ *
+ * Packets carry no length; the transport frames them.
+ */
+enum class PacketType : uint8_t {
+  CHUNK_SNAPSHOT = 1,
+  SECTION_DELTA = 2,
+  SECTION_SNAPSHOT = 3,
+  CHUNK_UNLOAD = 4,
+};
+
+// Changed blocks beyond which a section is sent whole instead of as a
+// delta; a delta costs at least two bytes per block, a mostly uniform
+// section far less
+constexpr size_t SECTION_DELTA_LIMIT = 256;
+
+/**
+ * @brief Append a snapshot of a whole chunk column
+ */
+void EncodeChunkSnapshot(int chunk_x, int chunk_z,
+                         const world::ChunkStorage& storage,
+                         std::vector<uint8_t>* out);
+
+/**
+ * @brief Append the current blocks of a section's changed positions
+ *
+ * Written as a SECTION_DELTA, or as a SECTION_SNAPSHOT once more than
+ * SECTION_DELTA_LIMIT blocks changed.
+ *
+ * @param changes Changed positions, ascending
+ * @param storage The chunk's blocks after the changes
+ */
+void EncodeSectionUpdate(const world::SectionChanges& changes,
+                         const world::ChunkStorage& storage,
+                         std::vector<uint8_t>* out);
+
+/**
+ * @brief Append a notice that a chunk left the receiver's view
+ */
+void EncodeChunkUnload(int chunk_x, int chunk_z, std::vector<uint8_t>* out);
+
+/**
+ * @brief Client-side copy of the chunks a server replicates
+ */
+class ChunkReplica {
+ public:
+  /**
+   * @brief Apply one packet
+   * @return False if the packet is malformed or updates a chunk this replica
+   *         does not hold; the replica is unchanged then
+   */
+  bool Apply(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Get a replicated chunk, or nullptr
+   */
+  const world::ChunkStorage* Find(int chunk_x, int chunk_z) const;
+
+  size_t GetChunkCount() const { return chunks_.size(); }
+
+ private:
+  static uint64_t Key(int chunk_x, int chunk_z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x)) << 32) |
+           static_cast<uint32_t>(chunk_z);
+  }
+
+  std::unordered_map<uint64_t, world::ChunkStorage> chunks_;
+};
+
+}  // namespace net
+}  // namespace cppcraft
+
+#endif  // SRC_NET_CHUNK_PACKETS_H_
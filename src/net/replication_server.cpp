@@ -0,0 +1,243 @@
+#include "replication_server.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../core/profiler.h"
+#include "chunk_packets.h"
+
+namespace cppcraft {
+namespace net {
+
+namespace {
+
+// Whether an offset lies within a view distance
+bool IsWithin(int dx, int dz, int distance) {
+  return dx * dx + dz * dz <= distance * distance;
+}
+
+}  // namespace
+
+ReplicationServer::ReplicationServer(ChunkLookup lookup)
+    : lookup_(std::move(lookup)) {}
+
+ClientId ReplicationServer::AddClient(int chunk_x, int chunk_z,
+                                      int view_distance) {
+  const ClientId id = next_client_++;
+  Client& client = clients_[id];
+  client.center_x = chunk_x;
+  client.center_z = chunk_z;
+  client.view_distance = std::max(0, view_distance);
+  return id;
+}
+
+void ReplicationServer::RemoveClient(ClientId id) {
+  auto it = clients_.find(id);
+  if (it == clients_.end()) {
+    return;
+  }
+  for (uint64_t key : it->second.chunks) {
+    RemoveWatcher(key, id);
+  }
+  clients_.erase(it);
+}
+
+void ReplicationServer::SetClientView(ClientId id, int chunk_x, int chunk_z,
+                                      int view_distance) {
+  auto it = clients_.find(id);
+  if (it == clients_.end()) {
+    return;
+  }
+  Client& client = it->second;
+  view_distance = std::max(0, view_distance);
+  if (client.center_x != chunk_x || client.center_z != chunk_z ||
+      client.view_distance != view_distance) {
+    client.center_x = chunk_x;
+    client.center_z = chunk_z;
+    client.view_distance = view_distance;
+    client.view_changed = true;
+    client.complete = false;
+  }
+}
+
+void ReplicationServer::Tick() {
+  PROFILE_SCOPE("net.replicate");
+  ++tick_;
+  stats_ = ReplicationStats();
+  stats_.clients = clients_.size();
+
+  // Block changes first: chunks a client does not hold yet get them through
+  // their snapshot, which is encoded after this and includes them
+  changes_.Take(&taken_);
+  for (const world::SectionChanges& changes : taken_) {
+    const uint64_t key = Key(changes.chunk_x, changes.chunk_z);
+    snapshots_.erase(key);
+
+    auto watchers = watchers_.find(key);
+    if (watchers == watchers_.end()) {
+      continue;
+    }
+    const world::ChunkStorage* storage =
+        lookup_(changes.chunk_x, changes.chunk_z);
+    if (!storage) {
+      continue;
+    }
+
+    auto encoded = std::make_shared<std::vector<uint8_t>>();
+    EncodeSectionUpdate(changes, *storage, encoded.get());
+    const Packet packet = std::move(encoded);
+    ++stats_.section_updates;
+    stats_.bytes_encoded += packet->size();
+
+    for (ClientId id : watchers->second) {
+      Queue(&clients_[id], packet);
+    }
+  }
+
+  for (auto& entry : clients_) {
+    UpdateInterest(entry.first, &entry.second);
+  }
+
+  // Drop snapshots nobody has asked for in a while
+  if (tick_ % SNAPSHOT_CACHE_TICKS == 0) {
+    for (auto it = snapshots_.begin(); it != snapshots_.end();) {
+      if (it->second.last_used + SNAPSHOT_CACHE_TICKS < tick_) {
+        it = snapshots_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  core::Profiler& profiler = core::Profiler::Get();
+  profiler.SetCounter("net.bytes_encoded", static_cast<double>(stats_.bytes_encoded));
+  profiler.SetCounter("net.bytes_queued", static_cast<double>(stats_.bytes_queued));
+}
+
+void ReplicationServer::TakePackets(ClientId id, std::vector<Packet>* out) {
+  auto it = clients_.find(id);
+  if (it == clients_.end()) {
+    return;
+  }
+  std::vector<Packet>& queued = it->second.queued;
+  out->insert(out->end(), std::make_move_iterator(queued.begin()),
+              std::make_move_iterator(queued.end()));
+  queued.clear();
+}
+
+void ReplicationServer::Queue(Client* client, const Packet& packet) {
+  client->queued.push_back(packet);
+  stats_.bytes_queued += packet->size();
+}
+
+void ReplicationServer::UpdateInterest(ClientId id, Client* client) {
+  if (client->view_changed) {
+    client->view_changed = false;
+    const int keep = client->view_distance + VIEW_UNLOAD_MARGIN;
+    for (auto it = client->chunks.begin(); it != client->chunks.end();) {
+      const int chunk_x = static_cast<int32_t>(*it >> 32);
+      const int chunk_z = static_cast<int32_t>(*it & 0xFFFFFFFFu);
+      if (IsWithin(chunk_x - client->center_x, chunk_z - client->center_z, keep)) {
+        ++it;
+        continue;
+      }
+
+      auto encoded = std::make_shared<std::vector<uint8_t>>();
+      EncodeChunkUnload(chunk_x, chunk_z, encoded.get());
+      Queue(client, std::move(encoded));
+      RemoveWatcher(*it, id);
+      it = client->chunks.erase(it);
+    }
+  }
+
+  if (client->complete) {
+    return;
+  }
+
+  EnsureOffsets(client->view_distance);
+  size_t spent = 0;
+  bool complete = true;
+  for (const Offset& offset : offsets_) {
+    if (!IsWithin(offset.x, offset.z, client->view_distance)) {
+      break;
+    }
+
+    const int chunk_x = client->center_x + offset.x;
+    const int chunk_z = client->center_z + offset.z;
+    const uint64_t key = Key(chunk_x, chunk_z);
+    if (client->chunks.count(key)) {
+      continue;
+    }
+
+    // Not loaded yet; check again next tick
+    const world::ChunkStorage* storage = lookup_(chunk_x, chunk_z);
+    if (!storage) {
+      complete = false;
+      continue;
+    }
+    if (spent >= snapshot_budget_) {
+      complete = false;
+      break;
+    }
+
+    const Packet packet = GetSnapshot(chunk_x, chunk_z, *storage, key);
+    Queue(client, packet);
+    spent += packet->size();
+    client->chunks.insert(key);
+    watchers_[key].push_back(id);
+  }
+  client->complete = complete;
+}
+
+Packet ReplicationServer::GetSnapshot(int chunk_x, int chunk_z,
+                                      const world::ChunkStorage& storage,
+                                      uint64_t key) {
+  CachedSnapshot& cached = snapshots_[key];
+  cached.last_used = tick_;
+  if (cached.packet) {
+    ++stats_.snapshot_cache_hits;
+    return cached.packet;
+  }
+
+  auto encoded = std::make_shared<std::vector<uint8_t>>();
+  EncodeChunkSnapshot(chunk_x, chunk_z, storage, encoded.get());
+  cached.packet = std::move(encoded);
+  ++stats_.snapshots_encoded;
+  stats_.bytes_encoded += cached.packet->size();
+  return cached.packet;
+}
+
+void ReplicationServer::EnsureOffsets(int view_distance) {
+  if (view_distance <= offsets_radius_) {
+    return;
+  }
+
+  offsets_.clear();
+  for (int z = -view_distance; z <= view_distance; ++z) {
+    for (int x = -view_distance; x <= view_distance; ++x) {
+      if (IsWithin(x, z, view_distance)) {
+        offsets_.push_back({x, z});
+      }
+    }
+  }
+  std::sort(offsets_.begin(), offsets_.end(),
+            [](const Offset& a, const Offset& b) {
+              return a.x * a.x + a.z * a.z < b.x * b.x + b.z * b.z;
+            });
+  offsets_radius_ = view_distance;
+}
+
+void ReplicationServer::RemoveWatcher(uint64_t key, ClientId id) {
+  auto it = watchers_.find(key);
+  if (it == watchers_.end()) {
+    return;
+  }
+  std::vector<ClientId>& ids = it->second;
+  ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+  if (ids.empty()) {
+    watchers_.erase(it);
+  }
+}
+
+}  // namespace net
+}  // namespace cppcraft
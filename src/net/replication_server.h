@@ -0,0 +1,212 @@
+#ifndef SRC_NET_REPLICATION_SERVER_H_
+#define SRC_NET_REPLICATION_SERVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../world/block_change_log.h"
+#include "../world/chunk_section.h"
+
+namespace cppcraft {
+namespace net {
+
+// Default radius, in chunks, replicated around each client
+constexpr int DEFAULT_VIEW_DISTANCE = 8;
+
+// Chunks further than the view distance by this much are unloaded, so a
+// client walking along a chunk border does not reload it every step
+constexpr int VIEW_UNLOAD_MARGIN = 1;
+
+// Default bytes of chunk snapshots queued per client per tick; block
+// changes are never held back
+constexpr size_t DEFAULT_SNAPSHOT_BUDGET = 128 * 1024;
+
+// Ticks an encoded chunk snapshot stays cached after it was last sent
+constexpr uint64_t SNAPSHOT_CACHE_TICKS = 200;
+
+/**
+ * @brief Encoded packet, shared by every client it is queued for
+ */
+using Packet = std::shared_ptr<const std::vector<uint8_t>>;
+
+using ClientId = uint32_t;
+
+/**
+ * @struct ReplicationStats
+ * @brief Work and output of the last Tick()
+ */
+struct ReplicationStats {
+  size_t clients = 0;
+
+  /**
+   * @brief Changed sections encoded, once each however many clients see them
+   */
+  size_t section_updates = 0;
+
+  /**
+   * @brief Chunk snapshots encoded, and snapshots served from the cache
+   */
+  size_t snapshots_encoded = 0;
+  size_t snapshot_cache_hits = 0;
+
+  /**
+   * @brief Bytes encoded, and bytes queued summed over all clients
+   */
+  size_t bytes_encoded = 0;
+  size_t bytes_queued = 0;
+};
+
+/**
+ * @brief Replicates world chunks and block changes to clients
+ *
+ * Each tick the block changes recorded since the last one are encoded once
+ * per section, as a delta or a whole section (see EncodeSectionUpdate()),
+ * and the same packet is queued for every client holding that chunk. Each
+ * client then receives snapshots of the chunks within its view distance it
+ * does not hold yet, nearest first and within the per-tick snapshot budget,
+ * and unload notices for chunks it walked away from. Snapshots are region
+ * payloads, cached until the chunk changes, so clients streaming the same
+ * area share the encoding work.
+ *
+ * Serialization cost thus follows the number of changes and of distinct
+ * chunks sent, not the number of clients; per client the server only
+ * appends shared packets.
+ *
+ * Main thread only.
+ */
+class ReplicationServer {
+ public:
+  /**
+   * @brief Returns the blocks of a loaded chunk, or nullptr if it is not
+   *        loaded
+   */
+  using ChunkLookup =
+      std::function<const world::ChunkStorage*(int chunk_x, int chunk_z)>;
+
+  explicit ReplicationServer(ChunkLookup lookup);
+
+  ReplicationServer(const ReplicationServer&) = delete;
+  ReplicationServer& operator=(const ReplicationServer&) = delete;
+
+  /**
+   * @brief Get the log the world records block changes into
+   *
+   * Pass it to World::setBlockChangeLog().
+   */
+  world::BlockChangeLog* GetChangeLog() { return &changes_; }
+
+  /**
+   * @brief Start replicating to a client
+   * @param chunk_x Chunk the client's view is centered on
+   * @param chunk_z Chunk the client's view is centered on
+   * @param view_distance Replicated radius in chunks
+   */
+  ClientId AddClient(int chunk_x, int chunk_z,
+                     int view_distance = DEFAULT_VIEW_DISTANCE);
+
+  /**
+   * @brief Stop replicating to a client; its queued packets are dropped
+   */
+  void RemoveClient(ClientId id);
+
+  /**
+   * @brief Move a client's view
+   */
+  void SetClientView(ClientId id, int chunk_x, int chunk_z, int view_distance);
+
+  void SetSnapshotBudget(size_t bytes) { snapshot_budget_ = bytes; }
+
+  /**
+   * @brief Encode the changes since the last tick and queue packets
+   */
+  void Tick();
+
+  /**
+   * @brief Move a client's queued packets to the caller, in send order
+   * @param out Receives the packets, appended to its contents
+   */
+  void TakePackets(ClientId id, std::vector<Packet>* out);
+
+  const ReplicationStats& GetStats() const { return stats_; }
+
+ private:
+  struct Client {
+    int center_x = 0;
+    int center_z = 0;
+    int view_distance = 0;
+
+    // Chunks the client holds, by Key()
+    std::unordered_set<uint64_t> chunks;
+
+    // Set when the view moved; cleared once every chunk in view is sent
+    bool view_changed = true;
+    bool complete = false;
+
+    std::vector<Packet> queued;
+  };
+
+  struct CachedSnapshot {
+    Packet packet;
+    uint64_t last_used = 0;
+  };
+
+  struct Offset {
+    int x;
+    int z;
+  };
+
+  void Queue(Client* client, const Packet& packet);
+
+  /**
+   * @brief Unload chunks out of view, then send those missing in view
+   */
+  void UpdateInterest(ClientId id, Client* client);
+
+  /**
+   * @brief Get a chunk's snapshot, encoding it if not cached
+   */
+  Packet GetSnapshot(int chunk_x, int chunk_z,
+                     const world::ChunkStorage& storage, uint64_t key);
+
+  /**
+   * @brief Make sure offsets_ covers a view distance
+   */
+  void EnsureOffsets(int view_distance);
+
+  void RemoveWatcher(uint64_t key, ClientId id);
+
+  static uint64_t Key(int chunk_x, int chunk_z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x)) << 32) |
+           static_cast<uint32_t>(chunk_z);
+  }
+
+  ChunkLookup lookup_;
+  world::BlockChangeLog changes_;
+  std::vector<world::SectionChanges> taken_;
+
+  std::unordered_map<ClientId, Client> clients_;
+  ClientId next_client_ = 1;
+
+  // Clients holding each chunk, so updates only visit their audience
+  std::unordered_map<uint64_t, std::vector<ClientId>> watchers_;
+
+  std::unordered_map<uint64_t, CachedSnapshot> snapshots_;
+
+  // Chunk offsets nearest first, up to the largest view distance seen
+  std::vector<Offset> offsets_;
+  int offsets_radius_ = -1;
+
+  size_t snapshot_budget_ = DEFAULT_SNAPSHOT_BUDGET;
+  uint64_t tick_ = 0;
+  ReplicationStats stats_;
+};
+
+}  // namespace net
+}  // namespace cppcraft
+
+#endif  // SRC_NET_REPLICATION_SERVER_H_
@@ -1,6 +1,8 @@
 #ifndef SRC_WORLD_BLOCK_H_
 #define SRC_WORLD_BLOCK_H_
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <string>
 #include <unordered_map>
@@ -99,6 +101,122 @@ enum class BlockType : uint16_t {
     UNKNOWN = 65535
 };
 
+/**
+ * @brief Raw block ID of air, as stored in chunk block data
+ */
+constexpr uint16_t AIR_BLOCK_ID = static_cast<uint16_t>(BlockType::AIR);
+
+/**
+ * @brief Number of dense block IDs (0 to LEVER); larger IDs are unknown
+ */
+constexpr int BLOCK_TYPE_COUNT = static_cast<int>(BlockType::LEVER) + 1;
+
+// Block property bits stored in BLOCK_PROPERTIES
+constexpr uint8_t BLOCK_SOLID = 1 << 0;        // Collides with entities
+constexpr uint8_t BLOCK_LIQUID = 1 << 1;       // Water or lava
+constexpr uint8_t BLOCK_TRANSPARENT = 1 << 2;  // Neighbor faces stay visible
+constexpr uint8_t BLOCK_TRANSLUCENT = 1 << 3;  // Blended, not alpha-tested
+
+/**
+ * @brief Build the block property table at compile time
+ *
+ * Entry BLOCK_TYPE_COUNT stands for every unknown ID and is a plain solid
+ * block.
+ */
+constexpr std::array<uint8_t, BLOCK_TYPE_COUNT + 1> MakeBlockProperties() {
+    std::array<uint8_t, BLOCK_TYPE_COUNT + 1> properties{};
+    for (uint8_t& entry : properties) {
+        entry = BLOCK_SOLID;
+    }
+
+    auto set = [&properties](BlockType type, uint8_t flags) {
+        properties[static_cast<size_t>(type)] = flags;
+    };
+
+    set(BlockType::AIR, BLOCK_TRANSPARENT);
+
+    // Plants and thin blocks: see-through, and nothing to stand on
+    set(BlockType::GRASS, BLOCK_TRANSPARENT);
+    set(BlockType::TALL_GRASS, BLOCK_TRANSPARENT);
+    set(BlockType::LADDER, BLOCK_TRANSPARENT);
+    set(BlockType::PRESSURE_PLATE, BLOCK_TRANSPARENT);
+    set(BlockType::BUTTON, BLOCK_TRANSPARENT);
+    set(BlockType::LEVER, BLOCK_TRANSPARENT);
+
+    // Solid but see-through
+    set(BlockType::OAK_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::BIRCH_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::SPRUCE_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::JUNGLE_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::ACACIA_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::DARK_OAK_LEAVES, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::ICE, BLOCK_SOLID | BLOCK_TRANSPARENT | BLOCK_TRANSLUCENT);
+    set(BlockType::FENCE, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::FENCE_GATE, BLOCK_SOLID | BLOCK_TRANSPARENT);
+    set(BlockType::DOOR, BLOCK_SOLID | BLOCK_TRANSPARENT);
+
+    set(BlockType::WATER, BLOCK_LIQUID | BLOCK_TRANSPARENT | BLOCK_TRANSLUCENT);
+    set(BlockType::LAVA, BLOCK_LIQUID);
+
+    return properties;
+}
+
+/**
+ * @brief Property bits of every block ID, indexed by GetBlockPropertyIndex
+ */
+inline constexpr std::array<uint8_t, BLOCK_TYPE_COUNT + 1> BLOCK_PROPERTIES =
+    MakeBlockProperties();
+
+/**
+ * @brief Map a block ID to its BLOCK_PROPERTIES entry; unknown IDs share one
+ */
+constexpr size_t GetBlockPropertyIndex(uint16_t block_id) {
+    return std::min<size_t>(block_id, BLOCK_TYPE_COUNT);
+}
+
+/**
+ * @brief Get all property bits of a block ID
+ */
+constexpr uint8_t GetBlockProperties(uint16_t block_id) {
+    return BLOCK_PROPERTIES[GetBlockPropertyIndex(block_id)];
+}
+
+/**
+ * @brief Check if a block ID collides with entities
+ */
+constexpr bool IsSolidBlock(uint16_t block_id) {
+    return (GetBlockProperties(block_id) & BLOCK_SOLID) != 0;
+}
+
+/**
+ * @brief Check if a block ID is water or lava
+ */
+constexpr bool IsLiquidBlock(uint16_t block_id) {
+    return (GetBlockProperties(block_id) & BLOCK_LIQUID) != 0;
+}
+
+/**
+ * @brief Check if faces next to a block ID can be seen through it
+ */
+constexpr bool IsTransparentBlock(uint16_t block_id) {
+    return (GetBlockProperties(block_id) & BLOCK_TRANSPARENT) != 0;
+}
+
+/**
+ * @brief Check if a block ID is drawn with alpha blending
+ *
+ * Translucent blocks are always transparent; other transparent blocks are
+ * alpha-tested cutouts.
+ */
+constexpr bool IsTranslucentBlock(uint16_t block_id) {
+    return (GetBlockProperties(block_id) & BLOCK_TRANSLUCENT) != 0;
+}
+
+static_assert(IsTransparentBlock(AIR_BLOCK_ID) && !IsSolidBlock(AIR_BLOCK_ID),
+              "Air must be transparent and not solid");
+static_assert(IsSolidBlock(static_cast<uint16_t>(BlockType::UNKNOWN)),
+              "Unknown blocks must be solid");
+
 /**
  * @struct Block
  * @brief Represents a single block in the world
@@ -162,19 +280,21 @@ struct Block {
      * @brief Check if this block is air
      * @return true if this block is air, false otherwise
      */
-    bool is_air() const;
+    bool is_air() const { return type == BlockType::AIR; }
 
     /**
      * @brief Check if this block is liquid (water or lava)
      * @return true if this block is a liquid, false otherwise
      */
-    bool is_liquid() const;
+    bool is_liquid() const { return IsLiquidBlock(static_cast<uint16_t>(type)); }
 
     /**
      * @brief Check if this block is transparent
      * @return true if light can pass through this block, false otherwise
      */
-    bool is_transparent() const;
+    bool is_transparent() const {
+        return IsTransparentBlock(static_cast<uint16_t>(type));
+    }
 
     /**
      * @brief Get the display name of this block type
@@ -199,7 +319,11 @@ struct Block {
 
 /**
  * @class BlockRegistry
- * @brief Registry for block types and their properties
+ * @brief Registry for block names
+ *
+ * The property queries forward to the BLOCK_PROPERTIES table; hot paths and
+ * worker threads should call IsSolidBlock() and friends directly instead of
+ * going through the singleton.
  */
 class BlockRegistry {
 public:
@@ -214,21 +338,27 @@ public:
      * @param type The block type to check
      * @return true if the block is solid, false otherwise
      */
-    bool is_solid(BlockType type) const;
+    bool is_solid(BlockType type) const {
+        return IsSolidBlock(static_cast<uint16_t>(type));
+    }
 
     /**
      * @brief Check if a block type is liquid
      * @param type The block type to check
      * @return true if the block is a liquid, false otherwise
      */
-    bool is_liquid(BlockType type) const;
+    bool is_liquid(BlockType type) const {
+        return IsLiquidBlock(static_cast<uint16_t>(type));
+    }
 
     /**
      * @brief Check if a block type is transparent
      * @param type The block type to check
      * @return true if light can pass through this block type
      */
-    bool is_transparent(BlockType type) const;
+    bool is_transparent(BlockType type) const {
+        return IsTransparentBlock(static_cast<uint16_t>(type));
+    }
 
     /**
      * @brief Get the display name for a block type
@@ -246,9 +376,6 @@ private:
     BlockRegistry& operator=(const BlockRegistry&) = delete;
 
     std::unordered_map<uint16_t, std::string> block_names_;
-    std::unordered_map<uint16_t, bool> solid_blocks_;
-    std::unordered_map<uint16_t, bool> liquid_blocks_;
-    std::unordered_map<uint16_t, bool> transparent_blocks_;
 };
 
 }  // namespace world
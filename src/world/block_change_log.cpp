@@ -0,0 +1,50 @@
+#include "block_change_log.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace cppcraft {
+namespace world {
+
+void BlockChangeLog::Record(int chunk_x, int chunk_z, int local_x, int y,
+                            int local_z) {
+  const int section = y / SECTION_SIZE;
+  Pending& pending = sections_[Key(chunk_x, chunk_z, section)];
+  if (pending.changes.indices.empty()) {
+    pending.changes.chunk_x = chunk_x;
+    pending.changes.chunk_z = chunk_z;
+    pending.changes.section = section;
+  }
+
+  const int index = ChunkSection::GetIndex(local_x, y % SECTION_SIZE, local_z);
+  if (!pending.seen.test(static_cast<size_t>(index))) {
+    pending.seen.set(static_cast<size_t>(index));
+    pending.changes.indices.push_back(static_cast<uint16_t>(index));
+  }
+}
+
+void BlockChangeLog::RecordSection(int chunk_x, int chunk_z, int section) {
+  Pending& pending = sections_[Key(chunk_x, chunk_z, section)];
+  pending.changes.chunk_x = chunk_x;
+  pending.changes.chunk_z = chunk_z;
+  pending.changes.section = section;
+  pending.changes.indices.resize(SECTION_VOLUME);
+  std::iota(pending.changes.indices.begin(), pending.changes.indices.end(),
+            uint16_t{0});
+  pending.seen.set();
+}
+
+void BlockChangeLog::Take(std::vector<SectionChanges>* out) {
+  out->clear();
+  out->reserve(sections_.size());
+  for (auto& entry : sections_) {
+    SectionChanges& changes = entry.second.changes;
+    std::sort(changes.indices.begin(), changes.indices.end());
+    out->push_back(std::move(changes));
+  }
+  sections_.clear();
+}
+
+}  // namespace world
+}  // namespace cppcraft
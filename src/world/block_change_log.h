@@ -0,0 +1,84 @@
+#ifndef SRC_WORLD_BLOCK_CHANGE_LOG_H_
+#define SRC_WORLD_BLOCK_CHANGE_LOG_H_
+
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_section.h"
+
+namespace cppcraft {
+namespace world {
+
+/**
+ * @struct SectionChanges
+ * @brief Blocks of one chunk section changed since the last batch
+ */
+struct SectionChanges {
+  int chunk_x = 0;
+  int chunk_z = 0;
+  int section = 0;
+
+  /**
+   * @brief ChunkSection::GetIndex() of each changed block, ascending and
+   *        without duplicates
+   */
+  std::vector<uint16_t> indices;
+};
+
+/**
+ * @brief Collects which blocks changed, grouped by section
+ *
+ * Only positions are recorded; whoever takes a batch reads the current
+ * blocks, so a block edited several times in one batch is sent once with
+ * its final value. Main thread only.
+ */
+class BlockChangeLog {
+ public:
+  /**
+   * @brief Record a changed block
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param local_x Chunk-local X (0-15)
+   * @param y World Y
+   * @param local_z Chunk-local Z (0-15)
+   */
+  void Record(int chunk_x, int chunk_z, int local_x, int y, int local_z);
+
+  /**
+   * @brief Record every block of a section as changed, e.g. after the
+   *        chunk's blocks were replaced in bulk
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param section Section index (0 = bottom)
+   */
+  void RecordSection(int chunk_x, int chunk_z, int section);
+
+  /**
+   * @brief Move the recorded changes to the caller and start a new batch
+   * @param out Receives one entry per changed section, replacing its contents
+   */
+  void Take(std::vector<SectionChanges>* out);
+
+  bool IsEmpty() const { return sections_.empty(); }
+
+ private:
+  struct Pending {
+    SectionChanges changes;
+    std::bitset<SECTION_VOLUME> seen;
+  };
+
+  static uint64_t Key(int chunk_x, int chunk_z, int section) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x) & 0x3FFFFFFFu) << 34) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(chunk_z) & 0x3FFFFFFFu) << 4) |
+           static_cast<uint64_t>(section & 0xF);
+  }
+
+  std::unordered_map<uint64_t, Pending> sections_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_BLOCK_CHANGE_LOG_H_
@@ -0,0 +1,84 @@
+#ifndef SRC_WORLD_BLOCK_TEXTURES_H_
+#define SRC_WORLD_BLOCK_TEXTURES_H_
+
+#include <cstdint>
+
+#include "block.h"
+
+namespace cppcraft {
+namespace world {
+
+/**
+ * @brief Texture array layers of the block textures
+ *
+ * Layer N below 64 holds the main texture of BlockType N, so most blocks
+ * need no table at all. Faces that look different (grass tops, log ends)
+ * use the extra layers from FIRST_EXTRA_LAYER on.
+ */
+constexpr int BLOCK_TYPE_LAYER_COUNT = 64;
+constexpr int FIRST_EXTRA_LAYER = BLOCK_TYPE_LAYER_COUNT;
+
+constexpr int GRASS_BLOCK_TOP_LAYER = FIRST_EXTRA_LAYER;
+constexpr int OAK_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 1;
+constexpr int BIRCH_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 2;
+constexpr int SPRUCE_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 3;
+constexpr int JUNGLE_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 4;
+constexpr int ACACIA_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 5;
+constexpr int DARK_OAK_LOG_TOP_LAYER = FIRST_EXTRA_LAYER + 6;
+constexpr int CRAFTING_TABLE_TOP_LAYER = FIRST_EXTRA_LAYER + 7;
+
+/**
+ * @brief Total number of layers in the block texture array
+ */
+constexpr int BLOCK_TEXTURE_LAYER_COUNT = FIRST_EXTRA_LAYER + 8;
+
+/**
+ * @brief Get the texture array layer of a block face
+ * @param block_id The block ID
+ * @param face Face index (0 = +Z, 1 = -Z, 2 = -X, 3 = +X, 4 = -Y, 5 = +Y)
+ * @return Layer index in [0, BLOCK_TEXTURE_LAYER_COUNT)
+ */
+inline int GetBlockTextureLayer(uint16_t block_id, int face) {
+  const bool top = face == 5;
+  const bool vertical = face >= 4;
+
+  switch (static_cast<BlockType>(block_id)) {
+    case BlockType::GRASS_BLOCK:
+      if (top) return GRASS_BLOCK_TOP_LAYER;
+      if (vertical) return static_cast<int>(BlockType::DIRT);
+      break;
+    case BlockType::OAK_LOG:
+      if (vertical) return OAK_LOG_TOP_LAYER;
+      break;
+    case BlockType::BIRCH_LOG:
+      if (vertical) return BIRCH_LOG_TOP_LAYER;
+      break;
+    case BlockType::SPRUCE_LOG:
+      if (vertical) return SPRUCE_LOG_TOP_LAYER;
+      break;
+    case BlockType::JUNGLE_LOG:
+      if (vertical) return JUNGLE_LOG_TOP_LAYER;
+      break;
+    case BlockType::ACACIA_LOG:
+      if (vertical) return ACACIA_LOG_TOP_LAYER;
+      break;
+    case BlockType::DARK_OAK_LOG:
+      if (vertical) return DARK_OAK_LOG_TOP_LAYER;
+      break;
+    case BlockType::CRAFTING_TABLE:
+      if (top) return CRAFTING_TABLE_TOP_LAYER;
+      if (vertical) return static_cast<int>(BlockType::OAK_PLANKS);
+      break;
+    case BlockType::BOOKSHELF:
+      if (vertical) return static_cast<int>(BlockType::OAK_PLANKS);
+      break;
+    default:
+      break;
+  }
+  return block_id < BLOCK_TYPE_LAYER_COUNT ? block_id : 0;
+}
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_BLOCK_TEXTURES_H_
@@ -1,327 +1,425 @@
 #include "chunk.h"
-#include <glm/glm.hpp>
+
 #include <algorithm>
-#include <cmath>
+#include <memory>
+#include <utility>
+
+#include "chunk_mesher.h"
+#include "mesh_uploader.h"
+#include "mesh_worker_pool.h"
+#include "terrain_generator.h"
+#include "world.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
 
-// Constructor
-Chunk::Chunk(int chunkX, int chunkY, int chunkZ, World* world)
-    : chunkX(chunkX), chunkY(chunkY), chunkZ(chunkZ), world(world),
-      blocks(CHUNK_SIZE * CHUNK_SIZE * CHUNK_HEIGHT, BlockType::Air),
-      meshDirty(true), meshBuilt(false), vao(0), vbo(0), ebo(0),
-      vertexCount(0), indexCount(0) {}
+// Neighbor chunk offsets whose facing columns border a section: -X, +X, -Z, +Z
+constexpr int NEIGHBOR_OFFSETS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+}  // namespace
+
+Chunk::Chunk(int chunk_x, int chunk_z, World* world)
+    : chunk_x_(chunk_x),
+      chunk_z_(chunk_z),
+      is_dirty_(false),
+      world_(world),
+      added_to_world_(false),
+      mesh_dirty_(true),
+      mesh_evicted_(false),
+      mesh_mode_(MeshMode::Naive),
+      mesh_lod_(1),
+      mesh_skirts_(false),
+      vertex_count_(0),
+      index_count_(0) {}
 
-// Destructor
 Chunk::~Chunk() {
-    cleanup();
+  // Workers may still hold jobs; make sure they are never applied
+  for (SectionMesh& mesh : section_meshes_) {
+    CancelSectionJob(&mesh);
+  }
+  ReleaseMesh();
 }
 
-// Get block at local coordinates
-BlockType Chunk::getBlock(int x, int y, int z) const {
-    if (isInBounds(x, y, z)) {
-        return blocks[getBlockIndex(x, y, z)];
-    }
-    return BlockType::Air;
+bool Chunk::SetBlock(int x, int y, int z, uint16_t block_id) {
+  if (!IsInBounds(x, y, z) || !blocks_.Set(x, y, z, block_id)) {
+    return false;
+  }
+  is_dirty_ = true;
+
+  const int section = GetSectionIndex(y);
+  const int local_y = y % SECTION_SIZE;
+  MarkSectionMeshDirty(section);
+  if (local_y == 0 && section > 0) {
+    MarkSectionMeshDirty(section - 1);
+  } else if (local_y == SECTION_SIZE - 1 && section < SECTIONS_PER_CHUNK - 1) {
+    MarkSectionMeshDirty(section + 1);
+  }
+  return true;
 }
 
-// Set block at local coordinates
-void Chunk::setBlock(int x, int y, int z, BlockType type) {
-    if (isInBounds(x, y, z)) {
-        blocks[getBlockIndex(x, y, z)] = type;
-        meshDirty = true;
-    }
+void Chunk::Fill(uint16_t block_id) {
+  blocks_.Fill(block_id);
+  is_dirty_ = true;
+  ReplacedBlocks();
 }
 
-// Check if coordinates are within chunk bounds
-bool Chunk::isInBounds(int x, int y, int z) const {
-    return x >= 0 && x < CHUNK_SIZE &&
-           y >= 0 && y < CHUNK_HEIGHT &&
-           z >= 0 && z < CHUNK_SIZE;
+void Chunk::SetBlockData(const std::array<uint16_t, CHUNK_VOLUME>& data) {
+  blocks_.Encode(data.data());
+  is_dirty_ = true;
+  ReplacedBlocks();
 }
 
-// Calculate linear index for block array
-int Chunk::getBlockIndex(int x, int y, int z) const {
-    return x + CHUNK_SIZE * (z + CHUNK_SIZE * y);
+void Chunk::SetStorage(ChunkStorage storage) {
+  blocks_ = std::move(storage);
+  is_dirty_ = false;
+  ReplacedBlocks();
 }
 
-// Generate chunk terrain using Perlin noise
-void Chunk::generate() {
-    // Simple terrain generation using height-based noise
-    for (int x = 0; x < CHUNK_SIZE; ++x) {
-        for (int z = 0; z < CHUNK_SIZE; ++z) {
-            // Calculate world coordinates
-            float worldX = chunkX * CHUNK_SIZE + x;
-            float worldZ = chunkZ * CHUNK_SIZE + z;
-            
-            // Generate height using noise function
-            int height = generateHeight(worldX, worldZ);
-            
-            // Fill blocks from ground up to height
-            for (int y = 0; y < CHUNK_HEIGHT; ++y) {
-                BlockType blockType = BlockType::Air;
-                
-                if (y < height - 3) {
-                    blockType = BlockType::Stone;
-                } else if (y < height) {
-                    blockType = BlockType::Dirt;
-                } else if (y == height) {
-                    blockType = BlockType::Grass;
-                }
-                
-                setBlock(x, y, z, blockType);
-            }
-        }
-    }
-    
-    meshDirty = true;
+void Chunk::ReplacedBlocks() {
+  ComputeChunkLight(blocks_, &light_);
+  MarkMeshDirty();
+  if (world_ && added_to_world_) {
+    world_->chunkBlocksReplaced(chunk_x_, chunk_z_);
+  }
 }
 
-// Simplified Perlin noise height generation
-int Chunk::generateHeight(float x, float z) const {
-    // Using a simple sine/cosine based height function
-    float scale1 = 50.0f;
-    float scale2 = 100.0f;
-    
-    float height = 40.0f;
-    height += std::sin(x / scale1) * 15.0f;
-    height += std::cos(z / scale2) * 15.0f;
-    height += std::sin((x + z) / 75.0f) * 10.0f;
-    
-    return std::clamp(static_cast<int>(height), 1, CHUNK_HEIGHT - 1);
+void Chunk::Generate() {
+  static const TerrainGenerator DEFAULT_TERRAIN;
+  const TerrainGenerator& terrain =
+      world_ ? world_->getTerrainGenerator() : DEFAULT_TERRAIN;
+  terrain.Generate(chunk_x_, chunk_z_, &blocks_);
+  ComputeChunkLight(blocks_, &light_);
+  MarkMeshDirty();
 }
 
-// Build mesh for rendering
-void Chunk::buildMesh() {
-    if (!meshDirty && meshBuilt) {
-        return;
-    }
-    
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    
-    // Iterate through all blocks in the chunk
-    for (int x = 0; x < CHUNK_SIZE; ++x) {
-        for (int y = 0; y < CHUNK_HEIGHT; ++y) {
-            for (int z = 0; z < CHUNK_SIZE; ++z) {
-                BlockType blockType = getBlock(x, y, z);
-                
-                if (blockType == BlockType::Air) {
-                    continue;
-                }
-                
-                // Check each face and add if exposed
-                addFaceIfExposed(x, y, z, blockType, 0, vertices, indices); // Front
-                addFaceIfExposed(x, y, z, blockType, 1, vertices, indices); // Back
-                addFaceIfExposed(x, y, z, blockType, 2, vertices, indices); // Left
-                addFaceIfExposed(x, y, z, blockType, 3, vertices, indices); // Right
-                addFaceIfExposed(x, y, z, blockType, 4, vertices, indices); // Bottom
-                addFaceIfExposed(x, y, z, blockType, 5, vertices, indices); // Top
-            }
-        }
+void Chunk::Update() {
+  if (!mesh_dirty_ || mesh_evicted_) {
+    return;
+  }
+
+  MeshWorkerPool* pool = world_ ? world_->getMeshWorkerPool() : nullptr;
+  if (!pool) {
+    BuildMesh();
+    return;
+  }
+
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    SectionMesh& mesh = section_meshes_[section];
+    if (!mesh.dirty) {
+      continue;
     }
-    
-    vertexCount = vertices.size() / 8; // 8 floats per vertex (pos + tex)
-    indexCount = indices.size();
-    
-    // Create or update OpenGL buffers
-    if (!meshBuilt) {
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
-        glGenBuffers(1, &ebo);
+    mesh.dirty = false;
+
+    if (!blocks_.GetSection(section)) {
+      CancelSectionJob(&mesh);
+      ReleaseSectionMesh(&mesh);
+      continue;
     }
-    
-    glBindVertexArray(vao);
-    
-    // Bind and fill VBO
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    
-    // Bind and fill EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-    
-    // Vertex attribute pointers
-    // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // Texture coordinates
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // Normal
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    
-    meshDirty = false;
-    meshBuilt = true;
+    ScheduleSectionMesh(section, pool);
+  }
+  mesh_dirty_ = false;
 }
 
-// Add a face if it's exposed (adjacent block is air)
-void Chunk::addFaceIfExposed(int x, int y, int z, BlockType blockType, int face,
-                              std::vector<float>& vertices, std::vector<unsigned int>& indices) {
-    int nx = x, ny = y, nz = z;
-    
-    // Determine neighbor coordinates based on face
-    switch (face) {
-        case 0: nz++; break; // Front
-        case 1: nz--; break; // Back
-        case 2: nx--; break; // Left
-        case 3: nx++; break; // Right
-        case 4: ny--; break; // Bottom
-        case 5: ny++; break; // Top
+void Chunk::BuildMesh() {
+  if (!mesh_dirty_) {
+    return;
+  }
+
+  // The synchronous path's arena, reused by every rebuild on this thread
+  // the way each mesh worker reuses its own
+  static thread_local MeshScratch scratch;
+  static thread_local MeshInput input;
+  ChunkMeshData mesh_data;
+
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    SectionMesh& mesh = section_meshes_[section];
+    if (!mesh.dirty) {
+      continue;
     }
-    
-    // Check if neighbor is air (exposed)
-    BlockType neighborBlock = getBlock(nx, ny, nz);
-    if (neighborBlock != BlockType::Air) {
-        return;
+    mesh.dirty = false;
+    CancelSectionJob(&mesh);
+
+    if (!blocks_.GetSection(section)) {
+      ReleaseSectionMesh(&mesh);
+      continue;
     }
-    
-    // Add face vertices and indices
-    addFace(x, y, z, face, blockType, vertices, indices);
+
+    SnapshotMeshInput(section, &input);
+    ChunkMesher(input, &mesh_data, &scratch).Build();
+    UploadSectionMesh(&mesh, mesh_data);
+  }
+  mesh_dirty_ = false;
 }
 
-// Add a face to the mesh
-void Chunk::addFace(int x, int y, int z, int face, BlockType blockType,
-                     std::vector<float>& vertices, std::vector<unsigned int>& indices) {
-    unsigned int baseIndex = vertices.size() / 8;
-    
-    float texX = getTextureCoord(blockType, face).x;
-    float texY = getTextureCoord(blockType, face).y;
-    
-    // Define face vertices (position, texture coordinates, normal)
-    std::vector<float> faceVertices;
-    
-    switch (face) {
-        case 0: // Front (+Z)
-            faceVertices = {
-                x,     y,     z + 1, texX,     texY,     0, 0, 1,
-                x + 1, y,     z + 1, texX + 1, texY,     0, 0, 1,
-                x + 1, y + 1, z + 1, texX + 1, texY + 1, 0, 0, 1,
-                x,     y + 1, z + 1, texX,     texY + 1, 0, 0, 1,
-            };
-            break;
-        case 1: // Back (-Z)
-            faceVertices = {
-                x + 1, y,     z,     texX,     texY,     0, 0, -1,
-                x,     y,     z,     texX + 1, texY,     0, 0, -1,
-                x,     y + 1, z,     texX + 1, texY + 1, 0, 0, -1,
-                x + 1, y + 1, z,     texX,     texY + 1, 0, 0, -1,
-            };
-            break;
-        case 2: // Left (-X)
-            faceVertices = {
-                x,     y,     z,     texX,     texY,     -1, 0, 0,
-                x,     y,     z + 1, texX + 1, texY,     -1, 0, 0,
-                x,     y + 1, z + 1, texX + 1, texY + 1, -1, 0, 0,
-                x,     y + 1, z,     texX,     texY + 1, -1, 0, 0,
-            };
-            break;
-        case 3: // Right (+X)
-            faceVertices = {
-                x + 1, y,     z + 1, texX,     texY,     1, 0, 0,
-                x + 1, y,     z,     texX + 1, texY,     1, 0, 0,
-                x + 1, y + 1, z,     texX + 1, texY + 1, 1, 0, 0,
-                x + 1, y + 1, z + 1, texX,     texY + 1, 1, 0, 0,
-            };
-            break;
-        case 4: // Bottom (-Y)
-            faceVertices = {
-                x,     y,     z + 1, texX,     texY,     0, -1, 0,
-                x,     y,     z,     texX + 1, texY,     0, -1, 0,
-                x + 1, y,     z,     texX + 1, texY + 1, 0, -1, 0,
-                x + 1, y,     z + 1, texX,     texY + 1, 0, -1, 0,
-            };
-            break;
-        case 5: // Top (+Y)
-            faceVertices = {
-                x,     y + 1, z,     texX,     texY,     0, 1, 0,
-                x,     y + 1, z + 1, texX + 1, texY,     0, 1, 0,
-                x + 1, y + 1, z + 1, texX + 1, texY + 1, 0, 1, 0,
-                x + 1, y + 1, z,     texX,     texY + 1, 0, 1, 0,
-            };
-            break;
+// Neighbors that are not loaded read as air; their edges are remeshed when
+// they load (see World::addChunk). Light is copied for the same blocks,
+// since each face is lit by the block in front of it; unloaded neighbors
+// and the space above the world read as full sky light.
+void Chunk::SnapshotMeshInput(int section, MeshInput* input) const {
+  input->mode = mesh_mode_;
+  input->lod_scale = mesh_lod_;
+  input->skirts = mesh_skirts_;
+  input->section_y = section;
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; ++layer) {
+    input->expected_quads[layer] =
+        section_meshes_[section].layers[layer].index_count / INDICES_PER_QUAD;
+  }
+  input->blocks.assign(MESH_INPUT_VOLUME, AIR_BLOCK_ID);
+  input->light.assign(MESH_INPUT_VOLUME, FULL_SKY_LIGHT);
+
+  // Section interior, row by row
+  uint16_t interior[SECTION_VOLUME];
+  uint8_t interior_light[SECTION_VOLUME];
+  blocks_.GetSection(section)->Decode(interior);
+  light_.DecodeSection(section, interior_light);
+  for (int y = 0; y < SECTION_SIZE; ++y) {
+    for (int z = 0; z < SECTION_SIZE; ++z) {
+      const int row = ChunkSection::GetIndex(0, y, z);
+      const int target = MeshInput::GetIndex(0, y, z);
+      std::copy(interior + row, interior + row + SECTION_SIZE,
+                &input->blocks[target]);
+      std::copy(interior_light + row, interior_light + row + SECTION_SIZE,
+                &input->light[target]);
     }
-    
-    // Add vertices
-    vertices.insert(vertices.end(), faceVertices.begin(), faceVertices.end());
-    
-    // Add indices (two triangles per face)
-    indices.push_back(baseIndex);
-    indices.push_back(baseIndex + 1);
-    indices.push_back(baseIndex + 2);
-    
-    indices.push_back(baseIndex);
-    indices.push_back(baseIndex + 2);
-    indices.push_back(baseIndex + 3);
-}
+  }
 
-// Get texture coordinates for a block type
-glm::vec2 Chunk::getTextureCoord(BlockType blockType, int face) const {
-    // Simple texture atlas mapping (assuming 16x16 grid)
-    float texSize = 1.0f / 16.0f;
-    glm::vec2 texCoord(0.0f);
-    
-    switch (blockType) {
-        case BlockType::Grass:
-            texCoord = glm::vec2(0, 0) * texSize;
-            break;
-        case BlockType::Dirt:
-            texCoord = glm::vec2(2, 0) * texSize;
-            break;
-        case BlockType::Stone:
-            texCoord = glm::vec2(1, 0) * texSize;
-            break;
-        default:
-            texCoord = glm::vec2(0, 0) * texSize;
-            break;
+  // Layers above and below within this chunk
+  const ChunkSection* below = section > 0 ? blocks_.GetSection(section - 1) : nullptr;
+  const ChunkSection* above =
+      section < SECTIONS_PER_CHUNK - 1 ? blocks_.GetSection(section + 1) : nullptr;
+  const int base_y = section * SECTION_SIZE;
+  for (int z = 0; z < SECTION_SIZE; ++z) {
+    for (int x = 0; x < SECTION_SIZE; ++x) {
+      const int bottom = MeshInput::GetIndex(x, -1, z);
+      const int top = MeshInput::GetIndex(x, SECTION_SIZE, z);
+      if (below) {
+        input->blocks[bottom] = below->GetBlock(x, SECTION_SIZE - 1, z);
+      }
+      if (above) {
+        input->blocks[top] = above->GetBlock(x, 0, z);
+      }
+      if (section > 0) {
+        input->light[bottom] = light_.Get(x, base_y - 1, z);
+      }
+      if (section < SECTIONS_PER_CHUNK - 1) {
+        input->light[top] = light_.Get(x, base_y + SECTION_SIZE, z);
+      }
     }
-    
-    return texCoord;
-}
+  }
+
+  if (!world_) {
+    return;
+  }
 
-// Render the chunk
-void Chunk::render() {
-    if (!meshBuilt) {
-        return;
+  for (const auto& offset : NEIGHBOR_OFFSETS) {
+    const Chunk* neighbor =
+        world_->findChunk(chunk_x_ + offset[0], chunk_z_ + offset[1]);
+    if (!neighbor) {
+      continue;
     }
-    
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+
+    // Column in the neighbor and the padded border it lands in
+    const bool negative = offset[0] + offset[1] < 0;
+    const int source_edge = negative ? SECTION_SIZE - 1 : 0;
+    const int target_edge = negative ? -1 : SECTION_SIZE;
+    const ChunkSection* neighbor_section = neighbor->blocks_.GetSection(section);
+    const ChunkLight& neighbor_light = neighbor->light_;
+
+    for (int y = 0; y < SECTION_SIZE; ++y) {
+      for (int i = 0; i < SECTION_SIZE; ++i) {
+        const int source_x = offset[0] != 0 ? source_edge : i;
+        const int source_z = offset[0] != 0 ? i : source_edge;
+        const int target = offset[0] != 0
+                               ? MeshInput::GetIndex(target_edge, y, i)
+                               : MeshInput::GetIndex(i, y, target_edge);
+        input->light[target] = neighbor_light.Get(source_x, base_y + y, source_z);
+        if (neighbor_section) {
+          input->blocks[target] = neighbor_section->GetBlock(source_x, y, source_z);
+        }
+      }
+    }
+  }
 }
 
-// Update mesh if dirty
-void Chunk::update() {
-    if (meshDirty) {
-        buildMesh();
+void Chunk::ScheduleSectionMesh(int section, MeshWorkerPool* pool) {
+  SectionMesh& mesh = section_meshes_[section];
+
+  // Results of an older job would be stale once it finishes
+  CancelSectionJob(&mesh);
+
+  auto job = std::make_shared<MeshJob>();
+  job->chunk = this;
+  job->section = section;
+  job->revision = mesh.revision;
+  SnapshotMeshInput(section, &job->input);
+
+  mesh.pending_job = job;
+  pool->Submit(std::move(job));
+}
+
+void Chunk::CancelSectionJob(SectionMesh* mesh) {
+  if (mesh->pending_job) {
+    mesh->pending_job->cancelled.store(true, std::memory_order_release);
+    mesh->pending_job.reset();
+  }
+}
+
+bool Chunk::ApplyMeshJob(const MeshJob& job) {
+  SectionMesh& mesh = section_meshes_[job.section];
+  if (mesh.pending_job.get() == &job) {
+    mesh.pending_job.reset();
+  }
+
+  // Edited again after the snapshot; a newer job is or will be queued
+  if (job.revision != mesh.revision) {
+    return false;
+  }
+
+  UploadSectionMesh(&mesh, job.result);
+  return true;
+}
+
+// Only vertices reach the uploader: every mesh draws from the quad index
+// pattern. It sees the section's previous counts, which a shared range
+// needs to be released.
+void Chunk::UploadSectionMesh(SectionMesh* mesh, const ChunkMeshData& mesh_data) {
+  const std::vector<PackedVertex>& vertices = mesh_data.vertices;
+  const size_t indices = vertices.size() / VERTICES_PER_QUAD * INDICES_PER_QUAD;
+  if (MeshUploader* uploader = world_ ? world_->getMeshUploader() : nullptr) {
+    uploader->Upload(mesh, vertices);
+  }
+
+  vertex_count_ += vertices.size() - mesh->vertex_count;
+  index_count_ += indices - mesh->index_count;
+
+  mesh->stats = mesh_data.stats;
+  mesh->face_connections = mesh_data.face_connections;
+  mesh->layers = mesh_data.layers;
+  mesh->vertex_count = vertices.size();
+  mesh->index_count = indices;
+  mesh->built = true;
+}
+
+void Chunk::ReleaseSectionMesh(SectionMesh* mesh) {
+  MeshUploader* uploader = world_ ? world_->getMeshUploader() : nullptr;
+  if (mesh->built && uploader) {
+    uploader->Release(mesh);
+  }
+  mesh->built = false;
+
+  vertex_count_ -= mesh->vertex_count;
+  index_count_ -= mesh->index_count;
+  mesh->vertex_count = 0;
+  mesh->index_count = 0;
+  mesh->layers = {};
+  mesh->stats = MeshStats();
+  mesh->face_connections = ALL_FACES_CONNECTED;
+}
+
+void Chunk::Render() {
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    RenderSection(section);
+  }
+}
+
+void Chunk::RenderSection(int section) const {
+  const SectionMesh& mesh = section_meshes_[section];
+  MeshUploader* uploader = world_ ? world_->getMeshUploader() : nullptr;
+  if (!mesh.built || mesh.index_count == 0 || !uploader) {
+    return;
+  }
+  uploader->Draw(mesh, 0, mesh.index_count, GetWorldPosition());
+}
+
+void Chunk::RenderSectionLayer(int section, RenderLayer layer) const {
+  const SectionMesh& mesh = section_meshes_[section];
+  const LayerRange& range = mesh.layers[static_cast<int>(layer)];
+  MeshUploader* uploader = world_ ? world_->getMeshUploader() : nullptr;
+  if (!mesh.built || range.index_count == 0 || !uploader) {
+    return;
+  }
+  uploader->Draw(mesh, range.first_index, range.index_count, GetWorldPosition());
+}
+
+void Chunk::ReleaseMesh() {
+  for (SectionMesh& mesh : section_meshes_) {
+    ReleaseSectionMesh(&mesh);
+  }
+}
+
+void Chunk::EvictMesh() {
+  for (SectionMesh& mesh : section_meshes_) {
+    CancelSectionJob(&mesh);
+    ReleaseSectionMesh(&mesh);
+  }
+  mesh_evicted_ = true;
+}
+
+void Chunk::RestoreMesh() {
+  if (!mesh_evicted_) {
+    return;
+  }
+  mesh_evicted_ = false;
+  MarkMeshDirty();
+}
+
+bool Chunk::IsMeshReady() const {
+  if (mesh_dirty_ || mesh_evicted_) {
+    return false;
+  }
+  for (const SectionMesh& mesh : section_meshes_) {
+    if (mesh.pending_job) {
+      return false;
     }
+  }
+  return true;
 }
 
-// Clean up OpenGL resources
-void Chunk::cleanup() {
-    if (meshBuilt) {
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &ebo);
-        glDeleteVertexArrays(1, &vao);
-        meshBuilt = false;
+// Only sections with blocks, or with a mesh that has to be released, are
+// touched; all-air sections are skipped.
+void Chunk::MarkMeshDirty() {
+  const uint32_t non_empty = blocks_.GetNonEmptyMask();
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    if ((non_empty & (1u << section)) || section_meshes_[section].built) {
+      MarkSectionMeshDirty(section);
     }
+  }
 }
 
-// Get chunk world position
-glm::vec3 Chunk::getWorldPosition() const {
-    return glm::vec3(chunkX * CHUNK_SIZE, 0, chunkZ * CHUNK_SIZE);
+// Bumping the revision invalidates any mesh job already in flight
+void Chunk::MarkSectionMeshDirty(int section) {
+  SectionMesh& mesh = section_meshes_[section];
+  mesh.dirty = true;
+  ++mesh.revision;
+  mesh_dirty_ = true;
 }
 
-// Check if chunk is loaded
-bool Chunk::isLoaded() const {
-    return meshBuilt;
+void Chunk::SetMeshMode(MeshMode mode) {
+  if (mesh_mode_ != mode) {
+    mesh_mode_ = mode;
+    MarkMeshDirty();
+  }
 }
 
-// Mark mesh as dirty (needs rebuilding)
-void Chunk::markDirty() {
-    meshDirty = true;
+void Chunk::SetMeshLod(int scale, bool skirts) {
+  if (mesh_lod_ != scale || mesh_skirts_ != skirts) {
+    mesh_lod_ = scale;
+    mesh_skirts_ = skirts;
+    MarkMeshDirty();
+  }
 }
+
+MeshStats Chunk::GetMeshStats() const {
+  MeshStats total;
+  total.mode = mesh_mode_;
+  for (const SectionMesh& mesh : section_meshes_) {
+    total.quad_count += mesh.stats.quad_count;
+    total.naive_quad_count += mesh.stats.naive_quad_count;
+  }
+  return total;
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -2,24 +2,38 @@
 #define SRC_WORLD_CHUNK_H_
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <utility>
 #include <vector>
 
+#include <glm/glm.hpp>
+
+#include "chunk_mesh.h"
+#include "chunk_section.h"
+#include "light_engine.h"
+
 namespace cppcraft {
 namespace world {
 
-// Chunk dimensions
-constexpr int CHUNK_SIZE_X = 16;
-constexpr int CHUNK_SIZE_Y = 256;  // Height
-constexpr int CHUNK_SIZE_Z = 16;
-constexpr int CHUNK_VOLUME = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z;
+class MeshWorkerPool;
+class World;
+struct MeshInput;
 
 /**
  * @brief Represents a 16x256x16 chunk of blocks in the world
  * 
  * The Chunk class manages all blocks within a chunk section.
  * Chunks are the fundamental building blocks of the world structure,
- * containing 16x256x16 (65536) block positions.
+ * containing 16x256x16 (65536) block positions, stored as 16 vertical
+ * 16x16x16 sections. All-air sections are not allocated.
+ *
+ * Each section also owns its GPU mesh. A chunk tracks two kinds of
+ * staleness: IsDirty() means the blocks changed since the chunk was last
+ * saved, MarkMeshDirty() means sections must be remeshed. The mesh side is
+ * main thread only, since it drives the world's MeshUploader; a chunk that
+ * is still being created on a streaming worker only touches its blocks and
+ * light.
  */
 class Chunk {
  public:
@@ -27,13 +41,21 @@ class Chunk {
    * @brief Construct a new Chunk object
    * @param chunk_x X coordinate of the chunk in chunk space
    * @param chunk_z Z coordinate of the chunk in chunk space
+   * @param world World the chunk belongs to, for its terrain generator,
+   *              neighbor chunks, mesh workers and mesh uploader; null
+   *              for a standalone chunk, meshed but never uploaded
    */
-  Chunk(int chunk_x, int chunk_z);
+  Chunk(int chunk_x, int chunk_z, World* world = nullptr);
 
   /**
    * @brief Destroy the Chunk object
+   *
+   * In-flight mesh jobs are cancelled and the GPU meshes released.
    */
-  ~Chunk() = default;
+  ~Chunk();
+
+  Chunk(const Chunk&) = delete;
+  Chunk& operator=(const Chunk&) = delete;
 
   /**
    * @brief Get the block ID at the specified local coordinates
@@ -42,16 +64,24 @@ class Chunk {
    * @param z Local Z coordinate (0-15)
    * @return The block ID at the position
    */
-  uint16_t GetBlock(int x, int y, int z) const;
+  uint16_t GetBlock(int x, int y, int z) const {
+    return blocks_.Get(x, y, z);
+  }
 
   /**
    * @brief Set the block ID at the specified local coordinates
+   *
+   * Only the touched section is remeshed, plus the section above or below
+   * when the block lies on a section border. Neighbor chunks are the
+   * world's business (see World::setBlock).
+   *
    * @param x Local X coordinate (0-15)
    * @param y Local Y coordinate (0-255)
    * @param z Local Z coordinate (0-15)
    * @param block_id The block ID to set
+   * @return True if the block changed
    */
-  void SetBlock(int x, int y, int z, uint16_t block_id);
+  bool SetBlock(int x, int y, int z, uint16_t block_id);
 
   /**
    * @brief Get the chunk's X coordinate in chunk space
@@ -65,6 +95,14 @@ class Chunk {
    */
   int GetChunkZ() const { return chunk_z_; }
 
+  /**
+   * @brief Get the chunk's world position (its minimum corner)
+   * @return Position in world space
+   */
+  glm::vec3 GetWorldPosition() const {
+    return glm::vec3(chunk_x_ * CHUNK_SIZE_X, 0.0f, chunk_z_ * CHUNK_SIZE_Z);
+  }
+
   /**
    * @brief Check if the chunk has been modified since last save
    * @return True if the chunk is dirty, false otherwise
@@ -83,6 +121,10 @@ class Chunk {
 
   /**
    * @brief Fill the entire chunk with a single block type
+   *
+   * Light is recomputed within the chunk. In a world, the edit is then
+   * handled like a newly added chunk (see World::chunkBlocksReplaced()).
+   *
    * @param block_id The block ID to fill with
    */
   void Fill(uint16_t block_id);
@@ -118,30 +160,317 @@ class Chunk {
   }
 
   /**
-   * @brief Get a reference to the raw block data
-   * @return Reference to the block data array
+   * @brief Decode all block IDs in one pass
+   *
+   * Much faster than calling GetBlock for every position; used by
+   * meshing and serialization.
+   *
+   * @param out Receives the block IDs, indexed by GetIndex
    */
-  std::array<uint16_t, CHUNK_VOLUME>& GetBlockData() { return blocks_; }
+  void GetBlockData(std::array<uint16_t, CHUNK_VOLUME>& out) const {
+    blocks_.Decode(out.data());
+  }
+
+  /**
+   * @brief Replace all block IDs in one pass
+   *
+   * Light is recomputed within the chunk. In a world, the edit is then
+   * handled like a newly added chunk (see World::chunkBlocksReplaced()).
+   *
+   * @param data Block IDs indexed by GetIndex
+   */
+  void SetBlockData(const std::array<uint16_t, CHUNK_VOLUME>& data);
 
   /**
-   * @brief Get a const reference to the raw block data
-   * @return Const reference to the block data array
+   * @brief Get the sectioned, palette-compressed block storage
+   * @return Const reference to the block storage
    */
-  const std::array<uint16_t, CHUNK_VOLUME>& GetBlockData() const {
-    return blocks_;
+  const ChunkStorage& GetStorage() const { return blocks_; }
+
+  /**
+   * @brief Replace the block storage, e.g. with sections loaded from disk
+   *
+   * The chunk counts as clean afterwards; its light is recomputed within
+   * the chunk and its mesh is rebuilt. In a world, the edit is then handled
+   * like a newly added chunk (see World::chunkBlocksReplaced()).
+   *
+   * @param storage The new block storage
+   */
+  void SetStorage(ChunkStorage storage);
+
+  /**
+   * @brief Record whether the world has added the chunk
+   *
+   * Until then bulk edits stay within the chunk, so a chunk being created
+   * on a streaming worker never touches the world. Called by World.
+   */
+  void SetAddedToWorld(bool added) { added_to_world_ = added; }
+
+  /**
+   * @brief Generate the terrain from the world's terrain generator
+   *
+   * Sections are written in bulk; everything above the surface stays air
+   * and is never allocated. Light is computed within the chunk. Safe on a
+   * streaming worker as long as the chunk is not in the world yet.
+   */
+  void Generate();
+
+  /**
+   * @brief Get the sky and block light of the chunk
+   * @return Const reference to the light storage
+   */
+  const ChunkLight& GetLight() const { return light_; }
+
+  /**
+   * @brief Get the light storage for writing
+   *
+   * Light is derived from the blocks and never saved; it is recomputed
+   * when the chunk is generated, loaded or filled in bulk, and patched by
+   * the world's light updates after block edits.
+   *
+   * @return Pointer to the light storage
+   */
+  ChunkLight* GetMutableLight() { return &light_; }
+
+  /**
+   * @brief Get a vertical section
+   * @param index Section index (0 = bottom, SECTIONS_PER_CHUNK - 1 = top)
+   * @return The section, or nullptr if it is all air
+   */
+  const ChunkSection* GetSection(int index) const {
+    return blocks_.GetSection(index);
   }
 
+  /**
+   * @brief Get the section index containing a local Y coordinate
+   * @param y Local Y coordinate (0-255)
+   * @return Section index
+   */
+  static constexpr int GetSectionIndex(int y) { return y / SECTION_SIZE; }
+
+  /**
+   * @brief Rebuild or schedule the meshes of dirty sections
+   *
+   * With the world's mesh worker pool each dirty section is built in the
+   * background and uploaded later by MeshWorkerPool::UploadFinished();
+   * otherwise the sections are rebuilt synchronously. All-air sections
+   * never get a job. Evicted meshes stay dirty until restored.
+   */
+  void Update();
+
+  /**
+   * @brief Mesh and upload every dirty section synchronously
+   */
+  void BuildMesh();
+
+  /**
+   * @brief Upload a finished background mesh, unless the section changed
+   *        since its snapshot
+   * @param job A job this chunk scheduled
+   * @return True if the mesh was uploaded
+   */
+  bool ApplyMeshJob(const MeshJob& job);
+
+  /**
+   * @brief Mark every non-empty or meshed section for remeshing
+   */
+  void MarkMeshDirty();
+
+  /**
+   * @brief Mark one section for remeshing
+   *
+   * Any mesh job already in flight for it becomes stale.
+   *
+   * @param section Section index (0 = bottom)
+   */
+  void MarkSectionMeshDirty(int section);
+
+  /**
+   * @brief Release every section's GPU mesh
+   *
+   * The mesh is not rebuilt until MarkMeshDirty() is called.
+   */
+  void ReleaseMesh();
+
+  /**
+   * @brief Release the GPU meshes to free video memory
+   *
+   * The blocks stay, so RestoreMesh() can rebuild them when the chunk is
+   * needed again.
+   */
+  void EvictMesh();
+
+  /**
+   * @brief Rebuild an evicted mesh on the next Update()
+   */
+  void RestoreMesh();
+
+  /**
+   * @brief Check if the mesh was released by EvictMesh()
+   */
+  bool IsMeshEvicted() const { return mesh_evicted_; }
+
+  /**
+   * @brief Get the GPU memory held by the section meshes, in bytes
+   *
+   * The shared quad index buffer is not counted.
+   */
+  size_t GetMeshBytes() const { return vertex_count_ * sizeof(PackedVertex); }
+
+  /**
+   * @brief Check if every section's mesh is built and on the GPU
+   */
+  bool IsMeshReady() const;
+
+  /**
+   * @brief Draw every section
+   */
+  void Render();
+
+  /**
+   * @brief Draw one section's mesh through the world's MeshUploader
+   *
+   * Meshes in the shared chunk buffer are queued for its next multi-draw
+   * instead.
+   *
+   * @param section Section index (0 = bottom)
+   */
+  void RenderSection(int section) const;
+
+  /**
+   * @brief Draw one render layer of a section's mesh through the world's
+   *        MeshUploader
+   *
+   * Layers are contiguous quad ranges, so both kinds of mesh draw just that
+   * range of the quad index pattern.
+   *
+   * @param section Section index (0 = bottom)
+   * @param layer The layer to draw
+   */
+  void RenderSectionLayer(int section, RenderLayer layer) const;
+
+  /**
+   * @brief Check if a section has geometry on the GPU
+   */
+  bool HasSectionMesh(int section) const {
+    const SectionMesh& mesh = section_meshes_[section];
+    return mesh.built && mesh.index_count > 0;
+  }
+
+  /**
+   * @brief Check if a section has geometry in a render layer
+   */
+  bool HasSectionLayer(int section, RenderLayer layer) const {
+    const SectionMesh& mesh = section_meshes_[section];
+    return mesh.built && mesh.layers[static_cast<int>(layer)].index_count > 0;
+  }
+
+  /**
+   * @brief Get which faces of a section see each other
+   *
+   * Sections without an uploaded mesh count as fully open, so culling
+   * never hides geometry behind them.
+   *
+   * @return Face connection bits (see AreFacesConnected())
+   */
+  uint64_t GetSectionConnectivity(int section) const {
+    const SectionMesh& mesh = section_meshes_[section];
+    return mesh.built ? mesh.face_connections : ALL_FACES_CONNECTED;
+  }
+
+  /**
+   * @brief Select the meshing strategy; the mesh is rebuilt on the next
+   *        Update()
+   */
+  void SetMeshMode(MeshMode mode);
+
+  MeshMode GetMeshMode() const { return mesh_mode_; }
+
+  /**
+   * @brief Select the level of detail; the mesh is rebuilt on the next
+   *        Update() when either setting changes
+   * @param scale Blocks per mesh cell along each axis (see
+   *              MeshInput::lod_scale)
+   * @param skirts Whether to emit walls on the X/Z sides (see
+   *               MeshInput::skirts)
+   */
+  void SetMeshLod(int scale, bool skirts);
+
+  int GetMeshLod() const { return mesh_lod_; }
+
+  /**
+   * @brief Get quad counts summed over the uploaded section meshes
+   */
+  MeshStats GetMeshStats() const;
+
  private:
+  /**
+   * @brief Copy the blocks and light one section's mesh depends on
+   *
+   * The snapshot holds the section, the border layers of the sections above
+   * and below, and the facing columns of the four neighbor chunks.
+   */
+  void SnapshotMeshInput(int section, MeshInput* input) const;
+
+  /**
+   * @brief Queue a section mesh build on the worker pool
+   */
+  void ScheduleSectionMesh(int section, MeshWorkerPool* pool);
+
+  /**
+   * @brief Drop a section's in-flight job, if any
+   */
+  static void CancelSectionJob(SectionMesh* mesh);
+
+  /**
+   * @brief Recompute light and remesh after the blocks were replaced in
+   *        bulk, and tell the world if the chunk is in one
+   */
+  void ReplacedBlocks();
+
+  /**
+   * @brief Take a section's new mesh and hand its vertices to the uploader
+   */
+  void UploadSectionMesh(SectionMesh* mesh, const ChunkMeshData& mesh_data);
+
+  /**
+   * @brief Drop a section's mesh and free its storage in the uploader
+   */
+  void ReleaseSectionMesh(SectionMesh* mesh);
+
   // Chunk coordinates in chunk space
   int chunk_x_;
   int chunk_z_;
 
-  // Block storage (16x256x16 = 65536 blocks)
-  // Indexed as: blocks_[y * (16 * 16) + z * 16 + x]
-  std::array<uint16_t, CHUNK_VOLUME> blocks_;
+  // Sectioned, palette-compressed block storage (16x256x16 = 65536 blocks)
+  // Bulk data is indexed as: y * (16 * 16) + z * 16 + x
+  ChunkStorage blocks_;
+
+  // Sky and block light, 4 bits each per block
+  ChunkLight light_;
 
-  // Flag indicating if this chunk has been modified
+  // Flag indicating if this chunk has been modified since it was saved
   bool is_dirty_;
+
+  // Owning world, or null for a standalone chunk
+  World* world_;
+  bool added_to_world_;
+
+  // GPU meshes and rebuild state, one per section
+  std::array<SectionMesh, SECTIONS_PER_CHUNK> section_meshes_;
+
+  // Whether any section needs remeshing, and whether the meshes were evicted
+  bool mesh_dirty_;
+  bool mesh_evicted_;
+
+  // Mesh settings applied to every section
+  MeshMode mesh_mode_;
+  int mesh_lod_;
+  bool mesh_skirts_;
+
+  // Vertices and indices summed over the uploaded section meshes
+  size_t vertex_count_;
+  size_t index_count_;
 };
 
 }  // namespace world
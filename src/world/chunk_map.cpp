@@ -0,0 +1,132 @@
+#include "chunk_map.h"
+
+#include <utility>
+
+#include "chunk.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Initial slot count; a render radius of 8 loads about 200 chunks
+constexpr size_t INITIAL_SLOTS = 256;
+
+// Grow once more than 5/8 of the slots are used
+constexpr size_t LOAD_NUMERATOR = 5;
+constexpr size_t LOAD_DENOMINATOR = 8;
+
+// 64-bit finalizer (MurmurHash3); neighboring coordinates spread over the
+// whole table instead of clustering in adjacent slots
+uint64_t Mix(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDull;
+  key ^= key >> 33;
+  key *= 0xC4CEB9FE1A85EC53ull;
+  key ^= key >> 33;
+  return key;
+}
+
+}  // namespace
+
+ChunkMap::ChunkMap()
+    : slots_(INITIAL_SLOTS),
+      mask_(INITIAL_SLOTS - 1),
+      size_(0),
+      cached_key_(0),
+      cached_chunk_(nullptr) {}
+
+ChunkMap::~ChunkMap() = default;
+
+Chunk* ChunkMap::Insert(int chunk_x, int chunk_z, std::unique_ptr<Chunk> chunk) {
+  if ((size_ + 1) * LOAD_DENOMINATOR > slots_.size() * LOAD_NUMERATOR) {
+    Grow();
+  }
+
+  const uint64_t key = Key(chunk_x, chunk_z);
+  size_t index = HomeSlot(key);
+  while (slots_[index].chunk) {
+    index = (index + 1) & mask_;
+  }
+
+  slots_[index].key = key;
+  slots_[index].chunk = std::move(chunk);
+  ++size_;
+  return slots_[index].chunk.get();
+}
+
+std::unique_ptr<Chunk> ChunkMap::Remove(int chunk_x, int chunk_z) {
+  const uint64_t key = Key(chunk_x, chunk_z);
+  size_t index = HomeSlot(key);
+  while (slots_[index].chunk && slots_[index].key != key) {
+    index = (index + 1) & mask_;
+  }
+  if (!slots_[index].chunk) {
+    return nullptr;
+  }
+
+  std::unique_ptr<Chunk> removed = std::move(slots_[index].chunk);
+  --size_;
+  if (cached_chunk_ == removed.get()) {
+    cached_chunk_ = nullptr;
+  }
+
+  // Backward-shift deletion: pull later members of the probe run into the
+  // hole whenever the hole lies between their home slot and their slot
+  size_t hole = index;
+  size_t next = (hole + 1) & mask_;
+  while (slots_[next].chunk) {
+    const size_t home = HomeSlot(slots_[next].key);
+    if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+      slots_[hole] = std::move(slots_[next]);
+      hole = next;
+    }
+    next = (next + 1) & mask_;
+  }
+  return removed;
+}
+
+void ChunkMap::Clear() {
+  for (Slot& slot : slots_) {
+    slot.chunk.reset();
+  }
+  size_ = 0;
+  cached_chunk_ = nullptr;
+}
+
+Chunk* ChunkMap::FindSlow(uint64_t key) const {
+  size_t index = HomeSlot(key);
+  while (slots_[index].chunk) {
+    if (slots_[index].key == key) {
+      cached_key_ = key;
+      cached_chunk_ = slots_[index].chunk.get();
+      return cached_chunk_;
+    }
+    index = (index + 1) & mask_;
+  }
+  return nullptr;
+}
+
+size_t ChunkMap::HomeSlot(uint64_t key) const {
+  return static_cast<size_t>(Mix(key)) & mask_;
+}
+
+void ChunkMap::Grow() {
+  std::vector<Slot> old = std::move(slots_);
+  slots_ = std::vector<Slot>(old.size() * 2);
+  mask_ = slots_.size() - 1;
+
+  for (Slot& slot : old) {
+    if (!slot.chunk) {
+      continue;
+    }
+    size_t index = HomeSlot(slot.key);
+    while (slots_[index].chunk) {
+      index = (index + 1) & mask_;
+    }
+    slots_[index] = std::move(slot);
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
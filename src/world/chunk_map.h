@@ -0,0 +1,130 @@
+#ifndef SRC_WORLD_CHUNK_MAP_H_
+#define SRC_WORLD_CHUNK_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cppcraft {
+namespace world {
+
+class Chunk;
+
+/**
+ * @brief Open-addressing hash table of loaded chunks by chunk coordinates
+ *
+ * Slots hold the full 64-bit key (chunk X in the high 32 bits, chunk Z in
+ * the low 32 bits) next to the owning pointer in one flat array, so a
+ * lookup is a hash plus a short linear probe over adjacent slots. Removal
+ * uses backward-shift deletion, so there are no tombstones.
+ *
+ * The most recently found chunk is cached: runs of lookups that stay inside
+ * one chunk, as block access loops usually do, skip the hash entirely.
+ *
+ * Not thread-safe; lookups update the cache.
+ */
+class ChunkMap {
+ public:
+  ChunkMap();
+  ~ChunkMap();
+
+  ChunkMap(const ChunkMap&) = delete;
+  ChunkMap& operator=(const ChunkMap&) = delete;
+
+  /**
+   * @brief Find a loaded chunk
+   * @return The chunk, or nullptr if it is not in the map
+   */
+  Chunk* Find(int chunk_x, int chunk_z) const {
+    const uint64_t key = Key(chunk_x, chunk_z);
+    if (cached_chunk_ && cached_key_ == key) {
+      return cached_chunk_;
+    }
+    return FindSlow(key);
+  }
+
+  /**
+   * @brief Check if a chunk is in the map
+   */
+  bool Contains(int chunk_x, int chunk_z) const {
+    return Find(chunk_x, chunk_z) != nullptr;
+  }
+
+  /**
+   * @brief Add a chunk
+   * @param chunk The chunk; must not already be in the map
+   * @return Pointer to the stored chunk
+   */
+  Chunk* Insert(int chunk_x, int chunk_z, std::unique_ptr<Chunk> chunk);
+
+  /**
+   * @brief Remove a chunk and hand it back
+   * @return The removed chunk, or nullptr if it is not in the map
+   */
+  std::unique_ptr<Chunk> Remove(int chunk_x, int chunk_z);
+
+  /**
+   * @brief Destroy every chunk
+   */
+  void Clear();
+
+  /**
+   * @brief Get the number of chunks in the map
+   */
+  size_t Size() const { return size_; }
+
+  /**
+   * @brief Call a function on every chunk, in no particular order
+   *
+   * The map must not be modified during the walk.
+   *
+   * @param function Called as function(Chunk&)
+   */
+  template <typename Function>
+  void ForEach(Function&& function) const {
+    for (const Slot& slot : slots_) {
+      if (slot.chunk) {
+        function(*slot.chunk);
+      }
+    }
+  }
+
+  /**
+   * @brief Pack chunk coordinates into a map key
+   */
+  static uint64_t Key(int chunk_x, int chunk_z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x)) << 32) |
+           static_cast<uint32_t>(chunk_z);
+  }
+
+ private:
+  struct Slot {
+    uint64_t key = 0;
+    std::unique_ptr<Chunk> chunk;  // Null for an empty slot
+  };
+
+  Chunk* FindSlow(uint64_t key) const;
+
+  /**
+   * @brief Get the home slot of a key
+   */
+  size_t HomeSlot(uint64_t key) const;
+
+  /**
+   * @brief Double the slot count and reinsert every chunk
+   */
+  void Grow();
+
+  std::vector<Slot> slots_;  // Power-of-two length
+  size_t mask_;
+  size_t size_;
+
+  mutable uint64_t cached_key_;
+  mutable Chunk* cached_chunk_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_CHUNK_MAP_H_
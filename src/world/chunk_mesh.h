@@ -0,0 +1,280 @@
+#ifndef SRC_WORLD_CHUNK_MESH_H_
+#define SRC_WORLD_CHUNK_MESH_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chunk_section.h"
+
+class ChunkBuffer;
+
+namespace cppcraft {
+namespace world {
+
+struct MeshJob;
+
+/**
+ * @struct PackedVertex
+ * @brief 8-byte chunk mesh vertex, decoded in shaders/vertex.glsl
+ *
+ * Word 0 holds the chunk-local corner position and the face index:
+ * - bits 0-4:   x (0-16)
+ * - bits 5-13:  y (0-256)
+ * - bits 14-18: z (0-16)
+ * - bits 19-21: face (0 = +Z, 1 = -Z, 2 = -X, 3 = +X, 4 = -Y, 5 = +Y)
+ * - bits 22-31: reserved
+ *
+ * Word 1 holds the block texture array layer in bits 0-15 (see
+ * block_textures.h), the face's block light in bits 16-19 and its sky light
+ * in bits 20-23 (see light_engine.h); bits 24-31 are reserved.
+ *
+ * Corners sit on block boundaries, so each axis needs one bit more than
+ * the block coordinate range. The normal and the block-space texture
+ * coordinates are derived from the face index and position in the shader.
+ */
+struct PackedVertex {
+  uint32_t position_face;
+  uint32_t texture_data;
+};
+
+static_assert(sizeof(PackedVertex) == 8, "PackedVertex must stay 8 bytes");
+
+/**
+ * @brief Pack a chunk mesh vertex
+ * @param x Chunk-local corner X (0-16)
+ * @param y Chunk-local corner Y (0-256)
+ * @param z Chunk-local corner Z (0-16)
+ * @param face Face index (0-5)
+ * @param layer Block texture array layer
+ * @param light Light of the face, sky in the high nibble and block light in
+ *              the low nibble
+ * @return The packed vertex
+ */
+inline PackedVertex PackVertex(int x, int y, int z, int face, int layer,
+                               uint8_t light) {
+  PackedVertex vertex;
+  vertex.position_face = (static_cast<uint32_t>(x) & 0x1Fu) |
+                         ((static_cast<uint32_t>(y) & 0x1FFu) << 5) |
+                         ((static_cast<uint32_t>(z) & 0x1Fu) << 14) |
+                         ((static_cast<uint32_t>(face) & 0x7u) << 19);
+  vertex.texture_data = (static_cast<uint32_t>(layer) & 0xFFFFu) |
+                        (static_cast<uint32_t>(light) << 16);
+  return vertex;
+}
+
+// Every mesh is a list of quads, four vertices each, drawn with one shared
+// index pattern: quad q uses vertices 4q to 4q+3 as the triangles
+// (0, 1, 2) and (0, 2, 3). No mesh stores indices of its own.
+constexpr int VERTICES_PER_QUAD = 4;
+constexpr int INDICES_PER_QUAD = 6;
+
+// Most quads one section mesh can hold: six faces of every cell
+constexpr size_t MAX_SECTION_QUADS = static_cast<size_t>(SECTION_VOLUME) * 6;
+
+/**
+ * @brief Write the shared quad index pattern
+ * @param out Destination for quad_count * INDICES_PER_QUAD indices
+ * @param quad_count Number of quads to cover
+ */
+inline void FillQuadIndices(unsigned int* out, size_t quad_count) {
+  for (size_t quad = 0; quad < quad_count; ++quad) {
+    const unsigned int base = static_cast<unsigned int>(quad * VERTICES_PER_QUAD);
+    out[0] = base;
+    out[1] = base + 1;
+    out[2] = base + 2;
+    out[3] = base;
+    out[4] = base + 2;
+    out[5] = base + 3;
+    out += INDICES_PER_QUAD;
+  }
+}
+
+/**
+ * @enum MeshMode
+ * @brief Strategy used to turn chunk blocks into renderable quads
+ */
+enum class MeshMode {
+  /**
+   * One quad per exposed block face
+   */
+  Naive,
+
+  /**
+   * Coplanar exposed faces of the same block type are merged into
+   * larger rectangles before being emitted
+   */
+  Greedy
+};
+
+/**
+ * @struct MeshStats
+ * @brief Quad counts reported by the last mesh build of a chunk
+ */
+struct MeshStats {
+  /**
+   * @brief Mode used for the last build
+   */
+  MeshMode mode = MeshMode::Naive;
+
+  /**
+   * @brief Number of quads actually emitted
+   */
+  size_t quad_count = 0;
+
+  /**
+   * @brief Number of quads the naive mesher produces for the same blocks
+   *
+   * Equal to the number of exposed faces; matches quad_count in naive mode.
+   */
+  size_t naive_quad_count = 0;
+};
+
+// Face-to-face visibility through a section: bit (a * 6 + b) is set when
+// faces a and b are joined by a path of transparent blocks. Used by the
+// renderer's cave culling.
+constexpr uint64_t ALL_FACES_CONNECTED = (uint64_t{1} << 36) - 1;
+
+/**
+ * @brief Check if a section can be seen through from one face to another
+ * @param connections Face connection bits of the section
+ * @param from Face index the view enters through
+ * @param to Face index the view leaves through
+ */
+inline bool AreFacesConnected(uint64_t connections, int from, int to) {
+  return (connections >> (from * 6 + to)) & 1;
+}
+
+/**
+ * @enum RenderLayer
+ * @brief Render pass a block's faces are drawn in
+ */
+enum class RenderLayer {
+  /**
+   * Fully opaque blocks; drawn first, front to back
+   */
+  Opaque = 0,
+
+  /**
+   * Alpha-tested blocks with holes (leaves, plants, fences)
+   */
+  Cutout = 1,
+
+  /**
+   * Alpha-blended blocks (water, ice); drawn last, back to front, without
+   * depth writes
+   */
+  Translucent = 2
+};
+
+constexpr int RENDER_LAYER_COUNT = 3;
+
+/**
+ * @struct LayerRange
+ * @brief Indices of one render layer in the shared quad index pattern
+ *
+ * A layer's quads are contiguous, so its range of the pattern addresses
+ * exactly its vertices.
+ */
+struct LayerRange {
+  size_t first_index = 0;
+  size_t index_count = 0;
+};
+
+/**
+ * @struct ChunkMeshData
+ * @brief CPU-side mesh produced by the mesher, ready for GPU upload
+ */
+struct ChunkMeshData {
+  /**
+   * @brief Packed vertex data, four vertices per quad, grouped by render layer
+   */
+  std::vector<PackedVertex> vertices;
+
+  /**
+   * @brief Where each render layer's quads start, indexed by RenderLayer
+   */
+  std::array<LayerRange, RENDER_LAYER_COUNT> layers;
+
+  /**
+   * @brief Quad counts for this mesh
+   */
+  MeshStats stats;
+
+  /**
+   * @brief Which faces of the section see each other through transparent blocks
+   */
+  uint64_t face_connections = ALL_FACES_CONNECTED;
+};
+
+/**
+ * @struct SectionMesh
+ * @brief GPU buffers and rebuild state of one chunk section's mesh
+ */
+struct SectionMesh {
+  /**
+   * @brief OpenGL objects, valid while built is true and shared_buffer is null
+   *
+   * The VAO draws its indices from the shared quad index buffer. This and
+   * the shared buffer fields below are set by the world's MeshUploader.
+   */
+  unsigned int vao = 0;
+  unsigned int vbo = 0;
+
+  /**
+   * @brief Shared chunk buffer holding the mesh instead of the objects above
+   *
+   * The offset locates the mesh's vertices inside it.
+   */
+  ::ChunkBuffer* shared_buffer = nullptr;
+  size_t vertex_offset = 0;
+
+  /**
+   * @brief Number of vertices and of indices drawn for the uploaded mesh
+   */
+  size_t vertex_count = 0;
+  size_t index_count = 0;
+
+  /**
+   * @brief Index ranges of the uploaded mesh's render layers
+   */
+  std::array<LayerRange, RENDER_LAYER_COUNT> layers;
+
+  /**
+   * @brief Whether the mesh is built; it is on the GPU if the world has a
+   *        MeshUploader
+   */
+  bool built = false;
+
+  /**
+   * @brief Whether the section changed since its last build was started
+   */
+  bool dirty = true;
+
+  /**
+   * @brief Bumped on every edit; jobs started at an older revision are stale
+   */
+  uint64_t revision = 0;
+
+  /**
+   * @brief Background build in flight, if any
+   */
+  std::shared_ptr<MeshJob> pending_job;
+
+  /**
+   * @brief Quad counts of the uploaded mesh
+   */
+  MeshStats stats;
+
+  /**
+   * @brief Face connections of the uploaded mesh's blocks
+   */
+  uint64_t face_connections = ALL_FACES_CONNECTED;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_CHUNK_MESH_H_
@@ -0,0 +1,489 @@
+#include "chunk_mesher.h"
+
+#include <algorithm>
+#include <array>
+
+#include "block.h"
+#include "block_textures.h"
+#include "light_engine.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Axes per face: normal axis, step along it, and the two in-plane axes
+// matching the u/v extents expected by AddFace (0 = X, 1 = Y, 2 = Z)
+constexpr int FACE_AXIS[6] = {2, 2, 0, 0, 1, 1};
+constexpr int FACE_STEP[6] = {1, -1, -1, 1, -1, 1};
+constexpr int FACE_U_AXIS[6] = {0, 0, 2, 2, 0, 0};
+constexpr int FACE_V_AXIS[6] = {1, 1, 1, 1, 2, 2};
+
+// A face is drawn when the neighbor can be seen through, except between two
+// blocks of the same kind (water next to water, leaves next to leaves)
+inline bool IsFaceExposed(uint16_t block_id, uint16_t neighbor_id) {
+  return IsTransparentBlock(neighbor_id) && neighbor_id != block_id;
+}
+
+// Pass a block's faces are drawn in
+inline RenderLayer GetRenderLayer(uint16_t block_id) {
+  if (!IsTransparentBlock(block_id)) {
+    return RenderLayer::Opaque;
+  }
+  return IsTranslucentBlock(block_id) ? RenderLayer::Translucent
+                                      : RenderLayer::Cutout;
+}
+
+// Blocks that make a downsampled cell solid and can show on top of it;
+// plants and other thin blocks vanish at a distance
+inline bool IsLodVisible(uint16_t block_id) {
+  return IsSolidBlock(block_id) || IsLiquidBlock(block_id);
+}
+
+}  // namespace
+
+ChunkMesher::ChunkMesher(const MeshInput& input, ChunkMeshData* output,
+                         MeshScratch* scratch)
+    : input_(input),
+      output_(output),
+      scratch_(scratch ? scratch : &local_scratch_),
+      cells_(input.blocks.data()),
+      cell_light_(input.light.empty() ? nullptr : input.light.data()),
+      grid_size_(SECTION_SIZE),
+      grid_stride_(MESH_INPUT_SIZE),
+      scale_(1) {}
+
+void ChunkMesher::Build() {
+  output_->stats = MeshStats();
+  output_->stats.mode = input_.mode;
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; ++layer) {
+    std::vector<PackedVertex>& vertices = scratch_->layer_vertices[layer];
+    vertices.clear();
+    vertices.reserve(input_.expected_quads[layer] * VERTICES_PER_QUAD);
+  }
+
+  // Downsampled cells are always merged; that is where the savings are
+  if (input_.lod_scale > 1) {
+    BuildLodGrid();
+  }
+  if (input_.mode == MeshMode::Greedy || scale_ > 1) {
+    output_->stats.mode = MeshMode::Greedy;
+    BuildGreedy();
+  } else {
+    BuildNaive();
+    output_->stats.naive_quad_count = output_->stats.quad_count;
+  }
+  MergeLayers();
+
+  output_->face_connections = ComputeFaceConnections();
+}
+
+uint64_t ChunkMesher::ComputeFaceConnections() const {
+  std::array<bool, SECTION_VOLUME> visited{};
+  std::array<int, SECTION_VOLUME> stack;
+  uint64_t connections = 0;
+
+  for (int start = 0; start < SECTION_VOLUME; ++start) {
+    const int sx = start % SECTION_SIZE;
+    const int sz = (start / SECTION_SIZE) % SECTION_SIZE;
+    const int sy = start / SECTION_AREA;
+    if (visited[start] || !IsTransparentBlock(GetInputBlock(sx, sy, sz))) {
+      continue;
+    }
+
+    // Collect the faces touched by this see-through pocket
+    int faces = 0;
+    int top = 0;
+    stack[top++] = start;
+    visited[start] = true;
+
+    while (top > 0) {
+      const int index = stack[--top];
+      const int p[3] = {index % SECTION_SIZE, index / SECTION_AREA,
+                        (index / SECTION_SIZE) % SECTION_SIZE};
+
+      for (int face = 0; face < 6; ++face) {
+        int n[3] = {p[0], p[1], p[2]};
+        n[FACE_AXIS[face]] += FACE_STEP[face];
+        if (n[FACE_AXIS[face]] < 0 || n[FACE_AXIS[face]] >= SECTION_SIZE) {
+          faces |= 1 << face;
+          continue;
+        }
+
+        const int next = ChunkSection::GetIndex(n[0], n[1], n[2]);
+        if (!visited[next] &&
+            IsTransparentBlock(GetInputBlock(n[0], n[1], n[2]))) {
+          visited[next] = true;
+          stack[top++] = next;
+        }
+      }
+    }
+
+    for (int a = 0; a < 6; ++a) {
+      for (int b = 0; b < 6; ++b) {
+        if ((faces & (1 << a)) && (faces & (1 << b))) {
+          connections |= uint64_t{1} << (a * 6 + b);
+        }
+      }
+    }
+
+    if (connections == ALL_FACES_CONNECTED) {
+      break;
+    }
+  }
+
+  return connections;
+}
+
+uint16_t ChunkMesher::GetBlock(int x, int y, int z) const {
+  return cells_[((y + 1) * grid_stride_ + (z + 1)) * grid_stride_ + (x + 1)];
+}
+
+uint8_t ChunkMesher::GetLight(int x, int y, int z) const {
+  if (!cell_light_) {
+    return FULL_SKY_LIGHT;
+  }
+  return cell_light_[((y + 1) * grid_stride_ + (z + 1)) * grid_stride_ + (x + 1)];
+}
+
+uint16_t ChunkMesher::GetInputBlock(int x, int y, int z) const {
+  return input_.blocks[MeshInput::GetIndex(x, y, z)];
+}
+
+void ChunkMesher::BuildLodGrid() {
+  const int scale = input_.lod_scale;
+  if (scale > MAX_LOD_SCALE || SECTION_SIZE % scale != 0) {
+    return;
+  }
+
+  scale_ = scale;
+  grid_size_ = SECTION_SIZE / scale;
+  grid_stride_ = grid_size_ + 2;
+  const int cells = grid_stride_ * grid_stride_ * grid_stride_;
+  scratch_->lod_cells.assign(cells, AIR_BLOCK_ID);
+  scratch_->lod_light.assign(cells, FULL_SKY_LIGHT);
+
+  // Interior cells merge scale^3 blocks; border cells merge the matching
+  // patch of the one-block snapshot border. Edge and corner border cells
+  // are never looked at.
+  for (int cy = -1; cy <= grid_size_; ++cy) {
+    for (int cz = -1; cz <= grid_size_; ++cz) {
+      for (int cx = -1; cx <= grid_size_; ++cx) {
+        const int cell[3] = {cx, cy, cz};
+        int min[3];
+        int size[3];
+        int outside = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+          if (cell[axis] < 0 || cell[axis] >= grid_size_) {
+            ++outside;
+            min[axis] = cell[axis] < 0 ? -1 : SECTION_SIZE;
+            size[axis] = 1;
+          } else {
+            min[axis] = cell[axis] * scale;
+            size[axis] = scale;
+          }
+        }
+        if (outside > 1) {
+          continue;
+        }
+        DownsampleBox(min, size,
+                      ((cy + 1) * grid_stride_ + (cz + 1)) * grid_stride_ + (cx + 1));
+      }
+    }
+  }
+
+  cells_ = scratch_->lod_cells.data();
+  cell_light_ = scratch_->lod_light.data();
+}
+
+void ChunkMesher::DownsampleBox(const int min[3], const int size[3], int cell) {
+  std::array<uint16_t, MAX_LOD_SCALE * MAX_LOD_SCALE> tops;
+  int top_count = 0;
+  int filled = 0;
+  uint8_t sky = 0;
+  uint8_t block = 0;
+
+  for (int z = min[2]; z < min[2] + size[2]; ++z) {
+    for (int x = min[0]; x < min[0] + size[0]; ++x) {
+      bool found_top = false;
+      for (int y = min[1] + size[1] - 1; y >= min[1]; --y) {
+        const uint16_t block_id = GetInputBlock(x, y, z);
+        if (IsLodVisible(block_id)) {
+          ++filled;
+          if (!found_top) {
+            tops[top_count++] = block_id;
+            found_top = true;
+          }
+        }
+        if (!input_.light.empty()) {
+          const uint8_t light = input_.light[MeshInput::GetIndex(x, y, z)];
+          sky = std::max<uint8_t>(sky, light >> 4);
+          block = std::max<uint8_t>(block, light & 0xF);
+        }
+      }
+    }
+  }
+
+  if (!input_.light.empty()) {
+    scratch_->lod_light[cell] = PackLight(sky, block);
+  }
+  if (filled * 2 < size[0] * size[1] * size[2]) {
+    return;
+  }
+
+  // The block seen from above most often
+  std::sort(tops.begin(), tops.begin() + top_count);
+  uint16_t best = tops[0];
+  int best_run = 0;
+  for (int i = 0; i < top_count;) {
+    int run = 1;
+    while (i + run < top_count && tops[i + run] == tops[i]) {
+      ++run;
+    }
+    if (run > best_run) {
+      best = tops[i];
+      best_run = run;
+    }
+    i += run;
+  }
+  scratch_->lod_cells[cell] = best;
+}
+
+bool ChunkMesher::IsFaceVisible(int x, int y, int z, uint16_t block_id,
+                                int face, uint8_t* light) const {
+  int neighbor[3] = {x, y, z};
+  neighbor[FACE_AXIS[face]] += FACE_STEP[face];
+  const uint16_t neighbor_id = GetBlock(neighbor[0], neighbor[1], neighbor[2]);
+
+  if (IsFaceExposed(block_id, neighbor_id)) {
+    *light = GetLight(neighbor[0], neighbor[1], neighbor[2]);
+    return true;
+  }
+
+  // Skirt: an opaque wall on the section's X/Z sides, lit as if open to the
+  // sky since it only shows through cracks near the surface
+  const int axis = FACE_AXIS[face];
+  if (input_.skirts && axis != 1 && !IsTransparentBlock(block_id) &&
+      (neighbor[axis] < 0 || neighbor[axis] >= grid_size_)) {
+    *light = FULL_SKY_LIGHT;
+    return true;
+  }
+  return false;
+}
+
+void ChunkMesher::BuildNaive() {
+  for (int y = 0; y < grid_size_; ++y) {
+    for (int z = 0; z < grid_size_; ++z) {
+      for (int x = 0; x < grid_size_; ++x) {
+        uint16_t block_id = GetBlock(x, y, z);
+        if (block_id == AIR_BLOCK_ID) {
+          continue;
+        }
+
+        for (int face = 0; face < 6; ++face) {
+          AddFaceIfExposed(x, y, z, block_id, face);
+        }
+      }
+    }
+  }
+}
+
+void ChunkMesher::BuildGreedy() {
+  // Exposed block ID in the low 16 bits and face light above it, so only
+  // faces that look the same are merged; zero for no face
+  std::vector<uint32_t>& mask = scratch_->mask;
+  mask.resize(grid_size_ * grid_size_);
+
+  for (int face = 0; face < 6; ++face) {
+    const int axis = FACE_AXIS[face];
+    const int u_axis = FACE_U_AXIS[face];
+    const int v_axis = FACE_V_AXIS[face];
+    const int u_size = grid_size_;
+    const int v_size = grid_size_;
+
+    for (int slice = 0; slice < grid_size_; ++slice) {
+      // Build the mask of exposed faces in this slice
+      int pos[3];
+      pos[axis] = slice;
+      bool any_exposed = false;
+
+      for (int v = 0; v < v_size; ++v) {
+        pos[v_axis] = v;
+        for (int u = 0; u < u_size; ++u) {
+          pos[u_axis] = u;
+
+          uint32_t& cell = mask[u + v * u_size];
+          cell = AIR_BLOCK_ID;
+
+          uint16_t block_id = GetBlock(pos[0], pos[1], pos[2]);
+          if (block_id == AIR_BLOCK_ID) {
+            continue;
+          }
+
+          uint8_t light;
+          if (!IsFaceVisible(pos[0], pos[1], pos[2], block_id, face, &light)) {
+            continue;
+          }
+
+          cell = block_id | (static_cast<uint32_t>(light) << 16);
+          any_exposed = true;
+          output_->stats.naive_quad_count++;
+        }
+      }
+
+      if (!any_exposed) {
+        continue;
+      }
+
+      // Greedily grow rectangles along u, then along v
+      for (int v = 0; v < v_size; ++v) {
+        for (int u = 0; u < u_size;) {
+          uint32_t face_key = mask[u + v * u_size];
+          if (face_key == AIR_BLOCK_ID) {
+            ++u;
+            continue;
+          }
+
+          int width = 1;
+          while (u + width < u_size && mask[u + width + v * u_size] == face_key) {
+            ++width;
+          }
+
+          int height = 1;
+          bool can_grow = true;
+          while (v + height < v_size && can_grow) {
+            for (int k = 0; k < width; ++k) {
+              if (mask[u + k + (v + height) * u_size] != face_key) {
+                can_grow = false;
+                break;
+              }
+            }
+            if (can_grow) {
+              ++height;
+            }
+          }
+
+          pos[u_axis] = u;
+          pos[v_axis] = v;
+          AddFace(pos[0], pos[1], pos[2], face, face_key & 0xFFFFu,
+                  static_cast<uint8_t>(face_key >> 16), width, height);
+
+          // Clear the merged cells so they are not emitted again
+          for (int dv = 0; dv < height; ++dv) {
+            for (int du = 0; du < width; ++du) {
+              mask[u + du + (v + dv) * u_size] = AIR_BLOCK_ID;
+            }
+          }
+
+          u += width;
+        }
+      }
+    }
+  }
+}
+
+void ChunkMesher::AddFaceIfExposed(int x, int y, int z, uint16_t block_id,
+                                   int face) {
+  uint8_t light;
+  if (IsFaceVisible(x, y, z, block_id, face, &light)) {
+    AddFace(x, y, z, face, block_id, light, 1, 1);
+  }
+}
+
+void ChunkMesher::AddFace(int x, int y, int z, int face, uint16_t block_id,
+                          uint8_t light, int width, int height) {
+  std::vector<PackedVertex>& vertices =
+      scratch_->layer_vertices[static_cast<int>(GetRenderLayer(block_id))];
+  output_->stats.quad_count++;
+
+  int texture_layer = GetBlockTextureLayer(block_id, face);
+
+  // Cells to blocks; d is the depth of one cell
+  const int d = scale_;
+  const int w = width * d;
+  const int h = height * d;
+  x *= d;
+  y *= d;
+  z *= d;
+
+  // Vertices are chunk-local; the snapshot is section-local
+  y += input_.section_y * SECTION_SIZE;
+
+  // Corner positions in the same winding the mesher has always emitted
+  int corners[4][3];
+
+  switch (face) {
+    case 0:  // Front (+Z)
+      corners[0][0] = x;     corners[0][1] = y;     corners[0][2] = z + d;
+      corners[1][0] = x + w; corners[1][1] = y;     corners[1][2] = z + d;
+      corners[2][0] = x + w; corners[2][1] = y + h; corners[2][2] = z + d;
+      corners[3][0] = x;     corners[3][1] = y + h; corners[3][2] = z + d;
+      break;
+    case 1:  // Back (-Z)
+      corners[0][0] = x + w; corners[0][1] = y;     corners[0][2] = z;
+      corners[1][0] = x;     corners[1][1] = y;     corners[1][2] = z;
+      corners[2][0] = x;     corners[2][1] = y + h; corners[2][2] = z;
+      corners[3][0] = x + w; corners[3][1] = y + h; corners[3][2] = z;
+      break;
+    case 2:  // Left (-X)
+      corners[0][0] = x; corners[0][1] = y;     corners[0][2] = z;
+      corners[1][0] = x; corners[1][1] = y;     corners[1][2] = z + w;
+      corners[2][0] = x; corners[2][1] = y + h; corners[2][2] = z + w;
+      corners[3][0] = x; corners[3][1] = y + h; corners[3][2] = z;
+      break;
+    case 3:  // Right (+X)
+      corners[0][0] = x + d; corners[0][1] = y;     corners[0][2] = z + w;
+      corners[1][0] = x + d; corners[1][1] = y;     corners[1][2] = z;
+      corners[2][0] = x + d; corners[2][1] = y + h; corners[2][2] = z;
+      corners[3][0] = x + d; corners[3][1] = y + h; corners[3][2] = z + w;
+      break;
+    case 4:  // Bottom (-Y)
+      corners[0][0] = x;     corners[0][1] = y; corners[0][2] = z + h;
+      corners[1][0] = x;     corners[1][1] = y; corners[1][2] = z;
+      corners[2][0] = x + w; corners[2][1] = y; corners[2][2] = z;
+      corners[3][0] = x + w; corners[3][1] = y; corners[3][2] = z + h;
+      break;
+    default:  // Top (+Y)
+      corners[0][0] = x;     corners[0][1] = y + d; corners[0][2] = z;
+      corners[1][0] = x;     corners[1][1] = y + d; corners[1][2] = z + h;
+      corners[2][0] = x + w; corners[2][1] = y + d; corners[2][2] = z + h;
+      corners[3][0] = x + w; corners[3][1] = y + d; corners[3][2] = z;
+      break;
+  }
+
+  // Written in place; the triangles come from the shared index pattern
+  const size_t first = vertices.size();
+  vertices.resize(first + VERTICES_PER_QUAD);
+  PackedVertex* out = vertices.data() + first;
+  for (const int* corner : corners) {
+    *out++ = PackVertex(corner[0], corner[1], corner[2], face, texture_layer, light);
+  }
+}
+
+void ChunkMesher::MergeLayers() {
+  size_t total = 0;
+  for (const std::vector<PackedVertex>& layer : scratch_->layer_vertices) {
+    total += layer.size();
+  }
+
+  // Sized once; the output leaves this thread with the job
+  std::vector<PackedVertex>& vertices = output_->vertices;
+  vertices.clear();
+  vertices.shrink_to_fit();
+  vertices.resize(total);
+
+  size_t first_vertex = 0;
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; ++layer) {
+    const std::vector<PackedVertex>& quads = scratch_->layer_vertices[layer];
+    std::copy(quads.begin(), quads.end(), vertices.begin() + first_vertex);
+
+    output_->layers[layer].first_index =
+        first_vertex / VERTICES_PER_QUAD * INDICES_PER_QUAD;
+    output_->layers[layer].index_count =
+        quads.size() / VERTICES_PER_QUAD * INDICES_PER_QUAD;
+    first_vertex += quads.size();
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,239 @@
+#ifndef SRC_WORLD_CHUNK_MESHER_H_
+#define SRC_WORLD_CHUNK_MESHER_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "chunk_mesh.h"
+#include "chunk_section.h"
+
+namespace cppcraft {
+namespace world {
+
+// Edge length of a mesh snapshot: one section plus a one-block border
+// on every side (18x18x18)
+constexpr int MESH_INPUT_SIZE = SECTION_SIZE + 2;
+constexpr int MESH_INPUT_AREA = MESH_INPUT_SIZE * MESH_INPUT_SIZE;
+constexpr int MESH_INPUT_VOLUME = MESH_INPUT_AREA * MESH_INPUT_SIZE;
+
+// Largest level-of-detail scale: 8x8x8 blocks merged into one mesh cell
+constexpr int MAX_LOD_SCALE = 8;
+
+/**
+ * @struct MeshInput
+ * @brief Immutable snapshot of everything the mesher reads
+ *
+ * The snapshot covers one section plus a one-block border copied from the
+ * sections above and below and from the four neighboring chunks, so faces
+ * on every side can be culled without touching the world. It is taken once
+ * per job on the main thread, which lets the mesher run on a worker thread
+ * while the chunk and its neighbors keep being edited.
+ */
+struct MeshInput {
+  /**
+   * @brief Block IDs, MESH_INPUT_VOLUME entries in GetIndex order
+   */
+  std::vector<uint16_t> blocks;
+
+  /**
+   * @brief Light in GetIndex order, packed with PackLight
+   *
+   * Left empty, every face is lit by full sky light.
+   */
+  std::vector<uint8_t> light;
+
+  /**
+   * @brief Index of the meshed section within its chunk (0 = bottom)
+   */
+  int section_y = 0;
+
+  /**
+   * @brief Meshing strategy to use
+   */
+  MeshMode mode = MeshMode::Naive;
+
+  /**
+   * @brief Blocks merged into one mesh cell along each axis (1, 2, 4 or 8)
+   *
+   * Above 1 the section is downsampled before meshing: each cell becomes
+   * solid when at least half its blocks are, and shows the block most often
+   * found on top of its columns. Faces are always merged greedily then.
+   */
+  int lod_scale = 1;
+
+  /**
+   * @brief Emit opaque faces on the section's X/Z sides even when covered
+   *
+   * The walls hide the cracks between chunks meshed at different scales,
+   * whose surfaces no longer line up along the shared edge.
+   */
+  bool skirts = false;
+
+  /**
+   * @brief Quads per render layer in the section's previous mesh
+   *
+   * Scratch buffers reserve this much up front, so a rebuild of a similar
+   * mesh does not grow them face by face.
+   */
+  std::array<size_t, RENDER_LAYER_COUNT> expected_quads{};
+
+  /**
+   * @brief Calculate the snapshot index of a section-local position
+   * @param x Local X coordinate (-1 to 16, border included)
+   * @param y Local Y coordinate (-1 to 16, border included)
+   * @param z Local Z coordinate (-1 to 16, border included)
+   */
+  static constexpr int GetIndex(int x, int y, int z) {
+    return (y + 1) * MESH_INPUT_AREA + (z + 1) * MESH_INPUT_SIZE + (x + 1);
+  }
+};
+
+/**
+ * @struct MeshScratch
+ * @brief Working memory of the mesher, reused across builds on one thread
+ *
+ * Buffers only grow, so once a thread has meshed its largest section a
+ * build makes a single allocation: the exactly sized output vertices.
+ */
+struct MeshScratch {
+  /**
+   * @brief Quads of each render layer until they are merged into the output
+   */
+  std::array<std::vector<PackedVertex>, RENDER_LAYER_COUNT> layer_vertices;
+
+  /**
+   * @brief Greedy meshing slice mask
+   */
+  std::vector<uint32_t> mask;
+
+  /**
+   * @brief Downsampled cells and their light (see MeshInput::lod_scale)
+   */
+  std::vector<uint16_t> lod_cells;
+  std::vector<uint8_t> lod_light;
+};
+
+/**
+ * @brief Builds CPU-side section meshes from a block snapshot
+ *
+ * The mesher only touches its input and output, so independent instances
+ * can run concurrently on different threads. No OpenGL calls are made here;
+ * uploading the result is the caller's job.
+ */
+class ChunkMesher {
+ public:
+  /**
+   * @brief Construct a mesher for one build
+   * @param input Block snapshot to mesh
+   * @param output Mesh to fill; existing contents are discarded
+   * @param scratch Working memory of the calling thread, or nullptr to use
+   *        buffers local to this build
+   */
+  ChunkMesher(const MeshInput& input, ChunkMeshData* output,
+              MeshScratch* scratch = nullptr);
+
+  /**
+   * @brief Build the mesh using the mode requested in the input
+   */
+  void Build();
+
+ private:
+  /**
+   * @brief Get a mesh cell's block by cell position
+   *
+   * Cells are blocks at full detail; coordinates may address the one-cell
+   * border on any side.
+   */
+  uint16_t GetBlock(int x, int y, int z) const;
+
+  /**
+   * @brief Get the packed light of a mesh cell
+   *
+   * A face is lit by the cell in front of it.
+   */
+  uint8_t GetLight(int x, int y, int z) const;
+
+  /**
+   * @brief Get a block from the snapshot by section-local position
+   */
+  uint16_t GetInputBlock(int x, int y, int z) const;
+
+  /**
+   * @brief Downsample the snapshot into the LOD cell grid
+   */
+  void BuildLodGrid();
+
+  /**
+   * @brief Merge a box of snapshot blocks into one cell
+   * @param min Section-local corner of the box
+   * @param size Edge lengths of the box
+   * @param cell Index of the cell in the LOD grid
+   */
+  void DownsampleBox(const int min[3], const int size[3], int cell);
+
+  /**
+   * @brief Check if a cell face is drawn
+   * @param light Receives the face's light when it is
+   */
+  bool IsFaceVisible(int x, int y, int z, uint16_t block_id, int face,
+                     uint8_t* light) const;
+
+  /**
+   * @brief Flood-fill the section's transparent blocks to find which faces
+   *        see each other
+   * @return Face connection bits (see AreFacesConnected)
+   */
+  uint64_t ComputeFaceConnections() const;
+
+  /**
+   * @brief Emit one quad per exposed block face
+   */
+  void BuildNaive();
+
+  /**
+   * @brief Merge coplanar exposed faces of the same block type and light
+   *        into quads
+   */
+  void BuildGreedy();
+
+  /**
+   * @brief Add a face if the adjacent block can be seen through
+   */
+  void AddFaceIfExposed(int x, int y, int z, uint16_t block_id, int face);
+
+  /**
+   * @brief Append a quad to its render layer's scratch vertices
+   * @param width Extent in cells along the face's u axis
+   *              (X for front/back and bottom/top, Z for left/right)
+   * @param height Extent in cells along the face's v axis
+   *               (Y for the side faces, Z for bottom/top)
+   */
+  void AddFace(int x, int y, int z, int face, uint16_t block_id,
+               uint8_t light, int width, int height);
+
+  /**
+   * @brief Concatenate the per-layer quads into the output
+   */
+  void MergeLayers();
+
+  const MeshInput& input_;
+  ChunkMeshData* output_;
+
+  MeshScratch local_scratch_;
+  MeshScratch* scratch_;
+
+  // Cell grid being meshed: the snapshot itself at full detail, the
+  // scratch LOD cells otherwise; cells per axis, padded row length and block
+  // size of a cell
+  const uint16_t* cells_;
+  const uint8_t* cell_light_;
+  int grid_size_;
+  int grid_stride_;
+  int scale_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_CHUNK_MESHER_H_
@@ -0,0 +1,148 @@
+#include "chunk_section.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace cppcraft {
+namespace world {
+
+bool ChunkSection::SetBlock(int x, int y, int z, uint16_t block_id) {
+  const int index = GetIndex(x, y, z);
+  const uint16_t previous = blocks_.Get(index);
+  if (previous == block_id) {
+    return false;
+  }
+
+  blocks_.Set(index, block_id);
+  non_air_count_ += (block_id != AIR_BLOCK_ID) - (previous != AIR_BLOCK_ID);
+  return true;
+}
+
+void ChunkSection::Encode(const uint16_t* in) {
+  blocks_.Encode(in);
+  non_air_count_ = static_cast<int>(
+      SECTION_VOLUME - std::count(in, in + SECTION_VOLUME, AIR_BLOCK_ID));
+}
+
+bool ChunkSection::AssignStorage(int bits, std::vector<uint16_t> palette,
+                                 std::vector<uint64_t> words) {
+  if (!blocks_.Assign(bits, std::move(palette), std::move(words))) {
+    non_air_count_ = 0;
+    return false;
+  }
+  Recount();
+  return true;
+}
+
+void ChunkSection::Recount() {
+  // Palette storage is compact enough that a full decode is cheap
+  std::array<uint16_t, SECTION_VOLUME> decoded;
+  blocks_.Decode(decoded.data());
+  non_air_count_ = static_cast<int>(
+      SECTION_VOLUME -
+      std::count(decoded.begin(), decoded.end(), AIR_BLOCK_ID));
+}
+
+bool ChunkStorage::Set(int x, int y, int z, uint16_t block_id) {
+  const int index = y / SECTION_SIZE;
+  std::unique_ptr<ChunkSection>& section = sections_[index];
+
+  if (!section) {
+    if (block_id == AIR_BLOCK_ID) {
+      return false;
+    }
+    section = std::make_unique<ChunkSection>();
+  }
+
+  if (!section->SetBlock(x, y % SECTION_SIZE, z, block_id)) {
+    return false;
+  }
+
+  if (section->IsEmpty()) {
+    section.reset();
+  }
+  return true;
+}
+
+void ChunkStorage::Fill(uint16_t block_id) {
+  if (block_id == AIR_BLOCK_ID) {
+    for (auto& section : sections_) {
+      section.reset();
+    }
+    return;
+  }
+
+  std::array<uint16_t, SECTION_VOLUME> filled;
+  filled.fill(block_id);
+  for (auto& section : sections_) {
+    section = std::make_unique<ChunkSection>();
+    section->Encode(filled.data());
+  }
+}
+
+void ChunkStorage::Decode(uint16_t* out) const {
+  for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+    uint16_t* section_out = out + i * SECTION_VOLUME;
+    if (sections_[i]) {
+      sections_[i]->Decode(section_out);
+    } else {
+      std::fill(section_out, section_out + SECTION_VOLUME, AIR_BLOCK_ID);
+    }
+  }
+}
+
+void ChunkStorage::Encode(const uint16_t* in) {
+  for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+    const uint16_t* section_in = in + i * SECTION_VOLUME;
+    const bool empty = std::all_of(
+        section_in, section_in + SECTION_VOLUME,
+        [](uint16_t block_id) { return block_id == AIR_BLOCK_ID; });
+
+    if (empty) {
+      sections_[i].reset();
+      continue;
+    }
+
+    if (!sections_[i]) {
+      sections_[i] = std::make_unique<ChunkSection>();
+    }
+    sections_[i]->Encode(section_in);
+  }
+}
+
+ChunkSection& ChunkStorage::GetOrCreateSection(int index) {
+  if (!sections_[index]) {
+    sections_[index] = std::make_unique<ChunkSection>();
+  }
+  return *sections_[index];
+}
+
+void ChunkStorage::SetSection(int index, std::unique_ptr<ChunkSection> section) {
+  if (section && section->IsEmpty()) {
+    section.reset();
+  }
+  sections_[index] = std::move(section);
+}
+
+uint32_t ChunkStorage::GetNonEmptyMask() const {
+  uint32_t mask = 0;
+  for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+    if (sections_[i] && !sections_[i]->IsEmpty()) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+size_t ChunkStorage::GetMemoryUsage() const {
+  size_t bytes = 0;
+  for (const auto& section : sections_) {
+    if (section) {
+      bytes += sizeof(ChunkSection) + section->GetStorage().GetMemoryUsage();
+    }
+  }
+  return bytes;
+}
+
+}  // namespace world
+}  // namespace cppcraft
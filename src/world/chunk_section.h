@@ -0,0 +1,204 @@
+#ifndef SRC_WORLD_CHUNK_SECTION_H_
+#define SRC_WORLD_CHUNK_SECTION_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "block.h"
+#include "palette_storage.h"
+
+namespace cppcraft {
+namespace world {
+
+// Section dimensions (16x16x16 blocks)
+constexpr int SECTION_SIZE = 16;
+constexpr int SECTION_AREA = SECTION_SIZE * SECTION_SIZE;
+constexpr int SECTION_VOLUME = SECTION_AREA * SECTION_SIZE;
+
+// Number of sections stacked in a 256-block-high chunk column
+constexpr int SECTIONS_PER_CHUNK = 16;
+
+// Chunk column dimensions
+constexpr int CHUNK_SIZE_X = 16;
+constexpr int CHUNK_SIZE_Y = 256;  // Height
+constexpr int CHUNK_SIZE_Z = 16;
+constexpr int CHUNK_VOLUME = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z;
+
+static_assert(CHUNK_SIZE_X == SECTION_SIZE && CHUNK_SIZE_Z == SECTION_SIZE &&
+                  CHUNK_SIZE_Y == SECTION_SIZE * SECTIONS_PER_CHUNK,
+              "A chunk must be a whole column of sections");
+
+/**
+ * @brief A 16x16x16 slice of a chunk
+ *
+ * Sections keep their own palette storage and a count of non-air blocks,
+ * so generation, meshing and saving can skip empty sections outright.
+ */
+class ChunkSection {
+ public:
+  /**
+   * @brief Construct an all-air section
+   */
+  ChunkSection() : blocks_(SECTION_VOLUME, AIR_BLOCK_ID), non_air_count_(0) {}
+
+  /**
+   * @brief Get the block ID at section-local coordinates
+   * @param x Local X coordinate (0-15)
+   * @param y Local Y coordinate (0-15)
+   * @param z Local Z coordinate (0-15)
+   * @return The block ID at the position
+   */
+  uint16_t GetBlock(int x, int y, int z) const {
+    return blocks_.Get(GetIndex(x, y, z));
+  }
+
+  /**
+   * @brief Set the block ID at section-local coordinates
+   * @param x Local X coordinate (0-15)
+   * @param y Local Y coordinate (0-15)
+   * @param z Local Z coordinate (0-15)
+   * @param block_id The block ID to set
+   * @return True if the block changed
+   */
+  bool SetBlock(int x, int y, int z, uint16_t block_id);
+
+  /**
+   * @brief Get the number of non-air blocks
+   * @return Non-air block count (0-4096)
+   */
+  int GetNonAirCount() const { return non_air_count_; }
+
+  /**
+   * @brief Check if every block in the section is air
+   * @return True if the section is empty
+   */
+  bool IsEmpty() const { return non_air_count_ == 0; }
+
+  /**
+   * @brief Decode all SECTION_VOLUME block IDs in GetIndex order
+   * @param out Destination for the block IDs
+   */
+  void Decode(uint16_t* out) const { blocks_.Decode(out); }
+
+  /**
+   * @brief Replace all SECTION_VOLUME block IDs and recount non-air blocks
+   * @param in Block IDs in GetIndex order
+   */
+  void Encode(const uint16_t* in);
+
+  /**
+   * @brief Get the palette-compressed block storage
+   * @return Const reference to the storage
+   */
+  const PaletteStorage& GetStorage() const { return blocks_; }
+
+  /**
+   * @brief Replace the storage with previously serialized state
+   * @return False if the state is inconsistent
+   */
+  bool AssignStorage(int bits, std::vector<uint16_t> palette,
+                     std::vector<uint64_t> words);
+
+  /**
+   * @brief Calculate the linear index for a section-local position
+   *
+   * Matches the chunk layout, so a chunk's block array is its sections
+   * laid out one after another from bottom to top.
+   */
+  static constexpr int GetIndex(int x, int y, int z) {
+    return y * SECTION_AREA + z * SECTION_SIZE + x;
+  }
+
+ private:
+  void Recount();
+
+  PaletteStorage blocks_;
+  int non_air_count_;
+};
+
+/**
+ * @brief Column of chunk sections with empty sections left unallocated
+ *
+ * An unallocated section reads as air. Sections are allocated on the first
+ * non-air write and released again once their last non-air block is
+ * removed.
+ */
+class ChunkStorage {
+ public:
+  ChunkStorage() = default;
+
+  /**
+   * @brief Get the block ID at chunk-local coordinates (air if unallocated)
+   */
+  uint16_t Get(int x, int y, int z) const {
+    const ChunkSection* section = sections_[y / SECTION_SIZE].get();
+    return section ? section->GetBlock(x, y % SECTION_SIZE, z) : AIR_BLOCK_ID;
+  }
+
+  /**
+   * @brief Set the block ID at chunk-local coordinates
+   * @return True if the block changed
+   */
+  bool Set(int x, int y, int z, uint16_t block_id);
+
+  /**
+   * @brief Set every block to one ID
+   *
+   * Filling with air releases every section.
+   */
+  void Fill(uint16_t block_id);
+
+  /**
+   * @brief Decode the whole column, sections from bottom to top
+   * @param out Destination for SECTIONS_PER_CHUNK * SECTION_VOLUME IDs
+   */
+  void Decode(uint16_t* out) const;
+
+  /**
+   * @brief Replace the whole column, allocating only non-empty sections
+   * @param in SECTIONS_PER_CHUNK * SECTION_VOLUME block IDs
+   */
+  void Encode(const uint16_t* in);
+
+  /**
+   * @brief Get a section, or nullptr if it is empty
+   * @param index Section index (0 = bottom)
+   */
+  const ChunkSection* GetSection(int index) const {
+    return sections_[index].get();
+  }
+
+  /**
+   * @brief Get a section, allocating an empty one if needed
+   * @param index Section index (0 = bottom)
+   */
+  ChunkSection& GetOrCreateSection(int index);
+
+  /**
+   * @brief Replace a section; empty sections are released
+   * @param index Section index (0 = bottom)
+   * @param section The new section, or nullptr for all air
+   */
+  void SetSection(int index, std::unique_ptr<ChunkSection> section);
+
+  /**
+   * @brief Get a bitmask of allocated sections (bit i = section i)
+   */
+  uint32_t GetNonEmptyMask() const;
+
+  /**
+   * @brief Get the heap memory used by the allocated sections
+   */
+  size_t GetMemoryUsage() const;
+
+ private:
+  std::array<std::unique_ptr<ChunkSection>, SECTIONS_PER_CHUNK> sections_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_CHUNK_SECTION_H_
@@ -0,0 +1,133 @@
+#include "chunk_streamer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../core/profiler.h"
+#include "chunk.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Heap order putting the lowest priority value on top
+bool LoadsLater(const ChunkRequest& a, const ChunkRequest& b) {
+  return a.priority > b.priority;
+}
+
+}  // namespace
+
+ChunkStreamer::ChunkStreamer(LoadFunction load, unsigned int thread_count)
+    : load_(std::move(load)), stopping_(false), in_progress_count_(0) {
+  thread_count = std::max(1u, thread_count);
+  workers_.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(&ChunkStreamer::WorkerLoop, this);
+  }
+}
+
+ChunkStreamer::~ChunkStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queued_.clear();
+  }
+  queue_cv_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ChunkStreamer::SetRequests(const std::vector<ChunkRequest>& requests) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_.clear();
+    for (const ChunkRequest& request : requests) {
+      if (in_flight_.count(Key(request.chunk_x, request.chunk_z)) == 0) {
+        queued_.push_back(request);
+      }
+    }
+    std::make_heap(queued_.begin(), queued_.end(), LoadsLater);
+  }
+  queue_cv_.notify_all();
+}
+
+bool ChunkStreamer::IsInFlight(int chunk_x, int chunk_z) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_.count(Key(chunk_x, chunk_z)) != 0;
+}
+
+size_t ChunkStreamer::TakeFinished(size_t max_count,
+                                   std::vector<StreamedChunk>* out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const size_t count = std::min(max_count, finished_.size());
+  if (count == 0) {
+    return 0;
+  }
+
+  // Closest first, so a small budget fills in the view from the center
+  std::partial_sort(finished_.begin(), finished_.begin() + count,
+                    finished_.end(),
+                    [](const Finished& a, const Finished& b) {
+                      return a.priority < b.priority;
+                    });
+
+  for (size_t i = 0; i < count; ++i) {
+    StreamedChunk& result = finished_[i].result;
+    in_flight_.erase(Key(result.chunk_x, result.chunk_z));
+    out->push_back(std::move(result));
+  }
+  finished_.erase(finished_.begin(), finished_.begin() + count);
+  return count;
+}
+
+size_t ChunkStreamer::GetQueuedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queued_.size();
+}
+
+size_t ChunkStreamer::GetInProgressCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_progress_count_;
+}
+
+size_t ChunkStreamer::GetFinishedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return finished_.size();
+}
+
+void ChunkStreamer::WorkerLoop() {
+  core::Profiler::Get().SetThreadName("chunk streamer");
+
+  for (;;) {
+    ChunkRequest request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_cv_.wait(lock, [this] { return stopping_ || !queued_.empty(); });
+      if (stopping_) {
+        return;
+      }
+      std::pop_heap(queued_.begin(), queued_.end(), LoadsLater);
+      request = queued_.back();
+      queued_.pop_back();
+      in_flight_.insert(Key(request.chunk_x, request.chunk_z));
+      ++in_progress_count_;
+    }
+
+    Finished finished;
+    finished.result.chunk_x = request.chunk_x;
+    finished.result.chunk_z = request.chunk_z;
+    finished.result.chunk = load_(request.chunk_x, request.chunk_z);
+    finished.priority = request.priority;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_progress_count_;
+    finished_.push_back(std::move(finished));
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,197 @@
+#ifndef SRC_WORLD_CHUNK_STREAMER_H_
+#define SRC_WORLD_CHUNK_STREAMER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace cppcraft {
+namespace world {
+
+class Chunk;
+
+// Default number of streaming worker threads
+constexpr unsigned int DEFAULT_STREAM_THREADS = 2;
+
+// Default radius, in chunks, kept loaded around the viewer, and the extra
+// band beyond it before chunks are unloaded
+constexpr int DEFAULT_RENDER_RADIUS = 8;
+constexpr int DEFAULT_UNLOAD_MARGIN = 2;
+
+// Default per-frame budgets for adding and removing streamed chunks
+constexpr size_t DEFAULT_STREAM_LOADS_PER_FRAME = 4;
+constexpr size_t DEFAULT_STREAM_UNLOADS_PER_FRAME = 8;
+
+/**
+ * @struct ChunkRequest
+ * @brief A chunk the streamer should load, with its load priority
+ */
+struct ChunkRequest {
+  int chunk_x = 0;
+  int chunk_z = 0;
+
+  /**
+   * @brief Load order key; lower values are loaded first
+   */
+  float priority = 0.0f;
+};
+
+/**
+ * @struct StreamedChunk
+ * @brief A chunk loaded or generated by a streaming worker
+ */
+struct StreamedChunk {
+  int chunk_x = 0;
+  int chunk_z = 0;
+  std::unique_ptr<Chunk> chunk;
+};
+
+/**
+ * @struct StreamingStats
+ * @brief Queue depths and per-frame throughput of chunk streaming
+ */
+struct StreamingStats {
+  /**
+   * @brief Requests waiting for a worker
+   */
+  size_t queued = 0;
+
+  /**
+   * @brief Chunks being loaded or generated right now
+   */
+  size_t in_progress = 0;
+
+  /**
+   * @brief Finished chunks waiting to be added to the world
+   */
+  size_t ready = 0;
+
+  /**
+   * @brief Chunks added to the world by the last update
+   */
+  size_t loaded_last_update = 0;
+
+  /**
+   * @brief Chunks removed from the world by the last update
+   */
+  size_t unloaded_last_update = 0;
+
+  /**
+   * @brief Loaded chunks outside the unload radius still waiting for
+   *        an unload slot after the last update
+   */
+  size_t pending_unloads = 0;
+};
+
+/**
+ * @brief Worker threads that load or generate chunks in priority order
+ *
+ * The owner replaces the request queue whenever the viewer moves; requests
+ * that have not started yet are simply dropped or reordered. Workers build
+ * complete Chunk objects through the load function, and the owner collects
+ * them on the main thread with TakeFinished().
+ */
+class ChunkStreamer {
+ public:
+  /**
+   * @brief Builds the chunk at the given chunk coordinates
+   *
+   * Called on worker threads; must not touch other chunks or GL state.
+   */
+  using LoadFunction =
+      std::function<std::unique_ptr<Chunk>(int chunk_x, int chunk_z)>;
+
+  /**
+   * @brief Start the worker threads
+   * @param load Function that loads or generates one chunk
+   * @param thread_count Number of workers (at least one)
+   */
+  explicit ChunkStreamer(LoadFunction load,
+                         unsigned int thread_count = DEFAULT_STREAM_THREADS);
+
+  /**
+   * @brief Stop the workers; queued requests and unclaimed chunks are dropped
+   */
+  ~ChunkStreamer();
+
+  ChunkStreamer(const ChunkStreamer&) = delete;
+  ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+  /**
+   * @brief Replace all requests that have not started yet
+   *
+   * Requests for chunks already in progress or waiting in the finished
+   * queue are ignored.
+   *
+   * @param requests The chunks to load, in any order
+   */
+  void SetRequests(const std::vector<ChunkRequest>& requests);
+
+  /**
+   * @brief Check if a chunk is being loaded or waits to be taken
+   */
+  bool IsInFlight(int chunk_x, int chunk_z) const;
+
+  /**
+   * @brief Move finished chunks to the caller (main thread)
+   * @param max_count Maximum number of chunks to take
+   * @param out Receives the chunks, closest to the viewer first
+   * @return Number of chunks taken
+   */
+  size_t TakeFinished(size_t max_count, std::vector<StreamedChunk>* out);
+
+  /**
+   * @brief Get the number of requests waiting for a worker
+   */
+  size_t GetQueuedCount() const;
+
+  /**
+   * @brief Get the number of chunks being loaded or generated
+   */
+  size_t GetInProgressCount() const;
+
+  /**
+   * @brief Get the number of finished chunks waiting to be taken
+   */
+  size_t GetFinishedCount() const;
+
+ private:
+  struct Finished {
+    StreamedChunk result;
+    float priority;
+  };
+
+  void WorkerLoop();
+
+  static uint64_t Key(int chunk_x, int chunk_z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x)) << 32) |
+           static_cast<uint32_t>(chunk_z);
+  }
+
+  LoadFunction load_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queue_cv_;
+  bool stopping_;
+
+  // Min-heap on priority
+  std::vector<ChunkRequest> queued_;
+
+  // Keys of chunks in progress or finished but not yet taken
+  std::unordered_set<uint64_t> in_flight_;
+  size_t in_progress_count_;
+
+  std::vector<Finished> finished_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_CHUNK_STREAMER_H_
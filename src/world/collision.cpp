@@ -0,0 +1,187 @@
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "world.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+int FloorToInt(float value) { return static_cast<int>(std::floor(value)); }
+
+// Check whether a box overlaps a cell along one axis by more than the
+// collision epsilon
+bool OverlapsOnAxis(const Aabb& box, const glm::ivec3& cell, int axis) {
+  const float cell_min = static_cast<float>(cell[axis]);
+  return box.max[axis] > cell_min + COLLISION_EPSILON &&
+         box.min[axis] < cell_min + 1.0f - COLLISION_EPSILON;
+}
+
+// Limit motion along one axis so the box stops short of every cell in its
+// path; cells it already overlaps along that axis are ignored
+float ClipAxis(const std::vector<glm::ivec3>& cells, const Aabb& box, int axis,
+               float motion) {
+  if (motion == 0.0f) {
+    return 0.0f;
+  }
+
+  const int b = (axis + 1) % 3;
+  const int c = (axis + 2) % 3;
+  for (const glm::ivec3& cell : cells) {
+    if (!OverlapsOnAxis(box, cell, b) || !OverlapsOnAxis(box, cell, c)) {
+      continue;
+    }
+
+    const float cell_min = static_cast<float>(cell[axis]);
+    if (motion > 0.0f && box.max[axis] <= cell_min + COLLISION_EPSILON) {
+      motion = std::min(
+          motion, std::max(0.0f, cell_min - COLLISION_EPSILON - box.max[axis]));
+    } else if (motion < 0.0f &&
+               box.min[axis] >= cell_min + 1.0f - COLLISION_EPSILON) {
+      motion = std::max(
+          motion,
+          std::min(0.0f, cell_min + 1.0f + COLLISION_EPSILON - box.min[axis]));
+    }
+  }
+  return motion;
+}
+
+void Translate(Aabb* box, int axis, float distance) {
+  box->min[axis] += distance;
+  box->max[axis] += distance;
+}
+
+}  // namespace
+
+CollisionCache::CollisionCache(const World& world) : world_(world) {}
+
+void CollisionCache::Reset() {
+  for (Entry& entry : entries_) {
+    entry.valid = false;
+  }
+}
+
+const Chunk* CollisionCache::GetChunk(int chunk_x, int chunk_z) {
+  Entry& entry = entries_[(chunk_z & (TABLE_SIDE - 1)) * TABLE_SIDE +
+                          (chunk_x & (TABLE_SIDE - 1))];
+  if (!entry.valid || entry.chunk_x != chunk_x || entry.chunk_z != chunk_z) {
+    entry.chunk_x = chunk_x;
+    entry.chunk_z = chunk_z;
+    entry.chunk = world_.findChunk(chunk_x, chunk_z);
+    entry.valid = true;
+  }
+  return entry.chunk;
+}
+
+bool CollisionCache::IsSolid(int x, int y, int z) {
+  if (y < 0) {
+    return true;
+  }
+  if (y >= CHUNK_SIZE_Y) {
+    return false;
+  }
+
+  const Chunk* chunk =
+      GetChunk(World::worldToChunkCoord(x), World::worldToChunkCoord(z));
+  if (!chunk) {
+    return true;
+  }
+  return IsSolidBlock(chunk->GetBlock(World::worldToLocalCoord(x), y,
+                                      World::worldToLocalCoord(z)));
+}
+
+const std::vector<glm::ivec3>& CollisionCache::GatherSolidCells(
+    const Aabb& bounds) {
+  cells_.clear();
+
+  const int x0 = FloorToInt(bounds.min.x - COLLISION_EPSILON);
+  const int x1 = FloorToInt(bounds.max.x + COLLISION_EPSILON);
+  const int z0 = FloorToInt(bounds.min.z - COLLISION_EPSILON);
+  const int z1 = FloorToInt(bounds.max.z + COLLISION_EPSILON);
+
+  // One layer below the world is enough to stand on; everything above it
+  // is air
+  const int y0 = std::max(FloorToInt(bounds.min.y - COLLISION_EPSILON), -1);
+  const int y1 =
+      std::min(FloorToInt(bounds.max.y + COLLISION_EPSILON), CHUNK_SIZE_Y - 1);
+  if (y0 > y1) {
+    return cells_;
+  }
+
+  for (int z = z0; z <= z1; ++z) {
+    const int chunk_z = World::worldToChunkCoord(z);
+    const int local_z = World::worldToLocalCoord(z);
+    for (int x = x0; x <= x1; ++x) {
+      const Chunk* chunk = GetChunk(World::worldToChunkCoord(x), chunk_z);
+      const int local_x = World::worldToLocalCoord(x);
+
+      int y = y0;
+      if (y < 0 || !chunk) {
+        const int solid_end = chunk ? 0 : y1 + 1;
+        for (; y < solid_end; ++y) {
+          cells_.push_back(glm::ivec3(x, y, z));
+        }
+      }
+
+      // Read section by section, skipping sections that are all air
+      while (y <= y1) {
+        const int section_base = y & ~(SECTION_SIZE - 1);
+        const int section_end = std::min(section_base + SECTION_SIZE - 1, y1);
+        const ChunkSection* section =
+            chunk->GetSection(Chunk::GetSectionIndex(y));
+        if (section) {
+          for (; y <= section_end; ++y) {
+            if (IsSolidBlock(
+                    section->GetBlock(local_x, y - section_base, local_z))) {
+              cells_.push_back(glm::ivec3(x, y, z));
+            }
+          }
+        }
+        y = section_end + 1;
+      }
+    }
+  }
+  return cells_;
+}
+
+CollisionResult MoveAabb(const Aabb& box, const glm::vec3& motion,
+                         CollisionCache* cache) {
+  Aabb swept;
+  swept.min = glm::min(box.min, box.min + motion);
+  swept.max = glm::max(box.max, box.max + motion);
+  const std::vector<glm::ivec3>& cells = cache->GatherSolidCells(swept);
+
+  CollisionResult result;
+  result.box = box;
+
+  // Vertical first, so that walking off a ledge or into a wall while
+  // falling resolves the same way as on the ground
+  constexpr int AXIS_ORDER[3] = {1, 0, 2};
+  for (int axis : AXIS_ORDER) {
+    const float applied = ClipAxis(cells, result.box, axis, motion[axis]);
+    Translate(&result.box, axis, applied);
+    result.motion[axis] = applied;
+  }
+
+  result.hit_x = result.motion.x != motion.x;
+  result.hit_y = result.motion.y != motion.y;
+  result.hit_z = result.motion.z != motion.z;
+  result.on_ground = result.hit_y && motion.y < 0.0f;
+  return result;
+}
+
+bool IsAabbBlocked(const Aabb& box, CollisionCache* cache) {
+  for (const glm::ivec3& cell : cache->GatherSolidCells(box)) {
+    if (OverlapsOnAxis(box, cell, 0) && OverlapsOnAxis(box, cell, 1) &&
+        OverlapsOnAxis(box, cell, 2)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace world
+}  // namespace cppcraft
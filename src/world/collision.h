@@ -0,0 +1,148 @@
+#ifndef SRC_WORLD_COLLISION_H_
+#define SRC_WORLD_COLLISION_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace cppcraft {
+namespace world {
+
+class Chunk;
+class World;
+
+// Gap kept between a moving box and the blocks it stops against, so that
+// rounding never leaves it overlapping them; large enough to survive float
+// rounding a few thousand blocks from the origin
+constexpr float COLLISION_EPSILON = 1e-3f;
+
+/**
+ * @struct Aabb
+ * @brief Axis-aligned box in world coordinates
+ */
+struct Aabb {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+};
+
+/**
+ * @struct CollisionResult
+ * @brief Outcome of moving a box through the world
+ */
+struct CollisionResult {
+  /**
+   * @brief The box after the move
+   */
+  Aabb box;
+
+  /**
+   * @brief Motion actually applied; equal to the requested motion on every
+   *        axis that was not blocked
+   */
+  glm::vec3 motion{0.0f};
+
+  /**
+   * @brief Whether a block stopped the motion along X, Y and Z
+   */
+  bool hit_x = false;
+  bool hit_y = false;
+  bool hit_z = false;
+
+  /**
+   * @brief Whether the box landed on a block while moving down
+   */
+  bool on_ground = false;
+};
+
+/**
+ * @brief Loaded-chunk lookups shared by every collision query in one tick
+ *
+ * A small direct-mapped table of chunk pointers, so entities moving in the
+ * same area look each chunk up in the world's chunk map once per tick
+ * instead of once per block. Also owns the scratch list of solid cells.
+ *
+ * Pointers are only valid until the world next adds or removes chunks:
+ * call Reset() at the start of every tick, after World::update(). Main
+ * thread only, like World::getBlock().
+ */
+class CollisionCache {
+ public:
+  explicit CollisionCache(const World& world);
+
+  CollisionCache(const CollisionCache&) = delete;
+  CollisionCache& operator=(const CollisionCache&) = delete;
+
+  /**
+   * @brief Forget every cached chunk
+   */
+  void Reset();
+
+  /**
+   * @brief Get a loaded chunk
+   * @return The chunk, or nullptr if it is not loaded
+   */
+  const Chunk* GetChunk(int chunk_x, int chunk_z);
+
+  /**
+   * @brief Check whether a block cell stops boxes
+   *
+   * Cells below the world and in unloaded chunks count as solid, so nothing
+   * falls out of the world or into chunks still streaming in; cells above
+   * the world are open.
+   */
+  bool IsSolid(int x, int y, int z);
+
+  /**
+   * @brief Get the solid cells a box overlaps or touches
+   * @param bounds Box to search
+   * @return Minimum corners of the cells; valid until the next call
+   */
+  const std::vector<glm::ivec3>& GatherSolidCells(const Aabb& bounds);
+
+ private:
+  struct Entry {
+    int chunk_x = 0;
+    int chunk_z = 0;
+    const Chunk* chunk = nullptr;
+    bool valid = false;
+  };
+
+  // Entries per side of the table, a power of two; chunk (x, z) lives in
+  // column x & (TABLE_SIDE - 1), row z & (TABLE_SIDE - 1)
+  static constexpr int TABLE_SIDE = 4;
+
+  const World& world_;
+  std::array<Entry, TABLE_SIDE * TABLE_SIDE> entries_;
+  std::vector<glm::ivec3> cells_;
+};
+
+/**
+ * @brief Move a box through the world, stopping at solid blocks
+ *
+ * Only the block cells overlapping the box's swept volume are read, once
+ * each, and the motion is clipped against them one axis at a time: Y
+ * first, then X, then Z. The cost is proportional to the number of cells
+ * the move touches, independent of how many chunks are loaded.
+ *
+ * @param box The box before the move; must not already overlap a solid
+ *        block along the axes it moves on
+ * @param motion Requested displacement in blocks
+ * @param cache Lookups shared with the tick's other queries
+ * @return Where the box ended up and what stopped it
+ */
+CollisionResult MoveAabb(const Aabb& box, const glm::vec3& motion,
+                         CollisionCache* cache);
+
+/**
+ * @brief Check whether a box overlaps any solid block
+ *
+ * For spawn checks and for refusing to place a block inside an entity.
+ */
+bool IsAabbBlocked(const Aabb& box, CollisionCache* cache);
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_COLLISION_H_
@@ -0,0 +1,439 @@
+#include "light_engine.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+constexpr int COLUMN_HEIGHT = SECTION_SIZE * SECTIONS_PER_CHUNK;
+
+// Face indices as used by the mesher: 0 = +Z, 1 = -Z, 2 = -X, 3 = +X,
+// 4 = -Y, 5 = +Y
+constexpr int DOWN_FACE = 4;
+
+// Unloaded chunks read as solid and unlit
+constexpr uint16_t UNLOADED_BLOCK = static_cast<uint16_t>(BlockType::UNKNOWN);
+
+}  // namespace
+
+void LightNibbleArray::Set(int index, uint8_t level) {
+  if (!nibbles_) {
+    if (level == fill_) {
+      return;
+    }
+    nibbles_ = std::make_unique<std::array<uint8_t, SECTION_VOLUME / 2>>();
+    nibbles_->fill(static_cast<uint8_t>(fill_ | (fill_ << 4)));
+  }
+
+  uint8_t& pair = (*nibbles_)[index >> 1];
+  const int shift = (index & 1) * 4;
+  pair = static_cast<uint8_t>((pair & ~(0xF << shift)) | ((level & 0xF) << shift));
+}
+
+void LightNibbleArray::Fill(uint8_t level) {
+  nibbles_.reset();
+  fill_ = level;
+}
+
+void LightNibbleArray::Assign(const uint8_t* levels) {
+  if (std::all_of(levels, levels + SECTION_VOLUME,
+                  [levels](uint8_t level) { return level == levels[0]; })) {
+    Fill(levels[0]);
+    return;
+  }
+
+  if (!nibbles_) {
+    nibbles_ = std::make_unique<std::array<uint8_t, SECTION_VOLUME / 2>>();
+  }
+  for (int i = 0; i < SECTION_VOLUME / 2; ++i) {
+    (*nibbles_)[i] =
+        static_cast<uint8_t>((levels[2 * i] & 0xF) | ((levels[2 * i + 1] & 0xF) << 4));
+  }
+}
+
+void LightNibbleArray::Decode(uint8_t* out) const {
+  if (!nibbles_) {
+    std::memset(out, fill_, SECTION_VOLUME);
+    return;
+  }
+  for (int i = 0; i < SECTION_VOLUME / 2; ++i) {
+    out[2 * i] = (*nibbles_)[i] & 0xF;
+    out[2 * i + 1] = (*nibbles_)[i] >> 4;
+  }
+}
+
+void ChunkLight::DecodeSection(int section, uint8_t* out) const {
+  uint8_t block[SECTION_VOLUME];
+  sections_[section].sky.Decode(out);
+  sections_[section].block.Decode(block);
+  for (int i = 0; i < SECTION_VOLUME; ++i) {
+    out[i] = PackLight(out[i], block[i]);
+  }
+}
+
+void ChunkLight::AssignSection(int section, const uint8_t* packed) {
+  uint8_t levels[SECTION_VOLUME];
+  for (int i = 0; i < SECTION_VOLUME; ++i) {
+    levels[i] = packed[i] >> 4;
+  }
+  sections_[section].sky.Assign(levels);
+  for (int i = 0; i < SECTION_VOLUME; ++i) {
+    levels[i] = packed[i] & 0xF;
+  }
+  sections_[section].block.Assign(levels);
+}
+
+size_t ChunkLight::GetMemoryUsage() const {
+  size_t arrays = 0;
+  for (const SectionLight& section : sections_) {
+    arrays += !section.sky.IsUniform();
+    arrays += !section.block.IsUniform();
+  }
+  return arrays * (SECTION_VOLUME / 2);
+}
+
+void ComputeChunkLight(const ChunkStorage& blocks, ChunkLight* light) {
+  LightVolume volume;
+  volume.Reset(0, 0, 1, 1, 0);
+  volume.LoadChunk(0, blocks, ChunkLight());
+  std::fill(volume.light.begin(), volume.light.end(), 0);
+
+  LightEngine engine(&volume);
+  engine.LightFromScratch();
+
+  // Every section is stored, including those left at zero
+  volume.changed_sections[0] = 0xFFFF;
+  volume.StoreChunk(0, light);
+}
+
+void LightVolume::Reset(int origin_chunk_x, int origin_chunk_z, int chunks_x,
+                        int chunks_z, int border) {
+  this->origin_chunk_x = origin_chunk_x;
+  this->origin_chunk_z = origin_chunk_z;
+  this->chunks_x = chunks_x;
+  this->chunks_z = chunks_z;
+  this->border = border;
+  size_x = chunks_x * SECTION_SIZE;
+  size_z = chunks_z * SECTION_SIZE;
+
+  const size_t cells = static_cast<size_t>(size_x) * size_z * COLUMN_HEIGHT;
+  blocks.assign(cells, UNLOADED_BLOCK);
+  light.assign(cells, 0);
+
+  const size_t slots = static_cast<size_t>(chunks_x) * chunks_z;
+  loaded.assign(slots, 0);
+  changed_sections.assign(slots, 0);
+  remesh_sections.assign(slots, 0);
+}
+
+void LightVolume::LoadChunk(int slot, const ChunkStorage& chunk_blocks,
+                            const ChunkLight& chunk_light) {
+  const int base_x = (slot % chunks_x) * SECTION_SIZE;
+  const int base_z = (slot / chunks_x) * SECTION_SIZE;
+
+  uint16_t section_blocks[SECTION_VOLUME];
+  uint8_t section_light[SECTION_VOLUME];
+
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    if (const ChunkSection* blocks_section = chunk_blocks.GetSection(section)) {
+      blocks_section->Decode(section_blocks);
+    } else {
+      std::fill(section_blocks, section_blocks + SECTION_VOLUME, AIR_BLOCK_ID);
+    }
+    chunk_light.DecodeSection(section, section_light);
+
+    for (int y = 0; y < SECTION_SIZE; ++y) {
+      for (int z = 0; z < SECTION_SIZE; ++z) {
+        const int source = ChunkSection::GetIndex(0, y, z);
+        const int target = GetIndex(base_x, section * SECTION_SIZE + y, base_z + z);
+        std::copy(section_blocks + source, section_blocks + source + SECTION_SIZE,
+                  &blocks[target]);
+        std::copy(section_light + source, section_light + source + SECTION_SIZE,
+                  &light[target]);
+      }
+    }
+  }
+
+  loaded[slot] = 1;
+}
+
+void LightVolume::StoreChunk(int slot, ChunkLight* chunk_light) const {
+  const int base_x = (slot % chunks_x) * SECTION_SIZE;
+  const int base_z = (slot / chunks_x) * SECTION_SIZE;
+
+  uint8_t section_light[SECTION_VOLUME];
+
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    if (!(changed_sections[slot] & (1u << section))) {
+      continue;
+    }
+
+    for (int y = 0; y < SECTION_SIZE; ++y) {
+      for (int z = 0; z < SECTION_SIZE; ++z) {
+        const int source = GetIndex(base_x, section * SECTION_SIZE + y, base_z + z);
+        std::copy(&light[source], &light[source] + SECTION_SIZE,
+                  section_light + ChunkSection::GetIndex(0, y, z));
+      }
+    }
+    chunk_light->AssignSection(section, section_light);
+  }
+}
+
+void LightEngine::LightFromScratch() {
+  const int layer = volume_->size_x * volume_->size_z;
+
+  // Sky light falls straight down each column until something dims it
+  addition_queue_.clear();
+  for (int column = 0; column < layer; ++column) {
+    for (int y = COLUMN_HEIGHT - 1; y >= 0; --y) {
+      const int index = y * layer + column;
+      if (!IsWritable(index) || !PassesSkyLight(volume_->blocks[index])) {
+        break;
+      }
+      SetLevel(index, Channel::Sky, MAX_LIGHT_LEVEL);
+      addition_queue_.push_back(index);
+    }
+  }
+  PropagateAddition(Channel::Sky);
+
+  addition_queue_.clear();
+  for (int index = 0; index < static_cast<int>(volume_->blocks.size()); ++index) {
+    const uint8_t emission = GetBlockLightEmission(volume_->blocks[index]);
+    if (emission > 0 && IsWritable(index)) {
+      SetLevel(index, Channel::Block, emission);
+      addition_queue_.push_back(index);
+    }
+  }
+  PropagateAddition(Channel::Block);
+}
+
+void LightEngine::Update(const std::vector<LightEdit>& edits, int seam_chunk_x,
+                         int seam_chunk_z, bool seam) {
+  const int origin_x = volume_->origin_chunk_x * SECTION_SIZE;
+  const int origin_z = volume_->origin_chunk_z * SECTION_SIZE;
+
+  for (Channel channel : {Channel::Sky, Channel::Block}) {
+    removal_queue_.clear();
+    addition_queue_.clear();
+
+    for (const LightEdit& edit : edits) {
+      const int x = edit.x - origin_x;
+      const int z = edit.z - origin_z;
+      if (x < 0 || x >= volume_->size_x || z < 0 || z >= volume_->size_z ||
+          edit.y < 0 || edit.y >= COLUMN_HEIGHT) {
+        continue;
+      }
+      const int index = volume_->GetIndex(x, edit.y, z);
+      if (!IsWritable(index)) {
+        continue;
+      }
+
+      // Darken the edited block, then let its own light and the light of
+      // its neighbors flow back in
+      const uint8_t level = GetLevel(index, channel);
+      if (level > 0) {
+        SetLevel(index, channel, 0);
+        removal_queue_.push_back({index, level});
+      }
+      const uint8_t source = GetSourceLevel(index, channel);
+      if (source > 0) {
+        SetLevel(index, channel, source);
+        addition_queue_.push_back(index);
+      }
+      for (int face = 0; face < 6; ++face) {
+        const int neighbor = GetNeighbor(index, face);
+        if (neighbor >= 0 && GetLevel(neighbor, channel) > 0) {
+          addition_queue_.push_back(neighbor);
+        }
+      }
+    }
+
+    if (seam) {
+      QueueSeam(channel, seam_chunk_x, seam_chunk_z);
+    }
+
+    PropagateRemoval(channel);
+    PropagateAddition(channel);
+  }
+}
+
+void LightEngine::SetLevel(int index, Channel channel, uint8_t level) {
+  const int shift = GetShift(channel);
+  uint8_t& packed = volume_->light[index];
+  packed = static_cast<uint8_t>((packed & ~(0xF << shift)) | (level << shift));
+
+  // Record the section, and the neighbor sections whose meshes light their
+  // faces with this cell
+  const int x = index % volume_->size_x;
+  const int z = (index / volume_->size_x) % volume_->size_z;
+  const int y = index / (volume_->size_x * volume_->size_z);
+  const int slot = (z / SECTION_SIZE) * volume_->chunks_x + x / SECTION_SIZE;
+  const int section = y / SECTION_SIZE;
+  const uint16_t bit = static_cast<uint16_t>(1u << section);
+
+  volume_->changed_sections[slot] |= bit;
+  volume_->remesh_sections[slot] |= bit;
+
+  const int local_y = y % SECTION_SIZE;
+  if (local_y == 0 && section > 0) {
+    volume_->remesh_sections[slot] |= bit >> 1;
+  } else if (local_y == SECTION_SIZE - 1 && section < SECTIONS_PER_CHUNK - 1) {
+    volume_->remesh_sections[slot] |= static_cast<uint16_t>(bit << 1);
+  }
+
+  const int local_x = x % SECTION_SIZE;
+  if (local_x == 0 && x > 0) {
+    volume_->remesh_sections[slot - 1] |= bit;
+  } else if (local_x == SECTION_SIZE - 1 && x < volume_->size_x - 1) {
+    volume_->remesh_sections[slot + 1] |= bit;
+  }
+
+  const int local_z = z % SECTION_SIZE;
+  if (local_z == 0 && z > 0) {
+    volume_->remesh_sections[slot - volume_->chunks_x] |= bit;
+  } else if (local_z == SECTION_SIZE - 1 && z < volume_->size_z - 1) {
+    volume_->remesh_sections[slot + volume_->chunks_x] |= bit;
+  }
+}
+
+uint8_t LightEngine::GetSourceLevel(int index, Channel channel) const {
+  const uint16_t block_id = volume_->blocks[index];
+  if (channel == Channel::Block) {
+    return GetBlockLightEmission(block_id);
+  }
+
+  // The top layer is always under open sky; as in LightFromScratch(), only
+  // blocks sky light passes undimmed start at the full level
+  const bool top = index / (volume_->size_x * volume_->size_z) == COLUMN_HEIGHT - 1;
+  return top && PassesSkyLight(block_id) ? MAX_LIGHT_LEVEL : 0;
+}
+
+bool LightEngine::IsWritable(int index) const {
+  const int x = index % volume_->size_x;
+  const int z = (index / volume_->size_x) % volume_->size_z;
+  if (x < volume_->border || x >= volume_->size_x - volume_->border ||
+      z < volume_->border || z >= volume_->size_z - volume_->border) {
+    return false;
+  }
+  return volume_->loaded[(z / SECTION_SIZE) * volume_->chunks_x + x / SECTION_SIZE] != 0;
+}
+
+int LightEngine::GetNeighbor(int index, int face) const {
+  const int size_x = volume_->size_x;
+  const int layer = size_x * volume_->size_z;
+  const int x = index % size_x;
+  const int z = (index / size_x) % volume_->size_z;
+  const int y = index / layer;
+
+  switch (face) {
+    case 0:
+      return z + 1 < volume_->size_z ? index + size_x : -1;
+    case 1:
+      return z > 0 ? index - size_x : -1;
+    case 2:
+      return x > 0 ? index - 1 : -1;
+    case 3:
+      return x + 1 < size_x ? index + 1 : -1;
+    case 4:
+      return y > 0 ? index - layer : -1;
+    default:
+      return y + 1 < COLUMN_HEIGHT ? index + layer : -1;
+  }
+}
+
+void LightEngine::QueueSeam(Channel channel, int chunk_x, int chunk_z) {
+  const int base_x = (chunk_x - volume_->origin_chunk_x) * SECTION_SIZE;
+  const int base_z = (chunk_z - volume_->origin_chunk_z) * SECTION_SIZE;
+
+  // Edge columns of the chunk and the facing columns of its neighbors
+  const int edges[4] = {-1, 0, SECTION_SIZE - 1, SECTION_SIZE};
+
+  auto queue = [&](int x, int y, int z) {
+    if (x < 0 || x >= volume_->size_x || z < 0 || z >= volume_->size_z) {
+      return;
+    }
+    const int index = volume_->GetIndex(x, y, z);
+    if (GetLevel(index, channel) > 0) {
+      addition_queue_.push_back(index);
+    }
+  };
+
+  for (int y = 0; y < COLUMN_HEIGHT; ++y) {
+    for (int i = 0; i < SECTION_SIZE; ++i) {
+      for (int edge : edges) {
+        queue(base_x + edge, y, base_z + i);
+        queue(base_x + i, y, base_z + edge);
+      }
+    }
+  }
+}
+
+void LightEngine::PropagateRemoval(Channel channel) {
+  for (size_t head = 0; head < removal_queue_.size(); ++head) {
+    const RemovedLight node = removal_queue_[head];
+
+    for (int face = 0; face < 6; ++face) {
+      const int neighbor = GetNeighbor(node.index, face);
+      if (neighbor < 0) {
+        continue;
+      }
+      const uint8_t level = GetLevel(neighbor, channel);
+      if (level == 0) {
+        continue;
+      }
+
+      // Dimmer light came from the removed cell; so did full sky light
+      // directly below full sky light. Anything else has another source
+      // and refills the darkened area.
+      const bool fell = channel == Channel::Sky && face == DOWN_FACE &&
+                        node.level == MAX_LIGHT_LEVEL && level == MAX_LIGHT_LEVEL;
+      if ((level < node.level || fell) && IsWritable(neighbor)) {
+        SetLevel(neighbor, channel, 0);
+        removal_queue_.push_back({neighbor, level});
+
+        const uint8_t source = GetSourceLevel(neighbor, channel);
+        if (source > 0) {
+          SetLevel(neighbor, channel, source);
+          addition_queue_.push_back(neighbor);
+        }
+      } else {
+        addition_queue_.push_back(neighbor);
+      }
+    }
+  }
+}
+
+void LightEngine::PropagateAddition(Channel channel) {
+  for (size_t head = 0; head < addition_queue_.size(); ++head) {
+    const int index = addition_queue_[head];
+    const uint8_t level = GetLevel(index, channel);
+    if (level <= 1) {
+      continue;
+    }
+
+    for (int face = 0; face < 6; ++face) {
+      const int neighbor = GetNeighbor(index, face);
+      if (neighbor < 0 || !IsWritable(neighbor)) {
+        continue;
+      }
+      const uint16_t block_id = volume_->blocks[neighbor];
+      if (!IsTransparentBlock(block_id)) {
+        continue;
+      }
+
+      const bool falls = channel == Channel::Sky && face == DOWN_FACE &&
+                         level == MAX_LIGHT_LEVEL && PassesSkyLight(block_id);
+      const uint8_t target = falls ? MAX_LIGHT_LEVEL : level - 1;
+      if (GetLevel(neighbor, channel) < target) {
+        SetLevel(neighbor, channel, target);
+        addition_queue_.push_back(neighbor);
+      }
+    }
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
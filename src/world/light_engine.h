@@ -0,0 +1,351 @@
+#ifndef SRC_WORLD_LIGHT_ENGINE_H_
+#define SRC_WORLD_LIGHT_ENGINE_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chunk_section.h"
+
+namespace cppcraft {
+namespace world {
+
+// Light levels run from 0 (dark) to 15 (full sky or the brightest emitter)
+constexpr uint8_t MAX_LIGHT_LEVEL = 15;
+
+// Packed light as stored in snapshots and mesh vertices: sky light in the
+// high nibble, block light in the low nibble
+constexpr uint8_t PackLight(uint8_t sky, uint8_t block) {
+  return static_cast<uint8_t>((sky << 4) | (block & 0xF));
+}
+
+constexpr uint8_t FULL_SKY_LIGHT = PackLight(MAX_LIGHT_LEVEL, 0);
+
+/**
+ * @brief Light emitted by a block ID (0 for most blocks)
+ */
+constexpr uint8_t GetBlockLightEmission(uint16_t block_id) {
+  return block_id == static_cast<uint16_t>(BlockType::LAVA) ? MAX_LIGHT_LEVEL : 0;
+}
+
+/**
+ * @brief Check if full sky light falls through a block ID without dimming
+ *
+ * Light enters every transparent block; leaves, water and ice dim it by
+ * one level per block like any horizontal step.
+ */
+constexpr bool PassesSkyLight(uint16_t block_id) {
+  return IsTransparentBlock(block_id) && !IsSolidBlock(block_id) &&
+         !IsLiquidBlock(block_id);
+}
+
+/**
+ * @brief One 4-bit light channel of a section
+ *
+ * Sections entirely in the open sky or entirely underground hold a single
+ * level, so the nibble array is only allocated on the first write that
+ * differs from it.
+ */
+class LightNibbleArray {
+ public:
+  /**
+   * @brief Construct a uniform array
+   * @param fill Level of every block
+   */
+  explicit LightNibbleArray(uint8_t fill = 0) : fill_(fill) {}
+
+  /**
+   * @brief Get the level at a ChunkSection::GetIndex position
+   */
+  uint8_t Get(int index) const {
+    if (!nibbles_) {
+      return fill_;
+    }
+    return ((*nibbles_)[index >> 1] >> ((index & 1) * 4)) & 0xF;
+  }
+
+  /**
+   * @brief Set the level at a ChunkSection::GetIndex position
+   */
+  void Set(int index, uint8_t level);
+
+  /**
+   * @brief Set every block to one level, releasing the nibbles
+   */
+  void Fill(uint8_t level);
+
+  /**
+   * @brief Replace all SECTION_VOLUME levels; uniform input stays unallocated
+   * @param levels One level per byte, in GetIndex order
+   */
+  void Assign(const uint8_t* levels);
+
+  /**
+   * @brief Decode all SECTION_VOLUME levels, one per byte
+   */
+  void Decode(uint8_t* out) const;
+
+  /**
+   * @brief Check if the nibbles are unallocated
+   */
+  bool IsUniform() const { return nibbles_ == nullptr; }
+
+ private:
+  std::unique_ptr<std::array<uint8_t, SECTION_VOLUME / 2>> nibbles_;
+  uint8_t fill_;
+};
+
+/**
+ * @brief Sky and block light of a chunk column, one nibble per block
+ *
+ * A new column is all open sky with no block light, the right state for
+ * empty sections above the terrain.
+ */
+class ChunkLight {
+ public:
+  ChunkLight() = default;
+
+  /**
+   * @brief Get the sky light at chunk-local coordinates
+   */
+  uint8_t GetSky(int x, int y, int z) const {
+    return sections_[y / SECTION_SIZE].sky.Get(
+        ChunkSection::GetIndex(x, y % SECTION_SIZE, z));
+  }
+
+  /**
+   * @brief Get the block light at chunk-local coordinates
+   */
+  uint8_t GetBlock(int x, int y, int z) const {
+    return sections_[y / SECTION_SIZE].block.Get(
+        ChunkSection::GetIndex(x, y % SECTION_SIZE, z));
+  }
+
+  /**
+   * @brief Get both channels at chunk-local coordinates (see PackLight)
+   */
+  uint8_t Get(int x, int y, int z) const {
+    return PackLight(GetSky(x, y, z), GetBlock(x, y, z));
+  }
+
+  /**
+   * @brief Decode one section's light, packed with PackLight
+   * @param section Section index (0 = bottom)
+   * @param out Destination for SECTION_VOLUME bytes in GetIndex order
+   */
+  void DecodeSection(int section, uint8_t* out) const;
+
+  /**
+   * @brief Replace one section's light
+   * @param section Section index (0 = bottom)
+   * @param packed SECTION_VOLUME PackLight bytes in GetIndex order
+   */
+  void AssignSection(int section, const uint8_t* packed);
+
+  /**
+   * @brief Get the heap memory used by allocated nibble arrays
+   */
+  size_t GetMemoryUsage() const;
+
+ private:
+  struct SectionLight {
+    LightNibbleArray sky{MAX_LIGHT_LEVEL};
+    LightNibbleArray block{0};
+  };
+
+  std::array<SectionLight, SECTIONS_PER_CHUNK> sections_;
+};
+
+/**
+ * @brief Compute a chunk's light from its blocks alone
+ *
+ * Sky light falls down every column and both channels flood-fill within
+ * the chunk. Light crossing into neighbor chunks is added later by a seam
+ * update once the chunk joins the world. Safe to call from any thread.
+ *
+ * @param blocks The chunk's blocks
+ * @param light Receives the chunk's light
+ */
+void ComputeChunkLight(const ChunkStorage& blocks, ChunkLight* light);
+
+/**
+ * @brief Blocks and light of a group of chunk columns, copied for a worker
+ *
+ * Cells are addressed by volume-local X/Z and world Y. Cells in the
+ * outermost `border` columns, and in chunks that were not loaded, are
+ * read-only: no update can change light that far away, so they only act as
+ * light sources. Writes record which sections changed, and which section
+ * meshes read the changed cells, per chunk slot.
+ */
+struct LightVolume {
+  /**
+   * @brief Size the volume and mark every chunk slot unloaded
+   * @param origin_chunk_x Chunk X of slot 0
+   * @param origin_chunk_z Chunk Z of slot 0
+   * @param chunks_x Chunk columns along X
+   * @param chunks_z Chunk columns along Z
+   * @param border Read-only cells along each X/Z edge
+   */
+  void Reset(int origin_chunk_x, int origin_chunk_z, int chunks_x, int chunks_z,
+             int border);
+
+  /**
+   * @brief Copy a chunk's blocks and light into its slot
+   */
+  void LoadChunk(int slot, const ChunkStorage& blocks, const ChunkLight& light);
+
+  /**
+   * @brief Copy the slot's changed sections back to a chunk
+   */
+  void StoreChunk(int slot, ChunkLight* light) const;
+
+  int GetIndex(int x, int y, int z) const {
+    return (y * size_z + z) * size_x + x;
+  }
+
+  int GetSlot(int chunk_x, int chunk_z) const {
+    return (chunk_z - origin_chunk_z) * chunks_x + (chunk_x - origin_chunk_x);
+  }
+
+  int origin_chunk_x = 0;
+  int origin_chunk_z = 0;
+  int chunks_x = 0;
+  int chunks_z = 0;
+  int size_x = 0;
+  int size_z = 0;
+  int border = 0;
+
+  std::vector<uint16_t> blocks;
+  std::vector<uint8_t> light;  // PackLight bytes
+
+  // Per chunk slot: loaded flag, sections whose light changed, and sections
+  // whose meshes read changed cells (one bit per section)
+  std::vector<uint8_t> loaded;
+  std::vector<uint16_t> changed_sections;
+  std::vector<uint16_t> remesh_sections;
+};
+
+/**
+ * @brief Block edit a light update starts from, in world coordinates
+ */
+struct LightEdit {
+  int x;
+  int y;
+  int z;
+};
+
+/**
+ * @brief Breadth-first light propagation over a LightVolume
+ *
+ * Each channel is updated incrementally: light is first removed outward
+ * from the edited blocks while it keeps falling off, collecting the brighter
+ * cells met along the way, then everything is refilled from those cells,
+ * the remaining emitters and the sky. Only the cells whose light actually
+ * changes are visited.
+ */
+class LightEngine {
+ public:
+  explicit LightEngine(LightVolume* volume) : volume_(volume) {}
+
+  /**
+   * @brief Light a volume whose light is all zero from scratch
+   */
+  void LightFromScratch();
+
+  /**
+   * @brief Update light after blocks changed
+   *
+   * The volume holds the new blocks and the light from before the edits.
+   *
+   * @param edits Changed blocks, inside the writable area
+   * @param seam_chunk_x Chunk whose edges are reseeded, e.g. after it was
+   *        loaded next to lit neighbors; ignored unless seam is true
+   * @param seam_chunk_z See seam_chunk_x
+   * @param seam Whether to reseed a chunk's edges
+   */
+  void Update(const std::vector<LightEdit>& edits, int seam_chunk_x,
+              int seam_chunk_z, bool seam);
+
+ private:
+  enum class Channel { Sky, Block };
+
+  struct RemovedLight {
+    int index;
+    uint8_t level;
+  };
+
+  // Bit offset of a channel within a PackLight byte
+  static int GetShift(Channel channel) {
+    return channel == Channel::Sky ? 4 : 0;
+  }
+
+  uint8_t GetLevel(int index, Channel channel) const {
+    return (volume_->light[index] >> GetShift(channel)) & 0xF;
+  }
+
+  void SetLevel(int index, Channel channel, uint8_t level);
+
+  // Light a cell makes by itself: emission, or full sky in the top layer
+  uint8_t GetSourceLevel(int index, Channel channel) const;
+
+  bool IsWritable(int index) const;
+
+  // Neighbor of a cell, or -1 outside the volume
+  int GetNeighbor(int index, int face) const;
+
+  // Queue the lit cells on both sides of a chunk's four edges
+  void QueueSeam(Channel channel, int chunk_x, int chunk_z);
+  void PropagateRemoval(Channel channel);
+  void PropagateAddition(Channel channel);
+
+  LightVolume* volume_;
+  std::vector<RemovedLight> removal_queue_;
+  std::vector<int> addition_queue_;
+};
+
+/**
+ * @struct LightJob
+ * @brief One light update travelling through the mesh worker pool
+ *
+ * Created on the main thread with a snapshot of the 3x3 chunks around the
+ * updated chunk, propagated on a worker, then copied back to the loaded
+ * chunks on the main thread.
+ */
+struct LightJob {
+  /**
+   * @brief Chunk the edits and seam belong to (center of the volume)
+   */
+  int chunk_x = 0;
+  int chunk_z = 0;
+
+  /**
+   * @brief Changed blocks of the center chunk
+   */
+  std::vector<LightEdit> edits;
+
+  /**
+   * @brief Whether the center chunk's edges are reseeded
+   */
+  bool seam = false;
+
+  /**
+   * @brief Snapshot the update runs on; holds the result when finished
+   */
+  LightVolume volume;
+
+  /**
+   * @brief Set when the result must not be applied
+   */
+  std::atomic<bool> cancelled{false};
+};
+
+// Chunk columns in a light job's volume along X and Z, centered on the
+// job's chunk; light never travels more than 15 blocks
+constexpr int LIGHT_JOB_CHUNKS = 3;
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_LIGHT_ENGINE_H_
@@ -0,0 +1,81 @@
+#include "mesh_residency.h"
+
+#include <algorithm>
+
+#include "../core/profiler.h"
+#include "chunk.h"
+#include "chunk_map.h"
+
+namespace cppcraft {
+namespace world {
+
+MeshResidency::MeshResidency() : budget_(DEFAULT_MESH_MEMORY_BUDGET) {}
+
+void MeshResidency::MarkVisible(int chunk_x, int chunk_z) {
+  last_visible_[ChunkMap::Key(chunk_x, chunk_z)] = frame_;
+}
+
+void MeshResidency::Forget(int chunk_x, int chunk_z) {
+  last_visible_.erase(ChunkMap::Key(chunk_x, chunk_z));
+}
+
+void MeshResidency::Update(ChunkMap* chunks) {
+  size_t resident = 0;
+  size_t evicted = 0;
+  candidates_.clear();
+
+  chunks->ForEach([&](Chunk& chunk) {
+    const uint64_t key = ChunkMap::Key(chunk.GetChunkX(), chunk.GetChunkZ());
+    const uint64_t last_visible = last_visible_.try_emplace(key, frame_).first->second;
+
+    // Seen in the frame just drawn: remesh on the next update
+    if (chunk.IsMeshEvicted()) {
+      if (last_visible == frame_) {
+        chunk.RestoreMesh();
+        ++stats_.reuploads;
+      } else {
+        ++evicted;
+      }
+      return;
+    }
+
+    const size_t bytes = chunk.GetMeshBytes();
+    resident += bytes;
+    if (bytes > 0 && last_visible + MESH_EVICTION_IDLE_FRAMES < frame_) {
+      candidates_.push_back({last_visible, bytes, &chunk});
+    }
+  });
+
+  stats_.over_budget = false;
+  if (budget_ > 0 && resident > budget_) {
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) {
+                return a.last_visible < b.last_visible;
+              });
+    for (const Candidate& candidate : candidates_) {
+      if (resident <= budget_) {
+        break;
+      }
+      candidate.chunk->EvictMesh();
+      resident -= candidate.bytes;
+      ++evicted;
+      ++stats_.evictions;
+    }
+    stats_.over_budget = resident > budget_;
+  }
+
+  stats_.resident_bytes = resident;
+  stats_.evicted_chunks = evicted;
+
+  core::Profiler& profiler = core::Profiler::Get();
+  profiler.SetCounter("mesh.resident_mb",
+                      static_cast<double>(resident) / (1024.0 * 1024.0));
+  profiler.SetCounter("mesh.evicted_chunks", static_cast<double>(evicted));
+  profiler.SetCounter("mesh.evictions", static_cast<double>(stats_.evictions));
+  profiler.SetCounter("mesh.reuploads", static_cast<double>(stats_.reuploads));
+
+  ++frame_;
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,121 @@
+#ifndef SRC_WORLD_MESH_RESIDENCY_H_
+#define SRC_WORLD_MESH_RESIDENCY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cppcraft {
+namespace world {
+
+class Chunk;
+class ChunkMap;
+
+// Default limit on chunk mesh memory on the GPU, in bytes
+constexpr size_t DEFAULT_MESH_MEMORY_BUDGET = size_t{512} << 20;
+
+// Frames a chunk must go unseen before its mesh may be evicted, so that
+// meshes just out of view, or hidden by occlusion culling for a moment, are
+// not dropped and rebuilt as the camera turns
+constexpr uint64_t MESH_EVICTION_IDLE_FRAMES = 120;
+
+/**
+ * @struct MeshResidencyStats
+ * @brief GPU memory held by chunk meshes and the evictions it caused
+ */
+struct MeshResidencyStats {
+  /**
+   * @brief Vertex bytes of every uploaded chunk mesh
+   */
+  size_t resident_bytes = 0;
+
+  /**
+   * @brief Chunks whose meshes are currently evicted
+   */
+  size_t evicted_chunks = 0;
+
+  /**
+   * @brief Meshes evicted and meshes rebuilt after an eviction, since the
+   *        world was created
+   */
+  uint64_t evictions = 0;
+  uint64_t reuploads = 0;
+
+  /**
+   * @brief Whether every mesh that may be evicted is, and the budget is
+   *        still exceeded by meshes in view
+   */
+  bool over_budget = false;
+};
+
+/**
+ * @brief Keeps chunk meshes on the GPU within a memory budget
+ *
+ * The renderer reports the chunks it saw each frame; once per update the
+ * meshes of chunks unseen for longest are released until the resident
+ * bytes fit the budget. Evicted chunks keep their blocks and light, so when
+ * one comes back into view its sections are simply remeshed and uploaded
+ * again through the usual mesh jobs.
+ *
+ * Resident bytes, evictions and re-uploads are published as profiler
+ * counters. Main thread only.
+ */
+class MeshResidency {
+ public:
+  MeshResidency();
+
+  MeshResidency(const MeshResidency&) = delete;
+  MeshResidency& operator=(const MeshResidency&) = delete;
+
+  /**
+   * @brief Set the budget in bytes; 0 disables eviction
+   */
+  void SetBudget(size_t bytes) { budget_ = bytes; }
+
+  size_t GetBudget() const { return budget_; }
+
+  /**
+   * @brief Record that a chunk was in view this frame
+   *
+   * Called by the renderer for chunks with visible sections and for evicted
+   * chunks whose column is in the view frustum.
+   */
+  void MarkVisible(int chunk_x, int chunk_z);
+
+  /**
+   * @brief Restore evicted chunks seen since the last update, then evict
+   *        meshes until the budget is met
+   * @param chunks The world's loaded chunks
+   */
+  void Update(ChunkMap* chunks);
+
+  /**
+   * @brief Drop the bookkeeping of an unloaded chunk
+   */
+  void Forget(int chunk_x, int chunk_z);
+
+  const MeshResidencyStats& GetStats() const { return stats_; }
+
+ private:
+  struct Candidate {
+    uint64_t last_visible = 0;
+    size_t bytes = 0;
+    Chunk* chunk = nullptr;
+  };
+
+  size_t budget_;
+  uint64_t frame_ = 1;
+
+  // Frame each loaded chunk was last in view, by ChunkMap key; chunks
+  // start out seen in the frame they first appear
+  std::unordered_map<uint64_t, uint64_t> last_visible_;
+
+  std::vector<Candidate> candidates_;
+  MeshResidencyStats stats_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_MESH_RESIDENCY_H_
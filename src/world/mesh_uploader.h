@@ -0,0 +1,64 @@
+#ifndef SRC_WORLD_MESH_UPLOADER_H_
+#define SRC_WORLD_MESH_UPLOADER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "chunk_mesh.h"
+
+namespace cppcraft {
+namespace world {
+
+/**
+ * @brief GPU storage of section meshes, implemented by the graphics module
+ *
+ * The world meshes chunks on the CPU and hands the vertices to the uploader
+ * set with World::setMeshUploader(); without one, meshes are built but
+ * never leave the CPU, which keeps the world module free of OpenGL (the
+ * benchmark links it that way). A SectionMesh's vao, vbo, shared_buffer and
+ * vertex_offset fields belong to the uploader that stored it.
+ *
+ * Main thread only.
+ */
+class MeshUploader {
+ public:
+  virtual ~MeshUploader() = default;
+
+  /**
+   * @brief Store a section's new vertices, replacing what it held
+   * @param mesh The section; built says whether it already has storage, and
+   *        its counts still describe that storage
+   * @param vertices Four vertices per quad, drawn with the quad index pattern
+   */
+  virtual void Upload(SectionMesh* mesh,
+                      const std::vector<PackedVertex>& vertices) = 0;
+
+  /**
+   * @brief Free the storage of a section stored with Upload()
+   */
+  virtual void Release(SectionMesh* mesh) = 0;
+
+  /**
+   * @brief Draw, or queue for drawing, a range of a section's quad indices
+   * @param mesh The section, stored with Upload()
+   * @param first_index First index in the quad index pattern
+   * @param index_count Number of indices
+   * @param origin World position of the section's chunk
+   */
+  virtual void Draw(const SectionMesh& mesh, size_t first_index,
+                    size_t index_count, const glm::vec3& origin) = 0;
+
+  /**
+   * @brief Get the shared buffer draws are queued in, if any
+   * @return The buffer the renderer submits with one multi-draw, or null if
+   *         every section draws from its own VAO
+   */
+  virtual ::ChunkBuffer* GetSharedBuffer() const { return nullptr; }
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_MESH_UPLOADER_H_
@@ -0,0 +1,166 @@
+#include "mesh_worker_pool.h"
+
+#include <algorithm>
+
+#include "../core/profiler.h"
+#include "chunk.h"
+
+namespace cppcraft {
+namespace world {
+
+MeshWorkerPool::MeshWorkerPool(unsigned int thread_count) : stopping_(false) {
+  if (thread_count == 0) {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    thread_count = std::max(1u, hardware > 1 ? hardware - 1 : 1u);
+  }
+
+  workers_.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(&MeshWorkerPool::WorkerLoop, this);
+  }
+}
+
+MeshWorkerPool::~MeshWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopping_ = true;
+    queued_.clear();
+    queued_light_.clear();
+  }
+  queue_cv_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void MeshWorkerPool::Submit(std::shared_ptr<MeshJob> job) {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queued_.push_back(std::move(job));
+  }
+  queue_cv_.notify_one();
+}
+
+size_t MeshWorkerPool::UploadFinished(size_t max_uploads) {
+  size_t uploaded = 0;
+
+  while (uploaded < max_uploads) {
+    std::shared_ptr<MeshJob> job;
+    {
+      std::lock_guard<std::mutex> lock(finished_mutex_);
+      if (finished_.empty()) {
+        break;
+      }
+      job = std::move(finished_.front());
+      finished_.pop_front();
+    }
+
+    // Cancelled jobs belong to destroyed chunks or were superseded
+    if (job->cancelled.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    if (job->chunk->ApplyMeshJob(*job)) {
+      ++uploaded;
+    }
+  }
+
+  return uploaded;
+}
+
+void MeshWorkerPool::SubmitLight(std::shared_ptr<LightJob> job) {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queued_light_.push_back(std::move(job));
+  }
+  queue_cv_.notify_one();
+}
+
+void MeshWorkerPool::TakeFinishedLight(
+    std::vector<std::shared_ptr<LightJob>>* finished) {
+  std::lock_guard<std::mutex> lock(finished_mutex_);
+  for (std::shared_ptr<LightJob>& job : finished_light_) {
+    finished->push_back(std::move(job));
+  }
+  finished_light_.clear();
+}
+
+size_t MeshWorkerPool::GetQueuedCount() const {
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  return queued_.size();
+}
+
+size_t MeshWorkerPool::GetFinishedCount() const {
+  std::lock_guard<std::mutex> lock(finished_mutex_);
+  return finished_.size();
+}
+
+void MeshWorkerPool::WorkerLoop() {
+  core::Profiler::Get().SetThreadName("mesh worker");
+
+  // This worker's mesh arena, reused by every job it builds
+  MeshScratch scratch;
+
+  for (;;) {
+    std::shared_ptr<MeshJob> job;
+    std::shared_ptr<LightJob> light_job;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] {
+        return stopping_ || !queued_.empty() || !queued_light_.empty();
+      });
+      if (stopping_) {
+        return;
+      }
+      if (!queued_light_.empty()) {
+        light_job = std::move(queued_light_.front());
+        queued_light_.pop_front();
+      } else {
+        job = std::move(queued_.front());
+        queued_.pop_front();
+      }
+    }
+
+    if (light_job) {
+      // The world already requeued the edits of a cancelled job
+      if (light_job->cancelled.load(std::memory_order_acquire)) {
+        continue;
+      }
+
+      {
+        PROFILE_SCOPE("light.propagate");
+        LightEngine engine(&light_job->volume);
+        engine.Update(light_job->edits, light_job->chunk_x, light_job->chunk_z,
+                      light_job->seam);
+      }
+
+      std::lock_guard<std::mutex> lock(finished_mutex_);
+      finished_light_.push_back(std::move(light_job));
+      continue;
+    }
+
+    // Skip work for chunks that were edited or destroyed while queued
+    if (job->cancelled.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    {
+      PROFILE_SCOPE("mesh.build");
+      ChunkMesher mesher(job->input, &job->result, &scratch);
+      mesher.Build();
+    }
+
+    // The snapshot is no longer needed once meshed
+    job->input.blocks.clear();
+    job->input.blocks.shrink_to_fit();
+    job->input.light.clear();
+    job->input.light.shrink_to_fit();
+
+    std::lock_guard<std::mutex> lock(finished_mutex_);
+    finished_.push_back(std::move(job));
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,157 @@
+#ifndef SRC_WORLD_MESH_WORKER_POOL_H_
+#define SRC_WORLD_MESH_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "chunk_mesh.h"
+#include "chunk_mesher.h"
+#include "light_engine.h"
+
+namespace cppcraft {
+namespace world {
+
+class Chunk;
+
+// Default number of finished meshes uploaded to the GPU per frame
+constexpr size_t DEFAULT_MESH_UPLOADS_PER_FRAME = 4;
+
+/**
+ * @struct MeshJob
+ * @brief One section mesh build travelling through the worker pool
+ *
+ * Jobs are created on the main thread with a block snapshot, meshed on a
+ * worker thread, then handed back to the main thread for upload.
+ */
+struct MeshJob {
+  /**
+   * @brief Chunk that requested the mesh
+   *
+   * Only dereferenced on the main thread, and only while cancelled is false.
+   */
+  Chunk* chunk = nullptr;
+
+  /**
+   * @brief Section of the chunk being meshed (0 = bottom)
+   */
+  int section = 0;
+
+  /**
+   * @brief Section edit revision the snapshot was taken at
+   *
+   * The result is discarded on upload if the section has been edited since.
+   */
+  uint64_t revision = 0;
+
+  /**
+   * @brief Block snapshot to mesh
+   */
+  MeshInput input;
+
+  /**
+   * @brief Mesh produced by the worker
+   */
+  ChunkMeshData result;
+
+  /**
+   * @brief Set when the chunk is destroyed or the section schedules a newer job
+   */
+  std::atomic<bool> cancelled{false};
+};
+
+/**
+ * @brief Thread pool that builds chunk meshes off the render thread
+ *
+ * Submit() queues a job for the workers; UploadFinished() must be called
+ * once per frame on the thread owning the GL context and hands at most a
+ * fixed number of finished meshes back to their chunks for upload.
+ *
+ * The same workers propagate light: SubmitLight() queues a LightJob, which
+ * is picked ahead of mesh jobs since the meshes it affects wait for it, and
+ * TakeFinishedLight() returns the finished ones to the world.
+ */
+class MeshWorkerPool {
+ public:
+  /**
+   * @brief Start the worker threads
+   * @param thread_count Number of workers; 0 picks one less than the
+   *                     number of hardware threads (at least one)
+   */
+  explicit MeshWorkerPool(unsigned int thread_count = 0);
+
+  /**
+   * @brief Stop the workers; queued jobs are dropped
+   */
+  ~MeshWorkerPool();
+
+  MeshWorkerPool(const MeshWorkerPool&) = delete;
+  MeshWorkerPool& operator=(const MeshWorkerPool&) = delete;
+
+  /**
+   * @brief Queue a job for meshing
+   * @param job The job to build
+   */
+  void Submit(std::shared_ptr<MeshJob> job);
+
+  /**
+   * @brief Upload finished meshes to their chunks (main thread only)
+   * @param max_uploads Maximum number of meshes to upload this call;
+   *                    stale and cancelled results do not count
+   * @return Number of meshes uploaded
+   */
+  size_t UploadFinished(size_t max_uploads = DEFAULT_MESH_UPLOADS_PER_FRAME);
+
+  /**
+   * @brief Queue a light update
+   * @param job The job to propagate
+   */
+  void SubmitLight(std::shared_ptr<LightJob> job);
+
+  /**
+   * @brief Take every finished light job; cancelled jobs are dropped
+   * @param finished Receives the jobs, oldest first
+   */
+  void TakeFinishedLight(std::vector<std::shared_ptr<LightJob>>* finished);
+
+  /**
+   * @brief Get the number of jobs waiting for a worker
+   */
+  size_t GetQueuedCount() const;
+
+  /**
+   * @brief Get the number of finished jobs waiting for upload
+   */
+  size_t GetFinishedCount() const;
+
+  /**
+   * @brief Get the number of worker threads
+   */
+  size_t GetThreadCount() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::shared_ptr<MeshJob>> queued_;
+  std::deque<std::shared_ptr<LightJob>> queued_light_;
+  bool stopping_;
+
+  mutable std::mutex finished_mutex_;
+  std::deque<std::shared_ptr<MeshJob>> finished_;
+  std::vector<std::shared_ptr<LightJob>> finished_light_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_MESH_WORKER_POOL_H_
@@ -0,0 +1,192 @@
+#include "palette_storage.h"
+
+#include <algorithm>
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Palettes larger than this switch to direct 16-bit storage
+constexpr size_t MAX_PALETTE_SIZE = 256;
+
+// Find a block ID in a palette, or return the palette size if missing
+size_t FindInPalette(const std::vector<uint16_t>& palette, uint16_t block_id) {
+  auto it = std::find(palette.begin(), palette.end(), block_id);
+  return static_cast<size_t>(it - palette.begin());
+}
+
+}  // namespace
+
+PaletteStorage::PaletteStorage(size_t size, uint16_t block_id)
+    : size_(size),
+      bits_(1),
+      mask_(1),
+      palette_(1, block_id),
+      words_(GetWordCount(size, 1), 0) {}
+
+void PaletteStorage::Set(size_t index, uint16_t block_id) {
+  if (IsDirect()) {
+    WriteEntry(index, block_id);
+    return;
+  }
+
+  size_t palette_index = FindInPalette(palette_, block_id);
+  if (palette_index == palette_.size()) {
+    palette_.push_back(block_id);
+    if (palette_.size() > (size_t{1} << bits_)) {
+      Resize(BitsForPaletteSize(palette_.size()));
+      if (IsDirect()) {
+        WriteEntry(index, block_id);
+        return;
+      }
+    }
+  }
+
+  WriteEntry(index, static_cast<uint32_t>(palette_index));
+}
+
+void PaletteStorage::Fill(uint16_t block_id) {
+  bits_ = 1;
+  mask_ = 1;
+  palette_.assign(1, block_id);
+  words_.assign(GetWordCount(size_, bits_), 0);
+}
+
+void PaletteStorage::Decode(uint16_t* out) const {
+  const size_t per_word = 64 / bits_;
+  size_t index = 0;
+
+  for (uint64_t word : words_) {
+    const size_t count = std::min(per_word, size_ - index);
+    if (IsDirect()) {
+      for (size_t k = 0; k < count; ++k) {
+        out[index++] = static_cast<uint16_t>(word & mask_);
+        word >>= bits_;
+      }
+    } else {
+      for (size_t k = 0; k < count; ++k) {
+        out[index++] = palette_[word & mask_];
+        word >>= bits_;
+      }
+    }
+  }
+}
+
+void PaletteStorage::Encode(const uint16_t* in) {
+  // First pass: collect the distinct IDs, runs of equal IDs are the norm
+  std::vector<uint16_t> palette;
+  uint16_t last = in[0];
+  palette.push_back(last);
+  for (size_t i = 1; i < size_ && palette.size() <= MAX_PALETTE_SIZE; ++i) {
+    if (in[i] != last) {
+      last = in[i];
+      if (FindInPalette(palette, last) == palette.size()) {
+        palette.push_back(last);
+      }
+    }
+  }
+
+  const int bits = palette.size() > MAX_PALETTE_SIZE
+                       ? 16
+                       : BitsForPaletteSize(palette.size());
+  bits_ = bits;
+  mask_ = (uint64_t{1} << bits) - 1;
+  words_.assign(GetWordCount(size_, bits), 0);
+
+  if (IsDirect()) {
+    palette_.clear();
+    for (size_t i = 0; i < size_; ++i) {
+      WriteEntry(i, in[i]);
+    }
+    return;
+  }
+
+  palette_ = std::move(palette);
+
+  // Second pass: pack palette indices, reusing the index of the last run
+  uint16_t last_id = palette_[0];
+  uint32_t last_index = 0;
+  for (size_t i = 0; i < size_; ++i) {
+    if (in[i] != last_id) {
+      last_id = in[i];
+      last_index = static_cast<uint32_t>(FindInPalette(palette_, last_id));
+    }
+    WriteEntry(i, last_index);
+  }
+}
+
+void PaletteStorage::Compact() {
+  std::vector<uint16_t> decoded(size_);
+  Decode(decoded.data());
+  Encode(decoded.data());
+}
+
+bool PaletteStorage::Assign(int bits, std::vector<uint16_t> palette,
+                            std::vector<uint64_t> words) {
+  if (bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16) {
+    return false;
+  }
+  if (words.size() != GetWordCount(size_, bits)) {
+    return false;
+  }
+  if (bits != 16 && (palette.empty() || palette.size() > (size_t{1} << bits))) {
+    return false;
+  }
+
+  bits_ = bits;
+  mask_ = (uint64_t{1} << bits) - 1;
+  words_ = std::move(words);
+  palette_ = bits == 16 ? std::vector<uint16_t>() : std::move(palette);
+
+  // Reject indices past the end of the palette so Get() stays in range
+  if (!IsDirect()) {
+    for (size_t i = 0; i < size_; ++i) {
+      if (ReadEntry(i) >= palette_.size()) {
+        Fill(0);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+size_t PaletteStorage::GetMemoryUsage() const {
+  return palette_.capacity() * sizeof(uint16_t) +
+         words_.capacity() * sizeof(uint64_t);
+}
+
+void PaletteStorage::Resize(int bits) {
+  const int old_bits = bits_;
+  const uint64_t old_mask = mask_;
+  const size_t old_per_word = 64 / old_bits;
+  const bool to_direct = bits == 16;
+  std::vector<uint64_t> old_words = std::move(words_);
+
+  bits_ = bits;
+  mask_ = (uint64_t{1} << bits) - 1;
+  words_.assign(GetWordCount(size_, bits), 0);
+
+  for (size_t i = 0; i < size_; ++i) {
+    const size_t shift = (i % old_per_word) * old_bits;
+    uint32_t value =
+        static_cast<uint32_t>((old_words[i / old_per_word] >> shift) & old_mask);
+    WriteEntry(i, to_direct ? palette_[value] : value);
+  }
+
+  if (to_direct) {
+    palette_.clear();
+    palette_.shrink_to_fit();
+  }
+}
+
+int PaletteStorage::BitsForPaletteSize(size_t palette_size) {
+  if (palette_size <= 2) return 1;
+  if (palette_size <= 4) return 2;
+  if (palette_size <= 16) return 4;
+  if (palette_size <= MAX_PALETTE_SIZE) return 8;
+  return 16;
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,161 @@
+#ifndef SRC_WORLD_PALETTE_STORAGE_H_
+#define SRC_WORLD_PALETTE_STORAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppcraft {
+namespace world {
+
+/**
+ * @brief Palette-compressed array of block IDs
+ *
+ * Each entry stores an index into a palette of the distinct block IDs in
+ * use, packed at 1, 2, 4, 8 or 16 bits per entry. The width grows when a
+ * new block ID no longer fits the palette. At 16 bits the palette is
+ * dropped and entries hold block IDs directly.
+ *
+ * Entries never straddle a 64-bit word since every width divides 64.
+ */
+class PaletteStorage {
+ public:
+  /**
+   * @brief Construct storage with every entry set to one block ID
+   * @param size Number of entries
+   * @param block_id Initial block ID of every entry
+   */
+  explicit PaletteStorage(size_t size, uint16_t block_id = 0);
+
+  /**
+   * @brief Get the block ID of an entry
+   * @param index Entry index (must be less than GetSize())
+   * @return The block ID
+   */
+  uint16_t Get(size_t index) const {
+    const uint32_t value = ReadEntry(index);
+    return IsDirect() ? static_cast<uint16_t>(value) : palette_[value];
+  }
+
+  /**
+   * @brief Set the block ID of an entry, growing the bit width if needed
+   * @param index Entry index (must be less than GetSize())
+   * @param block_id The block ID to store
+   */
+  void Set(size_t index, uint16_t block_id);
+
+  /**
+   * @brief Set every entry to one block ID and shrink to the minimum width
+   * @param block_id The block ID to fill with
+   */
+  void Fill(uint16_t block_id);
+
+  /**
+   * @brief Bulk-decode every entry to block IDs
+   * @param out Destination for GetSize() block IDs
+   */
+  void Decode(uint16_t* out) const;
+
+  /**
+   * @brief Bulk-encode block IDs, rebuilding a minimal palette
+   * @param in Source of GetSize() block IDs
+   */
+  void Encode(const uint16_t* in);
+
+  /**
+   * @brief Rebuild the palette without unused IDs and shrink if possible
+   */
+  void Compact();
+
+  /**
+   * @brief Get the number of entries
+   * @return Number of entries
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Get the current bit width per entry (1, 2, 4, 8 or 16)
+   * @return Bits per entry
+   */
+  int GetBitsPerEntry() const { return bits_; }
+
+  /**
+   * @brief Check if entries hold block IDs directly instead of palette indices
+   * @return True at 16 bits per entry
+   */
+  bool IsDirect() const { return bits_ == 16; }
+
+  /**
+   * @brief Get the palette (empty in direct mode)
+   * @return The distinct block IDs, indexed by entry value
+   */
+  const std::vector<uint16_t>& GetPalette() const { return palette_; }
+
+  /**
+   * @brief Get the packed entry words
+   * @return The packed data, GetBitsPerEntry() bits per entry
+   */
+  const std::vector<uint64_t>& GetWords() const { return words_; }
+
+  /**
+   * @brief Replace the storage with previously serialized state
+   * @param bits Bits per entry (1, 2, 4, 8 or 16)
+   * @param palette Palette (ignored at 16 bits)
+   * @param words Packed entry words
+   * @return False if the state is inconsistent with GetSize()
+   */
+  bool Assign(int bits, std::vector<uint16_t> palette,
+              std::vector<uint64_t> words);
+
+  /**
+   * @brief Get the heap memory used by this storage
+   * @return Bytes used by the palette and packed words
+   */
+  size_t GetMemoryUsage() const;
+
+  /**
+   * @brief Get the number of 64-bit words needed for a width
+   * @param size Number of entries
+   * @param bits Bits per entry
+   * @return Number of words
+   */
+  static size_t GetWordCount(size_t size, int bits) {
+    const size_t per_word = 64 / bits;
+    return (size + per_word - 1) / per_word;
+  }
+
+ private:
+  uint32_t ReadEntry(size_t index) const {
+    const size_t per_word = 64 / bits_;
+    const size_t shift = (index % per_word) * bits_;
+    return static_cast<uint32_t>((words_[index / per_word] >> shift) & mask_);
+  }
+
+  void WriteEntry(size_t index, uint32_t value) {
+    const size_t per_word = 64 / bits_;
+    const size_t shift = (index % per_word) * bits_;
+    uint64_t& word = words_[index / per_word];
+    word = (word & ~(mask_ << shift)) | (static_cast<uint64_t>(value) << shift);
+  }
+
+  /**
+   * @brief Re-pack every entry at a new width (and into direct mode at 16)
+   */
+  void Resize(int bits);
+
+  /**
+   * @brief Smallest supported width holding palette_size distinct values
+   */
+  static int BitsForPaletteSize(size_t palette_size);
+
+  size_t size_;
+  int bits_;
+  uint64_t mask_;
+  std::vector<uint16_t> palette_;
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_PALETTE_STORAGE_H_
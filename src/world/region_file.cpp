@@ -0,0 +1,584 @@
+#include "region_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Bumped whenever the chunk payload layout changes
+constexpr uint8_t PAYLOAD_VERSION = 1;
+
+// Largest chunk payload, limited by the 8-bit sector count
+constexpr uint32_t MAX_SECTORS_PER_CHUNK = 255;
+
+// Run header: low 15 bits are the word count, the top bit marks a repeat
+constexpr uint16_t REPEAT_FLAG = 0x8000;
+constexpr size_t MAX_RUN_LENGTH = 0x7FFF;
+
+// Platform file access. The descriptor is a CRT file descriptor on
+// Windows too; positioned I/O and mapping go through its Win32 handle.
+#ifdef _WIN32
+
+int OpenFile(const std::string& path) {
+  return _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY,
+               _S_IREAD | _S_IWRITE);
+}
+
+void CloseFile(int fd) { _close(fd); }
+
+bool GetFileSize(int fd, size_t* size) {
+  struct _stat64 info;
+  if (_fstat64(fd, &info) != 0) return false;
+  *size = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+// Positioned read or write; returns the bytes transferred, or -1
+int64_t TransferAt(int fd, void* data, size_t size, uint64_t offset,
+                   bool write) {
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  DWORD done = 0;
+  const DWORD count = static_cast<DWORD>(size);
+  const BOOL ok = write ? WriteFile(handle, data, count, &done, &overlapped)
+                        : ReadFile(handle, data, count, &done, &overlapped);
+  if (!ok) {
+    // Reading at or past the end is a zero-byte read, as with pread
+    return !write && GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+  }
+  return done;
+}
+
+const uint8_t* MapFile(int fd, size_t size) {
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  HANDLE mapping =
+      CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) return nullptr;
+  // The view keeps the mapping object alive after its handle is closed
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  CloseHandle(mapping);
+  return static_cast<const uint8_t*>(view);
+}
+
+void UnmapFile(const uint8_t* data, size_t /*size*/) {
+  UnmapViewOfFile(data);
+}
+
+#else
+
+int OpenFile(const std::string& path) {
+  return open(path.c_str(), O_RDWR | O_CREAT, 0644);
+}
+
+void CloseFile(int fd) { close(fd); }
+
+bool GetFileSize(int fd, size_t* size) {
+  struct stat info;
+  if (fstat(fd, &info) != 0) return false;
+  *size = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+// Positioned read or write; returns the bytes transferred, or -1
+int64_t TransferAt(int fd, void* data, size_t size, uint64_t offset,
+                   bool write) {
+  while (true) {
+    const ssize_t count =
+        write ? pwrite(fd, data, size, static_cast<off_t>(offset))
+              : pread(fd, data, size, static_cast<off_t>(offset));
+    if (count >= 0 || errno != EINTR) return count;
+  }
+}
+
+const uint8_t* MapFile(int fd, size_t size) {
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  return data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+}
+
+void UnmapFile(const uint8_t* data, size_t size) {
+  munmap(const_cast<uint8_t*>(data), size);
+}
+
+#endif
+
+// Write the whole buffer at an offset, retrying short writes
+bool WriteAll(int fd, const uint8_t* data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    const int64_t written =
+        TransferAt(fd, const_cast<uint8_t*>(data), size, offset, true);
+    if (written < 0) return false;
+    data += written;
+    size -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+// Read the whole buffer at an offset, failing on a short file
+bool ReadAll(int fd, uint8_t* data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    const int64_t count = TransferAt(fd, data, size, offset, false);
+    if (count <= 0) return false;
+    data += count;
+    size -= static_cast<size_t>(count);
+    offset += static_cast<uint64_t>(count);
+  }
+  return true;
+}
+
+uint32_t LoadU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+void StoreU32(uint8_t* p, uint32_t value) {
+  p[0] = static_cast<uint8_t>(value);
+  p[1] = static_cast<uint8_t>(value >> 8);
+  p[2] = static_cast<uint8_t>(value >> 16);
+  p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+// Little-endian cursor over a mapped payload
+class PayloadReader {
+ public:
+  PayloadReader(const uint8_t* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  bool ReadU8(uint8_t* value) {
+    if (end_ - data_ < 1) return false;
+    *value = *data_++;
+    return true;
+  }
+
+  bool ReadU16(uint16_t* value) {
+    if (end_ - data_ < 2) return false;
+    *value = static_cast<uint16_t>(data_[0] | data_[1] << 8);
+    data_ += 2;
+    return true;
+  }
+
+  bool ReadU64(uint64_t* value) {
+    if (end_ - data_ < 8) return false;
+    *value = static_cast<uint64_t>(LoadU32(data_)) |
+             static_cast<uint64_t>(LoadU32(data_ + 4)) << 32;
+    data_ += 8;
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* end_;
+};
+
+void AppendU8(std::vector<uint8_t>& out, uint8_t value) {
+  out.push_back(value);
+}
+
+void AppendU16(std::vector<uint8_t>& out, uint16_t value) {
+  out.push_back(static_cast<uint8_t>(value));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void AppendU64(std::vector<uint8_t>& out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+  }
+}
+
+// Run-length code packed words: repeats of one word, or literal spans.
+// Uniform sections and solid stone collapse to a handful of bytes.
+void AppendWords(std::vector<uint8_t>& out, const std::vector<uint64_t>& words) {
+  size_t i = 0;
+  while (i < words.size()) {
+    size_t run = 1;
+    while (i + run < words.size() && run < MAX_RUN_LENGTH &&
+           words[i + run] == words[i]) {
+      ++run;
+    }
+
+    if (run > 1) {
+      AppendU16(out, static_cast<uint16_t>(REPEAT_FLAG | run));
+      AppendU64(out, words[i]);
+      i += run;
+      continue;
+    }
+
+    // Literal span up to the start of the next repeat
+    size_t literal = 1;
+    while (i + literal < words.size() && literal < MAX_RUN_LENGTH &&
+           (i + literal + 1 >= words.size() ||
+            words[i + literal] != words[i + literal + 1])) {
+      ++literal;
+    }
+
+    AppendU16(out, static_cast<uint16_t>(literal));
+    for (size_t k = 0; k < literal; ++k) {
+      AppendU64(out, words[i + k]);
+    }
+    i += literal;
+  }
+}
+
+bool ReadWords(PayloadReader& reader, size_t word_count,
+               std::vector<uint64_t>* words) {
+  words->clear();
+  words->reserve(word_count);
+
+  while (words->size() < word_count) {
+    uint16_t header;
+    if (!reader.ReadU16(&header)) return false;
+
+    const size_t run = header & MAX_RUN_LENGTH;
+    if (run == 0 || words->size() + run > word_count) return false;
+
+    uint64_t word;
+    if (header & REPEAT_FLAG) {
+      if (!reader.ReadU64(&word)) return false;
+      words->insert(words->end(), run, word);
+    } else {
+      for (size_t k = 0; k < run; ++k) {
+        if (!reader.ReadU64(&word)) return false;
+        words->push_back(word);
+      }
+    }
+  }
+  return true;
+}
+
+void AppendSection(std::vector<uint8_t>& out, const ChunkSection& section) {
+  const PaletteStorage& storage = section.GetStorage();
+  const std::vector<uint16_t>& palette = storage.GetPalette();
+
+  AppendU8(out, static_cast<uint8_t>(storage.GetBitsPerEntry()));
+  AppendU16(out, static_cast<uint16_t>(palette.size()));
+  for (uint16_t block_id : palette) {
+    AppendU16(out, block_id);
+  }
+  AppendWords(out, storage.GetWords());
+}
+
+bool ReadSection(PayloadReader& reader, ChunkSection* section) {
+  uint8_t bits;
+  uint16_t palette_size;
+  if (!reader.ReadU8(&bits) || !reader.ReadU16(&palette_size)) return false;
+  if (bits == 0 || bits > 16) return false;
+
+  std::vector<uint16_t> palette(palette_size);
+  for (uint16_t& block_id : palette) {
+    if (!reader.ReadU16(&block_id)) return false;
+  }
+
+  std::vector<uint64_t> words;
+  if (!ReadWords(reader, PaletteStorage::GetWordCount(SECTION_VOLUME, bits),
+                 &words)) {
+    return false;
+  }
+
+  return section->AssignStorage(bits, std::move(palette), std::move(words));
+}
+
+}  // namespace
+
+void EncodeChunkPayload(const ChunkStorage& storage, std::vector<uint8_t>* out) {
+  const uint32_t section_mask = storage.GetNonEmptyMask();
+  AppendU8(*out, PAYLOAD_VERSION);
+  AppendU16(*out, static_cast<uint16_t>(section_mask));
+  for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+    if (section_mask & (1u << i)) {
+      AppendSection(*out, *storage.GetSection(i));
+    }
+  }
+}
+
+bool DecodeChunkPayload(const uint8_t* data, size_t size, ChunkStorage* out) {
+  PayloadReader reader(data, size);
+  uint8_t version;
+  uint16_t section_mask;
+  if (!reader.ReadU8(&version) || version != PAYLOAD_VERSION ||
+      !reader.ReadU16(&section_mask)) {
+    return false;
+  }
+
+  // Decode into a scratch column so a corrupt payload leaves out untouched
+  ChunkStorage storage;
+  for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+    if (!(section_mask & (1u << i))) {
+      continue;
+    }
+    auto section = std::make_unique<ChunkSection>();
+    if (!ReadSection(reader, section.get())) {
+      return false;
+    }
+    storage.SetSection(i, std::move(section));
+  }
+
+  *out = std::move(storage);
+  return true;
+}
+
+void EncodeSectionPayload(const ChunkSection& section, std::vector<uint8_t>* out) {
+  AppendSection(*out, section);
+}
+
+bool DecodeSectionPayload(const uint8_t* data, size_t size, ChunkSection* out) {
+  PayloadReader reader(data, size);
+  return ReadSection(reader, out);
+}
+
+std::unique_ptr<RegionFile> RegionFile::Open(const std::string& path) {
+  const int fd = OpenFile(path);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  size_t file_size = 0;
+  if (!GetFileSize(fd, &file_size)) {
+    CloseFile(fd);
+    return nullptr;
+  }
+
+  if (file_size == 0) {
+    // New region: an all-zero offset table
+    std::vector<uint8_t> table(REGION_SECTOR_SIZE, 0);
+    if (!WriteAll(fd, table.data(), table.size(), 0)) {
+      CloseFile(fd);
+      return nullptr;
+    }
+    file_size = REGION_SECTOR_SIZE;
+  } else if (file_size < REGION_SECTOR_SIZE) {
+    CloseFile(fd);
+    return nullptr;
+  }
+
+  std::unique_ptr<RegionFile> region(new RegionFile(fd, file_size));
+
+  uint8_t table[REGION_SECTOR_SIZE];
+  if (!ReadAll(fd, table, sizeof(table), 0)) {
+    return nullptr;
+  }
+
+  // Entries pointing outside the file are treated as never saved
+  const uint32_t sector_count = static_cast<uint32_t>(
+      (file_size + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+  region->used_sectors_.assign(sector_count, false);
+  region->used_sectors_[0] = true;
+
+  for (int i = 0; i < REGION_CHUNK_COUNT; ++i) {
+    const uint32_t entry = LoadU32(&table[i * 4]);
+    const uint32_t first = entry >> 8;
+    const uint32_t count = entry & 0xFF;
+    if (entry == 0 || first == 0 || count == 0 || first + count > sector_count) {
+      region->table_[i] = 0;
+      continue;
+    }
+    region->table_[i] = entry;
+    region->MarkSectors(first, count, true);
+  }
+
+  return region;
+}
+
+RegionFile::RegionFile(int fd, size_t file_size)
+    : fd_(fd),
+      file_size_(file_size),
+      mapped_(nullptr),
+      mapped_size_(0),
+      table_() {}
+
+RegionFile::~RegionFile() {
+  Unmap();
+  CloseFile(fd_);
+}
+
+bool RegionFile::ReadChunk(int local_x, int local_z, ChunkStorage* out) {
+  const uint32_t entry = table_[GetTableIndex(local_x, local_z)];
+  if (entry == 0 || !Map()) {
+    return false;
+  }
+
+  const size_t offset = static_cast<size_t>(entry >> 8) * REGION_SECTOR_SIZE;
+  const size_t capacity = static_cast<size_t>(entry & 0xFF) * REGION_SECTOR_SIZE;
+  if (offset + capacity > mapped_size_) {
+    return false;
+  }
+
+  const uint8_t* payload = mapped_ + offset;
+  const uint32_t length = LoadU32(payload);
+  if (length > capacity - 4) {
+    return false;
+  }
+
+  return DecodeChunkPayload(payload + 4, length, out);
+}
+
+bool RegionFile::WriteChunk(int local_x, int local_z,
+                            const ChunkStorage& storage) {
+  std::vector<uint8_t> payload(4, 0);
+  EncodeChunkPayload(storage, &payload);
+  StoreU32(payload.data(), static_cast<uint32_t>(payload.size() - 4));
+
+  const uint32_t count = static_cast<uint32_t>(
+      (payload.size() + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+  if (count > MAX_SECTORS_PER_CHUNK) {
+    return false;
+  }
+  payload.resize(count * REGION_SECTOR_SIZE, 0);
+
+  // The old copy stays allocated until the table points at the new one
+  const uint32_t first = Allocate(count);
+  if (!WriteAll(fd_, payload.data(), payload.size(),
+                static_cast<uint64_t>(first) * REGION_SECTOR_SIZE)) {
+    MarkSectors(first, count, false);
+    return false;
+  }
+  file_size_ = std::max(file_size_,
+                        static_cast<size_t>(first + count) * REGION_SECTOR_SIZE);
+
+  const int index = GetTableIndex(local_x, local_z);
+  const uint32_t entry = first << 8 | count;
+  uint8_t encoded[4];
+  StoreU32(encoded, entry);
+  if (!WriteAll(fd_, encoded, sizeof(encoded), static_cast<uint64_t>(index) * 4)) {
+    MarkSectors(first, count, false);
+    return false;
+  }
+
+  const uint32_t previous = table_[index];
+  if (previous != 0) {
+    MarkSectors(previous >> 8, previous & 0xFF, false);
+  }
+  table_[index] = entry;
+  return true;
+}
+
+bool RegionFile::Map() {
+  if (mapped_ && mapped_size_ == file_size_) {
+    return true;
+  }
+
+  // The file grew since the last mapping
+  Unmap();
+  mapped_ = MapFile(fd_, file_size_);
+  if (!mapped_) {
+    return false;
+  }
+  mapped_size_ = file_size_;
+  return true;
+}
+
+void RegionFile::Unmap() {
+  if (mapped_) {
+    UnmapFile(mapped_, mapped_size_);
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+  }
+}
+
+uint32_t RegionFile::Allocate(uint32_t count) {
+  // First fit among the freed sectors
+  uint32_t run = 0;
+  for (uint32_t i = 1; i < used_sectors_.size(); ++i) {
+    run = used_sectors_[i] ? 0 : run + 1;
+    if (run == count) {
+      const uint32_t first = i + 1 - count;
+      MarkSectors(first, count, true);
+      return first;
+    }
+  }
+
+  // Otherwise extend the file, reusing any free sectors at its end
+  uint32_t first = static_cast<uint32_t>(used_sectors_.size());
+  while (first > 1 && !used_sectors_[first - 1]) {
+    --first;
+  }
+  used_sectors_.resize(std::max<size_t>(used_sectors_.size(), first + count), false);
+  MarkSectors(first, count, true);
+  return first;
+}
+
+void RegionFile::MarkSectors(uint32_t first, uint32_t count, bool used) {
+  for (uint32_t i = first; i < first + count; ++i) {
+    used_sectors_[i] = used;
+  }
+}
+
+RegionStore::RegionStore(std::string directory)
+    : directory_(std::move(directory)) {}
+
+bool RegionStore::HasChunk(int chunk_x, int chunk_z) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RegionFile* region = GetRegion(RegionFile::ToRegionCoord(chunk_x),
+                                 RegionFile::ToRegionCoord(chunk_z), false);
+  return region && region->HasChunk(RegionFile::ToLocalCoord(chunk_x),
+                                    RegionFile::ToLocalCoord(chunk_z));
+}
+
+bool RegionStore::LoadChunk(int chunk_x, int chunk_z, ChunkStorage* out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RegionFile* region = GetRegion(RegionFile::ToRegionCoord(chunk_x),
+                                 RegionFile::ToRegionCoord(chunk_z), false);
+  return region && region->ReadChunk(RegionFile::ToLocalCoord(chunk_x),
+                                     RegionFile::ToLocalCoord(chunk_z), out);
+}
+
+bool RegionStore::SaveChunk(int chunk_x, int chunk_z,
+                            const ChunkStorage& storage) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RegionFile* region = GetRegion(RegionFile::ToRegionCoord(chunk_x),
+                                 RegionFile::ToRegionCoord(chunk_z), true);
+  return region && region->WriteChunk(RegionFile::ToLocalCoord(chunk_x),
+                                      RegionFile::ToLocalCoord(chunk_z),
+                                      storage);
+}
+
+RegionFile* RegionStore::GetRegion(int region_x, int region_z, bool create) {
+  const uint64_t key = RegionKey(region_x, region_z);
+  auto it = regions_.find(key);
+  if (it != regions_.end()) {
+    return it->second.get();
+  }
+
+  const std::string path = GetRegionPath(region_x, region_z);
+  struct stat info;
+  if (!create && stat(path.c_str(), &info) != 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<RegionFile> region = RegionFile::Open(path);
+  if (!region) {
+    return nullptr;
+  }
+  return regions_.emplace(key, std::move(region)).first->second.get();
+}
+
+std::string RegionStore::GetRegionPath(int region_x, int region_z) const {
+  return directory_ + "/r." + std::to_string(region_x) + "." +
+         std::to_string(region_z) + ".region";
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,230 @@
+#ifndef SRC_WORLD_REGION_FILE_H_
+#define SRC_WORLD_REGION_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_section.h"
+
+namespace cppcraft {
+namespace world {
+
+// Chunks per region along X and Z (32x32 chunks per file)
+constexpr int REGION_SIZE = 32;
+constexpr int REGION_CHUNK_COUNT = REGION_SIZE * REGION_SIZE;
+
+// Allocation unit of a region file; sector 0 holds the offset table
+constexpr size_t REGION_SECTOR_SIZE = 4096;
+
+/**
+ * @brief Append a chunk's blocks in the region payload format
+ *
+ * The payload is the part of a region entry after its byte length: format
+ * version, section mask, then the palette and run-length coded words of
+ * every non-empty section. Network snapshots reuse it as is.
+ *
+ * @param storage The blocks to encode; empty sections are skipped
+ * @param out Receives the payload, appended to its contents
+ */
+void EncodeChunkPayload(const ChunkStorage& storage, std::vector<uint8_t>* out);
+
+/**
+ * @brief Decode a payload written by EncodeChunkPayload()
+ * @param out Receives the sections; untouched on failure
+ * @return False if the payload is truncated, corrupt or of another version
+ */
+bool DecodeChunkPayload(const uint8_t* data, size_t size, ChunkStorage* out);
+
+/**
+ * @brief Append one section's palette and run-length coded words
+ */
+void EncodeSectionPayload(const ChunkSection& section, std::vector<uint8_t>* out);
+
+/**
+ * @brief Decode a section written by EncodeSectionPayload()
+ * @return False if the data is truncated or corrupt
+ */
+bool DecodeSectionPayload(const uint8_t* data, size_t size, ChunkSection* out);
+
+/**
+ * @brief One region file holding up to 32x32 chunks
+ *
+ * Layout (all integers little-endian):
+ * - Sector 0: REGION_CHUNK_COUNT uint32 entries, indexed by
+ *   local_z * REGION_SIZE + local_x, each (first_sector << 8) | sector_count.
+ *   Zero means the chunk has never been saved.
+ * - Chunk payloads in whole sectors: uint32 byte length, uint8 format
+ *   version, uint16 section mask, then for every set section its bits per
+ *   entry, palette, and packed words run-length coded.
+ *
+ * The file is read through a read-only memory mapping, so loads decode
+ * straight from the page cache. Writes go through the descriptor: a chunk is
+ * written to free sectors first and the table entry is updated last, so an
+ * interrupted save leaves the previous copy intact.
+ *
+ * Not thread-safe.
+ */
+class RegionFile {
+ public:
+  /**
+   * @brief Open a region file, creating an empty one if it does not exist
+   * @param path File path
+   * @return The region file, or nullptr if it cannot be opened or is corrupt
+   */
+  static std::unique_ptr<RegionFile> Open(const std::string& path);
+
+  ~RegionFile();
+
+  RegionFile(const RegionFile&) = delete;
+  RegionFile& operator=(const RegionFile&) = delete;
+
+  /**
+   * @brief Check if a chunk has been saved to this region
+   * @param local_x Chunk X within the region (0-31)
+   * @param local_z Chunk Z within the region (0-31)
+   */
+  bool HasChunk(int local_x, int local_z) const {
+    return table_[GetTableIndex(local_x, local_z)] != 0;
+  }
+
+  /**
+   * @brief Read a chunk's blocks
+   * @param local_x Chunk X within the region (0-31)
+   * @param local_z Chunk Z within the region (0-31)
+   * @param out Receives the sections; untouched on failure
+   * @return False if the chunk is missing or its payload is corrupt
+   */
+  bool ReadChunk(int local_x, int local_z, ChunkStorage* out);
+
+  /**
+   * @brief Write a chunk's blocks, replacing any previous copy
+   * @param local_x Chunk X within the region (0-31)
+   * @param local_z Chunk Z within the region (0-31)
+   * @param storage The blocks to save; empty sections are skipped
+   * @return False on an I/O error
+   */
+  bool WriteChunk(int local_x, int local_z, const ChunkStorage& storage);
+
+  /**
+   * @brief Get the region coordinate containing a chunk coordinate
+   */
+  static int ToRegionCoord(int chunk_coord) {
+    return chunk_coord >= 0 ? chunk_coord / REGION_SIZE
+                            : (chunk_coord - (REGION_SIZE - 1)) / REGION_SIZE;
+  }
+
+  /**
+   * @brief Get a chunk coordinate's position within its region (0-31)
+   */
+  static int ToLocalCoord(int chunk_coord) {
+    const int local = chunk_coord % REGION_SIZE;
+    return local < 0 ? local + REGION_SIZE : local;
+  }
+
+ private:
+  RegionFile(int fd, size_t file_size);
+
+  static int GetTableIndex(int local_x, int local_z) {
+    return local_z * REGION_SIZE + local_x;
+  }
+
+  /**
+   * @brief Map the file if the mapping is missing or out of date
+   */
+  bool Map();
+  void Unmap();
+
+  /**
+   * @brief Find a run of free sectors, growing the file if none fits
+   * @return Index of the first sector
+   */
+  uint32_t Allocate(uint32_t count);
+  void MarkSectors(uint32_t first, uint32_t count, bool used);
+
+  int fd_;
+  size_t file_size_;
+
+  // Read-only mapping of the first mapped_size_ bytes, or nullptr
+  const uint8_t* mapped_;
+  size_t mapped_size_;
+
+  uint32_t table_[REGION_CHUNK_COUNT];
+  std::vector<bool> used_sectors_;
+};
+
+/**
+ * @brief Save directory of region files, opened on demand
+ *
+ * Files are named r.<region_x>.<region_z>.region. Regions are only created
+ * when a chunk is first saved into them. Loads and saves are serialized
+ * internally, so chunks can be streamed in from worker threads while the
+ * main thread saves.
+ */
+class RegionStore {
+ public:
+  /**
+   * @brief Use a directory for region files; it must already exist
+   * @param directory Save directory
+   */
+  explicit RegionStore(std::string directory);
+
+  /**
+   * @brief Check if a chunk has been saved, without creating its region
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   */
+  bool HasChunk(int chunk_x, int chunk_z);
+
+  /**
+   * @brief Load a chunk's blocks
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param out Receives the sections; untouched on failure
+   * @return False if the chunk has never been saved or cannot be read
+   */
+  bool LoadChunk(int chunk_x, int chunk_z, ChunkStorage* out);
+
+  /**
+   * @brief Save a chunk's blocks
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param storage The blocks to save
+   * @return False on an I/O error
+   */
+  bool SaveChunk(int chunk_x, int chunk_z, const ChunkStorage& storage);
+
+  /**
+   * @brief Get the save directory
+   */
+  const std::string& GetDirectory() const { return directory_; }
+
+ private:
+  /**
+   * @brief Get an open region, opening or creating its file
+   * @param create Create the file if it does not exist
+   * @return The region, or nullptr if it does not exist or failed to open
+   */
+  RegionFile* GetRegion(int region_x, int region_z, bool create);
+
+  std::string GetRegionPath(int region_x, int region_z) const;
+
+  static uint64_t RegionKey(int region_x, int region_z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(region_x)) << 32) |
+           static_cast<uint32_t>(region_z);
+  }
+
+  std::string directory_;
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, std::unique_ptr<RegionFile>> regions_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_REGION_FILE_H_
@@ -0,0 +1,413 @@
+#include "terrain_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "block.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPPCRAFT_NOISE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CPPCRAFT_NOISE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Four-lane float and 32-bit unsigned integer vectors. The noise below is
+// written once against these; each backend maps them to the same
+// lane-wise operations, which keeps results identical across backends.
+#if defined(CPPCRAFT_NOISE_SSE2)
+
+struct Float4 {
+  __m128 v;
+};
+
+struct Uint4 {
+  __m128i v;
+};
+
+inline Float4 Set(float a) { return {_mm_set1_ps(a)}; }
+inline Uint4 Set(uint32_t a) { return {_mm_set1_epi32(static_cast<int>(a))}; }
+inline Float4 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a.v); }
+
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float4 Min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Float4 Max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+inline Uint4 operator+(Uint4 a, Uint4 b) { return {_mm_add_epi32(a.v, b.v)}; }
+inline Uint4 operator^(Uint4 a, Uint4 b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline Uint4 operator&(Uint4 a, Uint4 b) { return {_mm_and_si128(a.v, b.v)}; }
+
+// SSE2 has no 32-bit low multiply; combine the even and odd lane products
+inline Uint4 operator*(Uint4 a, Uint4 b) {
+  const __m128i even = _mm_mul_epu32(a.v, b.v);
+  const __m128i odd =
+      _mm_mul_epu32(_mm_srli_si128(a.v, 4), _mm_srli_si128(b.v, 4));
+  return {_mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                             _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)))};
+}
+
+template <int BITS>
+inline Uint4 ShiftRight(Uint4 a) {
+  return {_mm_srli_epi32(a.v, BITS)};
+}
+
+// All bits set in lanes where (a & bit) != 0
+inline Uint4 TestBit(Uint4 a, uint32_t bit) {
+  const __m128i b = _mm_set1_epi32(static_cast<int>(bit));
+  return {_mm_cmpeq_epi32(_mm_and_si128(a.v, b), b)};
+}
+
+inline Float4 Select(Uint4 mask, Float4 a, Float4 b) {
+  const __m128 m = _mm_castsi128_ps(mask.v);
+  return {_mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v))};
+}
+
+inline Float4 NegateIf(Uint4 mask, Float4 a) {
+  const __m128i sign = _mm_and_si128(mask.v, _mm_set1_epi32(INT32_MIN));
+  return {_mm_xor_ps(a.v, _mm_castsi128_ps(sign))};
+}
+
+// Floor to int (as two's complement bits) and back to float
+inline void Floor(Float4 a, Uint4* cell, Float4* cell_float) {
+  __m128i truncated = _mm_cvttps_epi32(a.v);
+  const __m128 back = _mm_cvtepi32_ps(truncated);
+  // Truncation rounds negative values up; step those down by one
+  const __m128i fix = _mm_castps_si128(_mm_cmpgt_ps(back, a.v));
+  truncated = _mm_add_epi32(truncated, fix);
+  cell->v = truncated;
+  cell_float->v = _mm_cvtepi32_ps(truncated);
+}
+
+constexpr const char* SIMD_BACKEND = "sse2";
+
+#elif defined(CPPCRAFT_NOISE_NEON)
+
+struct Float4 {
+  float32x4_t v;
+};
+
+struct Uint4 {
+  uint32x4_t v;
+};
+
+inline Float4 Set(float a) { return {vdupq_n_f32(a)}; }
+inline Uint4 Set(uint32_t a) { return {vdupq_n_u32(a)}; }
+inline Float4 Load(const float* p) { return {vld1q_f32(p)}; }
+inline void Store(float* p, Float4 a) { vst1q_f32(p, a.v); }
+
+inline Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 Min(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+inline Float4 Max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+
+inline Uint4 operator+(Uint4 a, Uint4 b) { return {vaddq_u32(a.v, b.v)}; }
+inline Uint4 operator^(Uint4 a, Uint4 b) { return {veorq_u32(a.v, b.v)}; }
+inline Uint4 operator&(Uint4 a, Uint4 b) { return {vandq_u32(a.v, b.v)}; }
+inline Uint4 operator*(Uint4 a, Uint4 b) { return {vmulq_u32(a.v, b.v)}; }
+
+template <int BITS>
+inline Uint4 ShiftRight(Uint4 a) {
+  return {vshrq_n_u32(a.v, BITS)};
+}
+
+inline Uint4 TestBit(Uint4 a, uint32_t bit) {
+  return {vtstq_u32(a.v, vdupq_n_u32(bit))};
+}
+
+inline Float4 Select(Uint4 mask, Float4 a, Float4 b) {
+  return {vbslq_f32(mask.v, a.v, b.v)};
+}
+
+inline Float4 NegateIf(Uint4 mask, Float4 a) {
+  const uint32x4_t sign = vandq_u32(mask.v, vdupq_n_u32(0x80000000u));
+  return {vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v), sign))};
+}
+
+inline void Floor(Float4 a, Uint4* cell, Float4* cell_float) {
+  int32x4_t truncated = vcvtq_s32_f32(a.v);
+  const float32x4_t back = vcvtq_f32_s32(truncated);
+  // Truncation rounds negative values up; step those down by one
+  const int32x4_t fix = vreinterpretq_s32_u32(vcgtq_f32(back, a.v));
+  truncated = vaddq_s32(truncated, fix);
+  cell->v = vreinterpretq_u32_s32(truncated);
+  cell_float->v = vcvtq_f32_s32(truncated);
+}
+
+constexpr const char* SIMD_BACKEND = "neon";
+
+#else
+
+struct Float4 {
+  float v[4];
+};
+
+struct Uint4 {
+  uint32_t v[4];
+};
+
+template <typename T, typename Op>
+inline T Map(T a, T b, Op op) {
+  T r;
+  for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]);
+  return r;
+}
+
+inline Float4 Set(float a) { return {{a, a, a, a}}; }
+inline Uint4 Set(uint32_t a) { return {{a, a, a, a}}; }
+inline Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void Store(float* p, Float4 a) { std::copy(a.v, a.v + 4, p); }
+
+inline Float4 operator+(Float4 a, Float4 b) {
+  return Map(a, b, [](float x, float y) { return x + y; });
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return Map(a, b, [](float x, float y) { return x - y; });
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return Map(a, b, [](float x, float y) { return x * y; });
+}
+inline Float4 Min(Float4 a, Float4 b) {
+  return Map(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+inline Float4 Max(Float4 a, Float4 b) {
+  return Map(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+
+inline Uint4 operator+(Uint4 a, Uint4 b) {
+  return Map(a, b, [](uint32_t x, uint32_t y) { return x + y; });
+}
+inline Uint4 operator^(Uint4 a, Uint4 b) {
+  return Map(a, b, [](uint32_t x, uint32_t y) { return x ^ y; });
+}
+inline Uint4 operator&(Uint4 a, Uint4 b) {
+  return Map(a, b, [](uint32_t x, uint32_t y) { return x & y; });
+}
+inline Uint4 operator*(Uint4 a, Uint4 b) {
+  return Map(a, b, [](uint32_t x, uint32_t y) { return x * y; });
+}
+
+template <int BITS>
+inline Uint4 ShiftRight(Uint4 a) {
+  for (uint32_t& lane : a.v) lane >>= BITS;
+  return a;
+}
+
+inline Uint4 TestBit(Uint4 a, uint32_t bit) {
+  for (uint32_t& lane : a.v) lane = (lane & bit) ? ~0u : 0u;
+  return a;
+}
+
+inline Float4 Select(Uint4 mask, Float4 a, Float4 b) {
+  Float4 r;
+  for (int i = 0; i < 4; ++i) r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+  return r;
+}
+
+inline Float4 NegateIf(Uint4 mask, Float4 a) {
+  for (int i = 0; i < 4; ++i) {
+    if (mask.v[i]) a.v[i] = -a.v[i];
+  }
+  return a;
+}
+
+inline void Floor(Float4 a, Uint4* cell, Float4* cell_float) {
+  for (int i = 0; i < 4; ++i) {
+    const int32_t floored = static_cast<int32_t>(std::floor(a.v[i]));
+    cell->v[i] = static_cast<uint32_t>(floored);
+    cell_float->v[i] = static_cast<float>(floored);
+  }
+}
+
+constexpr const char* SIMD_BACKEND = "scalar";
+
+#endif
+
+// Seed offset between octaves (golden ratio), decorrelating their lattices
+constexpr uint32_t OCTAVE_SEED_STEP = 0x9E3779B9u;
+
+// Brings the gradient dot products back to roughly [-1, 1]
+constexpr float NOISE_SCALE = 0.5f;
+
+// Hash a lattice point to 32 well-mixed bits
+inline Uint4 Hash(Uint4 x, Uint4 z, Uint4 seed) {
+  Uint4 h = x * Set(0x27D4EB2Du) ^ z * Set(0x165667B1u) ^ seed;
+  h = h ^ ShiftRight<15>(h);
+  h = h * Set(0x2C1B3C6Du);
+  h = h ^ ShiftRight<12>(h);
+  h = h * Set(0x297A2D39u);
+  return h ^ ShiftRight<15>(h);
+}
+
+// Dot product of the offset with one of eight hashed gradients
+inline Float4 Gradient(Uint4 hash, Float4 x, Float4 z) {
+  const Uint4 swap = TestBit(hash, 4);
+  const Float4 u = Select(swap, z, x);
+  const Float4 v = Select(swap, x, z);
+  return NegateIf(TestBit(hash, 1), u) +
+         NegateIf(TestBit(hash, 2), v) * Set(2.0f);
+}
+
+// Quintic fade, 6t^5 - 15t^4 + 10t^3
+inline Float4 Fade(Float4 t) {
+  return t * t * t * (t * (t * Set(6.0f) - Set(15.0f)) + Set(10.0f));
+}
+
+inline Float4 Lerp(Float4 a, Float4 b, Float4 t) { return a + t * (b - a); }
+
+// 2D Perlin noise in roughly [-1, 1]
+Float4 Perlin(Float4 x, Float4 z, Uint4 seed) {
+  Uint4 x0;
+  Uint4 z0;
+  Float4 x0_float;
+  Float4 z0_float;
+  Floor(x, &x0, &x0_float);
+  Floor(z, &z0, &z0_float);
+
+  const Uint4 x1 = x0 + Set(1u);
+  const Uint4 z1 = z0 + Set(1u);
+  const Float4 fx = x - x0_float;
+  const Float4 fz = z - z0_float;
+  const Float4 fx1 = fx - Set(1.0f);
+  const Float4 fz1 = fz - Set(1.0f);
+
+  const Float4 g00 = Gradient(Hash(x0, z0, seed), fx, fz);
+  const Float4 g10 = Gradient(Hash(x1, z0, seed), fx1, fz);
+  const Float4 g01 = Gradient(Hash(x0, z1, seed), fx, fz1);
+  const Float4 g11 = Gradient(Hash(x1, z1, seed), fx1, fz1);
+
+  const Float4 u = Fade(fx);
+  const Float4 a = Lerp(g00, g10, u);
+  const Float4 b = Lerp(g01, g11, u);
+  return Lerp(a, b, Fade(fz)) * Set(NOISE_SCALE);
+}
+
+}  // namespace
+
+TerrainGenerator::TerrainGenerator(const TerrainSettings& settings)
+    : settings_(settings) {
+  settings_.octaves = std::max(1, settings_.octaves);
+
+  float total = 0.0f;
+  float amplitude = 1.0f;
+  for (int octave = 0; octave < settings_.octaves; ++octave) {
+    total += amplitude;
+    amplitude *= settings_.gain;
+  }
+  amplitude_scale_ = 1.0f / total;
+}
+
+void TerrainGenerator::GenerateHeights4(int world_x, int world_z,
+                                        int* heights) const {
+  const float xs[4] = {
+      static_cast<float>(world_x), static_cast<float>(world_x + 1),
+      static_cast<float>(world_x + 2), static_cast<float>(world_x + 3)};
+  const Float4 x = Load(xs);
+  const Float4 z = Set(static_cast<float>(world_z));
+
+  Float4 sum = Set(0.0f);
+  float amplitude = 1.0f;
+  float frequency = settings_.frequency;
+  uint32_t seed = settings_.seed;
+
+  for (int octave = 0; octave < settings_.octaves; ++octave) {
+    const Float4 scale = Set(frequency);
+    sum = sum + Perlin(x * scale, z * scale, Set(seed)) * Set(amplitude);
+    amplitude *= settings_.gain;
+    frequency *= settings_.lacunarity;
+    seed += OCTAVE_SEED_STEP;
+  }
+
+  const Float4 noise =
+      Max(Set(-1.0f), Min(Set(1.0f), sum * Set(amplitude_scale_)));
+  float offsets[4];
+  Store(offsets, noise * Set(settings_.height_amplitude));
+
+  for (int i = 0; i < 4; ++i) {
+    const int height =
+        settings_.base_height + static_cast<int>(std::floor(offsets[i]));
+    heights[i] = std::clamp(height, 1, SECTION_SIZE * SECTIONS_PER_CHUNK - 1);
+  }
+}
+
+void TerrainGenerator::GenerateHeights(int chunk_x, int chunk_z,
+                                       int* heights) const {
+  const int origin_x = chunk_x * SECTION_SIZE;
+  const int origin_z = chunk_z * SECTION_SIZE;
+
+  for (int z = 0; z < SECTION_SIZE; ++z) {
+    for (int x = 0; x < SECTION_SIZE; x += 4) {
+      GenerateHeights4(origin_x + x, origin_z + z, &heights[z * SECTION_SIZE + x]);
+    }
+  }
+}
+
+void TerrainGenerator::Generate(int chunk_x, int chunk_z,
+                                ChunkStorage* storage) const {
+  int heights[SECTION_AREA];
+  GenerateHeights(chunk_x, chunk_z, heights);
+
+  const int lowest = *std::min_element(heights, heights + SECTION_AREA);
+  const int highest = *std::max_element(heights, heights + SECTION_AREA);
+
+  const uint16_t stone = static_cast<uint16_t>(BlockType::STONE);
+  const uint16_t dirt = static_cast<uint16_t>(BlockType::DIRT);
+  const uint16_t grass = static_cast<uint16_t>(BlockType::GRASS_BLOCK);
+
+  storage->Fill(AIR_BLOCK_ID);
+
+  std::array<uint16_t, SECTION_VOLUME> blocks;
+  for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+    const int base_y = section * SECTION_SIZE;
+    if (base_y > highest) {
+      break;
+    }
+
+    for (int local_y = 0; local_y < SECTION_SIZE; ++local_y) {
+      const int y = base_y + local_y;
+      uint16_t* layer = &blocks[local_y * SECTION_AREA];
+
+      // Whole layers below the shallowest stone or above every surface
+      if (y < lowest - settings_.dirt_depth) {
+        std::fill(layer, layer + SECTION_AREA, stone);
+        continue;
+      }
+      if (y > highest) {
+        std::fill(layer, layer + SECTION_AREA, AIR_BLOCK_ID);
+        continue;
+      }
+
+      for (int column = 0; column < SECTION_AREA; ++column) {
+        const int height = heights[column];
+        layer[column] = y > height                          ? AIR_BLOCK_ID
+                        : y == height                       ? grass
+                        : y >= height - settings_.dirt_depth ? dirt
+                                                            : stone;
+      }
+    }
+
+    storage->GetOrCreateSection(section).Encode(blocks.data());
+  }
+}
+
+int TerrainGenerator::GetHeight(int world_x, int world_z) const {
+  int heights[4];
+  GenerateHeights4(world_x, world_z, heights);
+  return heights[0];
+}
+
+const char* TerrainGenerator::GetSimdBackend() { return SIMD_BACKEND; }
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,128 @@
+#ifndef SRC_WORLD_TERRAIN_GENERATOR_H_
+#define SRC_WORLD_TERRAIN_GENERATOR_H_
+
+#include <cstdint>
+
+#include "chunk_section.h"
+
+namespace cppcraft {
+namespace world {
+
+/**
+ * @struct TerrainSettings
+ * @brief Parameters of the height-map terrain
+ */
+struct TerrainSettings {
+  /**
+   * @brief World seed; equal seeds and settings give equal terrain
+   */
+  uint32_t seed = 0;
+
+  /**
+   * @brief Surface height where the noise is zero
+   */
+  int base_height = 40;
+
+  /**
+   * @brief Largest surface offset from base_height, in blocks
+   */
+  float height_amplitude = 32.0f;
+
+  /**
+   * @brief Frequency of the first octave, in cycles per block
+   */
+  float frequency = 1.0f / 96.0f;
+
+  /**
+   * @brief Number of noise octaves summed
+   */
+  int octaves = 5;
+
+  /**
+   * @brief Frequency multiplier between octaves
+   */
+  float lacunarity = 2.0f;
+
+  /**
+   * @brief Amplitude multiplier between octaves
+   */
+  float gain = 0.5f;
+
+  /**
+   * @brief Dirt layers between the grass and the stone below
+   */
+  int dirt_depth = 3;
+};
+
+/**
+ * @brief Seedable fractal Perlin noise terrain
+ *
+ * Surface heights are evaluated four columns at a time with SSE2 or NEON
+ * (scalar fallback elsewhere). Every backend performs the same IEEE float
+ * operations in the same order and hashes lattice points with integer
+ * arithmetic only, so a given seed produces the same terrain on every run
+ * and every thread.
+ *
+ * The generator is immutable after construction and safe to share between
+ * threads.
+ */
+class TerrainGenerator {
+ public:
+  explicit TerrainGenerator(const TerrainSettings& settings = TerrainSettings());
+
+  /**
+   * @brief Compute the surface height of every column of a chunk
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param heights Receives SECTION_AREA heights, indexed z * 16 + x
+   */
+  void GenerateHeights(int chunk_x, int chunk_z, int* heights) const;
+
+  /**
+   * @brief Generate a chunk's blocks
+   *
+   * Sections are filled layer by layer into a dense buffer and encoded
+   * once; layers wholly below or above the surface are written as one run,
+   * and sections above the highest column stay unallocated.
+   *
+   * @param chunk_x Chunk X coordinate in chunk space
+   * @param chunk_z Chunk Z coordinate in chunk space
+   * @param storage Receives the blocks; previous contents are replaced
+   */
+  void Generate(int chunk_x, int chunk_z, ChunkStorage* storage) const;
+
+  /**
+   * @brief Get the surface height of one column
+   * @param world_x World X coordinate
+   * @param world_z World Z coordinate
+   * @return Height of the topmost solid block
+   */
+  int GetHeight(int world_x, int world_z) const;
+
+  /**
+   * @brief Get the settings the generator was built with
+   */
+  const TerrainSettings& GetSettings() const { return settings_; }
+
+  /**
+   * @brief Get the name of the compiled-in SIMD backend
+   * @return "sse2", "neon" or "scalar"
+   */
+  static const char* GetSimdBackend();
+
+ private:
+  /**
+   * @brief Compute the surface heights of four adjacent columns along X
+   */
+  void GenerateHeights4(int world_x, int world_z, int* heights) const;
+
+  TerrainSettings settings_;
+
+  // Reciprocal of the summed octave amplitudes, normalizing noise to [-1, 1]
+  float amplitude_scale_;
+};
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_TERRAIN_GENERATOR_H_
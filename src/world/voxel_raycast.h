@@ -0,0 +1,192 @@
+#ifndef SRC_WORLD_VOXEL_RAYCAST_H_
+#define SRC_WORLD_VOXEL_RAYCAST_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "block.h"
+
+namespace cppcraft {
+namespace world {
+
+// Default reach of block picking, in blocks
+constexpr float DEFAULT_PICK_DISTANCE = 8.0f;
+
+/**
+ * @brief Decides which blocks stop a ray
+ */
+using RaycastFilter = bool (*)(uint16_t block_id);
+
+/**
+ * @brief Stop at anything that can be targeted: every block but air and
+ *        liquids, plants included
+ */
+constexpr bool IsPickableBlock(uint16_t block_id) {
+  return block_id != AIR_BLOCK_ID && !IsLiquidBlock(block_id);
+}
+
+/**
+ * @brief Stop at blocks that cannot be seen through
+ */
+constexpr bool BlocksLineOfSight(uint16_t block_id) {
+  return !IsTransparentBlock(block_id);
+}
+
+/**
+ * @struct Ray
+ * @brief A ray in world space
+ */
+struct Ray {
+  glm::vec3 origin{0.0f};
+
+  /**
+   * @brief Direction; need not be normalized
+   */
+  glm::vec3 direction{0.0f, 0.0f, -1.0f};
+
+  /**
+   * @brief Distance along the normalized direction to give up at
+   */
+  float max_distance = DEFAULT_PICK_DISTANCE;
+};
+
+/**
+ * @struct RaycastHit
+ * @brief Result of a voxel raycast
+ */
+struct RaycastHit {
+  /**
+   * @brief Whether a block stopped the ray within its maximum distance
+   */
+  bool hit = false;
+
+  /**
+   * @brief World position and ID of the block hit
+   */
+  int block_x = 0;
+  int block_y = 0;
+  int block_z = 0;
+  uint16_t block_id = AIR_BLOCK_ID;
+
+  /**
+   * @brief Face of the block the ray entered through, as used by the mesher
+   *        (0 = +Z, 1 = -Z, 2 = -X, 3 = +X, 4 = -Y, 5 = +Y), or -1 when
+   *        the ray started inside the block
+   */
+  int face = -1;
+
+  /**
+   * @brief Distance from the origin to the entry point, in blocks
+   */
+  float distance = 0.0f;
+
+  /**
+   * @brief Cell in front of the face, where a placed block would go
+   */
+  int adjacent_x = 0;
+  int adjacent_y = 0;
+  int adjacent_z = 0;
+};
+
+/**
+ * @brief Walk the voxels a ray passes through (Amanatides & Woo)
+ *
+ * Visits cells in order along the ray, one axis step per cell, with no
+ * per-cell division or rounding. Cells above or below the world read as
+ * whatever the reader returns; the walk ends early once the ray has left
+ * the world's height range and is moving away from it.
+ *
+ * @param ray The ray
+ * @param filter Blocks that stop the ray
+ * @param height World height; cells outside [0, height) are never hits
+ * @param reader Object with `uint16_t Get(int x, int y, int z)`, called
+ *        once per visited cell inside the height range
+ * @return The first block accepted by the filter, if any
+ */
+template <typename Reader>
+RaycastHit TraceVoxels(const Ray& ray, RaycastFilter filter, int height,
+                       Reader& reader) {
+  RaycastHit result;
+  const float length = glm::length(ray.direction);
+  if (!(length > 0.0f) || !(ray.max_distance >= 0.0f)) {
+    return result;
+  }
+  const glm::vec3 direction = ray.direction / length;
+  const float infinity = std::numeric_limits<float>::infinity();
+
+  // Entry face when stepping along each axis in the positive and negative
+  // direction
+  static constexpr int ENTRY_FACE[3][2] = {{2, 3}, {4, 5}, {1, 0}};
+
+  int cell[3];
+  int step[3];
+  float t_max[3];
+  float t_delta[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    const float origin = ray.origin[axis];
+    const float d = direction[axis];
+    cell[axis] = static_cast<int>(std::floor(origin));
+    if (d > 0.0f) {
+      step[axis] = 1;
+      t_delta[axis] = 1.0f / d;
+      t_max[axis] = (static_cast<float>(cell[axis]) + 1.0f - origin) * t_delta[axis];
+    } else if (d < 0.0f) {
+      step[axis] = -1;
+      t_delta[axis] = -1.0f / d;
+      t_max[axis] = (origin - static_cast<float>(cell[axis])) * t_delta[axis];
+    } else {
+      step[axis] = 0;
+      t_delta[axis] = infinity;
+      t_max[axis] = infinity;
+    }
+  }
+
+  int face = -1;
+  int entered_axis = -1;
+  float t = 0.0f;
+  for (;;) {
+    if (cell[1] >= 0 && cell[1] < height) {
+      const uint16_t block_id = reader.Get(cell[0], cell[1], cell[2]);
+      if (filter(block_id)) {
+        result.hit = true;
+        result.block_x = cell[0];
+        result.block_y = cell[1];
+        result.block_z = cell[2];
+        result.block_id = block_id;
+        result.face = face;
+        result.distance = t;
+        result.adjacent_x = cell[0];
+        result.adjacent_y = cell[1];
+        result.adjacent_z = cell[2];
+        if (entered_axis >= 0) {
+          (&result.adjacent_x)[entered_axis] -= step[entered_axis];
+        }
+        return result;
+      }
+    } else if ((cell[1] < 0 && step[1] <= 0) || (cell[1] >= height && step[1] >= 0)) {
+      return result;
+    }
+
+    // Step into the neighbor whose boundary the ray reaches first
+    int axis = t_max[0] < t_max[1] ? 0 : 1;
+    if (t_max[2] < t_max[axis]) {
+      axis = 2;
+    }
+    t = t_max[axis];
+    if (t > ray.max_distance) {
+      return result;
+    }
+    cell[axis] += step[axis];
+    t_max[axis] += t_delta[axis];
+    face = ENTRY_FACE[axis][step[axis] > 0 ? 0 : 1];
+    entered_axis = axis;
+  }
+}
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_VOXEL_RAYCAST_H_
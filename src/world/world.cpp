@@ -0,0 +1,778 @@
+#include "world.h"
+#include "../core/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+// Chunks directly behind the viewer load as if they were this many times
+// farther away; chunks to the side fall in between
+const float STREAM_BEHIND_WEIGHT = 2.0f;
+
+// Requests are rebuilt once the view turns by more than about 25 degrees
+const float STREAM_REQUEST_TURN_COS = 0.9f;
+
+// Light jobs on the workers at once; each holds a 3x3 chunk snapshot
+const size_t MAX_LIGHT_JOBS_IN_FLIGHT = 4;
+
+// Chunks between a light job's center and the edge of its volume
+const int LIGHT_JOB_RADIUS = LIGHT_JOB_CHUNKS / 2;
+
+// Chunks a mesh must cross past a level-of-detail boundary before it
+// switches, so that moving along the boundary does not remesh every frame
+const float LOD_HYSTERESIS = 1.0f;
+
+// Level of detail for a distance in chunks: full detail within the radius,
+// then doubling the cell size each time the radius doubles
+int lodScaleAt(float distance, int lodRadius) {
+    int scale = 1;
+    float limit = static_cast<float>(lodRadius);
+    while (distance > limit && scale < MAX_LOD_SCALE) {
+        scale *= 2;
+        limit *= 2.0f;
+    }
+    return scale;
+}
+
+// Block reader for raycasts that keeps the chunk it last read from, so a ray
+// only looks a chunk up when it crosses into the next one
+class RaycastReader {
+public:
+    explicit RaycastReader(const ChunkMap& chunks)
+        : chunks(chunks), chunkX(0), chunkZ(0), chunk(nullptr), cached(false) {}
+
+    uint16_t Get(int x, int y, int z) {
+        int cx = World::worldToChunkCoord(x);
+        int cz = World::worldToChunkCoord(z);
+        if (!cached || cx != chunkX || cz != chunkZ) {
+            chunk = chunks.Find(cx, cz);
+            chunkX = cx;
+            chunkZ = cz;
+            cached = true;
+        }
+        if (!chunk) {
+            return AIR_BLOCK_ID;
+        }
+        return chunk->GetBlock(World::worldToLocalCoord(x), y, World::worldToLocalCoord(z));
+    }
+
+private:
+    const ChunkMap& chunks;
+    int chunkX;
+    int chunkZ;
+    const Chunk* chunk;
+    bool cached;
+};
+
+} // namespace
+
+// Constructor
+World::World(const TerrainSettings& terrainSettings)
+    : terrain(terrainSettings),
+      meshWorkers(std::make_unique<MeshWorkerPool>()),
+      meshUploadsPerFrame(DEFAULT_MESH_UPLOADS_PER_FRAME),
+      meshUploader(nullptr),
+      meshResidency(std::make_unique<MeshResidency>()),
+      hasViewer(false),
+      viewerPosition(0.0f),
+      viewerDirection(0.0f, 0.0f, -1.0f),
+      renderRadius(DEFAULT_RENDER_RADIUS),
+      unloadMargin(DEFAULT_UNLOAD_MARGIN),
+      lodRadius(DEFAULT_RENDER_RADIUS),
+      lodDirty(true),
+      lodCenterX(0),
+      lodCenterZ(0),
+      streamLoadsPerFrame(DEFAULT_STREAM_LOADS_PER_FRAME),
+      streamUnloadsPerFrame(DEFAULT_STREAM_UNLOADS_PER_FRAME),
+      streamRequestsDirty(true),
+      requestCenterX(0),
+      requestCenterZ(0),
+      requestDirection(0.0f),
+      blockChangeLog(nullptr) {}
+
+// Destructor
+World::~World() {
+    // Stop streaming workers before the chunks and regions they use go away
+    streamer.reset();
+    unloadAll();
+}
+
+// Move every section mesh to a new uploader's storage
+void World::setMeshUploader(MeshUploader* uploader) {
+    if (uploader == meshUploader) {
+        return;
+    }
+
+    // Meshes leave the storage of the uploader that holds them
+    chunks.ForEach([](Chunk& chunk) {
+        chunk.ReleaseMesh();
+        chunk.MarkMeshDirty();
+    });
+    meshUploader = uploader;
+}
+
+// Get or create a chunk
+Chunk* World::getChunk(int chunkX, int chunkZ) {
+    if (Chunk* chunk = chunks.Find(chunkX, chunkZ)) {
+        return chunk;
+    }
+    return loadChunk(chunkX, chunkZ);
+}
+
+// Get a chunk without loading it
+Chunk* World::findChunk(int chunkX, int chunkZ) const {
+    return chunks.Find(chunkX, chunkZ);
+}
+
+// Check if a chunk exists
+bool World::hasChunk(int chunkX, int chunkZ) const {
+    return chunks.Contains(chunkX, chunkZ);
+}
+
+// Load (generate) a chunk
+Chunk* World::loadChunk(int chunkX, int chunkZ) {
+    if (Chunk* chunk = chunks.Find(chunkX, chunkZ)) {
+        return chunk;
+    }
+
+    return addChunk(chunkX, chunkZ, createChunk(chunkX, chunkZ));
+}
+
+// Unload a chunk
+bool World::unloadChunk(int chunkX, int chunkZ) {
+    Chunk* chunk = chunks.Find(chunkX, chunkZ);
+    if (!chunk) {
+        return false;
+    }
+
+    saveChunk(*chunk);
+    cancelLightJobs(chunkX, chunkZ);
+    meshResidency->Forget(chunkX, chunkZ);
+    chunks.Remove(chunkX, chunkZ);
+
+    // Re-request it if it is still within the render radius
+    streamRequestsDirty = true;
+    lodDirty = true;
+
+    // Neighbor faces on the shared edge are exposed again
+    markNeighborsDirty(chunkX, chunkZ);
+    return true;
+}
+
+// Get a block at world coordinates
+uint16_t World::getBlock(int x, int y, int z) const {
+    // Above and below the world, like unloaded chunks, is air
+    if (y < 0 || y >= CHUNK_SIZE_Y) {
+        return AIR_BLOCK_ID;
+    }
+
+    // Consecutive lookups in one chunk hit the chunk map's cache
+    const Chunk* chunk = chunks.Find(worldToChunkCoord(x), worldToChunkCoord(z));
+    if (!chunk) {
+        return AIR_BLOCK_ID;
+    }
+    return chunk->GetBlock(worldToLocalCoord(x), y, worldToLocalCoord(z));
+}
+
+// Cast a ray through the loaded blocks
+RaycastHit World::raycast(const glm::vec3& origin, const glm::vec3& direction,
+                          float maxDistance, RaycastFilter filter) const {
+    Ray ray;
+    ray.origin = origin;
+    ray.direction = direction;
+    ray.max_distance = maxDistance;
+    RaycastReader reader(chunks);
+    return TraceVoxels(ray, filter, CHUNK_SIZE_Y, reader);
+}
+
+// Cast many rays, sharing one chunk cache between them
+void World::raycastBatch(const Ray* rays, size_t count, RaycastHit* hits,
+                         RaycastFilter filter) const {
+    PROFILE_SCOPE("world.raycast_batch");
+    RaycastReader reader(chunks);
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = TraceVoxels(rays[i], filter, CHUNK_SIZE_Y, reader);
+    }
+}
+
+// Check whether the segment between two points is free of opaque blocks
+bool World::hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const {
+    Ray ray;
+    ray.origin = from;
+    ray.direction = to - from;
+    ray.max_distance = glm::length(ray.direction);
+    if (ray.max_distance == 0.0f) {
+        return !BlocksLineOfSight(getBlock(static_cast<int>(std::floor(from.x)),
+                                           static_cast<int>(std::floor(from.y)),
+                                           static_cast<int>(std::floor(from.z))));
+    }
+    RaycastReader reader(chunks);
+    return !TraceVoxels(ray, BlocksLineOfSight, CHUNK_SIZE_Y, reader).hit;
+}
+
+// Set a block at world coordinates
+void World::setBlock(int x, int y, int z, uint16_t blockID) {
+    if (y < 0 || y >= CHUNK_SIZE_Y) {
+        return;
+    }
+
+    int chunkX = worldToChunkCoord(x);
+    int chunkZ = worldToChunkCoord(z);
+    int localX = worldToLocalCoord(x);
+    int localZ = worldToLocalCoord(z);
+
+    Chunk* chunk = getChunk(chunkX, chunkZ);
+    if (!chunk->SetBlock(localX, y, localZ, blockID)) {
+        return;
+    }
+    if (blockChangeLog) {
+        blockChangeLog->Record(chunkX, chunkZ, localX, y, localZ);
+    }
+
+    LightEdit edit = { x, y, z };
+    queueLightUpdate(chunkX, chunkZ, &edit, false);
+
+    // The neighbor's mesh culls its edge faces against this block
+    int section = y / SECTION_SIZE;
+    Chunk* neighbor = nullptr;
+    if (localX == 0 && (neighbor = findChunk(chunkX - 1, chunkZ))) {
+        neighbor->MarkSectionMeshDirty(section);
+    } else if (localX == CHUNK_SIZE_X - 1 && (neighbor = findChunk(chunkX + 1, chunkZ))) {
+        neighbor->MarkSectionMeshDirty(section);
+    }
+    if (localZ == 0 && (neighbor = findChunk(chunkX, chunkZ - 1))) {
+        neighbor->MarkSectionMeshDirty(section);
+    } else if (localZ == CHUNK_SIZE_Z - 1 && (neighbor = findChunk(chunkX, chunkZ + 1))) {
+        neighbor->MarkSectionMeshDirty(section);
+    }
+}
+
+// Spread a bulk edit of a loaded chunk beyond the chunk itself
+void World::chunkBlocksReplaced(int chunkX, int chunkZ) {
+    // Jobs in flight would store light computed from the old blocks
+    cancelLightJobs(chunkX, chunkZ);
+    queueLightUpdate(chunkX, chunkZ, nullptr, true);
+
+    // The neighbors' edge faces were culled against the old blocks
+    markNeighborsDirty(chunkX, chunkZ);
+
+    // Any section may have changed, including ones that are now empty
+    if (blockChangeLog) {
+        for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+            blockChangeLog->RecordSection(chunkX, chunkZ, section);
+        }
+    }
+}
+
+// Update all chunks and upload finished meshes
+void World::update(float deltaTime) {
+    (void)deltaTime;
+    PROFILE_SCOPE("world.update");
+
+    if (hasViewer) {
+        PROFILE_SCOPE("world.streaming");
+        updateStreaming();
+        updateLod();
+    }
+
+    {
+        PROFILE_SCOPE("world.light");
+        applyFinishedLight();
+        scheduleLightJobs();
+    }
+
+    // Chunks whose light is about to change are meshed once it has
+    {
+        PROFILE_SCOPE("mesh.schedule");
+        chunks.ForEach([this](Chunk& chunk) {
+            if (!isLightBusy(chunk.GetChunkX(), chunk.GetChunkZ())) {
+                chunk.Update();
+            }
+        });
+    }
+
+    {
+        PROFILE_SCOPE("mesh.upload");
+        meshWorkers->UploadFinished(meshUploadsPerFrame);
+    }
+
+    // Chunks the renderer saw since the last update are remeshed on the next
+    // one if they were evicted; meshes unseen for longest go if over budget
+    PROFILE_SCOPE("mesh.residency");
+    meshResidency->Update(&chunks);
+}
+
+// Set the viewer that chunk streaming follows
+void World::setViewer(const glm::vec3& position, const glm::vec3& direction) {
+    viewerPosition = position;
+    viewerDirection = direction;
+
+    if (!hasViewer) {
+        hasViewer = true;
+        streamRequestsDirty = true;
+        streamer = std::make_unique<ChunkStreamer>(
+            [this](int chunkX, int chunkZ) { return createChunk(chunkX, chunkZ); });
+    }
+}
+
+// Set the render radius in chunks
+void World::setRenderRadius(int radius) {
+    radius = std::max(0, radius);
+    if (renderRadius != radius) {
+        renderRadius = radius;
+        streamRequestsDirty = true;
+    }
+}
+
+// Set the distance at which chunks start being meshed at lower detail
+void World::setLodRadius(int radius) {
+    radius = std::max(0, radius);
+    if (lodRadius != radius) {
+        lodRadius = radius;
+        lodDirty = true;
+    }
+}
+
+// Set the hysteresis band in chunks
+void World::setUnloadMargin(int margin) {
+    unloadMargin = std::max(0, margin);
+}
+
+// Set the per-frame streaming budgets
+void World::setStreamingBudgets(size_t loadsPerFrame, size_t unloadsPerFrame) {
+    streamLoadsPerFrame = loadsPerFrame;
+    streamUnloadsPerFrame = unloadsPerFrame;
+}
+
+// Get streaming queue depths and last-update throughput
+StreamingStats World::getStreamingStats() const {
+    StreamingStats stats = streamingStats;
+    if (streamer) {
+        stats.queued = streamer->GetQueuedCount();
+        stats.in_progress = streamer->GetInProgressCount();
+        stats.ready = streamer->GetFinishedCount();
+    }
+    return stats;
+}
+
+// Get number of loaded chunks
+size_t World::getLoadedChunkCount() const {
+    return chunks.Size();
+}
+
+// Unload all chunks
+void World::unloadAll() {
+    saveDirtyChunks();
+
+    // Light results would have nowhere to go
+    for (const std::shared_ptr<LightJob>& job : lightJobs) {
+        job->cancelled.store(true, std::memory_order_release);
+    }
+    lightJobs.clear();
+    pendingLight.clear();
+
+    chunks.ForEach([this](Chunk& chunk) {
+        meshResidency->Forget(chunk.GetChunkX(), chunk.GetChunkZ());
+    });
+    chunks.Clear();
+}
+
+// Save chunks to region files in a directory
+bool World::setSaveDirectory(const std::string& path) {
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error) {
+        std::cerr << "Failed to create save directory " << path << ": "
+                  << error.message() << std::endl;
+        return false;
+    }
+
+    regions = std::make_unique<RegionStore>(path);
+    return true;
+}
+
+// Save every chunk with unsaved edits
+size_t World::saveDirtyChunks() {
+    size_t saved = 0;
+    chunks.ForEach([&](Chunk& chunk) {
+        if (saveChunk(chunk)) {
+            ++saved;
+        }
+    });
+    return saved;
+}
+
+// Convert world coordinate to chunk coordinate (floor division)
+int World::worldToChunkCoord(int worldCoord) {
+    return worldCoord >= 0 ? worldCoord / CHUNK_SIZE_X
+                           : (worldCoord - (CHUNK_SIZE_X - 1)) / CHUNK_SIZE_X;
+}
+
+// Convert world coordinate to local chunk coordinate
+int World::worldToLocalCoord(int worldCoord) {
+    int local = worldCoord % CHUNK_SIZE_X;
+    return local < 0 ? local + CHUNK_SIZE_X : local;
+}
+
+// Remesh the loaded neighbors of a chunk
+void World::markNeighborsDirty(int chunkX, int chunkZ) {
+    static const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+    for (const auto& offset : offsets) {
+        if (Chunk* neighbor = findChunk(chunkX + offset[0], chunkZ + offset[1])) {
+            neighbor->MarkMeshDirty();
+        }
+    }
+}
+
+// Read a chunk from disk or generate it (any thread)
+std::unique_ptr<Chunk> World::createChunk(int chunkX, int chunkZ) {
+    auto chunk = std::make_unique<Chunk>(chunkX, chunkZ, this);
+
+    ChunkStorage saved;
+    if (regions && regions->LoadChunk(chunkX, chunkZ, &saved)) {
+        PROFILE_SCOPE("chunk.load");
+        chunk->SetStorage(std::move(saved));
+    } else {
+        // Generated terrain is reproducible; only edits need saving
+        PROFILE_SCOPE("chunk.generate");
+        chunk->Generate();
+        chunk->MarkClean();
+    }
+    return chunk;
+}
+
+// Add a chunk to the world
+Chunk* World::addChunk(int chunkX, int chunkZ, std::unique_ptr<Chunk> chunk) {
+    Chunk* result = chunks.Insert(chunkX, chunkZ, std::move(chunk));
+    result->SetAddedToWorld(true);
+
+    // Neighbors emitted walls along the edge while this chunk was missing
+    markNeighborsDirty(chunkX, chunkZ);
+    lodDirty = true;
+
+    // Light only flowed within the chunk so far
+    queueLightUpdate(chunkX, chunkZ, nullptr, true);
+    return result;
+}
+
+// Add finished streamed chunks and unload distant ones
+void World::updateStreaming() {
+    int centerX = worldToChunkCoord(static_cast<int>(std::floor(viewerPosition.x)));
+    int centerZ = worldToChunkCoord(static_cast<int>(std::floor(viewerPosition.z)));
+
+    glm::vec2 direction(viewerDirection.x, viewerDirection.z);
+    float length = glm::length(direction);
+    direction = length > 0.0f ? direction / length : glm::vec2(0.0f);
+
+    if (streamRequestsDirty || centerX != requestCenterX || centerZ != requestCenterZ ||
+        glm::dot(direction, requestDirection) < STREAM_REQUEST_TURN_COS) {
+        requestCenterX = centerX;
+        requestCenterZ = centerZ;
+        requestDirection = direction;
+        streamRequestsDirty = false;
+        requestMissingChunks(centerX, centerZ);
+    }
+
+    // Add finished chunks, dropping any that were loaded synchronously or
+    // left the unload radius meanwhile
+    std::vector<StreamedChunk> ready;
+    streamer->TakeFinished(streamLoadsPerFrame, &ready);
+
+    size_t loaded = 0;
+    for (StreamedChunk& entry : ready) {
+        if (hasChunk(entry.chunk_x, entry.chunk_z) ||
+            isBeyondUnloadRadius(entry.chunk_x, entry.chunk_z, centerX, centerZ)) {
+            continue;
+        }
+        addChunk(entry.chunk_x, entry.chunk_z, std::move(entry.chunk));
+        ++loaded;
+    }
+
+    streamingStats.loaded_last_update = loaded;
+    streamingStats.unloaded_last_update = unloadDistantChunks(centerX, centerZ);
+}
+
+// Pick each chunk's level of detail from its distance to the viewer
+// Skirts are needed wherever a mesh meets one at another scale, and by
+// every reduced mesh, whose surface no longer matches its neighbors' blocks.
+void World::updateLod() {
+    int centerX = worldToChunkCoord(static_cast<int>(std::floor(viewerPosition.x)));
+    int centerZ = worldToChunkCoord(static_cast<int>(std::floor(viewerPosition.z)));
+    if (!lodDirty && centerX == lodCenterX && centerZ == lodCenterZ) {
+        return;
+    }
+    lodDirty = false;
+    lodCenterX = centerX;
+    lodCenterZ = centerZ;
+
+    lodScales.clear();
+    chunks.ForEach([&](Chunk& chunk) {
+        int scale = 1;
+        if (lodRadius > 0) {
+            float dx = static_cast<float>(chunk.GetChunkX() - centerX);
+            float dz = static_cast<float>(chunk.GetChunkZ() - centerZ);
+            float distance = std::sqrt(dx * dx + dz * dz);
+            int current = chunk.GetMeshLod();
+
+            scale = lodScaleAt(distance, lodRadius);
+            if (scale > current) {
+                scale = std::max(current, lodScaleAt(distance - LOD_HYSTERESIS, lodRadius));
+            } else if (scale < current) {
+                scale = std::min(current, lodScaleAt(distance + LOD_HYSTERESIS, lodRadius));
+            }
+        }
+        lodScales[lightKey(chunk.GetChunkX(), chunk.GetChunkZ())] = scale;
+    });
+
+    const int offsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    chunks.ForEach([&](Chunk& chunk) {
+        int chunkX = chunk.GetChunkX();
+        int chunkZ = chunk.GetChunkZ();
+        int scale = lodScales[lightKey(chunkX, chunkZ)];
+
+        bool skirts = scale > 1;
+        for (const auto& offset : offsets) {
+            auto neighbor = lodScales.find(lightKey(chunkX + offset[0], chunkZ + offset[1]));
+            if (neighbor != lodScales.end() && neighbor->second != scale) {
+                skirts = true;
+            }
+        }
+        chunk.SetMeshLod(scale, skirts);
+    });
+}
+
+// Queue every missing chunk within the render radius
+void World::requestMissingChunks(int centerX, int centerZ) {
+    std::vector<ChunkRequest> requests;
+
+    for (int dz = -renderRadius; dz <= renderRadius; ++dz) {
+        for (int dx = -renderRadius; dx <= renderRadius; ++dx) {
+            int distanceSq = dx * dx + dz * dz;
+            if (distanceSq > renderRadius * renderRadius ||
+                hasChunk(centerX + dx, centerZ + dz)) {
+                continue;
+            }
+
+            // Nearest first, with chunks in front of the viewer ahead of
+            // those behind it at the same distance
+            float distance = std::sqrt(static_cast<float>(distanceSq));
+            float facing = distance > 0.0f
+                ? glm::dot(requestDirection, glm::vec2(dx, dz) / distance)
+                : 1.0f;
+            float weight = 1.0f + (STREAM_BEHIND_WEIGHT - 1.0f) * (1.0f - facing) * 0.5f;
+
+            ChunkRequest request;
+            request.chunk_x = centerX + dx;
+            request.chunk_z = centerZ + dz;
+            request.priority = distance * weight;
+            requests.push_back(request);
+        }
+    }
+
+    streamer->SetRequests(requests);
+}
+
+// Unload the farthest chunks beyond the unload radius
+size_t World::unloadDistantChunks(int centerX, int centerZ) {
+    std::vector<std::pair<int, std::pair<int, int>>> distant;
+    chunks.ForEach([&](const Chunk& chunk) {
+        int chunkX = chunk.GetChunkX();
+        int chunkZ = chunk.GetChunkZ();
+        // Chunks a light job is working on wait for its result
+        if (isBeyondUnloadRadius(chunkX, chunkZ, centerX, centerZ) &&
+            !isLightBusy(chunkX, chunkZ)) {
+            int dx = chunkX - centerX;
+            int dz = chunkZ - centerZ;
+            distant.push_back({ dx * dx + dz * dz, { chunkX, chunkZ } });
+        }
+    });
+
+    size_t count = std::min(streamUnloadsPerFrame, distant.size());
+    std::partial_sort(distant.begin(), distant.begin() + count, distant.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (size_t i = 0; i < count; ++i) {
+        unloadChunk(distant[i].second.first, distant[i].second.second);
+    }
+
+    streamingStats.pending_unloads = distant.size() - count;
+    return count;
+}
+
+// Check if a chunk lies beyond the unload radius
+bool World::isBeyondUnloadRadius(int chunkX, int chunkZ, int centerX, int centerZ) const {
+    int dx = chunkX - centerX;
+    int dz = chunkZ - centerZ;
+    int limit = renderRadius + unloadMargin;
+    return dx * dx + dz * dz > limit * limit;
+}
+
+// Queue a light update for a chunk, merging it with any already pending
+void World::queueLightUpdate(int chunkX, int chunkZ, const LightEdit* edit, bool seam) {
+    auto inserted = pendingLight.emplace(lightKey(chunkX, chunkZ),
+                                         PendingLightUpdate{ chunkX, chunkZ, false, {} });
+    PendingLightUpdate& update = inserted.first->second;
+    update.seam = update.seam || seam;
+    if (edit) {
+        update.edits.push_back(*edit);
+    }
+}
+
+// Copy finished light jobs back to their chunks
+void World::applyFinishedLight() {
+    std::vector<std::shared_ptr<LightJob>> finished;
+    meshWorkers->TakeFinishedLight(&finished);
+
+    for (const std::shared_ptr<LightJob>& job : finished) {
+        // Cancelled jobs were already removed and their updates requeued
+        if (job->cancelled.load(std::memory_order_acquire)) {
+            continue;
+        }
+        lightJobs.erase(std::find(lightJobs.begin(), lightJobs.end(), job));
+
+        const LightVolume& volume = job->volume;
+        for (int slot = 0; slot < volume.chunks_x * volume.chunks_z; ++slot) {
+            Chunk* chunk = findChunk(volume.origin_chunk_x + slot % volume.chunks_x,
+                                     volume.origin_chunk_z + slot / volume.chunks_x);
+            if (!chunk) {
+                continue;
+            }
+
+            // Chunks added after the snapshot keep their own light, but
+            // their edges may still face changed cells
+            if (volume.loaded[slot]) {
+                volume.StoreChunk(slot, chunk->GetMutableLight());
+            }
+            for (int section = 0; section < SECTIONS_PER_CHUNK; ++section) {
+                if (volume.remesh_sections[slot] & (1u << section)) {
+                    chunk->MarkSectionMeshDirty(section);
+                }
+            }
+        }
+    }
+}
+
+// Snapshot the chunks around each pending update and hand it to the workers
+// An update waits while a job in flight shares any chunk with its volume,
+// so results never overwrite each other.
+void World::scheduleLightJobs() {
+    for (auto it = pendingLight.begin();
+         it != pendingLight.end() && lightJobs.size() < MAX_LIGHT_JOBS_IN_FLIGHT;) {
+        PendingLightUpdate& update = it->second;
+
+        // Nothing to light once the chunk is gone
+        if (!findChunk(update.chunkX, update.chunkZ)) {
+            it = pendingLight.erase(it);
+            continue;
+        }
+
+        bool overlaps = std::any_of(
+            lightJobs.begin(), lightJobs.end(), [&update](const std::shared_ptr<LightJob>& job) {
+                return std::abs(job->chunk_x - update.chunkX) < LIGHT_JOB_CHUNKS &&
+                       std::abs(job->chunk_z - update.chunkZ) < LIGHT_JOB_CHUNKS;
+            });
+        if (overlaps) {
+            ++it;
+            continue;
+        }
+
+        auto job = std::make_shared<LightJob>();
+        job->chunk_x = update.chunkX;
+        job->chunk_z = update.chunkZ;
+        job->seam = update.seam;
+        job->edits = std::move(update.edits);
+
+        // The outermost column is read-only: light never changes 16 blocks
+        // away from the center chunk
+        LightVolume& volume = job->volume;
+        volume.Reset(update.chunkX - LIGHT_JOB_RADIUS, update.chunkZ - LIGHT_JOB_RADIUS,
+                     LIGHT_JOB_CHUNKS, LIGHT_JOB_CHUNKS, 1);
+        for (int dz = -LIGHT_JOB_RADIUS; dz <= LIGHT_JOB_RADIUS; ++dz) {
+            for (int dx = -LIGHT_JOB_RADIUS; dx <= LIGHT_JOB_RADIUS; ++dx) {
+                int chunkX = update.chunkX + dx;
+                int chunkZ = update.chunkZ + dz;
+                if (const Chunk* chunk = findChunk(chunkX, chunkZ)) {
+                    volume.LoadChunk(volume.GetSlot(chunkX, chunkZ), chunk->GetStorage(),
+                                     chunk->GetLight());
+                }
+            }
+        }
+
+        lightJobs.push_back(job);
+        meshWorkers->SubmitLight(std::move(job));
+        it = pendingLight.erase(it);
+    }
+}
+
+// Check if a chunk waits for a light job
+bool World::isLightBusy(int chunkX, int chunkZ) const {
+    auto pending = pendingLight.find(lightKey(chunkX, chunkZ));
+    if (pending != pendingLight.end() && pending->second.seam) {
+        return true;
+    }
+
+    for (const std::shared_ptr<LightJob>& job : lightJobs) {
+        if (std::abs(job->chunk_x - chunkX) <= LIGHT_JOB_RADIUS &&
+            std::abs(job->chunk_z - chunkZ) <= LIGHT_JOB_RADIUS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cancel the jobs covering a chunk that is about to be unloaded
+// Their results would be missing the chunk, so the updates start over.
+void World::cancelLightJobs(int chunkX, int chunkZ) {
+    for (auto it = lightJobs.begin(); it != lightJobs.end();) {
+        LightJob& job = **it;
+        if (std::abs(job.chunk_x - chunkX) > LIGHT_JOB_RADIUS ||
+            std::abs(job.chunk_z - chunkZ) > LIGHT_JOB_RADIUS) {
+            ++it;
+            continue;
+        }
+
+        job.cancelled.store(true, std::memory_order_release);
+        for (const LightEdit& edit : job.edits) {
+            queueLightUpdate(job.chunk_x, job.chunk_z, &edit, false);
+        }
+        if (job.seam) {
+            queueLightUpdate(job.chunk_x, job.chunk_z, nullptr, true);
+        }
+        it = lightJobs.erase(it);
+    }
+}
+
+// Pack chunk coordinates like the chunk map does
+uint64_t World::lightKey(int chunkX, int chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) |
+           static_cast<uint32_t>(chunkZ);
+}
+
+// Write one chunk if it has unsaved edits
+bool World::saveChunk(Chunk& chunk) {
+    if (!regions || !chunk.IsDirty()) {
+        return false;
+    }
+
+    if (!regions->SaveChunk(chunk.GetChunkX(), chunk.GetChunkZ(), chunk.GetStorage())) {
+        std::cerr << "Failed to save chunk " << chunk.GetChunkX() << ", "
+                  << chunk.GetChunkZ() << std::endl;
+        return false;
+    }
+
+    chunk.MarkClean();
+    return true;
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -1,10 +1,24 @@
 #ifndef CPPCRAFT_WORLD_H
 #define CPPCRAFT_WORLD_H
 
-#include <unordered_map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
+#include "block_change_log.h"
 #include "chunk.h"
+#include "chunk_map.h"
+#include "chunk_streamer.h"
+#include "light_engine.h"
+#include "mesh_residency.h"
+#include "mesh_uploader.h"
+#include "mesh_worker_pool.h"
+#include "region_file.h"
+#include "terrain_generator.h"
+#include "voxel_raycast.h"
+
+class ChunkBuffer;
 
 namespace cppcraft {
 namespace world {
@@ -18,13 +32,17 @@ namespace world {
  * - Managing chunk positions and data
  * - Providing access to blocks across chunk boundaries
  * - Updating chunks and their states
+ * - Saving edited chunks to region files, when a save directory is set
+ * - Streaming chunks in and out around the viewer, once one is set
+ * - Keeping sky and block light up to date as blocks change
  */
 class World {
 public:
     /**
      * @brief Constructor for World
+     * @param terrainSettings Seed and shape of the generated terrain
      */
-    World();
+    explicit World(const TerrainSettings& terrainSettings = TerrainSettings());
 
     /**
      * @brief Destructor for World
@@ -39,6 +57,14 @@ public:
      */
     Chunk* getChunk(int chunkX, int chunkZ);
 
+    /**
+     * @brief Get a chunk only if it is already loaded
+     * @param chunkX The X coordinate of the chunk
+     * @param chunkZ The Z coordinate of the chunk
+     * @return Pointer to the chunk, or nullptr if it is not loaded
+     */
+    Chunk* findChunk(int chunkX, int chunkZ) const;
+
     /**
      * @brief Check if a chunk exists at the specified coordinates
      * @param chunkX The X coordinate of the chunk
@@ -49,6 +75,10 @@ public:
 
     /**
      * @brief Load a chunk at the specified coordinates
+     *
+     * Chunks found in the save directory are read from disk; all others are
+     * generated.
+     *
      * @param chunkX The X coordinate of the chunk
      * @param chunkZ The Z coordinate of the chunk
      * @return Pointer to the loaded chunk
@@ -57,6 +87,9 @@ public:
 
     /**
      * @brief Unload a chunk at the specified coordinates
+     *
+     * A chunk with unsaved edits is saved first.
+     *
      * @param chunkX The X coordinate of the chunk
      * @param chunkZ The Z coordinate of the chunk
      * @return True if chunk was unloaded, false if it didn't exist
@@ -68,12 +101,60 @@ public:
      * @param x The world X coordinate
      * @param y The world Y coordinate
      * @param z The world Z coordinate
-     * @return The block ID at the specified location
+     * @return The block ID at the specified location; air outside loaded
+     *         chunks and outside the world's height
      */
     uint16_t getBlock(int x, int y, int z) const;
 
+    /**
+     * @brief Find the first block along a ray
+     *
+     * Steps from voxel to voxel (Amanatides & Woo), so the cost grows with
+     * the distance covered and not with the number of blocks tested, and the
+     * chunk is only looked up again when the ray crosses into a new one.
+     * Unloaded chunks read as air. Main thread only, like getBlock().
+     *
+     * @param origin Start of the ray in world coordinates
+     * @param direction Direction of the ray; need not be normalized
+     * @param maxDistance Distance to give up at, in blocks
+     * @param filter Blocks that stop the ray; by default everything but air
+     *        and liquids, which is what the player can target
+     * @return The block hit, the face it was entered through and the
+     *         distance to it; hit is false if nothing was found
+     */
+    RaycastHit raycast(const glm::vec3& origin, const glm::vec3& direction,
+                       float maxDistance = DEFAULT_PICK_DISTANCE,
+                       RaycastFilter filter = IsPickableBlock) const;
+
+    /**
+     * @brief Cast many rays at once
+     *
+     * For AI sight checks, audio occlusion and the like. Rays share one chunk
+     * cache, so rays cast from the same area rarely look up a chunk at all.
+     *
+     * @param rays The rays
+     * @param count Number of rays
+     * @param hits Receives one result per ray
+     * @param filter Blocks that stop the rays; by default opaque blocks
+     */
+    void raycastBatch(const Ray* rays, size_t count, RaycastHit* hits,
+                      RaycastFilter filter = BlocksLineOfSight) const;
+
+    /**
+     * @brief Check whether no opaque block lies between two points
+     * @param from Start point in world coordinates
+     * @param to End point in world coordinates
+     * @return True if the segment is clear
+     */
+    bool hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const;
+
     /**
      * @brief Set a block at world coordinates
+     *
+     * Blocks on a chunk's X/Z edge also remesh the facing section of the
+     * neighboring chunk. Light around the block is updated in the
+     * background; the affected sections are remeshed once it is done.
+     *
      * @param x The world X coordinate
      * @param y The world Y coordinate
      * @param z The world Z coordinate
@@ -81,12 +162,181 @@ public:
      */
     void setBlock(int x, int y, int z, uint16_t blockID);
 
+    /**
+     * @brief Handle a loaded chunk whose blocks were replaced in bulk
+     *
+     * Called by Chunk::Fill(), SetBlockData() and SetStorage(), which have
+     * already recomputed the chunk's own light. Light jobs using the old
+     * blocks are cancelled, light is reseeded across the chunk's edges like
+     * for a newly added chunk, the neighbors are remeshed, and every section
+     * is recorded in the block change log.
+     *
+     * @param chunkX The X coordinate of the chunk
+     * @param chunkZ The Z coordinate of the chunk
+     */
+    void chunkBlocksReplaced(int chunkX, int chunkZ);
+
+    /**
+     * @brief Record the position of every block setBlock() and bulk chunk
+     *        edits change
+     * @param log The log, e.g. of the replication server, or null to stop
+     *        recording; must outlive the world or be reset first
+     */
+    void setBlockChangeLog(BlockChangeLog* log) { blockChangeLog = log; }
+
     /**
      * @brief Update all loaded chunks
+     *
+     * With a viewer set, finished streamed chunks are added and distant
+     * chunks removed first, within the per-frame streaming budgets. Finished
+     * light updates are copied back and new ones started. Dirty chunks that
+     * are not waiting for light queue their mesh builds on the mesh worker
+     * pool, then up to getMeshUploadsPerFrame() finished meshes are uploaded
+     * to the GPU, and meshes are evicted or restored to stay within the mesh
+     * memory budget.
+     * Must be called on the thread that owns the GL context.
+     *
      * @param deltaTime The time elapsed since last update in seconds
      */
     void update(float deltaTime);
 
+    /**
+     * @brief Get the generator used for chunks that are not on disk
+     * @return The terrain generator (safe to use from any thread)
+     */
+    const TerrainGenerator& getTerrainGenerator() const { return terrain; }
+
+    /**
+     * @brief Get the pool that builds chunk meshes in the background
+     * @return Pointer to the mesh worker pool
+     */
+    MeshWorkerPool* getMeshWorkerPool() { return meshWorkers.get(); }
+
+    /**
+     * @brief Set where built section meshes are stored for drawing
+     *
+     * The graphics module's SectionMeshUploader keeps them in per-section
+     * VAOs or in one shared ChunkBuffer. All loaded meshes are released from
+     * the previous uploader and rebuilt for the new one. Without an uploader
+     * meshes are built but never leave the CPU.
+     *
+     * @param uploader The uploader, or null; must outlive the world or be
+     *        reset first
+     */
+    void setMeshUploader(MeshUploader* uploader);
+
+    /**
+     * @brief Get where built section meshes are stored
+     * @return The uploader, or nullptr if there is none
+     */
+    MeshUploader* getMeshUploader() const { return meshUploader; }
+
+    /**
+     * @brief Get the shared chunk mesh buffer
+     * @return Pointer to the buffer, or nullptr if sections own their buffers
+     */
+    ChunkBuffer* getChunkBuffer() const {
+        return meshUploader ? meshUploader->GetSharedBuffer() : nullptr;
+    }
+
+    /**
+     * @brief Set how many finished meshes are uploaded per update
+     * @param count Maximum number of mesh uploads per frame
+     */
+    void setMeshUploadsPerFrame(size_t count) { meshUploadsPerFrame = count; }
+
+    /**
+     * @brief Set the GPU memory chunk meshes may use
+     *
+     * Past the budget, the meshes of the chunks out of view for longest are
+     * released; their blocks stay loaded and they are remeshed once seen
+     * again. See MeshResidency.
+     *
+     * @param bytes Budget in bytes; 0 never evicts
+     */
+    void setMeshMemoryBudget(size_t bytes) { meshResidency->SetBudget(bytes); }
+
+    /**
+     * @brief Get the GPU memory budget of chunk meshes, in bytes
+     */
+    size_t getMeshMemoryBudget() const { return meshResidency->GetBudget(); }
+
+    /**
+     * @brief Get the mesh residency manager the renderer reports seen chunks to
+     */
+    MeshResidency* getMeshResidency() const { return meshResidency.get(); }
+
+    /**
+     * @brief Get how many finished meshes are uploaded per update
+     * @return Maximum number of mesh uploads per frame
+     */
+    size_t getMeshUploadsPerFrame() const { return meshUploadsPerFrame; }
+
+    /**
+     * @brief Set the viewer that chunk streaming follows
+     *
+     * The first call starts streaming: from then on update() loads chunks
+     * within the render radius on background threads, the nearest and the
+     * ones in front of the viewer first, and unloads chunks beyond the render
+     * radius plus the unload margin. Call setSaveDirectory() before this.
+     *
+     * @param position The camera position in world space
+     * @param direction The camera view direction
+     */
+    void setViewer(const glm::vec3& position, const glm::vec3& direction);
+
+    /**
+     * @brief Set the radius, in chunks, kept loaded around the viewer
+     * @param radius The render radius in chunks
+     */
+    void setRenderRadius(int radius);
+
+    /**
+     * @brief Get the radius, in chunks, kept loaded around the viewer
+     * @return The render radius in chunks
+     */
+    int getRenderRadius() const { return renderRadius; }
+
+    /**
+     * @brief Set the distance, in chunks, up to which meshes keep full detail
+     *
+     * Farther chunks are meshed from downsampled blocks: 2x2x2 blocks per
+     * cell up to twice the radius, 4x4x4 up to four times, 8x8x8 beyond.
+     * A radius of half the render radius roughly halves the triangle count.
+     *
+     * @param radius The full-detail radius in chunks, or 0 to disable LOD
+     */
+    void setLodRadius(int radius);
+
+    /**
+     * @brief Get the distance, in chunks, up to which meshes keep full detail
+     * @return The full-detail radius in chunks, 0 if LOD is disabled
+     */
+    int getLodRadius() const { return lodRadius; }
+
+    /**
+     * @brief Set how far past the render radius chunks stay loaded
+     *
+     * The band keeps chunks from loading and unloading repeatedly while the
+     * viewer moves back and forth across a chunk border.
+     *
+     * @param margin The hysteresis band in chunks
+     */
+    void setUnloadMargin(int margin);
+
+    /**
+     * @brief Set how many streamed chunks are added and removed per update
+     * @param loadsPerFrame Maximum number of chunks added per frame
+     * @param unloadsPerFrame Maximum number of chunks unloaded per frame
+     */
+    void setStreamingBudgets(size_t loadsPerFrame, size_t unloadsPerFrame);
+
+    /**
+     * @brief Get streaming queue depths and last-update throughput
+     * @return The streaming statistics
+     */
+    StreamingStats getStreamingStats() const;
+
     /**
      * @brief Get the number of loaded chunks
      * @return The count of loaded chunks
@@ -94,10 +344,47 @@ public:
     size_t getLoadedChunkCount() const;
 
     /**
-     * @brief Unload all chunks from the world
+     * @brief Call a function on every loaded chunk, in no particular order
+     * @param function Called as function(const Chunk&); must not load or
+     *        unload chunks
+     */
+    template <typename Function>
+    void forEachChunk(Function&& function) const {
+        chunks.ForEach(function);
+    }
+
+    /**
+     * @brief Unload all chunks from the world, saving unsaved edits
      */
     void unloadAll();
 
+    /**
+     * @brief Save chunks to region files in a directory
+     *
+     * The directory is created if needed. Chunks loaded afterwards are read
+     * from it when present.
+     *
+     * @param path The save directory
+     * @return False if the directory cannot be created
+     */
+    bool setSaveDirectory(const std::string& path);
+
+    /**
+     * @brief Check if chunks are being saved
+     * @return True if a save directory is set
+     */
+    bool hasSaveDirectory() const { return regions != nullptr; }
+
+    /**
+     * @brief Save every loaded chunk edited since it was last saved
+     *
+     * Unmodified chunks are skipped, so autosaving is cheap regardless of
+     * how many chunks are loaded.
+     *
+     * @return The number of chunks written
+     */
+    size_t saveDirtyChunks();
+
     /**
      * @brief Convert world coordinates to chunk coordinates
      * @param worldCoord The world coordinate
@@ -113,17 +400,170 @@ public:
     static int worldToLocalCoord(int worldCoord);
 
 private:
-    // Chunk storage using a hash map for O(1) access
-    // Key format: (chunkX << 16) | (chunkZ & 0xFFFF)
-    std::unordered_map<long long, std::unique_ptr<Chunk>> chunks;
+    // Shared by the main thread and streaming workers; immutable
+    TerrainGenerator terrain;
+
+    // Background mesh builds; declared before chunks so that chunks, which
+    // cancel their in-flight jobs on destruction, are destroyed first
+    std::unique_ptr<MeshWorkerPool> meshWorkers;
+    size_t meshUploadsPerFrame;
+
+    // GPU storage of section meshes, or null; not owned
+    MeshUploader* meshUploader;
+
+    // Which chunk meshes stay on the GPU under the memory budget
+    std::unique_ptr<MeshResidency> meshResidency;
+
+    // Region files of the save directory, or null if saving is off
+    std::unique_ptr<RegionStore> regions;
+
+    // Background chunk loading; declared after regions, which its workers
+    // read from, and created by the first setViewer() call
+    std::unique_ptr<ChunkStreamer> streamer;
+    bool hasViewer;
+    glm::vec3 viewerPosition;
+    glm::vec3 viewerDirection;
+    int renderRadius;
+    int unloadMargin;
+
+    // Level-of-detail radius and the viewer chunk the current scales were
+    // picked for; lodScales is scratch space keyed like pendingLight
+    int lodRadius;
+    bool lodDirty;
+    int lodCenterX;
+    int lodCenterZ;
+    std::unordered_map<uint64_t, int> lodScales;
+    size_t streamLoadsPerFrame;
+    size_t streamUnloadsPerFrame;
+    StreamingStats streamingStats;
+
+    // Viewer state the current streaming requests were built for
+    bool streamRequestsDirty;
+    int requestCenterX;
+    int requestCenterZ;
+    glm::vec2 requestDirection;
+
+    // Receives changed block positions, or null
+    BlockChangeLog* blockChangeLog;
+
+    // Light updates not started yet, by chunk key, and the ones on the
+    // workers; jobs in flight never share a chunk
+    struct PendingLightUpdate {
+        int chunkX;
+        int chunkZ;
+        bool seam;
+        std::vector<LightEdit> edits;
+    };
+    std::unordered_map<uint64_t, PendingLightUpdate> pendingLight;
+    std::vector<std::shared_ptr<LightJob>> lightJobs;
+
+    // Loaded chunks in a flat open-addressing table
+    // Key format: (chunkX << 32) | (chunkZ & 0xFFFFFFFF)
+    ChunkMap chunks;
+
+    /**
+     * @brief Remesh the four loaded neighbors of a chunk
+     *
+     * Called when a chunk loads or unloads, since the neighbors' faces on
+     * the shared edges were culled against the previous state.
+     *
+     * @param chunkX The X coordinate of the chunk that changed
+     * @param chunkZ The Z coordinate of the chunk that changed
+     */
+    void markNeighborsDirty(int chunkX, int chunkZ);
 
     /**
-     * @brief Generate a key for chunk coordinates
+     * @brief Read a chunk from the save directory, or generate it
+     *
+     * Touches no other chunk, so streaming workers call it concurrently.
+     *
      * @param chunkX The X coordinate of the chunk
      * @param chunkZ The Z coordinate of the chunk
-     * @return Hash key for the chunk
+     * @return The new chunk, not yet added to the world
+     */
+    std::unique_ptr<Chunk> createChunk(int chunkX, int chunkZ);
+
+    /**
+     * @brief Add a created chunk and remesh its neighbors
+     * @return Pointer to the added chunk
+     */
+    Chunk* addChunk(int chunkX, int chunkZ, std::unique_ptr<Chunk> chunk);
+
+    /**
+     * @brief Add finished streamed chunks and unload distant ones
+     */
+    void updateStreaming();
+
+    /**
+     * @brief Update chunk mesh detail after the viewer or the loaded set changed
+     */
+    void updateLod();
+
+    /**
+     * @brief Queue every missing chunk within the render radius
+     * @param centerX The viewer's chunk X coordinate
+     * @param centerZ The viewer's chunk Z coordinate
+     */
+    void requestMissingChunks(int centerX, int centerZ);
+
+    /**
+     * @brief Unload the farthest chunks beyond the unload radius
+     * @param centerX The viewer's chunk X coordinate
+     * @param centerZ The viewer's chunk Z coordinate
+     * @return The number of chunks unloaded
+     */
+    size_t unloadDistantChunks(int centerX, int centerZ);
+
+    /**
+     * @brief Check if a chunk lies beyond the unload radius
+     */
+    bool isBeyondUnloadRadius(int chunkX, int chunkZ, int centerX, int centerZ) const;
+
+    /**
+     * @brief Queue a light update for a chunk
+     * @param chunkX The X coordinate of the chunk
+     * @param chunkZ The Z coordinate of the chunk
+     * @param edit Changed block, or nullptr for none
+     * @param seam true to reseed the chunk's edges, e.g. after it was added
+     */
+    void queueLightUpdate(int chunkX, int chunkZ, const LightEdit* edit, bool seam);
+
+    /**
+     * @brief Copy finished light jobs back to their chunks and remesh them
+     */
+    void applyFinishedLight();
+
+    /**
+     * @brief Start pending light updates whose chunks no job is using
+     */
+    void scheduleLightJobs();
+
+    /**
+     * @brief Check if a chunk's light is about to change
+     *
+     * True while a job covering the chunk is in flight, and for newly added
+     * chunks until their seam update starts, so they are not meshed twice.
+     */
+    bool isLightBusy(int chunkX, int chunkZ) const;
+
+    /**
+     * @brief Cancel the jobs covering a chunk and queue their updates again
+     * @param chunkX The X coordinate of the chunk
+     * @param chunkZ The Z coordinate of the chunk
+     */
+    void cancelLightJobs(int chunkX, int chunkZ);
+
+    /**
+     * @brief Pack chunk coordinates into a pendingLight key
+     */
+    static uint64_t lightKey(int chunkX, int chunkZ);
+
+    /**
+     * @brief Write a chunk to its region file if it has unsaved edits
+     * @param chunk The chunk to save
+     * @return True if the chunk was written
      */
-    static long long chunkKey(int chunkX, int chunkZ);
+    bool saveChunk(Chunk& chunk);
 };
 
 } // namespace world
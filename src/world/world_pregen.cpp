@@ -0,0 +1,180 @@
+#include "world_pregen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../core/profiler.h"
+#include "../core/task_scheduler.h"
+#include "chunk_section.h"
+#include "region_file.h"
+#include "terrain_generator.h"
+
+namespace cppcraft {
+namespace world {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ChunkCoord {
+  int x;
+  int z;
+};
+
+struct GeneratedChunk {
+  ChunkCoord coord;
+  ChunkStorage storage;
+};
+
+// Chunks generated by the workers, waiting for the writer
+class FinishedQueue {
+ public:
+  void Push(GeneratedChunk chunk) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      chunks_.push_back(std::move(chunk));
+    }
+    ready_cv_.notify_one();
+  }
+
+  // Wait for at least one chunk or the deadline, then take every chunk
+  void TakeAll(Clock::time_point deadline, std::vector<GeneratedChunk>* out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait_until(lock, deadline, [this] { return !chunks_.empty(); });
+    out->swap(chunks_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  std::vector<GeneratedChunk> chunks_;
+};
+
+}  // namespace
+
+PregenProgress PregenerateChunks(const TerrainGenerator& terrain,
+                                 RegionStore* regions,
+                                 const PregenSettings& settings,
+                                 const PregenProgressFunction& progress) {
+  const Clock::time_point start = Clock::now();
+  const Clock::duration interval = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(PREGEN_REPORT_INTERVAL));
+
+  const int radius = std::max(0, settings.radius);
+  const int min_x = settings.center_x - radius;
+  const int max_x = settings.center_x + radius;
+  const int min_z = settings.center_z - radius;
+  const int max_z = settings.center_z + radius;
+  const size_t max_pending = std::max<size_t>(1, settings.max_pending_writes);
+
+  PregenProgress result;
+  const size_t side = static_cast<size_t>(radius) * 2 + 1;
+  result.total = side * side;
+
+  auto report = [&]() {
+    result.elapsed_seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    result.chunks_per_second =
+        result.elapsed_seconds > 0.0
+            ? static_cast<double>(result.written) / result.elapsed_seconds
+            : 0.0;
+    if (progress) {
+      progress(result);
+    }
+  };
+
+  // Regions overlapping the square, visited row by row
+  const int region_min_x = RegionFile::ToRegionCoord(min_x);
+  const int region_max_x = RegionFile::ToRegionCoord(max_x);
+  const int region_max_z = RegionFile::ToRegionCoord(max_z);
+  int region_x = region_min_x;
+  int region_z = RegionFile::ToRegionCoord(min_z);
+
+  // Unsaved chunks of the current region, and the next one to submit
+  std::vector<ChunkCoord> region_chunks;
+  size_t next_chunk = 0;
+
+  // Declared before the scheduler, whose destructor waits for the tasks
+  // pushing into it
+  FinishedQueue finished;
+  std::vector<GeneratedChunk> batch;
+  size_t pending = 0;
+
+  core::TaskScheduler scheduler(settings.thread_count);
+  Clock::time_point next_report = start + interval;
+
+  for (;;) {
+    // Keep up to max_pending chunks generating or waiting to be written
+    while (pending < max_pending) {
+      if (next_chunk == region_chunks.size()) {
+        if (region_z > region_max_z) {
+          break;
+        }
+
+        region_chunks.clear();
+        next_chunk = 0;
+        const int first_x = std::max(min_x, region_x * REGION_SIZE);
+        const int last_x = std::min(max_x, region_x * REGION_SIZE + REGION_SIZE - 1);
+        const int first_z = std::max(min_z, region_z * REGION_SIZE);
+        const int last_z = std::min(max_z, region_z * REGION_SIZE + REGION_SIZE - 1);
+        for (int chunk_z = first_z; chunk_z <= last_z; ++chunk_z) {
+          for (int chunk_x = first_x; chunk_x <= last_x; ++chunk_x) {
+            if (regions->HasChunk(chunk_x, chunk_z)) {
+              ++result.skipped;
+            } else {
+              region_chunks.push_back({chunk_x, chunk_z});
+            }
+          }
+        }
+
+        if (++region_x > region_max_x) {
+          region_x = region_min_x;
+          ++region_z;
+        }
+        continue;
+      }
+
+      const ChunkCoord coord = region_chunks[next_chunk++];
+      ++pending;
+      scheduler.Submit([&terrain, &finished, coord] {
+        PROFILE_SCOPE("pregen.generate");
+        GeneratedChunk chunk;
+        chunk.coord = coord;
+        terrain.Generate(coord.x, coord.z, &chunk.storage);
+        finished.Push(std::move(chunk));
+      });
+    }
+
+    if (pending == 0) {
+      break;
+    }
+
+    finished.TakeAll(next_report, &batch);
+    for (const GeneratedChunk& chunk : batch) {
+      PROFILE_SCOPE("pregen.write");
+      if (regions->SaveChunk(chunk.coord.x, chunk.coord.z, chunk.storage)) {
+        ++result.written;
+      } else {
+        ++result.failed;
+      }
+      --pending;
+    }
+    batch.clear();
+
+    const Clock::time_point now = Clock::now();
+    if (now >= next_report) {
+      report();
+      next_report = now + interval;
+    }
+  }
+
+  report();
+  return result;
+}
+
+}  // namespace world
+}  // namespace cppcraft
@@ -0,0 +1,108 @@
+#ifndef SRC_WORLD_WORLD_PREGEN_H_
+#define SRC_WORLD_WORLD_PREGEN_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace cppcraft {
+namespace world {
+
+class RegionStore;
+class TerrainGenerator;
+
+// Generated chunks that may wait for the region writer before generation
+// pauses; bounds memory however large the radius
+constexpr size_t DEFAULT_PREGEN_PENDING_WRITES = 256;
+
+// Seconds between progress reports
+constexpr double PREGEN_REPORT_INTERVAL = 1.0;
+
+/**
+ * @struct PregenSettings
+ * @brief Square of chunks to pre-generate and the resources to use
+ */
+struct PregenSettings {
+  /**
+   * @brief Center of the square, in chunk coordinates
+   */
+  int center_x = 0;
+  int center_z = 0;
+
+  /**
+   * @brief Chunks from the center to the edge; the square is
+   *        2 * radius + 1 chunks wide
+   */
+  int radius = 0;
+
+  /**
+   * @brief Generation threads; 0 uses one per hardware thread
+   */
+  unsigned int thread_count = 0;
+
+  size_t max_pending_writes = DEFAULT_PREGEN_PENDING_WRITES;
+};
+
+/**
+ * @struct PregenProgress
+ * @brief Chunk counts of a pre-generation run so far
+ */
+struct PregenProgress {
+  /**
+   * @brief Chunks in the square
+   */
+  size_t total = 0;
+
+  /**
+   * @brief Chunks already saved before the run; left untouched
+   */
+  size_t skipped = 0;
+
+  /**
+   * @brief Chunks generated and written to their region files
+   */
+  size_t written = 0;
+
+  /**
+   * @brief Chunks whose write failed
+   */
+  size_t failed = 0;
+
+  double elapsed_seconds = 0.0;
+
+  /**
+   * @brief Chunks written per second since the run started
+   */
+  double chunks_per_second = 0.0;
+};
+
+/**
+ * @brief Called on the pre-generating thread with the progress so far
+ */
+using PregenProgressFunction = std::function<void(const PregenProgress&)>;
+
+/**
+ * @brief Generate a square of chunks and save them to region files
+ *
+ * Chunks are generated in parallel on a work-stealing TaskScheduler and
+ * written by the calling thread as they finish, at most
+ * max_pending_writes chunks behind; generation waits while the writer is
+ * that far behind. Chunks are taken region by region, so writes stay within
+ * a few region files at a time. Chunks the store already holds are skipped,
+ * so player edits survive and an interrupted run picks up where it stopped.
+ *
+ * @param terrain Terrain to generate
+ * @param regions Save directory to write to
+ * @param settings Square and thread count
+ * @param progress Called every PREGEN_REPORT_INTERVAL seconds and once at
+ *        the end; may be empty
+ * @return The final counts
+ */
+PregenProgress PregenerateChunks(const TerrainGenerator& terrain,
+                                 RegionStore* regions,
+                                 const PregenSettings& settings,
+                                 const PregenProgressFunction& progress);
+
+}  // namespace world
+}  // namespace cppcraft
+
+#endif  // SRC_WORLD_WORLD_PREGEN_H_
@@ -0,0 +1,210 @@
+// Chunk replication packets applied to a ChunkReplica: every packet type,
+// varint and zigzag coordinates and counts, and rejection of malformed
+// packets.
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/net/chunk_packets.h"
+#include "../src/world/block_change_log.h"
+#include "../src/world/chunk_section.h"
+#include "test_check.h"
+
+namespace cppcraft {
+namespace net {
+namespace {
+
+using world::ChunkSection;
+using world::ChunkStorage;
+using world::SectionChanges;
+
+// Coordinates far from the origin and negative, so their zigzag varints
+// take several bytes
+constexpr int CHUNK_X = -70001;
+constexpr int CHUNK_Z = 1234567;
+constexpr int SECTION = 3;
+
+std::vector<uint16_t> GetBlocks(const ChunkStorage& storage) {
+  std::vector<uint16_t> blocks(world::CHUNK_VOLUME);
+  storage.Decode(blocks.data());
+  return blocks;
+}
+
+bool SameBlocks(const ChunkStorage& a, const ChunkStorage& b) {
+  return GetBlocks(a) == GetBlocks(b) &&
+         a.GetNonEmptyMask() == b.GetNonEmptyMask();
+}
+
+bool Apply(ChunkReplica* replica, const std::vector<uint8_t>& packet) {
+  return replica->Apply(packet.data(), packet.size());
+}
+
+// Set every step-th block of the test section, starting at first, and
+// record the changed indices
+SectionChanges ChangeSection(ChunkStorage* storage, int first, int step,
+                             uint16_t block_id) {
+  SectionChanges changes;
+  changes.chunk_x = CHUNK_X;
+  changes.chunk_z = CHUNK_Z;
+  changes.section = SECTION;
+  for (int index = first; index < world::SECTION_VOLUME; index += step) {
+    const int x = index % world::SECTION_SIZE;
+    const int z = index / world::SECTION_SIZE % world::SECTION_SIZE;
+    const int y = index / world::SECTION_AREA;
+    storage->Set(x, SECTION * world::SECTION_SIZE + y, z, block_id);
+    changes.indices.push_back(
+        static_cast<uint16_t>(ChunkSection::GetIndex(x, y, z)));
+  }
+  return changes;
+}
+
+// Every shorter prefix of a packet is rejected and leaves the replica alone
+bool RejectsTruncations(ChunkReplica* replica,
+                        const std::vector<uint8_t>& packet) {
+  const ChunkStorage* before = replica->Find(CHUNK_X, CHUNK_Z);
+  const std::vector<uint16_t> blocks =
+      before ? GetBlocks(*before) : std::vector<uint16_t>();
+  const size_t count = replica->GetChunkCount();
+  bool rejected = true;
+  for (size_t size = 0; size < packet.size(); size += 1 + size / 16) {
+    rejected &= !replica->Apply(packet.data(), size);
+  }
+  const ChunkStorage* after = replica->Find(CHUNK_X, CHUNK_Z);
+  return rejected && replica->GetChunkCount() == count &&
+         (before == nullptr) == (after == nullptr) &&
+         (!after || GetBlocks(*after) == blocks);
+}
+
+void TestChunkSnapshot() {
+  ChunkStorage server;
+  for (int y = 0; y < 70; ++y) {
+    server.Set(y % 16, y, (y * 7) % 16, static_cast<uint16_t>(1 + y));
+  }
+  std::vector<uint8_t> packet;
+  EncodeChunkSnapshot(CHUNK_X, CHUNK_Z, server, &packet);
+  CHECK_EQ(packet[0], static_cast<uint8_t>(PacketType::CHUNK_SNAPSHOT));
+
+  ChunkReplica replica;
+  CHECK(RejectsTruncations(&replica, packet));
+  CHECK(Apply(&replica, packet));
+  CHECK_EQ(replica.GetChunkCount(), 1u);
+  CHECK(replica.Find(CHUNK_X, CHUNK_Z) != nullptr);
+  CHECK(replica.Find(CHUNK_Z, CHUNK_X) == nullptr);
+  CHECK(replica.Find(-CHUNK_X, CHUNK_Z) == nullptr);
+  if (const ChunkStorage* chunk = replica.Find(CHUNK_X, CHUNK_Z)) {
+    CHECK(SameBlocks(*chunk, server));
+  }
+
+  // A second snapshot replaces the first
+  packet.clear();
+  EncodeChunkSnapshot(CHUNK_X, CHUNK_Z, ChunkStorage(), &packet);
+  CHECK(Apply(&replica, packet));
+  CHECK_EQ(replica.GetChunkCount(), 1u);
+  if (const ChunkStorage* chunk = replica.Find(CHUNK_X, CHUNK_Z)) {
+    CHECK(SameBlocks(*chunk, ChunkStorage()));
+  }
+}
+
+void TestSectionUpdates() {
+  ChunkStorage server;
+  ChunkReplica replica;
+  std::vector<uint8_t> packet;
+
+  // Deltas sent before the chunk are refused
+  SectionChanges changes = ChangeSection(&server, 5, 97, 2);
+  EncodeSectionUpdate(changes, server, &packet);
+  CHECK(!Apply(&replica, packet));
+
+  packet.clear();
+  EncodeChunkSnapshot(CHUNK_X, CHUNK_Z, server, &packet);
+  CHECK(Apply(&replica, packet));
+
+  // 200 changes: the count and the gaps need two-byte varints, the
+  // block ID too
+  changes = ChangeSection(&server, 1, 20, 300);
+  CHECK(changes.indices.size() > 127 &&
+        changes.indices.size() <= SECTION_DELTA_LIMIT);
+  packet.clear();
+  EncodeSectionUpdate(changes, server, &packet);
+  CHECK_EQ(packet[0], static_cast<uint8_t>(PacketType::SECTION_DELTA));
+  CHECK(RejectsTruncations(&replica, packet));
+  CHECK(Apply(&replica, packet));
+  if (const ChunkStorage* chunk = replica.Find(CHUNK_X, CHUNK_Z)) {
+    CHECK(SameBlocks(*chunk, server));
+  }
+
+  // Past the limit the section is sent whole
+  changes = ChangeSection(&server, 0, 3, 7);
+  CHECK(changes.indices.size() > SECTION_DELTA_LIMIT);
+  packet.clear();
+  EncodeSectionUpdate(changes, server, &packet);
+  CHECK_EQ(packet[0], static_cast<uint8_t>(PacketType::SECTION_SNAPSHOT));
+  CHECK(RejectsTruncations(&replica, packet));
+  CHECK(Apply(&replica, packet));
+  if (const ChunkStorage* chunk = replica.Find(CHUNK_X, CHUNK_Z)) {
+    CHECK(SameBlocks(*chunk, server));
+  }
+
+  // Clearing the whole section sends it as all air
+  changes = ChangeSection(&server, 0, 1, world::AIR_BLOCK_ID);
+  packet.clear();
+  EncodeSectionUpdate(changes, server, &packet);
+  CHECK_EQ(packet[0], static_cast<uint8_t>(PacketType::SECTION_SNAPSHOT));
+  CHECK(Apply(&replica, packet));
+  if (const ChunkStorage* chunk = replica.Find(CHUNK_X, CHUNK_Z)) {
+    CHECK(SameBlocks(*chunk, server));
+    CHECK_EQ(chunk->GetNonEmptyMask() & (1u << SECTION), 0u);
+  }
+
+  // Sections past the top of the chunk are malformed
+  changes = ChangeSection(&server, 0, 512, 4);
+  packet.clear();
+  EncodeSectionUpdate(changes, server, &packet);
+  // Type byte, then zigzag varints of 140001 (3 bytes) and 2469134 (4)
+  const size_t section_offset = 1 + 3 + 4;
+  CHECK_EQ(packet[section_offset], SECTION);
+  packet[section_offset] = world::SECTIONS_PER_CHUNK;
+  CHECK(!Apply(&replica, packet));
+}
+
+void TestUnloadAndMalformed() {
+  ChunkReplica replica;
+  std::vector<uint8_t> packet;
+  EncodeChunkSnapshot(CHUNK_X, CHUNK_Z, ChunkStorage(), &packet);
+  CHECK(Apply(&replica, packet));
+  packet.clear();
+  EncodeChunkSnapshot(-1, 0, ChunkStorage(), &packet);
+  CHECK(Apply(&replica, packet));
+  CHECK_EQ(replica.GetChunkCount(), 2u);
+
+  packet.clear();
+  EncodeChunkUnload(CHUNK_X, CHUNK_Z, &packet);
+  CHECK_EQ(packet[0], static_cast<uint8_t>(PacketType::CHUNK_UNLOAD));
+  CHECK(RejectsTruncations(&replica, packet));
+  CHECK(Apply(&replica, packet));
+  CHECK_EQ(replica.GetChunkCount(), 1u);
+  CHECK(replica.Find(CHUNK_X, CHUNK_Z) == nullptr);
+  CHECK(replica.Find(-1, 0) != nullptr);
+
+  // Unknown types are refused
+  const std::vector<uint8_t> unknown = {0, 0, 0};
+  CHECK(!Apply(&replica, unknown));
+  CHECK_EQ(replica.GetChunkCount(), 1u);
+
+  // Unloading a chunk the replica does not hold is harmless
+  packet.clear();
+  EncodeChunkUnload(5, 5, &packet);
+  CHECK(Apply(&replica, packet));
+  CHECK_EQ(replica.GetChunkCount(), 1u);
+}
+
+}  // namespace
+}  // namespace net
+}  // namespace cppcraft
+
+int main() {
+  cppcraft::net::TestChunkSnapshot();
+  cppcraft::net::TestSectionUpdates();
+  cppcraft::net::TestUnloadAndMalformed();
+  return cppcraft::test::TestResult();
+}
@@ -0,0 +1,152 @@
+// Swept-AABB collision against a small flat world: landing, sliding along
+// walls, fast moves that must not tunnel, and the solid world edges.
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "../src/world/block.h"
+#include "../src/world/chunk.h"
+#include "../src/world/collision.h"
+#include "../src/world/world.h"
+#include "test_check.h"
+
+namespace cppcraft {
+namespace world {
+namespace {
+
+constexpr uint16_t STONE_ID = static_cast<uint16_t>(BlockType::STONE);
+constexpr uint16_t WATER_ID = static_cast<uint16_t>(BlockType::WATER);
+
+// Top of the one block thick floor
+constexpr int FLOOR_Y = 10;
+
+// Cells x = WALL_X, y in (FLOOR_Y, FLOOR_Y + 3], every z of the loaded area
+constexpr int WALL_X = 3;
+
+// Chunks -1 and 0 on both axes are loaded, so blocks [-16, 16) exist
+constexpr int LOADED_MIN = -CHUNK_SIZE_X;
+constexpr int LOADED_MAX = CHUNK_SIZE_X;
+
+// Player-sized box with its feet centered on (x, y, z)
+Aabb MakeBox(float x, float y, float z) {
+  Aabb box;
+  box.min = glm::vec3(x - 0.3f, y, z - 0.3f);
+  box.max = glm::vec3(x + 0.3f, y + 1.8f, z + 0.3f);
+  return box;
+}
+
+bool NearlyEqual(float a, float b) { return a - b < 1e-4f && b - a < 1e-4f; }
+
+void BuildWorld(World* world) {
+  for (int chunk_z = -1; chunk_z <= 0; ++chunk_z) {
+    for (int chunk_x = -1; chunk_x <= 0; ++chunk_x) {
+      world->loadChunk(chunk_x, chunk_z)->Fill(AIR_BLOCK_ID);
+    }
+  }
+  for (int z = LOADED_MIN; z < LOADED_MAX; ++z) {
+    for (int x = LOADED_MIN; x < LOADED_MAX; ++x) {
+      world->setBlock(x, FLOOR_Y - 1, z, STONE_ID);
+    }
+    for (int y = FLOOR_Y; y < FLOOR_Y + 3; ++y) {
+      world->setBlock(WALL_X, y, z, STONE_ID);
+    }
+  }
+  // A pool in the floor; liquids never stop boxes
+  world->setBlock(-5, FLOOR_Y - 1, -5, WATER_ID);
+}
+
+void TestLanding(CollisionCache* cache) {
+  const Aabb box = MakeBox(0.5f, FLOOR_Y + 2.0f, 0.5f);
+  const CollisionResult fall = MoveAabb(box, glm::vec3(0.0f, -0.5f, 0.0f), cache);
+  CHECK(!fall.hit_y);
+  CHECK(!fall.on_ground);
+  CHECK(NearlyEqual(fall.box.min.y, FLOOR_Y + 1.5f));
+
+  const CollisionResult land = MoveAabb(box, glm::vec3(0.0f, -5.0f, 0.0f), cache);
+  CHECK(land.hit_y);
+  CHECK(land.on_ground);
+  CHECK(NearlyEqual(land.box.min.y, FLOOR_Y + COLLISION_EPSILON));
+  CHECK(!IsAabbBlocked(land.box, cache));
+
+  // Hitting a ceiling stops the box but does not ground it
+  const Aabb under = MakeBox(WALL_X + 0.5f, FLOOR_Y - 3.0f, 0.5f);
+  const CollisionResult jump = MoveAabb(under, glm::vec3(0.0f, 3.0f, 0.0f), cache);
+  CHECK(jump.hit_y);
+  CHECK(!jump.on_ground);
+
+  // Water does not hold anything up
+  const Aabb pool = MakeBox(-4.5f, FLOOR_Y, -4.5f);
+  CHECK(!MoveAabb(pool, glm::vec3(0.0f, -0.5f, 0.0f), cache).hit_y);
+}
+
+void TestSliding(CollisionCache* cache) {
+  // Walking diagonally into the wall keeps the motion along it
+  const Aabb box = MakeBox(1.5f, FLOOR_Y + COLLISION_EPSILON, 0.5f);
+  const glm::vec3 motion(2.0f, -0.1f, 1.5f);
+  const CollisionResult slide = MoveAabb(box, motion, cache);
+  CHECK(slide.hit_x);
+  CHECK(!slide.hit_z);
+  CHECK(slide.on_ground);
+  CHECK(NearlyEqual(slide.box.max.x, WALL_X - COLLISION_EPSILON));
+  CHECK(NearlyEqual(slide.motion.z, 1.5f));
+  CHECK(!IsAabbBlocked(slide.box, cache));
+
+  // Standing against the wall, moving away is free and into it is not
+  const CollisionResult away =
+      MoveAabb(slide.box, glm::vec3(-1.0f, 0.0f, 0.0f), cache);
+  CHECK(!away.hit_x);
+  const CollisionResult into =
+      MoveAabb(slide.box, glm::vec3(0.5f, 0.0f, 0.0f), cache);
+  CHECK(into.hit_x);
+  CHECK(NearlyEqual(into.motion.x, 0.0f));
+}
+
+void TestNoTunneling(CollisionCache* cache) {
+  // Moves far longer than a block still stop at the first solid cell
+  const Aabb high = MakeBox(-8.5f, FLOOR_Y + 40.0f, 7.5f);
+  const CollisionResult fall =
+      MoveAabb(high, glm::vec3(0.0f, -200.0f, 0.0f), cache);
+  CHECK(fall.on_ground);
+  CHECK(NearlyEqual(fall.box.min.y, FLOOR_Y + COLLISION_EPSILON));
+
+  const Aabb box = MakeBox(-10.5f, FLOOR_Y + COLLISION_EPSILON, -2.5f);
+  const CollisionResult dash =
+      MoveAabb(box, glm::vec3(100.0f, 0.0f, 0.0f), cache);
+  CHECK(dash.hit_x);
+  CHECK(NearlyEqual(dash.box.max.x, WALL_X - COLLISION_EPSILON));
+}
+
+void TestWorldEdges(CollisionCache* cache) {
+  // Unloaded chunks are solid walls
+  const Aabb box = MakeBox(0.5f, FLOOR_Y + COLLISION_EPSILON, -14.5f);
+  const CollisionResult edge =
+      MoveAabb(box, glm::vec3(0.0f, 0.0f, -10.0f), cache);
+  CHECK(edge.hit_z);
+  CHECK(NearlyEqual(edge.box.min.z, LOADED_MIN + COLLISION_EPSILON));
+  CHECK(IsAabbBlocked(MakeBox(0.5f, FLOOR_Y, LOADED_MAX + 2.0f), cache));
+
+  // Below the world is solid, above it is open
+  CHECK(IsAabbBlocked(MakeBox(0.5f, -1.5f, 0.5f), cache));
+  CHECK(!IsAabbBlocked(MakeBox(0.5f, CHUNK_SIZE_Y + 1.0f, 0.5f), cache));
+
+  // Boxes overlapping the floor or the wall are blocked
+  CHECK(IsAabbBlocked(MakeBox(0.5f, FLOOR_Y - 0.5f, 0.5f), cache));
+  CHECK(IsAabbBlocked(MakeBox(WALL_X + 0.2f, FLOOR_Y + 1.0f, 0.5f), cache));
+  CHECK(!IsAabbBlocked(MakeBox(0.5f, FLOOR_Y + 1.0f, 0.5f), cache));
+}
+
+}  // namespace
+}  // namespace world
+}  // namespace cppcraft
+
+int main() {
+  cppcraft::world::World world;
+  cppcraft::world::BuildWorld(&world);
+  cppcraft::world::CollisionCache cache(world);
+  cppcraft::world::TestLanding(&cache);
+  cppcraft::world::TestSliding(&cache);
+  cppcraft::world::TestNoTunneling(&cache);
+  cppcraft::world::TestWorldEdges(&cache);
+  return cppcraft::test::TestResult();
+}
@@ -0,0 +1,152 @@
+// Round trips through PaletteStorage and ChunkStorage at every bit width.
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/world/chunk_section.h"
+#include "../src/world/palette_storage.h"
+#include "test_check.h"
+
+namespace cppcraft {
+namespace world {
+namespace {
+
+constexpr size_t ENTRY_COUNT = SECTION_VOLUME;
+
+// Block IDs cycling through distinct_ids values, offset so 0 is not first
+std::vector<uint16_t> MakeBlocks(size_t distinct_ids) {
+  std::vector<uint16_t> blocks(ENTRY_COUNT);
+  for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+    blocks[i] = static_cast<uint16_t>(7 + (i * 31) % distinct_ids);
+  }
+  return blocks;
+}
+
+bool MatchesBlocks(const PaletteStorage& storage,
+                   const std::vector<uint16_t>& blocks) {
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (storage.Get(i) != blocks[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Set() grows the width one new ID at a time and keeps earlier entries
+void TestSetGrowsWidth() {
+  PaletteStorage storage(ENTRY_COUNT, 7);
+  CHECK_EQ(storage.GetBitsPerEntry(), 1);
+
+  const struct {
+    size_t distinct_ids;
+    int bits;
+  } steps[] = {{2, 1}, {3, 2}, {5, 4}, {17, 8}, {300, 16}};
+  for (const auto& step : steps) {
+    const std::vector<uint16_t> blocks = MakeBlocks(step.distinct_ids);
+    for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+      storage.Set(i, blocks[i]);
+    }
+    CHECK_EQ(storage.GetBitsPerEntry(), step.bits);
+    CHECK(MatchesBlocks(storage, blocks));
+  }
+  CHECK(storage.IsDirect());
+  CHECK(storage.GetPalette().empty());
+}
+
+// Encode() builds the minimal palette; Decode() returns the same IDs
+void TestEncodeDecode() {
+  for (size_t distinct_ids : {1, 2, 4, 16, 200, 256, 257, 4096}) {
+    const std::vector<uint16_t> blocks = MakeBlocks(distinct_ids);
+    PaletteStorage storage(ENTRY_COUNT);
+    storage.Encode(blocks.data());
+    CHECK(MatchesBlocks(storage, blocks));
+
+    std::vector<uint16_t> decoded(ENTRY_COUNT);
+    storage.Decode(decoded.data());
+    CHECK(decoded == blocks);
+    if (!storage.IsDirect()) {
+      CHECK_EQ(storage.GetPalette().size(), distinct_ids);
+    }
+  }
+}
+
+// Assign() restores exactly what the serialized state described
+void TestAssignRoundTrip() {
+  const std::vector<uint16_t> blocks = MakeBlocks(13);
+  PaletteStorage source(ENTRY_COUNT);
+  source.Encode(blocks.data());
+
+  PaletteStorage copy(ENTRY_COUNT);
+  CHECK(copy.Assign(source.GetBitsPerEntry(), source.GetPalette(),
+                    source.GetWords()));
+  CHECK(MatchesBlocks(copy, blocks));
+
+  // Too few words for the size is rejected
+  std::vector<uint64_t> short_words = source.GetWords();
+  short_words.pop_back();
+  CHECK(!copy.Assign(source.GetBitsPerEntry(), source.GetPalette(),
+                     short_words));
+}
+
+// Compact() drops IDs no entry uses and shrinks the width
+void TestCompactShrinks() {
+  PaletteStorage storage(ENTRY_COUNT);
+  const std::vector<uint16_t> blocks = MakeBlocks(40);
+  storage.Encode(blocks.data());
+  CHECK_EQ(storage.GetBitsPerEntry(), 8);
+
+  for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+    storage.Set(i, static_cast<uint16_t>(i % 2 ? 3 : 9));
+  }
+  storage.Compact();
+  CHECK_EQ(storage.GetBitsPerEntry(), 1);
+  for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+    CHECK_EQ(storage.Get(i), static_cast<uint16_t>(i % 2 ? 3 : 9));
+  }
+
+  storage.Fill(5);
+  CHECK_EQ(storage.GetBitsPerEntry(), 1);
+  CHECK_EQ(storage.Get(ENTRY_COUNT - 1), 5);
+}
+
+// Whole chunks keep their blocks and leave all-air sections unallocated
+void TestChunkStorageRoundTrip() {
+  std::vector<uint16_t> blocks(CHUNK_VOLUME, AIR_BLOCK_ID);
+  for (int y = 0; y < 40; ++y) {
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z) {
+      for (int x = 0; x < CHUNK_SIZE_X; ++x) {
+        blocks[(y / SECTION_SIZE) * SECTION_VOLUME +
+               ChunkSection::GetIndex(x, y % SECTION_SIZE, z)] =
+            static_cast<uint16_t>(1 + (x + y * 3 + z * 5) % 9);
+      }
+    }
+  }
+
+  ChunkStorage storage;
+  storage.Encode(blocks.data());
+  CHECK_EQ(storage.GetNonEmptyMask(), 0x7u);
+
+  std::vector<uint16_t> decoded(CHUNK_VOLUME);
+  storage.Decode(decoded.data());
+  CHECK(decoded == blocks);
+
+  // Clearing a section's last block releases it
+  CHECK(storage.Set(3, 60, 4, 2));
+  CHECK(storage.GetSection(3) != nullptr);
+  CHECK(storage.Set(3, 60, 4, AIR_BLOCK_ID));
+  CHECK(storage.GetSection(3) == nullptr);
+  CHECK_EQ(storage.Get(3, 60, 4), AIR_BLOCK_ID);
+}
+
+}  // namespace
+}  // namespace world
+}  // namespace cppcraft
+
+int main() {
+  cppcraft::world::TestSetGrowsWidth();
+  cppcraft::world::TestEncodeDecode();
+  cppcraft::world::TestAssignRoundTrip();
+  cppcraft::world::TestCompactShrinks();
+  cppcraft::world::TestChunkStorageRoundTrip();
+  return cppcraft::test::TestResult();
+}
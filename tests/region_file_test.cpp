@@ -0,0 +1,181 @@
+// Save/load round trips through the region payload format, RegionFile and
+// RegionStore. The file I/O goes through the platform's own path, Win32 or
+// POSIX, whichever the test is built for.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../src/world/chunk_section.h"
+#include "../src/world/region_file.h"
+#include "test_check.h"
+
+namespace cppcraft {
+namespace world {
+namespace {
+
+// Deterministic column filled up to height; noise makes sections compress
+// poorly, so the payload spans several sectors
+ChunkStorage MakeChunk(uint32_t seed, int height, bool noise) {
+  ChunkStorage storage;
+  uint32_t state = seed * 2654435761u + 1;
+  for (int y = 0; y < height; ++y) {
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z) {
+      for (int x = 0; x < CHUNK_SIZE_X; ++x) {
+        state = state * 1664525u + 1013904223u;
+        const uint16_t block =
+            noise ? static_cast<uint16_t>(1 + (state >> 16) % 300)
+                  : static_cast<uint16_t>(1 + (y / 4 + seed) % 5);
+        storage.Set(x, y, z, block);
+      }
+    }
+  }
+  return storage;
+}
+
+bool SameBlocks(const ChunkStorage& a, const ChunkStorage& b) {
+  std::vector<uint16_t> blocks_a(CHUNK_VOLUME);
+  std::vector<uint16_t> blocks_b(CHUNK_VOLUME);
+  a.Decode(blocks_a.data());
+  b.Decode(blocks_b.data());
+  return blocks_a == blocks_b && a.GetNonEmptyMask() == b.GetNonEmptyMask();
+}
+
+// Scratch directory, removed again when the test ends
+class TempDirectory {
+ public:
+  TempDirectory() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    path_ = std::filesystem::temp_directory_path() /
+            ("cppcraft_region_test_" + std::to_string(now.count()));
+    std::filesystem::create_directories(path_);
+  }
+
+  ~TempDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+  }
+
+  std::string GetPath() const { return path_.string(); }
+
+ private:
+  std::filesystem::path path_;
+};
+
+void TestPayloadRoundTrip() {
+  const ChunkStorage empty;
+  const ChunkStorage layered = MakeChunk(3, 70, false);
+  const ChunkStorage noisy = MakeChunk(4, 40, true);
+  for (const ChunkStorage* storage : {&empty, &layered, &noisy}) {
+    std::vector<uint8_t> payload;
+    EncodeChunkPayload(*storage, &payload);
+
+    ChunkStorage decoded;
+    CHECK(DecodeChunkPayload(payload.data(), payload.size(), &decoded));
+    CHECK(SameBlocks(decoded, *storage));
+
+    // Every truncation is rejected and leaves the output alone
+    ChunkStorage untouched = MakeChunk(9, 16, false);
+    bool rejected = true;
+    for (size_t size = 0; size < payload.size(); size += 1 + size / 8) {
+      rejected &= !DecodeChunkPayload(payload.data(), size, &untouched);
+    }
+    CHECK(rejected);
+    CHECK(SameBlocks(untouched, MakeChunk(9, 16, false)));
+  }
+
+  // Another format version is rejected
+  std::vector<uint8_t> payload;
+  EncodeChunkPayload(layered, &payload);
+  payload[0] ^= 0xFF;
+  ChunkStorage decoded;
+  CHECK(!DecodeChunkPayload(payload.data(), payload.size(), &decoded));
+}
+
+void TestRegionFileRewrite(const TempDirectory& directory) {
+  const std::string path = directory.GetPath() + "/single.region";
+  const ChunkStorage small = MakeChunk(1, 20, false);
+  const ChunkStorage large = MakeChunk(2, 64, true);
+  {
+    std::unique_ptr<RegionFile> region = RegionFile::Open(path);
+    CHECK(region != nullptr);
+    if (!region) {
+      return;
+    }
+    CHECK(!region->HasChunk(5, 7));
+    CHECK(region->WriteChunk(5, 7, small));
+    CHECK(region->WriteChunk(31, 31, small));
+
+    // Growing past the chunk's sectors moves it; shrinking reuses space
+    CHECK(region->WriteChunk(5, 7, large));
+    ChunkStorage read;
+    CHECK(region->ReadChunk(5, 7, &read));
+    CHECK(SameBlocks(read, large));
+    CHECK(region->WriteChunk(0, 0, large));
+    CHECK(region->WriteChunk(0, 0, small));
+  }
+
+  // Everything is still there after reopening
+  std::unique_ptr<RegionFile> region = RegionFile::Open(path);
+  CHECK(region != nullptr);
+  if (!region) {
+    return;
+  }
+  ChunkStorage read;
+  CHECK(region->ReadChunk(5, 7, &read));
+  CHECK(SameBlocks(read, large));
+  CHECK(region->ReadChunk(31, 31, &read));
+  CHECK(SameBlocks(read, small));
+  CHECK(region->ReadChunk(0, 0, &read));
+  CHECK(SameBlocks(read, small));
+  CHECK(!region->HasChunk(1, 0));
+  CHECK(!region->ReadChunk(1, 0, &read));
+}
+
+void TestRegionStore(const TempDirectory& directory) {
+  // Chunks on both sides of region borders, including negative coordinates
+  const int coords[][2] = {{0, 0}, {31, 31}, {32, 0}, {-1, -1}, {-33, 40}};
+  {
+    RegionStore store(directory.GetPath());
+    CHECK(!store.HasChunk(0, 0));
+    uint32_t seed = 10;
+    for (const auto& coord : coords) {
+      CHECK(store.SaveChunk(coord[0], coord[1], MakeChunk(seed, 50, seed % 2)));
+      ++seed;
+    }
+  }
+
+  RegionStore store(directory.GetPath());
+  uint32_t seed = 10;
+  for (const auto& coord : coords) {
+    ChunkStorage read;
+    CHECK(store.HasChunk(coord[0], coord[1]));
+    CHECK(store.LoadChunk(coord[0], coord[1], &read));
+    CHECK(SameBlocks(read, MakeChunk(seed, 50, seed % 2)));
+    ++seed;
+  }
+  ChunkStorage read;
+  CHECK(!store.HasChunk(1, 1));
+  CHECK(!store.LoadChunk(1, 1, &read));
+  CHECK(!store.LoadChunk(500, 500, &read));
+
+  // Files are only created for regions something was saved into
+  CHECK(std::filesystem::exists(directory.GetPath() + "/r.-2.1.region"));
+  CHECK(!std::filesystem::exists(directory.GetPath() + "/r.15.15.region"));
+}
+
+}  // namespace
+}  // namespace world
+}  // namespace cppcraft
+
+int main() {
+  cppcraft::world::TempDirectory directory;
+  cppcraft::world::TestPayloadRoundTrip();
+  cppcraft::world::TestRegionFileRewrite(directory);
+  cppcraft::world::TestRegionStore(directory);
+  return cppcraft::test::TestResult();
+}
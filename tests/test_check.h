@@ -0,0 +1,44 @@
+#ifndef TESTS_TEST_CHECK_H_
+#define TESTS_TEST_CHECK_H_
+
+#include <cstdio>
+
+// Minimal checks for the unit tests, which build without GL or a test
+// framework. A failed check prints its location and keeps going, so one
+// run reports every failure; main() returns TestResult().
+
+namespace cppcraft {
+namespace test {
+
+inline int& FailureCount() {
+  static int failures = 0;
+  return failures;
+}
+
+inline bool Check(bool passed, const char* expression, const char* file,
+                  int line) {
+  if (!passed) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    ++FailureCount();
+  }
+  return passed;
+}
+
+inline int TestResult() {
+  if (FailureCount() > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", FailureCount());
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace test
+}  // namespace cppcraft
+
+#define CHECK(condition) \
+  ::cppcraft::test::Check((condition), #condition, __FILE__, __LINE__)
+
+#define CHECK_EQ(a, b) \
+  ::cppcraft::test::Check((a) == (b), #a " == " #b, __FILE__, __LINE__)
+
+#endif  // TESTS_TEST_CHECK_H_
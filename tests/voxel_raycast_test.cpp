@@ -0,0 +1,161 @@
+// DDA raycast through a hand-built set of blocks: hit cells, entry faces,
+// adjacent cells, distances and the distance and height limits.
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+#include "../src/world/block.h"
+#include "../src/world/voxel_raycast.h"
+#include "test_check.h"
+
+namespace cppcraft {
+namespace world {
+namespace {
+
+constexpr uint16_t STONE_ID = static_cast<uint16_t>(BlockType::STONE);
+constexpr uint16_t WATER_ID = static_cast<uint16_t>(BlockType::WATER);
+constexpr int HEIGHT = 64;
+
+// Sparse world; every cell not set is air. Counts reads to check that the
+// walk never reads outside the height range
+class BlockReader {
+ public:
+  void Set(int x, int y, int z, uint16_t block_id) {
+    blocks_[std::make_tuple(x, y, z)] = block_id;
+  }
+
+  uint16_t Get(int x, int y, int z) {
+    if (y < 0 || y >= HEIGHT) {
+      ++outside_reads_;
+    }
+    const auto it = blocks_.find(std::make_tuple(x, y, z));
+    return it == blocks_.end() ? AIR_BLOCK_ID : it->second;
+  }
+
+  int GetOutsideReads() const { return outside_reads_; }
+
+ private:
+  std::map<std::tuple<int, int, int>, uint16_t> blocks_;
+  int outside_reads_ = 0;
+};
+
+RaycastHit Trace(BlockReader& reader, const glm::vec3& origin,
+                 const glm::vec3& direction, float max_distance = 16.0f) {
+  Ray ray;
+  ray.origin = origin;
+  ray.direction = direction;
+  ray.max_distance = max_distance;
+  return TraceVoxels(ray, IsPickableBlock, HEIGHT, reader);
+}
+
+bool NearlyEqual(float a, float b) { return a - b < 1e-4f && b - a < 1e-4f; }
+
+void TestAxisAlignedFaces() {
+  BlockReader reader;
+  reader.Set(0, 10, 0, STONE_ID);
+  const glm::vec3 center(0.5f, 10.5f, 0.5f);
+
+  // One ray per face, each starting 3.5 blocks away; face order as in the
+  // mesher: +Z, -Z, -X, +X, -Y, +Y
+  const glm::vec3 offsets[6] = {{0, 0, 3}, {0, 0, -3}, {-3, 0, 0},
+                                {3, 0, 0}, {0, -3, 0}, {0, 3, 0}};
+  const glm::ivec3 adjacent[6] = {{0, 10, 1}, {0, 10, -1}, {-1, 10, 0},
+                                  {1, 10, 0}, {0, 9, 0},   {0, 11, 0}};
+  for (int face = 0; face < 6; ++face) {
+    const RaycastHit hit = Trace(reader, center + offsets[face], -offsets[face]);
+    CHECK(hit.hit);
+    CHECK_EQ(hit.face, face);
+    CHECK_EQ(hit.block_id, STONE_ID);
+    CHECK(hit.block_x == 0 && hit.block_y == 10 && hit.block_z == 0);
+    CHECK(hit.adjacent_x == adjacent[face].x &&
+          hit.adjacent_y == adjacent[face].y &&
+          hit.adjacent_z == adjacent[face].z);
+    CHECK(NearlyEqual(hit.distance, 2.5f));
+  }
+}
+
+void TestNegativeCoordinates() {
+  BlockReader reader;
+  reader.Set(-5, 3, -7, STONE_ID);
+
+  // Diagonal ray from the positive quadrant, unnormalized direction
+  const glm::vec3 target(-4.5f, 3.5f, -6.5f);
+  const glm::vec3 origin(2.25f, 3.5f, 1.75f);
+  const RaycastHit hit = Trace(reader, origin, (target - origin) * 10.0f);
+  CHECK(hit.hit);
+  CHECK(hit.block_x == -5 && hit.block_y == 3 && hit.block_z == -7);
+  CHECK(hit.face == 0 || hit.face == 3);
+  CHECK(hit.distance < glm::length(target - origin));
+
+  // Cells are floored, so -0.5 lies in cell -1, not 0
+  BlockReader floor_reader;
+  floor_reader.Set(-1, 3, -1, STONE_ID);
+  const RaycastHit inside =
+      Trace(floor_reader, glm::vec3(-0.5f, 3.5f, -0.5f), glm::vec3(0, 1, 0));
+  CHECK(inside.hit);
+  CHECK_EQ(inside.face, -1);
+  CHECK(NearlyEqual(inside.distance, 0.0f));
+  CHECK(inside.adjacent_x == -1 && inside.adjacent_y == 3 &&
+        inside.adjacent_z == -1);
+}
+
+void TestFilterAndDistance() {
+  BlockReader reader;
+  reader.Set(0, 5, -3, WATER_ID);
+  reader.Set(0, 5, -6, STONE_ID);
+  const glm::vec3 origin(0.5f, 5.5f, 0.5f);
+  const glm::vec3 forward(0.0f, 0.0f, -1.0f);
+
+  // Liquids are not pickable, so the ray passes through the water
+  const RaycastHit hit = Trace(reader, origin, forward);
+  CHECK(hit.hit);
+  CHECK_EQ(hit.block_z, -6);
+  CHECK(NearlyEqual(hit.distance, 5.5f));
+
+  // ... and stops just short of the stone when the reach ends first
+  CHECK(!Trace(reader, origin, forward, 5.4f).hit);
+  CHECK(Trace(reader, origin, forward, 5.6f).hit);
+
+  // Line of sight stops at the first opaque block only
+  Ray ray;
+  ray.origin = origin;
+  ray.direction = forward;
+  ray.max_distance = 16.0f;
+  CHECK_EQ(TraceVoxels(ray, BlocksLineOfSight, HEIGHT, reader).block_z, -6);
+
+  // Degenerate rays hit nothing
+  CHECK(!Trace(reader, origin, glm::vec3(0.0f)).hit);
+  CHECK(!Trace(reader, origin, forward, -1.0f).hit);
+}
+
+void TestHeightRange() {
+  BlockReader reader;
+
+  // Rays leaving the world stop without reading outside the height range
+  CHECK(!Trace(reader, glm::vec3(0.5f, 60.5f, 0.5f), glm::vec3(0, 1, 0), 100.0f).hit);
+  CHECK(!Trace(reader, glm::vec3(0.5f, 2.5f, 0.5f), glm::vec3(0.3f, -1, 0), 100.0f).hit);
+
+  // A ray starting above the world still finds the top layer on its way down
+  reader.Set(4, HEIGHT - 1, 0, STONE_ID);
+  const RaycastHit hit =
+      Trace(reader, glm::vec3(4.5f, HEIGHT + 2.5f, 0.5f), glm::vec3(0, -1, 0));
+  CHECK(hit.hit);
+  CHECK_EQ(hit.face, 5);
+  CHECK_EQ(hit.block_y, HEIGHT - 1);
+  CHECK_EQ(reader.GetOutsideReads(), 0);
+}
+
+}  // namespace
+}  // namespace world
+}  // namespace cppcraft
+
+int main() {
+  cppcraft::world::TestAxisAlignedFaces();
+  cppcraft::world::TestNegativeCoordinates();
+  cppcraft::world::TestFilterAndDistance();
+  cppcraft::world::TestHeightRange();
+  return cppcraft::test::TestResult();
+}